@@ -108,6 +108,19 @@ if "%look_at_raddbg%"=="1"     %compile%             ..\src\scratch\look_at_radd
 if "%mule_main%"=="1"          del vc*.pdb mule*.pdb && %compile_release% %only_compile% ..\src\mule\mule_inline.cpp && %compile_release% %only_compile% ..\src\mule\mule_o2.cpp && %compile_debug% %EHsc% ..\src\mule\mule_main.cpp ..\src\mule\mule_c.c mule_inline.obj mule_o2.obj %compile_link% %out%mule_main.exe || exit /b 1
 if "%mule_module%"=="1"        %compile%             ..\src\mule\mule_module.cpp                                  %compile_link% %link_dll% %out%mule_module.dll || exit /b 1
 if "%mule_hotload%"=="1"       %compile% ..\src\mule\mule_hotload_main.c %compile_link% %out%mule_hotload.exe & %compile% ..\src\mule\mule_hotload_module_main.c %compile_link% %link_dll% %out%mule_hotload_module.dll || exit /b 1
+if "%os_sync_bench%"=="1"      %compile%             ..\src\os\core\test\os_sync_bench.c                          %compile_link% %out%os_sync_bench.exe || exit /b 1
+if "%os_file_map_bench%"=="1"  %compile%             ..\src\os\core\test\os_file_map_bench.c                      %compile_link% %out%os_file_map_bench.exe || exit /b 1
+if "%dbgi_fuzzy_bench%"=="1"   %compile%             ..\src\dbgi\test\dbgi_fuzzy_bench.c                          %compile_link% %out%dbgi_fuzzy_bench.exe || exit /b 1
+if "%demon_linux_write_tracking_test%"=="1" %compile% ..\src\demon\test\demon_linux_write_tracking_test.c          %compile_link% %out%demon_linux_write_tracking_test.exe || exit /b 1
+if "%demon_linux_read_batch_bench%"=="1" %compile%    ..\src\demon\test\demon_linux_read_batch_bench.c             %compile_link% %out%demon_linux_read_batch_bench.exe || exit /b 1
+if "%txt_bench%"=="1"          %compile%             ..\src\text_cache\test\txt_bench.c                           %compile_link% %out%txt_bench.exe || exit /b 1
+if "%hs_lookup_bench%"=="1"    %compile%             ..\src\hash_store\test\hs_lookup_bench.c                     %compile_link% %out%hs_lookup_bench.exe || exit /b 1
+if "%hs_stress_test%"=="1"     %compile%             ..\src\hash_store\test\hs_stress_test.c                      %compile_link% %out%hs_stress_test.exe || exit /b 1
+if "%raddbg_cons_bake_test%"=="1" %compile%             ..\src\raddbg_cons\test\raddbg_cons_bake_test.c              %compile_link% %out%raddbg_cons_bake_test.exe || exit /b 1
+if "%raddbg_cons_sort_bench%"=="1" %compile%             ..\src\raddbg_cons\test\raddbg_cons_sort_bench.c             %compile_link% %out%raddbg_cons_sort_bench.exe || exit /b 1
+if "%raddbg_cons_rss_bench%"=="1" %compile%             ..\src\raddbg_cons\test\raddbg_cons_rss_bench.c              %compile_link% %out%raddbg_cons_rss_bench.exe || exit /b 1
+if "%eval_machine_fuzz%"=="1"  %compile%             ..\src\eval\test\eval_machine_fuzz.c                         %compile_link% %out%eval_machine_fuzz.exe || exit /b 1
+if "%eval_machine_bench%"=="1" %compile%             ..\src\eval\test\eval_machine_bench.c                        %compile_link% %out%eval_machine_bench.exe || exit /b 1
 popd
 
 :: --- Unset ------------------------------------------------------------------
@@ -58,43 +58,43 @@ clz64(U64 mask)
 internal U64
 count_bits_set16(U16 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_popcount(val);
 }
 
 internal U64
 count_bits_set32(U32 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_popcount(val);
 }
 
 internal U64
 count_bits_set64(U64 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_popcountll(val);
 }
 
 internal U64
 ctz32(U32 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_ctz(val);
+}
+
+internal U64
+ctz64(U64 val)
+{
+  return __builtin_ctzll(val);
 }
 
 internal U64
 clz32(U32 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_clz(val);
 }
 
 internal U64
 clz64(U64 val)
 {
-  NotImplemented;
-  return 0;
+  return __builtin_clzll(val);
 }
 
 #else
@@ -227,3 +227,33 @@ cmd_line_has_argument(CmdLine *cmd_line, String8 name)
   CmdLineOpt *var = cmd_line_opt_from_string(cmd_line, name);
   return(var != 0 && var->value_strings.node_count > 0);
 }
+
+internal B32
+cmd_line_argcv_has_flag(int argc, char **argv, String8 name)
+{
+  // NOTE: matches "-name" & "--name" without building a CmdLine, for options
+  // which must be known before any arena exists (e.g. large pages).
+  B32 result = 0;
+  for(int idx = 1; idx < argc && !result; idx += 1)
+  {
+    String8 arg = str8_cstring(argv[idx]);
+    if(str8_match(arg, str8_lit("--"), 0))
+    {
+      break;
+    }
+    if(str8_match(str8_prefix(arg, 2), str8_lit("--"), 0))
+    {
+      arg = str8_skip(arg, 2);
+    }
+    else if(str8_match(str8_prefix(arg, 1), str8_lit("-"), 0))
+    {
+      arg = str8_skip(arg, 1);
+    }
+    else
+    {
+      continue;
+    }
+    result = str8_match(arg, name, 0);
+  }
+  return result;
+}
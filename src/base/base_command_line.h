@@ -49,5 +49,6 @@ internal String8List      cmd_line_strings(CmdLine *cmd_line, String8 name);
 internal String8          cmd_line_string(CmdLine *cmd_line, String8 name);
 internal B32              cmd_line_has_flag(CmdLine *cmd_line, String8 name);
 internal B32              cmd_line_has_argument(CmdLine *cmd_line, String8 name);
+internal B32              cmd_line_argcv_has_flag(int argc, char **argv, String8 name);
 
 #endif // BASE_COMMAND_LINE_H
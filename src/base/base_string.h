@@ -148,6 +148,23 @@ struct FuzzyMatchRangeList
   U64 total_dim;
 };
 
+typedef struct FuzzyMatchPrefilterPart FuzzyMatchPrefilterPart;
+struct FuzzyMatchPrefilterPart
+{
+  String8 string;
+  U8 first;
+  U8 last;
+  U8 first_fold;
+  U8 last_fold;
+};
+
+typedef struct FuzzyMatchPrefilter FuzzyMatchPrefilter;
+struct FuzzyMatchPrefilter
+{
+  FuzzyMatchPrefilterPart *v;
+  U64 count;
+};
+
 ////////////////////////////////
 //~ rjf: Character Classification & Conversion Functions
 
@@ -337,6 +354,9 @@ internal Vec4F32 rgba_from_hex_string_4f32(String8 hex_string);
 
 internal FuzzyMatchRangeList fuzzy_match_find(Arena *arena, String8 needle, String8 haystack);
 internal FuzzyMatchRangeList fuzzy_match_range_list_copy(Arena *arena, FuzzyMatchRangeList *src);
+internal FuzzyMatchPrefilter fuzzy_match_prefilter_from_needle(Arena *arena, String8 needle);
+internal B32 fuzzy_match_prefilter_part_in_string(FuzzyMatchPrefilterPart *part, String8 haystack);
+internal B32 fuzzy_match_prefilter_pass(FuzzyMatchPrefilter *prefilter, String8 haystack);
 
 ////////////////////////////////
 //~ NOTE(allen): Serialization Helpers
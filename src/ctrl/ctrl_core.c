@@ -28,6 +28,7 @@ ctrl_init(CTRL_WakeupFunctionType *wakeup_hook)
       eval_string2num_map_insert(ctrl_state->arena, &ctrl_state->arch_string2alias_tables[arch], alias_names[idx], idx);
     }
   }
+  ctrl_state->memgen_idx = 1;
   ctrl_state->process_memory_cache.slots_count = 256;
   ctrl_state->process_memory_cache.slots = push_array(arena, CTRL_ProcessMemoryCacheSlot, ctrl_state->process_memory_cache.slots_count);
   ctrl_state->process_memory_cache.stripes_count = 8;
@@ -37,6 +38,15 @@ ctrl_init(CTRL_WakeupFunctionType *wakeup_hook)
     ctrl_state->process_memory_cache.stripes[idx].rw_mutex = os_rw_mutex_alloc();
     ctrl_state->process_memory_cache.stripes[idx].cv = os_condition_variable_alloc();
   }
+  ctrl_state->module_index_rw_mutex = os_rw_mutex_alloc();
+  ctrl_state->module_index_slots_count = 256;
+  ctrl_state->module_index_slots = push_array(arena, CTRL_ModuleIndexSlot, ctrl_state->module_index_slots_count);
+  ctrl_state->unwind_cache_mutex = os_mutex_alloc();
+  ctrl_state->unwind_cache_slots_count = 256;
+  ctrl_state->unwind_cache_slots = push_array(arena, CTRL_UnwindCacheSlot, ctrl_state->unwind_cache_slots_count);
+  ctrl_state->user_bp_stats_mutex = os_mutex_alloc();
+  ctrl_state->user_bp_stats_slots_count = 256;
+  ctrl_state->user_bp_stats_slots = push_array(arena, CTRL_UserBreakpointStatsSlot, ctrl_state->user_bp_stats_slots_count);
   ctrl_state->u2c_ring_size = KB(64);
   ctrl_state->u2c_ring_base = push_array_no_zero(arena, U8, ctrl_state->u2c_ring_size);
   ctrl_state->u2c_ring_mutex = os_mutex_alloc();
@@ -47,6 +57,11 @@ ctrl_init(CTRL_WakeupFunctionType *wakeup_hook)
   ctrl_state->c2u_ring_cv = os_condition_variable_alloc();
   ctrl_state->demon_event_arena = arena_alloc();
   ctrl_state->user_entry_point_arena = arena_alloc();
+  ctrl_state->bp_condition_cache_arena = arena_alloc();
+  ctrl_state->bp_condition_cache_slots_count = 256;
+  ctrl_state->bp_condition_cache_slots = push_array(ctrl_state->bp_condition_cache_arena, CTRL_BpConditionCacheSlot, ctrl_state->bp_condition_cache_slots_count);
+  ctrl_state->scope_maps_cache_slots_count = 256;
+  ctrl_state->scope_maps_cache_slots = push_array(ctrl_state->bp_condition_cache_arena, CTRL_ScopeMapsCacheSlot, ctrl_state->scope_maps_cache_slots_count);
   for(CTRL_ExceptionCodeKind k = (CTRL_ExceptionCodeKind)0; k < CTRL_ExceptionCodeKind_COUNT; k = (CTRL_ExceptionCodeKind)(k+1))
   {
     if(ctrl_exception_code_kind_default_enable_table[k])
@@ -192,6 +207,22 @@ ctrl_user_breakpoint_list_copy(Arena *arena, CTRL_UserBreakpointList *src)
   return dst;
 }
 
+internal U64
+ctrl_hash_from_user_breakpoint(CTRL_UserBreakpoint *bp)
+{
+  Temp scratch = scratch_begin(0, 0);
+  String8List parts = {0};
+  str8_list_push(scratch.arena, &parts, str8_struct(&bp->kind));
+  str8_list_push(scratch.arena, &parts, bp->string);
+  str8_list_push(scratch.arena, &parts, str8_struct(&bp->pt));
+  str8_list_push(scratch.arena, &parts, str8_struct(&bp->u64));
+  str8_list_push(scratch.arena, &parts, bp->condition);
+  String8 joined = str8_list_join(scratch.arena, &parts, 0);
+  U64 hash = ctrl_hash_from_string(joined);
+  scratch_end(scratch);
+  return hash;
+}
+
 internal void
 ctrl_append_resolved_module_user_bp_traps(Arena *arena, DEMON_Handle process, DEMON_Handle module, CTRL_UserBreakpointList *user_bps, DEMON_TrapChunkList *traps_out)
 {
@@ -754,6 +785,13 @@ ctrl_process_read(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range,
   return actual_bytes_read;
 }
 
+internal U64
+ctrl_process_read_batch(CTRL_MachineID machine_id, CTRL_Handle process, DEMON_MemoryRead *reads, U64 reads_count)
+{
+  U64 total_bytes_read = demon_read_memory_batch(ctrl_demon_handle_from_ctrl(process), reads, reads_count);
+  return total_bytes_read;
+}
+
 internal B32
 ctrl_process_write(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, void *src)
 {
@@ -761,10 +799,15 @@ ctrl_process_write(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range
   U64 size = dim_1u64(range);
   B32 result = demon_write_memory(ctrl_demon_handle_from_ctrl(process), range.min, src, size);
   
-  //- rjf: success -> increment memgen
+  //- success -> bump memgen, so that anything derived from memory is
+  // recomputed, but carry all cached regions which the write did not touch
+  // forward to the new memgen, so that only affected regions are re-read
+  U64 old_memgen_idx = 0;
+  U64 new_memgen_idx = 0;
   if(result)
   {
-    ins_atomic_u64_inc_eval(&ctrl_state->memgen_idx);
+    new_memgen_idx = ins_atomic_u64_inc_eval(&ctrl_state->memgen_idx);
+    old_memgen_idx = new_memgen_idx-1;
   }
   
   //- rjf: success -> wait for cache updates, for small regions - prefer relatively seamless
@@ -775,7 +818,8 @@ ctrl_process_write(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range
     Temp scratch = scratch_begin(0, 0);
     U64 endt_us = os_now_microseconds()+5000;
     
-    //- rjf: gather tasks for all affected cached regions
+    //- invalidate & gather tasks for all affected cached regions, carry
+    // forward all others
     typedef struct Task Task;
     struct Task
     {
@@ -792,23 +836,37 @@ ctrl_process_write(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range
       U64 stripe_idx = slot_idx%cache->stripes_count;
       CTRL_ProcessMemoryCacheSlot *slot = &cache->slots[slot_idx];
       CTRL_ProcessMemoryCacheStripe *stripe = &cache->stripes[stripe_idx];
+      if(slot->first == 0)
+      {
+        continue;
+      }
       OS_MutexScopeW(stripe->rw_mutex)
       {
         for(CTRL_ProcessMemoryCacheNode *proc_n = slot->first; proc_n != 0; proc_n = proc_n->next)
         {
+          B32 is_written_process = (proc_n->machine_id == machine_id && ctrl_handle_match(proc_n->process, process));
           for(U64 range_hash_idx = 0; range_hash_idx < proc_n->range_hash_slots_count; range_hash_idx += 1)
           {
             CTRL_ProcessMemoryRangeHashSlot *range_slot = &proc_n->range_hash_slots[range_hash_idx];
             for(CTRL_ProcessMemoryRangeHashNode *n = range_slot->first; n != 0; n = n->next)
             {
               Rng1U64 intersection_w_range = intersect_1u64(range, n->vaddr_range);
-              if(dim_1u64(intersection_w_range) != 0 && dim_1u64(n->vaddr_range) <= KB(64))
+              if(is_written_process && dim_1u64(intersection_w_range) != 0)
+              {
+                n->memgen_idx = 0;
+                n->write_gen += 1;
+                if(dim_1u64(n->vaddr_range) <= KB(64))
+                {
+                  Task *task = push_array(scratch.arena, Task, 1);
+                  task->machine_id = proc_n->machine_id;
+                  task->process = proc_n->process;
+                  task->range = n->vaddr_range;
+                  SLLQueuePush(first_task, last_task, task);
+                }
+              }
+              else if(n->memgen_idx == old_memgen_idx)
               {
-                Task *task = push_array(scratch.arena, Task, 1);
-                task->machine_id = proc_n->machine_id;
-                task->process = proc_n->process;
-                task->range = n->vaddr_range;
-                SLLQueuePush(first_task, last_task, task);
+                n->memgen_idx = new_memgen_idx;
               }
             }
           }
@@ -883,6 +941,21 @@ ctrl_stored_hash_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle
                 result = range_n->hash;
                 is_good = 1;
                 is_stale = range_n->memgen_idx < ctrl_memgen_idx();
+                
+                // hash store evicted blobs since this hash was checked ->
+                // re-read if ours was among them
+                U64 evict_gen = hs_evict_gen();
+                if(!is_stale && range_n->hs_evict_gen != evict_gen)
+                {
+                  if(hs_hash_is_resident(range_n->hash))
+                  {
+                    ins_atomic_u64_eval_assign(&range_n->hs_evict_gen, evict_gen);
+                  }
+                  else
+                  {
+                    is_stale = 1;
+                  }
+                }
                 goto read_cache__break_all;
               }
             }
@@ -979,6 +1052,44 @@ ctrl_stored_hash_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle
   return result;
 }
 
+internal U128
+ctrl_fresh_stored_hash_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, B32 zero_terminated)
+{
+  U128 result = {0};
+  CTRL_ProcessMemoryCache *cache = &ctrl_state->process_memory_cache;
+  U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
+  U64 process_slot_idx = process_hash%cache->slots_count;
+  U64 process_stripe_idx = process_slot_idx%cache->stripes_count;
+  CTRL_ProcessMemoryCacheSlot *process_slot = &cache->slots[process_slot_idx];
+  CTRL_ProcessMemoryCacheStripe *process_stripe = &cache->stripes[process_stripe_idx];
+  U64 range_hash = ctrl_hash_from_string(str8_struct(&range));
+  U64 memgen_idx = ctrl_memgen_idx();
+  OS_MutexScopeR(process_stripe->rw_mutex)
+  {
+    for(CTRL_ProcessMemoryCacheNode *n = process_slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+      {
+        U64 range_slot_idx = range_hash%n->range_hash_slots_count;
+        CTRL_ProcessMemoryRangeHashSlot *range_slot = &n->range_hash_slots[range_slot_idx];
+        for(CTRL_ProcessMemoryRangeHashNode *range_n = range_slot->first; range_n != 0; range_n = range_n->next)
+        {
+          if(MemoryMatchStruct(&range_n->vaddr_range, &range) && range_n->zero_terminated == zero_terminated)
+          {
+            if(range_n->memgen_idx >= memgen_idx)
+            {
+              result = range_n->hash;
+            }
+            goto break_all;
+          }
+        }
+      }
+    }
+    break_all:;
+  }
+  return result;
+}
+
 //- rjf: process memory cache reading helpers
 
 internal CTRL_ProcessMemorySlice
@@ -1175,41 +1286,296 @@ ctrl_tls_root_vaddr_from_thread(CTRL_MachineID machine_id, CTRL_Handle thread)
 
 //- rjf: process * vaddr -> module
 
+internal U64
+ctrl_module_index_entry_idx_from_vaddr(CTRL_ModuleIndexEntry *entries, U64 entries_count, U64 vaddr)
+{
+  // NOTE: returns the index of the last entry whose range begins at or
+  // before `vaddr`, or `entries_count` if there is none
+  U64 result = entries_count;
+  if(entries_count != 0 && entries[0].vaddr_range.min <= vaddr)
+  {
+    U64 first = 0;
+    U64 opl = entries_count;
+    for(;opl-first > 1;)
+    {
+      U64 mid = first + (opl-first)/2;
+      if(entries[mid].vaddr_range.min <= vaddr)
+      {
+        first = mid;
+      }
+      else
+      {
+        opl = mid;
+      }
+    }
+    result = first;
+  }
+  return result;
+}
+
 internal CTRL_Handle
 ctrl_module_from_process_vaddr(CTRL_MachineID machine_id, CTRL_Handle process, U64 vaddr)
 {
   CTRL_Handle handle = {0};
+  ctrl_modules_from_process_vaddrs(machine_id, process, &vaddr, 1, &handle);
+  return handle;
+}
+
+internal void
+ctrl_modules_from_process_vaddrs(CTRL_MachineID machine_id, CTRL_Handle process, U64 *vaddrs, U64 count, CTRL_Handle *modules_out)
+{
+  MemoryZero(modules_out, sizeof(CTRL_Handle)*count);
+  
+  //- look up in the process' module index
+  B32 is_indexed = 0;
+  U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
+  CTRL_ModuleIndexSlot *slot = &ctrl_state->module_index_slots[process_hash%ctrl_state->module_index_slots_count];
+  OS_MutexScopeR(ctrl_state->module_index_rw_mutex)
+  {
+    for(CTRL_ModuleIndexNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+      {
+        is_indexed = 1;
+        for(U64 idx = 0; idx < count; idx += 1)
+        {
+          U64 entry_idx = ctrl_module_index_entry_idx_from_vaddr(n->entries, n->entries_count, vaddrs[idx]);
+          if(entry_idx < n->entries_count && contains_1u64(n->entries[entry_idx].vaddr_range, vaddrs[idx]))
+          {
+            modules_out[idx] = n->entries[entry_idx].module;
+          }
+        }
+        break;
+      }
+    }
+  }
+  
+  //- process not indexed (no module events seen yet) -> scan demon's modules
+  if(!is_indexed)
   {
     Temp scratch = scratch_begin(0, 0);
     DEMON_HandleArray modules = demon_modules_from_process(scratch.arena, ctrl_demon_handle_from_ctrl(process));
-    for(U64 idx = 0; idx < modules.count; idx += 1)
+    Rng1U64 *modules_vaddr_rngs = push_array_no_zero(scratch.arena, Rng1U64, modules.count);
+    for(U64 module_idx = 0; module_idx < modules.count; module_idx += 1)
+    {
+      modules_vaddr_rngs[module_idx] = demon_vaddr_range_from_module(modules.handles[module_idx]);
+    }
+    for(U64 idx = 0; idx < count; idx += 1)
     {
-      DEMON_Handle m = modules.handles[idx];
-      Rng1U64 m_vaddr_rng = demon_vaddr_range_from_module(m);
-      if(contains_1u64(m_vaddr_rng, vaddr))
+      for(U64 module_idx = 0; module_idx < modules.count; module_idx += 1)
       {
-        handle = ctrl_handle_from_demon(m);
-        break;
+        if(contains_1u64(modules_vaddr_rngs[module_idx], vaddrs[idx]))
+        {
+          modules_out[idx] = ctrl_handle_from_demon(modules.handles[module_idx]);
+          break;
+        }
       }
     }
     scratch_end(scratch);
   }
-  return handle;
 }
 
 //- rjf: unwinding
 
+internal CTRL_UnwindStackPage *
+ctrl_unwind_stack_page_from_vaddr(CTRL_UnwindStackReader *reader, U64 page_vaddr)
+{
+  U64 page_size = KB(4);
+  U64 slot_idx = (page_vaddr/page_size)%reader->page_slots_count;
+  CTRL_UnwindStackPage *page = 0;
+  for(CTRL_UnwindStackPage *p = reader->page_slots[slot_idx]; p != 0; p = p->hash_next)
+  {
+    if(p->vaddr == page_vaddr)
+    {
+      page = p;
+      break;
+    }
+  }
+  if(page == 0)
+  {
+    page = push_array(reader->arena, CTRL_UnwindStackPage, 1);
+    page->vaddr = page_vaddr;
+    page->hash_next = reader->page_slots[slot_idx];
+    reader->page_slots[slot_idx] = page;
+    SLLQueuePush_N(reader->first_page, reader->last_page, page, order_next);
+    Rng1U64 page_vaddr_range = r1u64(page_vaddr, page_vaddr+page_size);
+    
+    // try the process memory cache first - if it has an up-to-date copy
+    // of this page, we get both the data & its hash for free
+    U128 hash = ctrl_fresh_stored_hash_from_process_vaddr_range(reader->machine_id, reader->process, page_vaddr_range, 0);
+    if(!u128_match(hash, u128_zero()))
+    {
+      String8 data = hs_data_from_hash(reader->hs_scope, hash);
+      if(data.size == page_size)
+      {
+        page->hash = hash;
+        page->data = data;
+      }
+    }
+    
+    // not cached -> ask the cache to pick it up for next time, but read
+    // it directly now
+    if(page->data.size == 0)
+    {
+      ctrl_stored_hash_from_process_vaddr_range(reader->machine_id, reader->process, page_vaddr_range, 0, 0);
+      U8 *buffer = push_array_no_zero(reader->arena, U8, page_size);
+      U64 bytes_read = ctrl_process_read(reader->machine_id, reader->process, page_vaddr_range, buffer);
+      if(bytes_read != 0)
+      {
+        if(bytes_read < page_size)
+        {
+          MemoryZero(buffer+bytes_read, page_size-bytes_read);
+        }
+        page->data = str8(buffer, page_size);
+        page->hash = hs_hash_from_data(page->data);
+      }
+    }
+  }
+  return page;
+}
+
+internal UNW_MEMVIEW_READ_FUNCTION_DEF(ctrl_unwind_stack_read)
+{
+  CTRL_UnwindStackReader *reader = (CTRL_UnwindStackReader *)user_data;
+  U64 page_size = KB(4);
+  B32 result = (reader->stack_vaddr_range.min <= addr && addr <= addr+size && addr+size <= reader->stack_vaddr_range.max);
+  U64 write_off = 0;
+  for(U64 page_vaddr = AlignDownPow2(addr, page_size); result && page_vaddr < addr+size; page_vaddr += page_size)
+  {
+    CTRL_UnwindStackPage *page = ctrl_unwind_stack_page_from_vaddr(reader, page_vaddr);
+    if(page->data.size == 0)
+    {
+      result = 0;
+      break;
+    }
+    U64 read_min = Max(page_vaddr, addr);
+    U64 read_max = Min(page_vaddr+page_size, addr+size);
+    MemoryCopy((U8 *)out + write_off, page->data.str + (read_min-page_vaddr), read_max-read_min);
+    write_off += read_max-read_min;
+    reader->touched_page_min = Min(reader->touched_page_min, page_vaddr);
+  }
+  return result;
+}
+
+internal B32
+ctrl_unwind_stack_pages_match(CTRL_UnwindStackReader *reader, U64 pages_count, U64 *page_vaddrs, U128 *page_hashes, U64 page_min)
+{
+  B32 result = 1;
+  for(U64 idx = 0; idx < pages_count; idx += 1)
+  {
+    if(page_vaddrs[idx] >= page_min)
+    {
+      CTRL_UnwindStackPage *page = ctrl_unwind_stack_page_from_vaddr(reader, page_vaddrs[idx]);
+      if(page->data.size == 0 || !u128_match(page->hash, page_hashes[idx]))
+      {
+        result = 0;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+internal B32
+ctrl_unwind_regs_x64_match(REGS_RegBlockX64 *a, REGS_RegBlockX64 *b)
+{
+  // NOTE: an x64 unwind step is a function of rip, rsp, the nonvolatile
+  // registers (any of which may be a frame register), and stack memory - so
+  // two frames agreeing on all of these unwind identically from there on.
+  B32 result = (a->rip.u64 == b->rip.u64 &&
+                a->rsp.u64 == b->rsp.u64 &&
+                a->rbx.u64 == b->rbx.u64 &&
+                a->rbp.u64 == b->rbp.u64 &&
+                a->rsi.u64 == b->rsi.u64 &&
+                a->rdi.u64 == b->rdi.u64 &&
+                a->r12.u64 == b->r12.u64 &&
+                a->r13.u64 == b->r13.u64 &&
+                a->r14.u64 == b->r14.u64 &&
+                a->r15.u64 == b->r15.u64);
+  for(U64 idx = 0; result && idx < 10; idx += 1)
+  {
+    result = MemoryMatch((&a->ymm6)[idx].v, (&b->ymm6)[idx].v, 16);
+  }
+  return result;
+}
+
 internal CTRL_Unwind
 ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle thread)
 {
   ProfBeginFunction();
   Temp scratch = scratch_begin(&arena, 1);
   DBGI_Scope *scope = dbgi_scope_open();
+  HS_Scope *hs_scope = hs_scope_open();
   Architecture arch = demon_arch_from_object(ctrl_demon_handle_from_ctrl(thread));
   U64 arch_reg_block_size = regs_block_size_from_architecture(arch);
+  U64 reggen_idx = ctrl_reggen_idx();
+  U64 memgen_idx = ctrl_memgen_idx();
   CTRL_Unwind unwind = {0};
   unwind.error = 1;
-  switch(arch)
+  
+  //- look up this thread's last unwind - if nothing has changed since,
+  // it is the answer; otherwise, grab a copy for reuse of unchanged frames
+  B32 is_cache_hit = 0;
+  U64 prior_frames_count = 0;
+  CTRL_UnwindCacheFrame *prior_frames = 0;
+  U64 prior_pages_count = 0;
+  U64 *prior_page_vaddrs = 0;
+  U128 *prior_page_hashes = 0;
+  U64 thread_hash = ctrl_hash_from_string(str8_struct(&thread));
+  CTRL_UnwindCacheSlot *cache_slot = &ctrl_state->unwind_cache_slots[thread_hash%ctrl_state->unwind_cache_slots_count];
+  ProfScope("look up cached unwind") OS_MutexScope(ctrl_state->unwind_cache_mutex)
+  {
+    for(CTRL_UnwindCacheNode *n = cache_slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->thread, thread) && n->arch == arch)
+      {
+        is_cache_hit = (n->reggen_idx == reggen_idx && n->memgen_idx == memgen_idx);
+        if(is_cache_hit)
+        {
+          unwind.error = 0;
+          for(U64 idx = 0; idx < n->frames_count; idx += 1)
+          {
+            CTRL_UnwindFrame *frame = push_array(arena, CTRL_UnwindFrame, 1);
+            frame->rip = n->frames[idx].rip;
+            frame->regs = push_array_no_zero(arena, U8, arch_reg_block_size);
+            MemoryCopy(frame->regs, n->frames[idx].regs, arch_reg_block_size);
+            DLLPushBack(unwind.first, unwind.last, frame);
+            unwind.count += 1;
+          }
+        }
+        else
+        {
+          prior_frames_count = n->frames_count;
+          prior_frames = push_array_no_zero(scratch.arena, CTRL_UnwindCacheFrame, prior_frames_count);
+          for(U64 idx = 0; idx < prior_frames_count; idx += 1)
+          {
+            prior_frames[idx] = n->frames[idx];
+            prior_frames[idx].regs = push_array_no_zero(scratch.arena, U8, arch_reg_block_size);
+            MemoryCopy(prior_frames[idx].regs, n->frames[idx].regs, arch_reg_block_size);
+          }
+          prior_pages_count = n->pages_count;
+          prior_page_vaddrs = push_array_no_zero(scratch.arena, U64, prior_pages_count);
+          prior_page_hashes = push_array_no_zero(scratch.arena, U128, prior_pages_count);
+          MemoryCopy(prior_page_vaddrs, n->page_vaddrs, sizeof(U64)*prior_pages_count);
+          MemoryCopy(prior_page_hashes, n->page_hashes, sizeof(U128)*prior_pages_count);
+        }
+        break;
+      }
+    }
+  }
+  
+  //- not cached -> unwind
+  typedef struct FrameInfo FrameInfo;
+  struct FrameInfo
+  {
+    FrameInfo *next;
+    CTRL_UnwindFrame *frame;
+    U64 stack_page_min;
+  };
+  FrameInfo *first_frame_info = 0;
+  FrameInfo *last_frame_info = 0;
+  CTRL_UnwindStackReader reader = {0};
+  if(!is_cache_hit) switch(arch)
   {
     default:{}break;
     case Architecture_x64:
@@ -1226,40 +1592,44 @@ ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Ha
         }
       }
       
-      // rjf: grab initial memory view
+      // set up lazily-paged view of stack memory
       B32 stack_memview_good = 0;
-      UNW_MemView stack_memview = {0};
+      UNW_MemView memview = {0};
       if(regs_block_good)
       {
         U64 stack_base_unrounded = demon_stack_base_vaddr_from_thread(ctrl_demon_handle_from_ctrl(thread));
         U64 stack_top_unrounded = regs_rsp_from_arch_block(arch, regs_block);
         U64 stack_base = AlignPow2(stack_base_unrounded, KB(4));
         U64 stack_top = AlignDownPow2(stack_top_unrounded, KB(4));
-        U64 stack_size = stack_base - stack_top;
         if(stack_base >= stack_top)
         {
-          String8 stack_memory = {0};
-          stack_memory.str = push_array_no_zero(scratch.arena, U8, stack_size);
-          stack_memory.size = ctrl_process_read(machine_id, process, r1u64(stack_top, stack_top+stack_size), stack_memory.str);
-          if(stack_memory.size != 0)
+          reader.arena = scratch.arena;
+          reader.hs_scope = hs_scope;
+          reader.machine_id = machine_id;
+          reader.process = process;
+          reader.stack_vaddr_range = r1u64(stack_top, stack_base);
+          reader.page_slots_count = 1024;
+          reader.page_slots = push_array(scratch.arena, CTRL_UnwindStackPage *, reader.page_slots_count);
+          reader.touched_page_min = max_U64;
+          if(ctrl_unwind_stack_page_from_vaddr(&reader, stack_top)->data.size != 0)
           {
             stack_memview_good = 1;
-            stack_memview.data = stack_memory.str;
-            stack_memview.addr_first = stack_top;
-            stack_memview.addr_opl = stack_base;
+            memview = unw_memview_from_read_function(ctrl_unwind_stack_read, &reader);
           }
         }
       }
       
       // rjf: loop & unwind
-      UNW_MemView memview = stack_memview;
+      U64 prior_frame_idx = 0;
+      CTRL_Handle module = {0};
+      Rng1U64 module_vaddr_range = {0};
+      DBGI_Parse *dbgi = &dbgi_parse_nil;
       if(stack_memview_good) for(;;)
       {
         unwind.error = 0;
         
-        // rjf: regs -> rip*module*binary
+        // regs -> rip
         U64 rip = regs_rip_from_arch_block(arch, regs_block);
-        CTRL_Handle module = ctrl_module_from_process_vaddr(machine_id, process, rip);
         
         // rjf: cancel on 0 rip
         if(rip == 0)
@@ -1267,9 +1637,57 @@ ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Ha
           break;
         }
         
-        // rjf: binary -> all the binary info
-        String8 binary_full_path = demon_full_path_from_module(scratch.arena, ctrl_demon_handle_from_ctrl(module));
-        DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, binary_full_path, 0);
+        // this frame matches one from the last unwind, & none of the
+        // stack memory which the rest of that unwind read has changed -> the
+        // rest of the unwind is the same; reuse it & stop
+        if(prior_frames_count != 0)
+        {
+          U64 rsp = regs_rsp_from_arch_block(arch, regs_block);
+          for(;prior_frame_idx < prior_frames_count && regs_rsp_from_arch_block(arch, prior_frames[prior_frame_idx].regs) < rsp;)
+          {
+            prior_frame_idx += 1;
+          }
+          CTRL_UnwindCacheFrame *prior_frame = prior_frame_idx < prior_frames_count ? &prior_frames[prior_frame_idx] : 0;
+          if(prior_frame != 0 &&
+             ctrl_unwind_regs_x64_match((REGS_RegBlockX64 *)prior_frame->regs, (REGS_RegBlockX64 *)regs_block) &&
+             ctrl_unwind_stack_pages_match(&reader, prior_pages_count, prior_page_vaddrs, prior_page_hashes, prior_frame->stack_page_min))
+          {
+            ProfScope("reuse unchanged frames")
+            {
+              // NOTE: registers which the unwind did not touch carry
+              // through from this frame; everything else comes from the
+              // prior unwind.
+              U8 *prior_base_regs = (U8 *)prior_frame->regs;
+              for(U64 idx = prior_frame_idx; idx < prior_frames_count; idx += 1)
+              {
+                U8 *prior_regs = (U8 *)prior_frames[idx].regs;
+                CTRL_UnwindFrame *frame = push_array(arena, CTRL_UnwindFrame, 1);
+                frame->rip = prior_frames[idx].rip;
+                frame->regs = push_array_no_zero(arena, U8, arch_reg_block_size);
+                for(U64 byte_idx = 0; byte_idx < arch_reg_block_size; byte_idx += 1)
+                {
+                  ((U8 *)frame->regs)[byte_idx] = (prior_regs[byte_idx] != prior_base_regs[byte_idx] ? prior_regs[byte_idx] : ((U8 *)regs_block)[byte_idx]);
+                }
+                DLLPushBack(unwind.first, unwind.last, frame);
+                unwind.count += 1;
+                FrameInfo *info = push_array(scratch.arena, FrameInfo, 1);
+                info->frame = frame;
+                info->stack_page_min = prior_frames[idx].stack_page_min;
+                SLLQueuePush(first_frame_info, last_frame_info, info);
+              }
+            }
+            break;
+          }
+        }
+        
+        // rip -> module -> all the binary info
+        if(!contains_1u64(module_vaddr_range, rip))
+        {
+          module = ctrl_module_from_process_vaddr(machine_id, process, rip);
+          module_vaddr_range = demon_vaddr_range_from_module(ctrl_demon_handle_from_ctrl(module));
+          String8 binary_full_path = demon_full_path_from_module(scratch.arena, ctrl_demon_handle_from_ctrl(module));
+          dbgi = dbgi_parse_from_exe_path(scope, binary_full_path, 0);
+        }
         String8 binary_data = str8((U8 *)dbgi->exe_base, dbgi->exe_props.size);
         
         // rjf: cancel on bad data
@@ -1286,9 +1704,14 @@ ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Ha
         MemoryCopy(frame->regs, regs_block, arch_reg_block_size);
         DLLPushBack(unwind.first, unwind.last, frame);
         unwind.count += 1;
+        FrameInfo *info = push_array(scratch.arena, FrameInfo, 1);
+        info->frame = frame;
+        SLLQueuePush(first_frame_info, last_frame_info, info);
         
         // rjf: unwind one step
-        UNW_Result unwind_step = unw_pe_x64(binary_data, &dbgi->pe, demon_vaddr_range_from_module(ctrl_demon_handle_from_ctrl(module)).min, &memview, (UNW_X64_Regs *)regs_block);
+        reader.touched_page_min = max_U64;
+        UNW_Result unwind_step = unw_pe_x64(binary_data, &dbgi->pe, module_vaddr_range.min, &memview, (UNW_X64_Regs *)regs_block);
+        info->stack_page_min = reader.touched_page_min;
         
         // rjf: cancel on bad step
         if(unwind_step.dead != 0)
@@ -1307,6 +1730,92 @@ ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Ha
       }
     }break;
   }
+  
+  //- good fresh unwind -> store in cache
+  if(!is_cache_hit && unwind.error == 0 && unwind.count != 0) ProfScope("store unwind in cache")
+  {
+    Arena *node_arena = arena_alloc();
+    CTRL_UnwindCacheNode *node = push_array(node_arena, CTRL_UnwindCacheNode, 1);
+    node->arena = node_arena;
+    node->machine_id = machine_id;
+    node->thread = thread;
+    node->reggen_idx = reggen_idx;
+    node->memgen_idx = memgen_idx;
+    node->arch = arch;
+    
+    // frames, w/ the lowest stack page read by each frame's step & all
+    // steps after it
+    node->frames_count = unwind.count;
+    node->frames = push_array_no_zero(node_arena, CTRL_UnwindCacheFrame, node->frames_count);
+    {
+      U64 idx = 0;
+      for(FrameInfo *info = first_frame_info; info != 0; info = info->next, idx += 1)
+      {
+        node->frames[idx].rip = info->frame->rip;
+        node->frames[idx].regs = push_array_no_zero(node_arena, U8, arch_reg_block_size);
+        MemoryCopy(node->frames[idx].regs, info->frame->regs, arch_reg_block_size);
+        node->frames[idx].stack_page_min = info->stack_page_min;
+      }
+      for(U64 rev_idx = node->frames_count-1; rev_idx > 0; rev_idx -= 1)
+      {
+        node->frames[rev_idx-1].stack_page_min = Min(node->frames[rev_idx-1].stack_page_min, node->frames[rev_idx].stack_page_min);
+      }
+    }
+    
+    // all stack pages which were read, w/ their hashes
+    {
+      U64 pages_count = 0;
+      for(CTRL_UnwindStackPage *page = reader.first_page; page != 0; page = page->order_next)
+      {
+        pages_count += (page->data.size != 0);
+      }
+      node->page_vaddrs = push_array_no_zero(node_arena, U64, pages_count);
+      node->page_hashes = push_array_no_zero(node_arena, U128, pages_count);
+      for(CTRL_UnwindStackPage *page = reader.first_page; page != 0; page = page->order_next)
+      {
+        if(page->data.size != 0)
+        {
+          node->page_vaddrs[node->pages_count] = page->vaddr;
+          node->page_hashes[node->pages_count] = page->hash;
+          node->pages_count += 1;
+        }
+      }
+    }
+    
+    // replace this thread's node; drop everything if the cache has
+    // grown large (threads which have gone away are never looked up again)
+    OS_MutexScope(ctrl_state->unwind_cache_mutex)
+    {
+      for(CTRL_UnwindCacheNode *n = cache_slot->first, *next = 0; n != 0; n = next)
+      {
+        next = n->next;
+        if(n->machine_id == machine_id && ctrl_handle_match(n->thread, thread))
+        {
+          DLLRemove(cache_slot->first, cache_slot->last, n);
+          arena_release(n->arena);
+          ctrl_state->unwind_cache_node_count -= 1;
+        }
+      }
+      if(ctrl_state->unwind_cache_node_count >= 1024)
+      {
+        for(U64 slot_idx = 0; slot_idx < ctrl_state->unwind_cache_slots_count; slot_idx += 1)
+        {
+          CTRL_UnwindCacheSlot *slot = &ctrl_state->unwind_cache_slots[slot_idx];
+          for(CTRL_UnwindCacheNode *n = slot->first, *next = 0; n != 0; n = next)
+          {
+            next = n->next;
+            arena_release(n->arena);
+          }
+          slot->first = slot->last = 0;
+        }
+        ctrl_state->unwind_cache_node_count = 0;
+      }
+      DLLPushBack(cache_slot->first, cache_slot->last, node);
+      ctrl_state->unwind_cache_node_count += 1;
+    }
+  }
+  
+  hs_scope_close(hs_scope);
   dbgi_scope_close(scope);
   scratch_end(scratch);
   ProfEnd();
@@ -1327,6 +1836,29 @@ ctrl_string2alias_from_arch(Architecture arch)
   return &ctrl_state->arch_string2alias_tables[arch];
 }
 
+//- user breakpoint stats
+
+internal CTRL_UserBreakpointStats
+ctrl_user_breakpoint_stats_from_bp(CTRL_UserBreakpoint *bp)
+{
+  CTRL_UserBreakpointStats stats = {0};
+  U64 hash = ctrl_hash_from_user_breakpoint(bp);
+  U64 slot_idx = hash%ctrl_state->user_bp_stats_slots_count;
+  CTRL_UserBreakpointStatsSlot *slot = &ctrl_state->user_bp_stats_slots[slot_idx];
+  OS_MutexScope(ctrl_state->user_bp_stats_mutex)
+  {
+    for(CTRL_UserBreakpointStatsNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->hash == hash)
+      {
+        stats = n->v;
+        break;
+      }
+    }
+  }
+  return stats;
+}
+
 ////////////////////////////////
 //~ rjf: User -> Ctrl Communication
 
@@ -1505,6 +2037,29 @@ ctrl_u2ms_dequeue_req(CTRL_MachineID *out_machine_id, CTRL_Handle *out_process,
   os_condition_variable_broadcast(ctrl_state->u2ms_ring_cv);
 }
 
+internal B32
+ctrl_u2ms_try_dequeue_req(CTRL_MachineID *out_machine_id, CTRL_Handle *out_process, Rng1U64 *out_vaddr_range, B32 *out_zero_terminated)
+{
+  B32 good = 0;
+  OS_MutexScope(ctrl_state->u2ms_ring_mutex)
+  {
+    U64 unconsumed_size = ctrl_state->u2ms_ring_write_pos-ctrl_state->u2ms_ring_read_pos;
+    if(unconsumed_size >= sizeof(*out_machine_id)+sizeof(*out_process)+sizeof(*out_vaddr_range))
+    {
+      good = 1;
+      ctrl_state->u2ms_ring_read_pos += ring_read_struct(ctrl_state->u2ms_ring_base, ctrl_state->u2ms_ring_size, ctrl_state->u2ms_ring_read_pos, out_machine_id);
+      ctrl_state->u2ms_ring_read_pos += ring_read_struct(ctrl_state->u2ms_ring_base, ctrl_state->u2ms_ring_size, ctrl_state->u2ms_ring_read_pos, out_process);
+      ctrl_state->u2ms_ring_read_pos += ring_read_struct(ctrl_state->u2ms_ring_base, ctrl_state->u2ms_ring_size, ctrl_state->u2ms_ring_read_pos, out_vaddr_range);
+      ctrl_state->u2ms_ring_read_pos += ring_read_struct(ctrl_state->u2ms_ring_base, ctrl_state->u2ms_ring_size, ctrl_state->u2ms_ring_read_pos, out_zero_terminated);
+    }
+  }
+  if(good)
+  {
+    os_condition_variable_broadcast(ctrl_state->u2ms_ring_cv);
+  }
+  return good;
+}
+
 ////////////////////////////////
 //~ rjf: Control-Thread-Only Functions
 
@@ -1724,6 +2279,11 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
         demon_write_memory(ctrl_demon_handle_from_ctrl(spoof->process), spoof->vaddr, &spoof->new_ip_value, size_of_spoof);
       }
       
+      // begin tracking target writes, so that cached memory which is not
+      // touched by this run can survive it
+      U64 pre_run_memgen_idx = ctrl_memgen_idx();
+      ctrl_thread__process_memory_write_tracking_reset();
+      
       // rjf: run for new events
       ProfScope("run for new events")
       {
@@ -1751,6 +2311,9 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
         demon_write_memory(ctrl_demon_handle_from_ctrl(spoof->process), spoof->vaddr, &spoof_old_ip_value, size_of_spoof);
       }
       
+      // carry unwritten cached memory forward to the next memgen
+      ctrl_thread__process_memory_cache_revalidate(pre_run_memgen_idx, pre_run_memgen_idx+1);
+      
       // rjf: inc generation counters
       {
         ins_atomic_u64_inc_eval(&ctrl_state->run_idx);
@@ -1818,6 +2381,7 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
       out_evt->vaddr_rng  = r1u64(event->address, event->address+event->size);
       out_evt->rip_vaddr  = demon_base_vaddr_from_module(event->module);
       out_evt->string     = module_path;
+      ctrl_thread__module_index_insert(CTRL_MachineID_Client, out_evt->parent, out_evt->entity, demon_vaddr_range_from_module(event->module));
     }break;
     case DEMON_EventKind_ExitProcess:
     {
@@ -1828,6 +2392,7 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
       out_evt->entity     = ctrl_handle_from_demon(event->process);
       out_evt->u64_code   = event->code;
       ctrl_state->process_counter -= 1;
+      ctrl_thread__module_index_release(CTRL_MachineID_Client, out_evt->entity);
     }break;
     case DEMON_EventKind_ExitThread:
     {
@@ -1847,6 +2412,7 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
       out_evt->msg_id     = msg->msg_id;
       out_evt->machine_id = CTRL_MachineID_Client;
       out_evt->entity     = ctrl_handle_from_demon(event->module);
+      ctrl_thread__module_index_remove(CTRL_MachineID_Client, ctrl_handle_from_demon(event->process), out_evt->entity);
     }break;
     case DEMON_EventKind_DebugString:
     {
@@ -1905,6 +2471,124 @@ ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_c
   return(event);
 }
 
+//- process memory cache write tracking
+
+internal void
+ctrl_thread__process_memory_write_tracking_reset(void)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  DEMON_HandleArray processes = demon_all_processes(scratch.arena);
+  for(U64 idx = 0; idx < processes.count; idx += 1)
+  {
+    demon_memory_write_tracking_reset(processes.handles[idx]);
+  }
+  scratch_end(scratch);
+  ProfEnd();
+}
+
+internal void
+ctrl_thread__process_memory_cache_revalidate(U64 old_memgen_idx, U64 new_memgen_idx)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  CTRL_ProcessMemoryCache *cache = &ctrl_state->process_memory_cache;
+  typedef struct Task Task;
+  struct Task
+  {
+    Task *next;
+    CTRL_Handle process;
+    Rng1U64 vaddr_range;
+    Rng1U64 vaddr_range_clamped;
+    B32 zero_terminated;
+    U64 write_gen;
+    B32 is_clean;
+  };
+  for(U64 slot_idx = 0; slot_idx < cache->slots_count; slot_idx += 1)
+  {
+    U64 stripe_idx = slot_idx%cache->stripes_count;
+    CTRL_ProcessMemoryCacheSlot *slot = &cache->slots[slot_idx];
+    CTRL_ProcessMemoryCacheStripe *stripe = &cache->stripes[stripe_idx];
+    Temp temp = temp_begin(scratch.arena);
+    
+    //- gather all ranges which are up-to-date as of the pre-run memgen
+    Task *first_task = 0;
+    Task *last_task = 0;
+    OS_MutexScopeR(stripe->rw_mutex)
+    {
+      for(CTRL_ProcessMemoryCacheNode *proc_n = slot->first; proc_n != 0; proc_n = proc_n->next)
+      {
+        for(U64 range_hash_idx = 0; range_hash_idx < proc_n->range_hash_slots_count; range_hash_idx += 1)
+        {
+          CTRL_ProcessMemoryRangeHashSlot *range_slot = &proc_n->range_hash_slots[range_hash_idx];
+          for(CTRL_ProcessMemoryRangeHashNode *n = range_slot->first; n != 0; n = n->next)
+          {
+            if(n->memgen_idx == old_memgen_idx && dim_1u64(n->vaddr_range_clamped) <= MB(16))
+            {
+              Task *task = push_array(temp.arena, Task, 1);
+              task->process = proc_n->process;
+              task->vaddr_range = n->vaddr_range;
+              task->vaddr_range_clamped = n->vaddr_range_clamped;
+              task->zero_terminated = n->zero_terminated;
+              task->write_gen = n->write_gen;
+              SLLQueuePush(first_task, last_task, task);
+            }
+          }
+        }
+      }
+    }
+    
+    //- ask the demon whether each range was written by the target; any
+    // failure (no tracking support, unmapped pages, etc.) leaves it stale
+    B32 any_clean = 0;
+    for(Task *task = first_task; task != 0; task = task->next)
+    {
+      B32 was_written = 1;
+      if(demon_memory_range_was_written(ctrl_demon_handle_from_ctrl(task->process), task->vaddr_range_clamped, &was_written))
+      {
+        task->is_clean = !was_written;
+        any_clean = any_clean || task->is_clean;
+      }
+    }
+    
+    //- stamp clean ranges with the new memgen, unless they were touched
+    // since we gathered them
+    if(any_clean) OS_MutexScopeW(stripe->rw_mutex)
+    {
+      for(Task *task = first_task; task != 0; task = task->next)
+      {
+        if(!task->is_clean)
+        {
+          continue;
+        }
+        U64 range_hash = ctrl_hash_from_string(str8_struct(&task->vaddr_range));
+        for(CTRL_ProcessMemoryCacheNode *proc_n = slot->first; proc_n != 0; proc_n = proc_n->next)
+        {
+          if(!ctrl_handle_match(proc_n->process, task->process))
+          {
+            continue;
+          }
+          CTRL_ProcessMemoryRangeHashSlot *range_slot = &proc_n->range_hash_slots[range_hash%proc_n->range_hash_slots_count];
+          for(CTRL_ProcessMemoryRangeHashNode *n = range_slot->first; n != 0; n = n->next)
+          {
+            if(MemoryMatchStruct(&n->vaddr_range, &task->vaddr_range) &&
+               n->zero_terminated == task->zero_terminated &&
+               n->memgen_idx == old_memgen_idx &&
+               n->write_gen == task->write_gen)
+            {
+              n->memgen_idx = new_memgen_idx;
+            }
+          }
+        }
+      }
+    }
+    
+    temp_end(temp);
+  }
+  scratch_end(scratch);
+  ProfEnd();
+}
+
 //- rjf: eval helpers
 
 internal B32
@@ -1916,6 +2600,281 @@ ctrl_eval_memory_read(void *u, void *out, U64 addr, U64 size)
   return result;
 }
 
+//- module index maintenance
+
+internal void
+ctrl_thread__module_index_insert(CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle module, Rng1U64 vaddr_range)
+{
+  Temp scratch = scratch_begin(0, 0);
+  U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
+  CTRL_ModuleIndexSlot *slot = &ctrl_state->module_index_slots[process_hash%ctrl_state->module_index_slots_count];
+  OS_MutexScopeW(ctrl_state->module_index_rw_mutex)
+  {
+    // map process -> node, creating if needed
+    CTRL_ModuleIndexNode *node = 0;
+    for(CTRL_ModuleIndexNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+      {
+        node = n;
+        break;
+      }
+    }
+    if(node == 0)
+    {
+      node = ctrl_state->free_module_index_node;
+      if(node != 0)
+      {
+        SLLStackPop(ctrl_state->free_module_index_node);
+      }
+      else
+      {
+        node = push_array_no_zero(ctrl_state->arena, CTRL_ModuleIndexNode, 1);
+        node->arena = arena_alloc();
+      }
+      Arena *node_arena = node->arena;
+      MemoryZeroStruct(node);
+      node->arena = node_arena;
+      node->machine_id = machine_id;
+      node->process = process;
+      DLLPushBack(slot->first, slot->last, node);
+    }
+    
+    // rebuild sorted entries, w/ the new module inserted in place
+    U64 new_entries_count = node->entries_count+1;
+    CTRL_ModuleIndexEntry *new_entries = push_array_no_zero(scratch.arena, CTRL_ModuleIndexEntry, new_entries_count);
+    {
+      U64 insert_idx = ctrl_module_index_entry_idx_from_vaddr(node->entries, node->entries_count, vaddr_range.min);
+      insert_idx = (insert_idx == node->entries_count) ? 0 : insert_idx+1;
+      MemoryCopy(new_entries, node->entries, sizeof(CTRL_ModuleIndexEntry)*insert_idx);
+      new_entries[insert_idx].vaddr_range = vaddr_range;
+      new_entries[insert_idx].module = module;
+      MemoryCopy(new_entries+insert_idx+1, node->entries+insert_idx, sizeof(CTRL_ModuleIndexEntry)*(node->entries_count-insert_idx));
+    }
+    arena_clear(node->arena);
+    node->entries_count = new_entries_count;
+    node->entries = push_array_no_zero(node->arena, CTRL_ModuleIndexEntry, new_entries_count);
+    MemoryCopy(node->entries, new_entries, sizeof(CTRL_ModuleIndexEntry)*new_entries_count);
+  }
+  scratch_end(scratch);
+}
+
+internal void
+ctrl_thread__module_index_remove(CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle module)
+{
+  U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
+  CTRL_ModuleIndexSlot *slot = &ctrl_state->module_index_slots[process_hash%ctrl_state->module_index_slots_count];
+  OS_MutexScopeW(ctrl_state->module_index_rw_mutex)
+  {
+    for(CTRL_ModuleIndexNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+      {
+        U64 write_idx = 0;
+        for(U64 read_idx = 0; read_idx < n->entries_count; read_idx += 1)
+        {
+          if(!ctrl_handle_match(n->entries[read_idx].module, module))
+          {
+            n->entries[write_idx] = n->entries[read_idx];
+            write_idx += 1;
+          }
+        }
+        n->entries_count = write_idx;
+        break;
+      }
+    }
+  }
+}
+
+internal void
+ctrl_thread__module_index_release(CTRL_MachineID machine_id, CTRL_Handle process)
+{
+  U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
+  CTRL_ModuleIndexSlot *slot = &ctrl_state->module_index_slots[process_hash%ctrl_state->module_index_slots_count];
+  OS_MutexScopeW(ctrl_state->module_index_rw_mutex)
+  {
+    for(CTRL_ModuleIndexNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+      {
+        DLLRemove(slot->first, slot->last, n);
+        arena_clear(n->arena);
+        SLLStackPush(ctrl_state->free_module_index_node, n);
+        break;
+      }
+    }
+  }
+}
+
+//- breakpoint conditions
+
+internal CTRL_ScopeMapsCacheNode *
+ctrl_thread__scope_maps_from_dbgi_voff(DBGI_Parse *dbgi, U64 voff)
+{
+  RADDBG_Parsed *rdbg = &dbgi->rdbg;
+  EVAL_ScopeKey scope_key = eval_scope_key_from_raddbg_voff(rdbg, voff);
+  U64 hash = ctrl_hash_from_string(str8_struct(&scope_key)) ^ (U64)dbgi;
+  U64 slot_idx = hash%ctrl_state->scope_maps_cache_slots_count;
+  CTRL_ScopeMapsCacheSlot *slot = &ctrl_state->scope_maps_cache_slots[slot_idx];
+  
+  //- look up maps for the scope; every voff within one scope shares these
+  CTRL_ScopeMapsCacheNode *node = 0;
+  for(CTRL_ScopeMapsCacheNode *n = slot->first; n != 0; n = n->next)
+  {
+    if(n->dbgi == dbgi &&
+       n->dbgi_gen == dbgi->gen &&
+       n->rdbg_data == (void *)rdbg->raw_data &&
+       eval_scope_key_match(n->scope_key, scope_key))
+    {
+      node = n;
+      break;
+    }
+  }
+  
+  //- miss -> build & insert; lives with the bp condition cache
+  if(node == 0)
+  {
+    Arena *arena = ctrl_state->bp_condition_cache_arena;
+    node = push_array(arena, CTRL_ScopeMapsCacheNode, 1);
+    node->dbgi = dbgi;
+    node->dbgi_gen = dbgi->gen;
+    node->rdbg_data = (void *)rdbg->raw_data;
+    node->scope_key = scope_key;
+    node->locals_map = eval_push_locals_map_from_raddbg_scope_key(arena, rdbg, scope_key);
+    node->member_map = eval_push_member_map_from_raddbg_scope_key(arena, rdbg, scope_key);
+    SLLQueuePush(slot->first, slot->last, node);
+  }
+  return node;
+}
+
+internal EVAL_Program *
+ctrl_thread__program_from_bp_condition(DEMON_Handle module, DBGI_Parse *dbgi, Architecture arch, U64 ip_voff, String8 condition, B32 *compiled_out)
+{
+  RADDBG_Parsed *rdbg = &dbgi->rdbg;
+  U64 hash = ctrl_hash_from_string(condition) ^ (ip_voff*0x9E3779B97F4A7C15ull) ^ (U64)module;
+  U64 slot_idx = hash%ctrl_state->bp_condition_cache_slots_count;
+  CTRL_BpConditionCacheSlot *slot = &ctrl_state->bp_condition_cache_slots[slot_idx];
+  
+  //- look up cached compilation; (module, dbgi, gen, raw data) pins the
+  // exact debug info the bytecode was generated against
+  CTRL_BpConditionCacheNode *node = 0;
+  for(CTRL_BpConditionCacheNode *n = slot->first; n != 0; n = n->next)
+  {
+    if(n->module == module &&
+       n->dbgi == dbgi &&
+       n->dbgi_gen == dbgi->gen &&
+       n->rdbg_data == (void *)rdbg->raw_data &&
+       n->ip_voff == ip_voff &&
+       str8_match(n->condition, condition, 0))
+    {
+      node = n;
+      break;
+    }
+  }
+  
+  //- miss -> compile & insert
+  *compiled_out = 0;
+  if(node == 0)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    
+    // too many cached compilations -> start over
+    if(ctrl_state->bp_condition_cache_node_count >= 4096)
+    {
+      arena_clear(ctrl_state->bp_condition_cache_arena);
+      ctrl_state->bp_condition_cache_slots = push_array(ctrl_state->bp_condition_cache_arena, CTRL_BpConditionCacheSlot, ctrl_state->bp_condition_cache_slots_count);
+      ctrl_state->bp_condition_cache_node_count = 0;
+      ctrl_state->scope_maps_cache_slots = push_array(ctrl_state->bp_condition_cache_arena, CTRL_ScopeMapsCacheSlot, ctrl_state->scope_maps_cache_slots_count);
+      slot = &ctrl_state->bp_condition_cache_slots[slot_idx];
+    }
+    
+    // condition text -> bytecode -> decoded program
+    EVAL_ParseCtx parse_ctx = zero_struct;
+    {
+      parse_ctx.arch = arch;
+      parse_ctx.ip_voff = ip_voff;
+      parse_ctx.rdbg = rdbg;
+      parse_ctx.type_graph = dbgi->type_graph;
+      if(parse_ctx.type_graph == 0 || parse_ctx.type_graph->address_size != bit_size_from_arch(arch)/8)
+      {
+        parse_ctx.type_graph = tg_graph_begin(bit_size_from_arch(arch)/8, 256);
+      }
+      parse_ctx.regs_map = ctrl_string2reg_from_arch(arch);
+      parse_ctx.reg_alias_map = ctrl_string2alias_from_arch(arch);
+      CTRL_ScopeMapsCacheNode *scope_maps = ctrl_thread__scope_maps_from_dbgi_voff(dbgi, ip_voff);
+      parse_ctx.locals_map = scope_maps->locals_map;
+      parse_ctx.member_map = scope_maps->member_map;
+    }
+    EVAL_TokenArray tokens = eval_token_array_from_text(scratch.arena, condition);
+    EVAL_ParseResult parse = eval_parse_expr_from_text_tokens(scratch.arena, &parse_ctx, condition, &tokens);
+    EVAL_ErrorList errors = parse.errors;
+    B32 parse_has_expr = (parse.expr != &eval_expr_nil);
+    B32 parse_is_type = (parse_has_expr && parse.expr->kind == EVAL_ExprKind_TypeIdent);
+    EVAL_IRTreeAndType ir_tree_and_type = {&eval_irtree_nil};
+    if(parse_has_expr && errors.count == 0)
+    {
+      ir_tree_and_type = eval_irtree_and_type_from_expr(scratch.arena, parse_ctx.type_graph, rdbg, &eval_string2expr_map_nil, parse.expr, &errors);
+    }
+    EVAL_OpList op_list = {0};
+    if(parse_has_expr && ir_tree_and_type.tree != &eval_irtree_nil)
+    {
+      eval_oplist_from_irtree(scratch.arena, ir_tree_and_type.tree, &op_list);
+    }
+    String8 bytecode = {0};
+    if(parse_has_expr && parse_is_type == 0 && op_list.encoded_size != 0)
+    {
+      bytecode = eval_bytecode_from_oplist(scratch.arena, &op_list);
+    }
+    
+    // insert; failed compilations are cached too, as empty programs
+    node = push_array(ctrl_state->bp_condition_cache_arena, CTRL_BpConditionCacheNode, 1);
+    SLLQueuePush(slot->first, slot->last, node);
+    node->condition = push_str8_copy(ctrl_state->bp_condition_cache_arena, condition);
+    node->module = module;
+    node->dbgi = dbgi;
+    node->dbgi_gen = dbgi->gen;
+    node->rdbg_data = (void *)rdbg->raw_data;
+    node->ip_voff = ip_voff;
+    node->program = eval_program_from_bytecode(ctrl_state->bp_condition_cache_arena, bytecode);
+    ctrl_state->bp_condition_cache_node_count += 1;
+    *compiled_out = 1;
+    scratch_end(scratch);
+  }
+  
+  return &node->program;
+}
+
+internal void
+ctrl_thread__record_user_bp_stats(CTRL_UserBreakpoint *bp, CTRL_UserBreakpointStats *delta)
+{
+  U64 hash = ctrl_hash_from_user_breakpoint(bp);
+  U64 slot_idx = hash%ctrl_state->user_bp_stats_slots_count;
+  CTRL_UserBreakpointStatsSlot *slot = &ctrl_state->user_bp_stats_slots[slot_idx];
+  OS_MutexScope(ctrl_state->user_bp_stats_mutex)
+  {
+    CTRL_UserBreakpointStatsNode *node = 0;
+    for(CTRL_UserBreakpointStatsNode *n = slot->first; n != 0; n = n->next)
+    {
+      if(n->hash == hash)
+      {
+        node = n;
+        break;
+      }
+    }
+    if(node == 0)
+    {
+      node = push_array(ctrl_state->arena, CTRL_UserBreakpointStatsNode, 1);
+      SLLQueuePush(slot->first, slot->last, node);
+      node->hash = hash;
+    }
+    node->v.hit_count                += delta->hit_count;
+    node->v.condition_eval_count     += delta->condition_eval_count;
+    node->v.condition_compile_count  += delta->condition_compile_count;
+    node->v.condition_filtered_count += delta->condition_filtered_count;
+    node->v.condition_eval_us        += delta->condition_eval_us;
+  }
+}
+
 //- rjf: msg kind implementations
 
 internal void
@@ -2838,7 +3797,7 @@ ctrl_thread__run(CTRL_Msg *msg)
         if(event->kind == DEMON_EventKind_Breakpoint)
         {
           Temp temp = temp_begin(scratch.arena);
-          String8List conditions = {0};
+          CTRL_UserBreakpointList conditional_bps = {0};
           
           // rjf: user breakpoints
           for(DEMON_TrapChunkNode *n = user_traps.first; n != 0; n = n->next)
@@ -2855,54 +3814,32 @@ ctrl_thread__run(CTRL_Msg *msg)
                 hit_user_bp = 1;
                 if(user_bp != 0 && user_bp->condition.size != 0)
                 {
-                  str8_list_push(temp.arena, &conditions, user_bp->condition);
+                  ctrl_user_breakpoint_list_push(temp.arena, &conditional_bps, user_bp);
+                }
+                else if(user_bp != 0)
+                {
+                  CTRL_UserBreakpointStats delta = {0};
+                  delta.hit_count = 1;
+                  ctrl_thread__record_user_bp_stats(user_bp, &delta);
                 }
               }
             }
           }
           
           // rjf: evaluate hit stop conditions
-          if(conditions.node_count != 0)
+          if(conditional_bps.count != 0)
           {
             String8 exe_path = demon_full_path_from_module(temp.arena, module);
             DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, exe_path, max_U64);
-            RADDBG_Parsed *rdbg = &dbgi->rdbg;
-            for(String8Node *condition_n = conditions.first; condition_n != 0; condition_n = condition_n->next)
+            for(CTRL_UserBreakpointNode *bp_n = conditional_bps.first; bp_n != 0; bp_n = bp_n->next)
             {
-              String8 string = condition_n->string;
-              EVAL_ParseCtx parse_ctx = zero_struct;
-              {
-                parse_ctx.arch = arch;
-                parse_ctx.ip_voff = thread_rip_voff;
-                parse_ctx.rdbg = rdbg;
-                parse_ctx.type_graph = tg_graph_begin(bit_size_from_arch(arch)/8, 256);
-                parse_ctx.regs_map = ctrl_string2reg_from_arch(arch);
-                parse_ctx.reg_alias_map = ctrl_string2alias_from_arch(arch);
-                parse_ctx.locals_map = eval_push_locals_map_from_raddbg_voff(temp.arena, rdbg, thread_rip_voff);
-                parse_ctx.member_map = eval_push_member_map_from_raddbg_voff(temp.arena, rdbg, thread_rip_voff);
-              }
-              EVAL_TokenArray tokens = eval_token_array_from_text(temp.arena, string);
-              EVAL_ParseResult parse = eval_parse_expr_from_text_tokens(temp.arena, &parse_ctx, string, &tokens);
-              EVAL_ErrorList errors = parse.errors;
-              B32 parse_has_expr = (parse.expr != &eval_expr_nil);
-              B32 parse_is_type = (parse_has_expr && parse.expr->kind == EVAL_ExprKind_TypeIdent);
-              EVAL_IRTreeAndType ir_tree_and_type = {&eval_irtree_nil};
-              if(parse_has_expr && errors.count == 0)
-              {
-                ir_tree_and_type = eval_irtree_and_type_from_expr(temp.arena, parse_ctx.type_graph, rdbg, &eval_string2expr_map_nil, parse.expr, &errors);
-              }
-              EVAL_OpList op_list = {0};
-              if(parse_has_expr && ir_tree_and_type.tree != &eval_irtree_nil)
-              {
-                eval_oplist_from_irtree(scratch.arena, ir_tree_and_type.tree, &op_list);
-              }
-              String8 bytecode = {0};
-              if(parse_has_expr && parse_is_type == 0 && op_list.encoded_size != 0)
-              {
-                bytecode = eval_bytecode_from_oplist(scratch.arena, &op_list);
-              }
+              CTRL_UserBreakpoint *user_bp = &bp_n->v;
+              CTRL_UserBreakpointStats delta = {0};
+              U64 eval_start_us = os_now_microseconds();
+              B32 compiled = 0;
+              EVAL_Program *program = ctrl_thread__program_from_bp_condition(module, dbgi, arch, thread_rip_voff, user_bp->condition, &compiled);
               EVAL_Result eval = {0};
-              if(bytecode.size != 0)
+              if(program->count != 0)
               {
                 U64 module_base = demon_base_vaddr_from_module(module);
                 U64 tls_base = 0; // TODO(rjf)
@@ -2914,9 +3851,16 @@ ctrl_thread__run(CTRL_Msg *msg)
                 machine.reg_size = reg_size;
                 machine.module_base = &module_base;
                 machine.tls_base = &tls_base;
-                eval = eval_interpret(&machine, bytecode);
+                eval = eval_interpret_program(&machine, program);
               }
-              if(eval.bad_eval == 0 && eval.value.u64 == 0)
+              B32 filtered = (eval.bad_eval == 0 && eval.value.u64 == 0);
+              delta.hit_count = 1;
+              delta.condition_eval_count = 1;
+              delta.condition_compile_count = !!compiled;
+              delta.condition_filtered_count = !!filtered;
+              delta.condition_eval_us = os_now_microseconds() - eval_start_us;
+              ctrl_thread__record_user_bp_stats(user_bp, &delta);
+              if(filtered)
               {
                 hit_user_bp = 0;
                 hit_conditional_bp_but_filtered = 1;
@@ -3272,135 +4216,224 @@ ctrl_mem_stream_thread__entry_point(void *p)
   TCTX tctx_ = {0};
   tctx_init_and_equip(&tctx_);
   CTRL_ProcessMemoryCache *cache = &ctrl_state->process_memory_cache;
+  typedef struct Task Task;
+  struct Task
+  {
+    CTRL_MachineID machine_id;
+    CTRL_Handle process;
+    Rng1U64 vaddr_range;
+    B32 zero_terminated;
+    U128 key;
+    CTRL_ProcessMemoryCacheSlot *process_slot;
+    CTRL_ProcessMemoryCacheStripe *process_stripe;
+    U64 range_hash;
+    B32 got_task;
+    U64 preexisting_memgen_idx;
+    U64 preexisting_write_gen;
+    Rng1U64 vaddr_range_clamped;
+    U64 memgen_idx;
+    Arena *range_arena;
+    void *range_base;
+    U64 range_size;
+    U64 bytes_read;
+    B32 is_batched;
+    U128 hash;
+    U64 hs_evict_gen;
+  };
   for(;;)
   {
-    //- rjf: unpack next request
-    CTRL_MachineID machine_id = 0;
-    CTRL_Handle process = {0};
-    Rng1U64 vaddr_range = {0};
-    B32 zero_terminated = 0;
-    ctrl_u2ms_dequeue_req(&machine_id, &process, &vaddr_range, &zero_terminated);
-    U128 key = ctrl_hash_store_key_from_process_vaddr_range(machine_id, process, vaddr_range, zero_terminated);
-    
-    //- rjf: unpack process memory cache key
-    U64 process_hash = ctrl_hash_from_string(str8_struct(&process));
-    U64 process_slot_idx = process_hash%cache->slots_count;
-    U64 process_stripe_idx = process_slot_idx%cache->stripes_count;
-    CTRL_ProcessMemoryCacheSlot *process_slot = &cache->slots[process_slot_idx];
-    CTRL_ProcessMemoryCacheStripe *process_stripe = &cache->stripes[process_stripe_idx];
+    Temp scratch = scratch_begin(0, 0);
     
-    //- rjf: unpack address range hash cache key
-    U64 range_hash = ctrl_hash_from_string(str8_struct(&vaddr_range));
+    //- unpack next requests - block for the first, then coalesce any
+    // others which are already queued, so that their reads can be batched
+    U64 tasks_cap = 256;
+    U64 tasks_count = 0;
+    Task *tasks = push_array(scratch.arena, Task, tasks_cap);
+    {
+      Task *t = &tasks[tasks_count];
+      ctrl_u2ms_dequeue_req(&t->machine_id, &t->process, &t->vaddr_range, &t->zero_terminated);
+      tasks_count += 1;
+    }
+    for(;tasks_count < tasks_cap;)
+    {
+      Task *t = &tasks[tasks_count];
+      if(!ctrl_u2ms_try_dequeue_req(&t->machine_id, &t->process, &t->vaddr_range, &t->zero_terminated))
+      {
+        break;
+      }
+      tasks_count += 1;
+    }
     
-    //- rjf: take task
-    B32 got_task = 0;
-    U64 preexisting_memgen_idx = 0;
-    U128 preexisting_hash = {0};
-    Rng1U64 vaddr_range_clamped = {0};
-    OS_MutexScopeW(process_stripe->rw_mutex)
+    //- unpack cache keys & take tasks
+    for(U64 task_idx = 0; task_idx < tasks_count; task_idx += 1)
     {
-      for(CTRL_ProcessMemoryCacheNode *n = process_slot->first; n != 0; n = n->next)
+      Task *t = &tasks[task_idx];
+      t->key = ctrl_hash_store_key_from_process_vaddr_range(t->machine_id, t->process, t->vaddr_range, t->zero_terminated);
+      U64 process_hash = ctrl_hash_from_string(str8_struct(&t->process));
+      U64 process_slot_idx = process_hash%cache->slots_count;
+      U64 process_stripe_idx = process_slot_idx%cache->stripes_count;
+      t->process_slot = &cache->slots[process_slot_idx];
+      t->process_stripe = &cache->stripes[process_stripe_idx];
+      t->range_hash = ctrl_hash_from_string(str8_struct(&t->vaddr_range));
+      OS_MutexScopeW(t->process_stripe->rw_mutex)
       {
-        if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+        for(CTRL_ProcessMemoryCacheNode *n = t->process_slot->first; n != 0; n = n->next)
         {
-          U64 range_slot_idx = range_hash%n->range_hash_slots_count;
-          CTRL_ProcessMemoryRangeHashSlot *range_slot = &n->range_hash_slots[range_slot_idx];
-          for(CTRL_ProcessMemoryRangeHashNode *range_n = range_slot->first; range_n != 0; range_n = range_n->next)
+          if(n->machine_id == t->machine_id && ctrl_handle_match(n->process, t->process))
           {
-            if(MemoryMatchStruct(&range_n->vaddr_range, &vaddr_range) && range_n->zero_terminated == zero_terminated)
+            U64 range_slot_idx = t->range_hash%n->range_hash_slots_count;
+            CTRL_ProcessMemoryRangeHashSlot *range_slot = &n->range_hash_slots[range_slot_idx];
+            for(CTRL_ProcessMemoryRangeHashNode *range_n = range_slot->first; range_n != 0; range_n = range_n->next)
             {
-              got_task = !ins_atomic_u32_eval_cond_assign(&range_n->is_taken, 1, 0);
-              preexisting_memgen_idx = range_n->memgen_idx;
-              preexisting_hash = range_n->hash;
-              vaddr_range_clamped = range_n->vaddr_range_clamped;
-              goto take_task__break_all;
+              if(MemoryMatchStruct(&range_n->vaddr_range, &t->vaddr_range) && range_n->zero_terminated == t->zero_terminated)
+              {
+                t->got_task = !ins_atomic_u32_eval_cond_assign(&range_n->is_taken, 1, 0);
+                t->preexisting_memgen_idx = range_n->memgen_idx;
+                t->preexisting_write_gen = range_n->write_gen;
+                t->vaddr_range_clamped = range_n->vaddr_range_clamped;
+                goto take_task__break_all;
+              }
             }
           }
         }
+        take_task__break_all:;
       }
-      take_task__break_all:;
     }
     
-    //- rjf: task was taken -> read memory
-    U64 range_size = 0;
-    Arena *range_arena = 0;
-    void *range_base = 0;
-    U64 zero_terminated_size = 0;
-    U64 memgen_idx = ctrl_memgen_idx();
-    if(got_task && memgen_idx != preexisting_memgen_idx)
+    //- tasks were taken -> allocate destination memory for stale ranges
+    for(U64 task_idx = 0; task_idx < tasks_count; task_idx += 1)
     {
-      range_size = dim_1u64(vaddr_range_clamped);
-      U64 arena_size = AlignPow2(range_size + ARENA_HEADER_SIZE, KB(64));
-      range_arena = arena_alloc__sized(range_size+ARENA_HEADER_SIZE, range_size+ARENA_HEADER_SIZE);
-      if(range_arena == 0)
-      {
-        range_size = 0;
-      }
-      else
+      Task *t = &tasks[task_idx];
+      t->memgen_idx = ctrl_memgen_idx();
+      if(t->got_task && t->preexisting_memgen_idx < t->memgen_idx)
       {
-        range_base = push_array_no_zero(range_arena, U8, range_size);
-        U64 bytes_read = ctrl_process_read(machine_id, process, vaddr_range_clamped, range_base);
-        if(bytes_read == 0)
+        t->range_size = dim_1u64(t->vaddr_range_clamped);
+        t->range_arena = arena_alloc__sized(t->range_size+ARENA_HEADER_SIZE, t->range_size+ARENA_HEADER_SIZE);
+        if(t->range_arena == 0)
         {
-          arena_release(range_arena);
-          range_base = 0;
-          range_size = 0;
-          range_arena = 0;
+          t->range_size = 0;
         }
-        else if(bytes_read < range_size)
+        else
         {
-          MemoryZero((U8 *)range_base + bytes_read, range_size-bytes_read);
+          t->range_base = push_array_no_zero(t->range_arena, U8, t->range_size);
         }
-        zero_terminated_size = range_size;
-        if(zero_terminated)
+      }
+    }
+    
+    //- read memory, in one batch per process
+    for(U64 task_idx = 0; task_idx < tasks_count; task_idx += 1)
+    {
+      Task *first = &tasks[task_idx];
+      if(first->range_base == 0 || first->is_batched)
+      {
+        continue;
+      }
+      Temp temp = temp_begin(scratch.arena);
+      U64 batch_count = 0;
+      U64 *batch_task_idxs = push_array_no_zero(temp.arena, U64, tasks_count-task_idx);
+      DEMON_MemoryRead *batch_reads = push_array(temp.arena, DEMON_MemoryRead, tasks_count-task_idx);
+      for(U64 other_idx = task_idx; other_idx < tasks_count; other_idx += 1)
+      {
+        Task *t = &tasks[other_idx];
+        if(t->range_base != 0 && !t->is_batched &&
+           t->machine_id == first->machine_id && ctrl_handle_match(t->process, first->process))
         {
-          for(U64 idx = 0; idx < bytes_read; idx += 1)
-          {
-            if(((U8 *)range_base)[idx] == 0)
-            {
-              zero_terminated_size = idx;
-              break;
-            }
-          }
+          t->is_batched = 1;
+          batch_task_idxs[batch_count] = other_idx;
+          batch_reads[batch_count].dst = t->range_base;
+          batch_reads[batch_count].src_address = t->vaddr_range_clamped.min;
+          batch_reads[batch_count].size = t->range_size;
+          batch_count += 1;
         }
       }
+      ctrl_process_read_batch(first->machine_id, first->process, batch_reads, batch_count);
+      for(U64 batch_idx = 0; batch_idx < batch_count; batch_idx += 1)
+      {
+        tasks[batch_task_idxs[batch_idx]].bytes_read = batch_reads[batch_idx].bytes_read;
+      }
+      temp_end(temp);
     }
     
     //- rjf: read successful -> submit to hash store
-    U128 hash = {0};
-    if(got_task && range_base != 0)
+    for(U64 task_idx = 0; task_idx < tasks_count; task_idx += 1)
     {
-      hash = hs_submit_data(key, &range_arena, str8((U8*)range_base, zero_terminated_size));
+      Task *t = &tasks[task_idx];
+      if(t->range_base == 0)
+      {
+        continue;
+      }
+      if(t->bytes_read == 0)
+      {
+        arena_release(t->range_arena);
+        t->range_arena = 0;
+        t->range_base = 0;
+        t->range_size = 0;
+        continue;
+      }
+      if(t->bytes_read < t->range_size)
+      {
+        MemoryZero((U8 *)t->range_base + t->bytes_read, t->range_size-t->bytes_read);
+      }
+      U64 zero_terminated_size = t->range_size;
+      if(t->zero_terminated)
+      {
+        for(U64 idx = 0; idx < t->bytes_read; idx += 1)
+        {
+          if(((U8 *)t->range_base)[idx] == 0)
+          {
+            zero_terminated_size = idx;
+            break;
+          }
+        }
+      }
+      t->hs_evict_gen = hs_evict_gen();
+      t->hash = hs_submit_data(t->key, &t->range_arena, str8((U8*)t->range_base, zero_terminated_size));
     }
     
-    //- rjf: commit hash to cache
-    if(got_task) OS_MutexScopeW(process_stripe->rw_mutex)
+    //- commit hashes to cache
+    for(U64 task_idx = 0; task_idx < tasks_count; task_idx += 1)
     {
-      for(CTRL_ProcessMemoryCacheNode *n = process_slot->first; n != 0; n = n->next)
+      Task *t = &tasks[task_idx];
+      if(!t->got_task)
       {
-        if(n->machine_id == machine_id && ctrl_handle_match(n->process, process))
+        continue;
+      }
+      OS_MutexScopeW(t->process_stripe->rw_mutex)
+      {
+        for(CTRL_ProcessMemoryCacheNode *n = t->process_slot->first; n != 0; n = n->next)
         {
-          U64 range_slot_idx = range_hash%n->range_hash_slots_count;
-          CTRL_ProcessMemoryRangeHashSlot *range_slot = &n->range_hash_slots[range_slot_idx];
-          for(CTRL_ProcessMemoryRangeHashNode *range_n = range_slot->first; range_n != 0; range_n = range_n->next)
+          if(n->machine_id == t->machine_id && ctrl_handle_match(n->process, t->process))
           {
-            if(MemoryMatchStruct(&range_n->vaddr_range, &vaddr_range) && range_n->zero_terminated == zero_terminated)
+            U64 range_slot_idx = t->range_hash%n->range_hash_slots_count;
+            CTRL_ProcessMemoryRangeHashSlot *range_slot = &n->range_hash_slots[range_slot_idx];
+            for(CTRL_ProcessMemoryRangeHashNode *range_n = range_slot->first; range_n != 0; range_n = range_n->next)
             {
-              if(!u128_match(u128_zero(), hash))
+              if(MemoryMatchStruct(&range_n->vaddr_range, &t->vaddr_range) && range_n->zero_terminated == t->zero_terminated)
               {
-                range_n->hash = hash;
-                range_n->memgen_idx = memgen_idx;
+                // only stamp the new memgen if no write to this range
+                // raced with our read; otherwise leave it stale & re-read
+                if(!u128_match(u128_zero(), t->hash))
+                {
+                  range_n->hash = t->hash;
+                  range_n->hs_evict_gen = t->hs_evict_gen;
+                  if(range_n->write_gen == t->preexisting_write_gen)
+                  {
+                    range_n->memgen_idx = t->memgen_idx;
+                  }
+                }
+                ins_atomic_u32_eval_assign(&range_n->is_taken, 0);
+                goto commit__break_all;
               }
-              ins_atomic_u32_eval_assign(&range_n->is_taken, 0);
-              goto commit__break_all;
             }
           }
         }
+        commit__break_all:;
       }
-      commit__break_all:;
+      
+      //- rjf: broadcast changes
+      os_condition_variable_broadcast(t->process_stripe->cv);
     }
     
-    //- rjf: broadcast changes
-    os_condition_variable_broadcast(process_stripe->cv);
+    scratch_end(scratch);
   }
 }
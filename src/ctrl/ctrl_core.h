@@ -67,6 +67,64 @@ struct CTRL_Unwind
   B32 error;
 };
 
+typedef struct CTRL_UnwindCacheFrame CTRL_UnwindCacheFrame;
+struct CTRL_UnwindCacheFrame
+{
+  U64 rip;
+  void *regs;
+  U64 stack_page_min;
+};
+
+typedef struct CTRL_UnwindCacheNode CTRL_UnwindCacheNode;
+struct CTRL_UnwindCacheNode
+{
+  CTRL_UnwindCacheNode *next;
+  CTRL_UnwindCacheNode *prev;
+  Arena *arena;
+  CTRL_MachineID machine_id;
+  CTRL_Handle thread;
+  U64 reggen_idx;
+  U64 memgen_idx;
+  Architecture arch;
+  U64 frames_count;
+  CTRL_UnwindCacheFrame *frames;
+  U64 pages_count;
+  U64 *page_vaddrs;
+  U128 *page_hashes;
+};
+
+typedef struct CTRL_UnwindCacheSlot CTRL_UnwindCacheSlot;
+struct CTRL_UnwindCacheSlot
+{
+  CTRL_UnwindCacheNode *first;
+  CTRL_UnwindCacheNode *last;
+};
+
+typedef struct CTRL_UnwindStackPage CTRL_UnwindStackPage;
+struct CTRL_UnwindStackPage
+{
+  CTRL_UnwindStackPage *hash_next;
+  CTRL_UnwindStackPage *order_next;
+  U64 vaddr;
+  U128 hash;
+  String8 data;
+};
+
+typedef struct CTRL_UnwindStackReader CTRL_UnwindStackReader;
+struct CTRL_UnwindStackReader
+{
+  Arena *arena;
+  HS_Scope *hs_scope;
+  CTRL_MachineID machine_id;
+  CTRL_Handle process;
+  Rng1U64 stack_vaddr_range;
+  U64 page_slots_count;
+  CTRL_UnwindStackPage **page_slots;
+  CTRL_UnwindStackPage *first_page;
+  CTRL_UnwindStackPage *last_page;
+  U64 touched_page_min;
+};
+
 ////////////////////////////////
 //~ rjf: Trap Types
 
@@ -148,6 +206,16 @@ struct CTRL_UserBreakpointList
   U64 count;
 };
 
+typedef struct CTRL_UserBreakpointStats CTRL_UserBreakpointStats;
+struct CTRL_UserBreakpointStats
+{
+  U64 hit_count;
+  U64 condition_eval_count;
+  U64 condition_compile_count;
+  U64 condition_filtered_count;
+  U64 condition_eval_us;
+};
+
 ////////////////////////////////
 //~ rjf: Generated Code
 
@@ -309,6 +377,35 @@ struct CTRL_EventList
   U64 count;
 };
 
+////////////////////////////////
+//~ Module Index Types
+
+typedef struct CTRL_ModuleIndexEntry CTRL_ModuleIndexEntry;
+struct CTRL_ModuleIndexEntry
+{
+  Rng1U64 vaddr_range;
+  CTRL_Handle module;
+};
+
+typedef struct CTRL_ModuleIndexNode CTRL_ModuleIndexNode;
+struct CTRL_ModuleIndexNode
+{
+  CTRL_ModuleIndexNode *next;
+  CTRL_ModuleIndexNode *prev;
+  Arena *arena;
+  CTRL_MachineID machine_id;
+  CTRL_Handle process;
+  U64 entries_count;
+  CTRL_ModuleIndexEntry *entries; // sorted by vaddr_range.min
+};
+
+typedef struct CTRL_ModuleIndexSlot CTRL_ModuleIndexSlot;
+struct CTRL_ModuleIndexSlot
+{
+  CTRL_ModuleIndexNode *first;
+  CTRL_ModuleIndexNode *last;
+};
+
 ////////////////////////////////
 //~ rjf: Process Memory Cache Types
 
@@ -321,6 +418,8 @@ struct CTRL_ProcessMemoryRangeHashNode
   Rng1U64 vaddr_range_clamped;
   U128 hash;
   U64 memgen_idx;
+  U64 write_gen;
+  U64 hs_evict_gen;
   B32 is_taken;
 };
 
@@ -374,6 +473,66 @@ struct CTRL_ProcessMemorySlice
   U64 *byte_changed_flags;
 };
 
+////////////////////////////////
+//~ Breakpoint Condition Cache Types
+
+typedef struct CTRL_BpConditionCacheNode CTRL_BpConditionCacheNode;
+struct CTRL_BpConditionCacheNode
+{
+  CTRL_BpConditionCacheNode *next;
+  String8 condition;
+  DEMON_Handle module;
+  DBGI_Parse *dbgi;
+  U64 dbgi_gen;
+  void *rdbg_data;
+  U64 ip_voff;
+  EVAL_Program program;
+};
+
+typedef struct CTRL_BpConditionCacheSlot CTRL_BpConditionCacheSlot;
+struct CTRL_BpConditionCacheSlot
+{
+  CTRL_BpConditionCacheNode *first;
+  CTRL_BpConditionCacheNode *last;
+};
+
+typedef struct CTRL_ScopeMapsCacheNode CTRL_ScopeMapsCacheNode;
+struct CTRL_ScopeMapsCacheNode
+{
+  CTRL_ScopeMapsCacheNode *next;
+  DBGI_Parse *dbgi;
+  U64 dbgi_gen;
+  void *rdbg_data;
+  EVAL_ScopeKey scope_key;
+  EVAL_String2NumMap *locals_map;
+  EVAL_String2NumMap *member_map;
+};
+
+typedef struct CTRL_ScopeMapsCacheSlot CTRL_ScopeMapsCacheSlot;
+struct CTRL_ScopeMapsCacheSlot
+{
+  CTRL_ScopeMapsCacheNode *first;
+  CTRL_ScopeMapsCacheNode *last;
+};
+
+////////////////////////////////
+//~ User Breakpoint Stats Cache Types
+
+typedef struct CTRL_UserBreakpointStatsNode CTRL_UserBreakpointStatsNode;
+struct CTRL_UserBreakpointStatsNode
+{
+  CTRL_UserBreakpointStatsNode *next;
+  U64 hash;
+  CTRL_UserBreakpointStats v;
+};
+
+typedef struct CTRL_UserBreakpointStatsSlot CTRL_UserBreakpointStatsSlot;
+struct CTRL_UserBreakpointStatsSlot
+{
+  CTRL_UserBreakpointStatsNode *first;
+  CTRL_UserBreakpointStatsNode *last;
+};
+
 ////////////////////////////////
 //~ rjf: Wakeup Hook Function Types
 
@@ -399,6 +558,23 @@ struct CTRL_State
   // rjf: process memory cache
   CTRL_ProcessMemoryCache process_memory_cache;
   
+  // user breakpoint stats (written by ctrl thread, read by user)
+  OS_Handle user_bp_stats_mutex;
+  U64 user_bp_stats_slots_count;
+  CTRL_UserBreakpointStatsSlot *user_bp_stats_slots;
+  
+  // per-process module index
+  OS_Handle module_index_rw_mutex;
+  U64 module_index_slots_count;
+  CTRL_ModuleIndexSlot *module_index_slots;
+  CTRL_ModuleIndexNode *free_module_index_node;
+  
+  // per-thread unwind cache
+  OS_Handle unwind_cache_mutex;
+  U64 unwind_cache_slots_count;
+  CTRL_UnwindCacheSlot *unwind_cache_slots;
+  U64 unwind_cache_node_count;
+  
   // rjf: user -> ctrl msg ring buffer
   U64 u2c_ring_size;
   U8 *u2c_ring_base;
@@ -425,6 +601,12 @@ struct CTRL_State
   String8List user_entry_points;
   U64 exception_code_filters[(CTRL_ExceptionCodeKind_COUNT+63)/64];
   U64 process_counter;
+  Arena *bp_condition_cache_arena;
+  U64 bp_condition_cache_slots_count;
+  CTRL_BpConditionCacheSlot *bp_condition_cache_slots;
+  U64 bp_condition_cache_node_count;
+  U64 scope_maps_cache_slots_count;
+  CTRL_ScopeMapsCacheSlot *scope_maps_cache_slots;
   
   // rjf: user -> memstream ring buffer
   U64 u2ms_ring_size;
@@ -479,6 +661,7 @@ internal CTRL_TrapList ctrl_trap_list_copy(Arena *arena, CTRL_TrapList *src);
 
 internal void ctrl_user_breakpoint_list_push(Arena *arena, CTRL_UserBreakpointList *list, CTRL_UserBreakpoint *bp);
 internal CTRL_UserBreakpointList ctrl_user_breakpoint_list_copy(Arena *arena, CTRL_UserBreakpointList *src);
+internal U64 ctrl_hash_from_user_breakpoint(CTRL_UserBreakpoint *bp);
 internal void ctrl_append_resolved_module_user_bp_traps(Arena *arena, DEMON_Handle process, DEMON_Handle module, CTRL_UserBreakpointList *user_bps, DEMON_TrapChunkList *traps_out);
 internal void ctrl_append_resolved_process_user_bp_traps(Arena *arena, DEMON_Handle process, CTRL_UserBreakpointList *user_bps, DEMON_TrapChunkList *traps_out);
 
@@ -528,11 +711,13 @@ internal Architecture ctrl_arch_from_handle(CTRL_MachineID machine, CTRL_Handle
 
 //- rjf: process memory reading/writing
 internal U64 ctrl_process_read(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, void *dst);
+internal U64 ctrl_process_read_batch(CTRL_MachineID machine_id, CTRL_Handle process, DEMON_MemoryRead *reads, U64 reads_count);
 internal B32 ctrl_process_write(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, void *src);
 
 //- rjf: process memory cache interaction
 internal U128 ctrl_hash_store_key_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, B32 zero_terminated);
 internal U128 ctrl_stored_hash_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, B32 zero_terminated, U64 endt_us);
+internal U128 ctrl_fresh_stored_hash_from_process_vaddr_range(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, B32 zero_terminated);
 
 //- rjf: process memory cache reading helpers
 internal CTRL_ProcessMemorySlice ctrl_query_cached_data_from_process_vaddr_range(Arena *arena, CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 range, U64 endt_us);
@@ -546,15 +731,24 @@ internal B32 ctrl_thread_write_rip(CTRL_MachineID machine_id, CTRL_Handle thread
 internal U64 ctrl_tls_root_vaddr_from_thread(CTRL_MachineID machine_id, CTRL_Handle thread);
 
 //- rjf: process * vaddr -> module
+internal U64 ctrl_module_index_entry_idx_from_vaddr(CTRL_ModuleIndexEntry *entries, U64 entries_count, U64 vaddr);
 internal CTRL_Handle ctrl_module_from_process_vaddr(CTRL_MachineID machine_id, CTRL_Handle process, U64 vaddr);
+internal void ctrl_modules_from_process_vaddrs(CTRL_MachineID machine_id, CTRL_Handle process, U64 *vaddrs, U64 count, CTRL_Handle *modules_out);
 
 //- rjf: unwinding
+internal CTRL_UnwindStackPage *ctrl_unwind_stack_page_from_vaddr(CTRL_UnwindStackReader *reader, U64 page_vaddr);
+internal UNW_MEMVIEW_READ_FUNCTION_DEF(ctrl_unwind_stack_read);
+internal B32 ctrl_unwind_stack_pages_match(CTRL_UnwindStackReader *reader, U64 pages_count, U64 *page_vaddrs, U128 *page_hashes, U64 page_min);
+internal B32 ctrl_unwind_regs_x64_match(REGS_RegBlockX64 *a, REGS_RegBlockX64 *b);
 internal CTRL_Unwind ctrl_unwind_from_process_thread(Arena *arena, CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle thread);
 
 //- rjf: name -> register/alias hash tables, for eval
 internal EVAL_String2NumMap *ctrl_string2reg_from_arch(Architecture arch);
 internal EVAL_String2NumMap *ctrl_string2alias_from_arch(Architecture arch);
 
+//- user breakpoint stats
+internal CTRL_UserBreakpointStats ctrl_user_breakpoint_stats_from_bp(CTRL_UserBreakpoint *bp);
+
 ////////////////////////////////
 //~ rjf: User -> Ctrl Communication
 
@@ -572,6 +766,7 @@ internal CTRL_EventList ctrl_c2u_pop_events(Arena *arena);
 
 internal B32 ctrl_u2ms_enqueue_req(CTRL_MachineID machine_id, CTRL_Handle process, Rng1U64 vaddr_range, B32 zero_terminated, U64 endt_us);
 internal void ctrl_u2ms_dequeue_req(CTRL_MachineID *out_machine_id, CTRL_Handle *out_process, Rng1U64 *out_vaddr_range, B32 *out_zero_terminated);
+internal B32 ctrl_u2ms_try_dequeue_req(CTRL_MachineID *out_machine_id, CTRL_Handle *out_process, Rng1U64 *out_vaddr_range, B32 *out_zero_terminated);
 
 ////////////////////////////////
 //~ rjf: Control-Thread-Only Functions
@@ -582,9 +777,23 @@ internal void ctrl_thread__entry_point(void *p);
 //- rjf: attached process running/event gathering
 internal DEMON_Event *ctrl_thread__next_demon_event(Arena *arena, CTRL_Msg *msg, DEMON_RunCtrls *run_ctrls, CTRL_Spoof *spoof);
 
+//- process memory cache write tracking
+internal void ctrl_thread__process_memory_write_tracking_reset(void);
+internal void ctrl_thread__process_memory_cache_revalidate(U64 old_memgen_idx, U64 new_memgen_idx);
+
 //- rjf: eval helpers
 internal B32 ctrl_eval_memory_read(void *u, void *out, U64 addr, U64 size);
 
+//- module index maintenance
+internal void ctrl_thread__module_index_insert(CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle module, Rng1U64 vaddr_range);
+internal void ctrl_thread__module_index_remove(CTRL_MachineID machine_id, CTRL_Handle process, CTRL_Handle module);
+internal void ctrl_thread__module_index_release(CTRL_MachineID machine_id, CTRL_Handle process);
+
+//- breakpoint conditions
+internal CTRL_ScopeMapsCacheNode *ctrl_thread__scope_maps_from_dbgi_voff(DBGI_Parse *dbgi, U64 voff);
+internal EVAL_Program *ctrl_thread__program_from_bp_condition(DEMON_Handle module, DBGI_Parse *dbgi, Architecture arch, U64 ip_voff, String8 condition, B32 *compiled_out);
+internal void ctrl_thread__record_user_bp_stats(CTRL_UserBreakpoint *bp, CTRL_UserBreakpointStats *delta);
+
 //- rjf: msg kind implementations
 internal void ctrl_thread__launch_and_handshake(CTRL_Msg *msg);
 internal void ctrl_thread__launch_and_init(CTRL_Msg *msg);
@@ -54,6 +54,9 @@ dbgi_init(void)
   {
     dbgi_shared->parse_threads[idx] = os_launch_thread(dbgi_parse_thread_entry_point, (void *)idx, 0);
   }
+  dbgi_shared->fuzzy_job_mutex = os_mutex_alloc();
+  dbgi_shared->fuzzy_job_cv = os_condition_variable_alloc();
+  dbgi_shared->fuzzy_worker_count = Clamp(1, os_logical_core_count()-1, 16);
   dbgi_shared->fuzzy_thread_count = Clamp(1, os_logical_core_count()-1, 1);
   dbgi_shared->fuzzy_threads = push_array(arena, DBGI_FuzzySearchThread, dbgi_shared->fuzzy_thread_count);
   for(U64 idx = 0; idx < dbgi_shared->fuzzy_thread_count; idx += 1)
@@ -63,8 +66,19 @@ dbgi_init(void)
     thread->u2f_ring_cv = os_condition_variable_alloc();
     thread->u2f_ring_size = KB(64);
     thread->u2f_ring_base = push_array_no_zero(dbgi_shared->arena, U8, thread->u2f_ring_size);
+    thread->job_arenas_count = dbgi_shared->fuzzy_worker_count+1;
+    thread->job_arenas = push_array(dbgi_shared->arena, Arena *, thread->job_arenas_count);
+    for(U64 arena_idx = 0; arena_idx < thread->job_arenas_count; arena_idx += 1)
+    {
+      thread->job_arenas[arena_idx] = arena_alloc();
+    }
     thread->thread = os_launch_thread(dbgi_fuzzy_thread__entry_point, (void *)idx, 0);
   }
+  dbgi_shared->fuzzy_workers = push_array(arena, OS_Handle, dbgi_shared->fuzzy_worker_count);
+  for(U64 idx = 0; idx < dbgi_shared->fuzzy_worker_count; idx += 1)
+  {
+    dbgi_shared->fuzzy_workers[idx] = os_launch_thread(dbgi_fuzzy_worker_thread__entry_point, (void *)idx, 0);
+  }
 }
 
 ////////////////////////////////
@@ -367,6 +381,8 @@ dbgi_binary_close(String8 exe_path)
       if(binary->refcount == 0 && ins_atomic_u64_eval(&binary->scope_touch_count) == 0)
       {
         if(binary->parse.arena != 0) { arena_release(binary->parse.arena); }
+        if(binary->parse.type_graph != 0) { tg_graph_release(binary->parse.type_graph); }
+        if(binary->parse.line_index != 0) { dbgi_line_index_release(binary->parse.line_index); }
         if(binary->parse.exe_base != 0) { os_file_map_view_close(binary->exe_file_map, binary->parse.exe_base); }
         if(!os_handle_match(os_handle_zero(), binary->exe_file_map)) { os_file_map_close(binary->exe_file_map); }
         if(!os_handle_match(os_handle_zero(), binary->exe_file)) { os_file_close(binary->exe_file); }
@@ -437,6 +453,217 @@ dbgi_parse_from_exe_path(DBGI_Scope *scope, String8 exe_path, U64 endt_us)
   return parse;
 }
 
+////////////////////////////////
+//~ Line Index Functions
+
+internal void
+dbgi_line_index__push_entry(U64 *voffs, DBGI_LineIndexEntry *entries, U64 *count, U64 voff, DBGI_LineIndexEntry *entry)
+{
+  U64 idx = *count;
+  
+  // out-of-order starts are clamped; anything starting at the same voff
+  // as the previous entry replaces it, so starts stay strictly increasing
+  if(idx != 0 && voff <= voffs[idx-1])
+  {
+    voff = voffs[idx-1];
+    idx -= 1;
+  }
+  
+  // adjacent gaps merge
+  if(entry->unit_idx == 0 && idx != 0 && entries[idx-1].unit_idx == 0)
+  {
+    *count = idx;
+    return;
+  }
+  
+  voffs[idx] = voff;
+  entries[idx] = *entry;
+  *count = idx+1;
+}
+
+internal DBGI_LineIndex *
+dbgi_line_index_alloc(RADDBG_Parsed *rdbg)
+{
+  ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  Arena *arena = arena_alloc();
+  DBGI_LineIndex *index = push_array(arena, DBGI_LineIndex, 1);
+  index->arena = arena;
+  
+  //- count upper bound of entries; each unit vmap range holds the lines
+  // starting inside of it, plus at most one clipped line & one gap
+  U64 total_line_count = 0;
+  for(U64 unit_idx = 0; unit_idx < rdbg->units_count; unit_idx += 1)
+  {
+    RADDBG_ParsedLineInfo line_info = {0};
+    raddbg_line_info_from_unit(rdbg, &rdbg->units[unit_idx], &line_info);
+    total_line_count += line_info.count;
+  }
+  U64 cap = total_line_count + 2*rdbg->unit_vmap_count + 1;
+  
+  //- walk unit vmap ranges in order, clip each unit's lines to its
+  // ranges, & fill holes with gaps; the result is sorted without sorting
+  U64 *voffs = push_array_no_zero(scratch.arena, U64, cap+1);
+  DBGI_LineIndexEntry *entries = push_array_no_zero(scratch.arena, DBGI_LineIndexEntry, cap);
+  U64 count = 0;
+  DBGI_LineIndexEntry gap = {0};
+  for(U64 vmap_idx = 0; vmap_idx+1 < rdbg->unit_vmap_count; vmap_idx += 1)
+  {
+    Rng1U64 range = r1u64(rdbg->unit_vmap[vmap_idx].voff, rdbg->unit_vmap[vmap_idx+1].voff);
+    U64 unit_idx = rdbg->unit_vmap[vmap_idx].idx;
+    RADDBG_ParsedLineInfo line_info = {0};
+    if(0 < unit_idx && unit_idx < rdbg->units_count)
+    {
+      raddbg_line_info_from_unit(rdbg, &rdbg->units[unit_idx], &line_info);
+    }
+    
+    // find first line ending past the start of the range
+    U64 line_idx = 0;
+    {
+      U64 opl = line_info.count;
+      for(;line_idx < opl;)
+      {
+        U64 mid = (line_idx+opl)/2;
+        if(line_info.voffs[mid+1] <= range.min)
+        {
+          line_idx = mid+1;
+        }
+        else
+        {
+          opl = mid;
+        }
+      }
+    }
+    
+    // push lines overlapping the range
+    U64 voff = range.min;
+    for(;line_idx < line_info.count && line_info.voffs[line_idx] < range.max; line_idx += 1)
+    {
+      U64 line_voff_min = Max(line_info.voffs[line_idx], range.min);
+      U64 line_voff_max = Min(line_info.voffs[line_idx+1], range.max);
+      if(line_voff_min >= line_voff_max)
+      {
+        continue;
+      }
+      if(voff < line_voff_min)
+      {
+        dbgi_line_index__push_entry(voffs, entries, &count, voff, &gap);
+      }
+      RADDBG_Line *line = &line_info.lines[line_idx];
+      DBGI_LineIndexEntry entry = {(U32)unit_idx, line->file_idx, line->line_num};
+      if(line_idx < line_info.col_count)
+      {
+        entry.col_first = line_info.cols[line_idx].col_first;
+      }
+      dbgi_line_index__push_entry(voffs, entries, &count, line_voff_min, &entry);
+      voff = line_voff_max;
+    }
+    if(voff < range.max)
+    {
+      dbgi_line_index__push_entry(voffs, entries, &count, voff, &gap);
+    }
+  }
+  if(count != 0)
+  {
+    voffs[count] = rdbg->unit_vmap[rdbg->unit_vmap_count-1].voff;
+  }
+  
+  //- copy into index
+  index->count = count;
+  index->voffs = push_array_no_zero(arena, U64, count+1);
+  MemoryCopy(index->voffs, voffs, sizeof(U64)*(count+1));
+  index->entries = push_array_no_zero(arena, DBGI_LineIndexEntry, count);
+  MemoryCopy(index->entries, entries, sizeof(DBGI_LineIndexEntry)*count);
+  
+  //- build eytzinger-ordered search voffs; node k at level l of a
+  // perfect tree of depth d holds sorted element ((2*(k-2^l)+1) << (d-1-l)) - 1
+  index->search_depth = (count != 0) ? 64 - clz64(count) : 0;
+  U64 search_voffs_count = 1ull<<index->search_depth;
+  index->search_voffs = push_array_no_zero(arena, U64, search_voffs_count);
+  index->search_voffs[0] = 0;
+  for(U64 k = 1; k < search_voffs_count; k += 1)
+  {
+    U64 level = 63 - clz64(k);
+    U64 sorted_idx = ((2*(k - (1ull<<level)) + 1) << (index->search_depth-1-level)) - 1;
+    index->search_voffs[k] = (sorted_idx < count) ? voffs[sorted_idx] : max_U64;
+  }
+  
+  scratch_end(scratch);
+  ProfEnd();
+  return index;
+}
+
+internal void
+dbgi_line_index_release(DBGI_LineIndex *index)
+{
+  arena_release(index->arena);
+}
+
+internal DBGI_LineIndex *
+dbgi_line_index_from_parse(DBGI_Parse *parse)
+{
+  DBGI_LineIndex *index = *(DBGI_LineIndex *volatile *)&parse->line_index;
+  return index;
+}
+
+internal U64
+dbgi_line_index__idx_from_voff_rank(DBGI_LineIndex *index, U64 voff, U64 rank)
+{
+  U64 result = index->count;
+  if(0 < rank && rank <= index->count && voff < index->voffs[index->count] && index->entries[rank-1].unit_idx != 0)
+  {
+    result = rank-1;
+  }
+  return result;
+}
+
+internal U64
+dbgi_line_index_idx_from_voff(DBGI_LineIndex *index, U64 voff)
+{
+  // after search_depth steps, the leaf reached counts the entry starts <= voff
+  U64 k = 1;
+  for(U64 step_idx = 0; step_idx < index->search_depth; step_idx += 1)
+  {
+    k = 2*k + (index->search_voffs[k] <= voff);
+  }
+  U64 rank = k - (1ull<<index->search_depth);
+  U64 result = dbgi_line_index__idx_from_voff_rank(index, voff, rank);
+  return result;
+}
+
+internal void
+dbgi_line_index_idxs_from_voffs(DBGI_LineIndex *index, U64 *voffs, U64 count, U64 *idxs_out)
+{
+  // search a group of voffs in lockstep; every search takes the same
+  // number of branch-free steps, so the group's loads are independent & can
+  // all be in flight at once
+  U64 *search_voffs = index->search_voffs;
+  U64 search_depth = index->search_depth;
+  for(U64 base_idx = 0; base_idx < count; base_idx += 8)
+  {
+    U64 group_count = Min(8, count-base_idx);
+    U64 group_voffs[8];
+    U64 k[8];
+    for(U64 lane_idx = 0; lane_idx < 8; lane_idx += 1)
+    {
+      group_voffs[lane_idx] = voffs[base_idx + ((lane_idx < group_count) ? lane_idx : 0)];
+      k[lane_idx] = 1;
+    }
+    for(U64 step_idx = 0; step_idx < search_depth; step_idx += 1)
+    {
+      for(U64 lane_idx = 0; lane_idx < 8; lane_idx += 1)
+      {
+        k[lane_idx] = 2*k[lane_idx] + (search_voffs[k[lane_idx]] <= group_voffs[lane_idx]);
+      }
+    }
+    for(U64 lane_idx = 0; lane_idx < group_count; lane_idx += 1)
+    {
+      U64 rank = k[lane_idx] - (1ull<<search_depth);
+      idxs_out[base_idx+lane_idx] = dbgi_line_index__idx_from_voff_rank(index, group_voffs[lane_idx], rank);
+    }
+  }
+}
+
 ////////////////////////////////
 //~ rjf: Fuzzy Search Cache Functions
 
@@ -879,6 +1106,7 @@ dbgi_parse_thread_entry_point(void *p)
             str8_list_pushf(scratch.arena, &opts.cmd_line, "raddbg");
             str8_list_pushf(scratch.arena, &opts.cmd_line, "--convert");
             str8_list_pushf(scratch.arena, &opts.cmd_line, "--quiet");
+            str8_list_pushf(scratch.arena, &opts.cmd_line, "--trigram_maps");
             //str8_list_pushf(scratch.arena, &opts.cmd_line, "--capture");
             str8_list_pushf(scratch.arena, &opts.cmd_line, "--exe:%S", exe_path);
             str8_list_pushf(scratch.arena, &opts.cmd_line, "--pdb:%S", og_dbg_path);
@@ -977,6 +1205,8 @@ dbgi_parse_thread_entry_point(void *p)
             
             // rjf: clean up old stuff
             if(bin->parse.arena != 0) { arena_release(bin->parse.arena); }
+            if(bin->parse.type_graph != 0) { tg_graph_release(bin->parse.type_graph); }
+            if(bin->parse.line_index != 0) { dbgi_line_index_release(bin->parse.line_index); }
             if(bin->parse.exe_base != 0) {os_file_map_view_close(bin->exe_file_map, bin->parse.exe_base);}
             if(!os_handle_match(os_handle_zero(), bin->exe_file_map)) {os_file_map_close(bin->exe_file_map);}
             if(!os_handle_match(os_handle_zero(), bin->exe_file)) {os_file_close(bin->exe_file);}
@@ -1054,6 +1284,7 @@ dbgi_parse_thread_entry_point(void *p)
           bin->parse.dbg_path = push_str8_copy(parse_arena, dbg_path);
           MemoryCopyStruct(&bin->parse.pe, &exe_pe_info);
           MemoryCopyStruct(&bin->parse.rdbg, &raddbg_parsed);
+          bin->parse.type_graph = tg_graph_alloc(arch_addr_size, 4096, &bin->parse.rdbg);
           bin->parse.gen = bin->gen;
           break;
         }
@@ -1080,6 +1311,33 @@ dbgi_parse_thread_entry_point(void *p)
       os_condition_variable_broadcast(stripe->cv);
     }
     
+    //- build line index for the stored parse. the parse is already
+    // visible, so users fall back to per-unit line info until this is
+    // published. a scope touch keeps the parse from being released meanwhile.
+    if(do_task && parse_store_good) ProfScope("build line index")
+    {
+      DBGI_Scope *scope = dbgi_scope_open();
+      DBGI_Parse *parse = 0;
+      OS_MutexScopeR(stripe->rw_mutex) for(DBGI_Binary *bin = slot->first; bin != 0; bin = bin->next)
+      {
+        if(str8_match(bin->exe_path, exe_path, 0))
+        {
+          if(bin->parse.arena == parse_arena && bin->parse.gen == bin->gen)
+          {
+            dbgi_scope_touch_binary__stripe_mutex_r_guarded(scope, bin);
+            parse = &bin->parse;
+          }
+          break;
+        }
+      }
+      if(parse != 0)
+      {
+        DBGI_LineIndex *line_index = dbgi_line_index_alloc(&parse->rdbg);
+        ins_atomic_ptr_eval_assign(&parse->line_index, line_index);
+      }
+      dbgi_scope_close(scope);
+    }
+    
     ProfEnd();
     scratch_end(scratch);
   }
@@ -1148,9 +1406,307 @@ dbgi_qsort_compare_fuzzy_search_items(DBGI_FuzzySearchItem *a, DBGI_FuzzySearchI
   {
     result = +1;
   }
+  else if(a->idx < b->idx)
+  {
+    result = -1;
+  }
+  else if(a->idx > b->idx)
+  {
+    result = +1;
+  }
+  return result;
+}
+
+internal B32
+dbgi_fuzzy_search_job_is_stale(DBGI_FuzzySearchJob *job)
+{
+  B32 is_stale = (ins_atomic_u64_eval(&job->cancelled) != 0);
+  if(!is_stale)
+  {
+    U64 slot_idx = job->key.u64[1]%dbgi_shared->fuzzy_search_slots_count;
+    U64 stripe_idx = slot_idx%dbgi_shared->fuzzy_search_stripes_count;
+    DBGI_FuzzySearchSlot *slot = &dbgi_shared->fuzzy_search_slots[slot_idx];
+    DBGI_FuzzySearchStripe *stripe = &dbgi_shared->fuzzy_search_stripes[stripe_idx];
+    OS_MutexScopeR(stripe->rw_mutex)
+    {
+      for(DBGI_FuzzySearchNode *n = slot->first; n != 0; n = n->next)
+      {
+        if(u128_match(n->key, job->key) && n->submit_gen > job->initial_submit_gen)
+        {
+          is_stale = 1;
+          break;
+        }
+      }
+    }
+    if(is_stale)
+    {
+      ins_atomic_u64_eval_assign(&job->cancelled, 1);
+    }
+  }
+  return is_stale;
+}
+
+internal DBGI_FuzzySearchCandidates
+dbgi_fuzzy_search_candidates_from_rdbg_target_query(Arena *arena, RADDBG_Parsed *rdbg, DBGI_FuzzySearchTarget target, String8 query)
+{
+  DBGI_FuzzySearchCandidates result = {0};
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  //- target -> trigram map (only present in newer files)
+  RADDBG_TrigramMapKind map_kind = RADDBG_TrigramMapKind_NULL;
+  switch(target)
+  {
+    // NOTE: no default - warn if we miss a case
+    case DBGI_FuzzySearchTarget_Procedures:     {map_kind = RADDBG_TrigramMapKind_Procedures;}break;
+    case DBGI_FuzzySearchTarget_GlobalVariables:{map_kind = RADDBG_TrigramMapKind_GlobalVariables;}break;
+    case DBGI_FuzzySearchTarget_ThreadVariables:{map_kind = RADDBG_TrigramMapKind_ThreadVariables;}break;
+    case DBGI_FuzzySearchTarget_UDTs:           {map_kind = RADDBG_TrigramMapKind_UDTs;}break;
+    case DBGI_FuzzySearchTarget_COUNT:{}break;
+  }
+  RADDBG_TrigramMap *map_ptr = raddbg_trigram_map_from_kind(rdbg, map_kind);
+  RADDBG_ParsedTrigramMap map = {0};
+  raddbg_trigram_map_parse(rdbg, map_ptr, &map);
+  
+  //- query -> posting lists for every trigram of every needle part that is
+  // long enough to have one; parts shorter than 3 bytes don't constrain anything
+  typedef struct PostingNode PostingNode;
+  struct PostingNode
+  {
+    PostingNode *next;
+    U32 *v;
+    U32 count;
+  };
+  PostingNode *first_posting = 0;
+  PostingNode *last_posting = 0;
+  U64 posting_list_count = 0;
+  B32 trigram_missing = 0;
+  if(map_ptr != 0)
+  {
+    String8List parts = str8_split(scratch.arena, query, (U8 *)" ", 1, 0);
+    for(String8Node *n = parts.first; n != 0 && !trigram_missing; n = n->next)
+    {
+      for(U64 off = 0; off+3 <= n->string.size; off += 1)
+      {
+        U32 trigram = raddbg_trigram_from_ptr(n->string.str+off);
+        U32 count = 0;
+        U32 *v = raddbg_trigram_map_postings_from_trigram(&map, trigram, &count);
+        if(v == 0 || count == 0)
+        {
+          trigram_missing = 1;
+          break;
+        }
+        PostingNode *node = push_array(scratch.arena, PostingNode, 1);
+        node->v = v;
+        node->count = count;
+        SLLQueuePush(first_posting, last_posting, node);
+        posting_list_count += 1;
+      }
+    }
+  }
+  
+  //- missing trigram -> nothing can match
+  if(trigram_missing)
+  {
+    result.is_narrowed = 1;
+  }
+  
+  //- posting lists -> intersection, seeded with the shortest list
+  else if(posting_list_count != 0)
+  {
+    PostingNode *seed = first_posting;
+    for(PostingNode *n = first_posting; n != 0; n = n->next)
+    {
+      if(n->count < seed->count)
+      {
+        seed = n;
+      }
+    }
+    U32 *v = push_array_no_zero(arena, U32, seed->count);
+    U64 count = seed->count;
+    MemoryCopy(v, seed->v, sizeof(U32)*count);
+    for(PostingNode *n = first_posting; n != 0 && count != 0; n = n->next)
+    {
+      if(n == seed)
+      {
+        continue;
+      }
+      U64 write_idx = 0;
+      U64 other_idx = 0;
+      for(U64 read_idx = 0; read_idx < count && other_idx < n->count; read_idx += 1)
+      {
+        // binary search for first other element >= this candidate
+        U32 candidate = v[read_idx];
+        U64 first = other_idx;
+        U64 opl = n->count;
+        for(;first < opl;)
+        {
+          U64 mid = (first+opl)/2;
+          if(n->v[mid] < candidate)
+          {
+            first = mid+1;
+          }
+          else
+          {
+            opl = mid;
+          }
+        }
+        other_idx = first;
+        if(other_idx < n->count && n->v[other_idx] == candidate)
+        {
+          v[write_idx] = candidate;
+          write_idx += 1;
+        }
+      }
+      count = write_idx;
+    }
+    result.is_narrowed = 1;
+    result.v = v;
+    result.count = count;
+  }
+  
+  scratch_end(scratch);
   return result;
 }
 
+internal void
+dbgi_fuzzy_search_job_do_partitions(DBGI_FuzzySearchJob *job, Arena *arena)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  for(;;)
+  {
+    //- grab next partition
+    U64 partition_idx = ins_atomic_u64_inc_eval(&job->next_partition_idx)-1;
+    if(partition_idx >= job->partition_count)
+    {
+      break;
+    }
+    DBGI_FuzzySearchPartition *partition = &job->partitions[partition_idx];
+    
+    //- partition elements * query -> item list
+    DBGI_FuzzySearchItemChunkList items_list = {0};
+    for(U64 range_idx = partition->element_range.min; range_idx < partition->element_range.max; range_idx += 1)
+    {
+      if(range_idx%1024 == 1023 && dbgi_fuzzy_search_job_is_stale(job))
+      {
+        break;
+      }
+      U64 idx = job->candidates.is_narrowed ? job->candidates.v[range_idx] : range_idx;
+      String8 name = dbgi_fuzzy_item_string_from_rdbg_target_element_idx(job->rdbg, job->target, idx);
+      if(name.size == 0 || !fuzzy_match_prefilter_pass(&job->prefilter, name)) { continue; }
+      FuzzyMatchRangeList matches = fuzzy_match_find(arena, job->query, name);
+      if(matches.count == matches.needle_part_count)
+      {
+        DBGI_FuzzySearchItemChunk *chunk = items_list.last;
+        if(chunk == 0 || chunk->count >= chunk->cap)
+        {
+          chunk = push_array(scratch.arena, DBGI_FuzzySearchItemChunk, 1);
+          chunk->cap = 512;
+          chunk->count = 0;
+          chunk->v = push_array_no_zero(scratch.arena, DBGI_FuzzySearchItem, chunk->cap);
+          SLLQueuePush(items_list.first, items_list.last, chunk);
+          items_list.chunk_count += 1;
+        }
+        chunk->v[chunk->count].idx = idx;
+        chunk->v[chunk->count].match_ranges = matches;
+        chunk->v[chunk->count].missed_size = (name.size > matches.total_dim) ? (name.size-matches.total_dim) : 0;
+        chunk->count += 1;
+        items_list.total_count += 1;
+      }
+    }
+    
+    //- rjf: item list -> item array
+    partition->items.count = items_list.total_count;
+    partition->items.v = push_array_no_zero(arena, DBGI_FuzzySearchItem, partition->items.count);
+    {
+      U64 idx = 0;
+      for(DBGI_FuzzySearchItemChunk *chunk = items_list.first; chunk != 0; chunk = chunk->next)
+      {
+        MemoryCopy(partition->items.v+idx, chunk->v, sizeof(DBGI_FuzzySearchItem)*chunk->count);
+        idx += chunk->count;
+      }
+    }
+    
+    //- sort partition's items
+    if(partition->items.count != 0 && job->query.size != 0)
+    {
+      qsort(partition->items.v, partition->items.count, sizeof(DBGI_FuzzySearchItem), (int (*)(const void *, const void *))dbgi_qsort_compare_fuzzy_search_items);
+    }
+    temp_end(scratch);
+  }
+  scratch_end(scratch);
+}
+
+internal DBGI_FuzzySearchItemArray
+dbgi_fuzzy_search_items_from_job(Arena *arena, DBGI_FuzzySearchJob *job)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  //- gather per-partition runs into one array
+  U64 total_count = 0;
+  for(U64 idx = 0; idx < job->partition_count; idx += 1)
+  {
+    total_count += job->partitions[idx].items.count;
+  }
+  DBGI_FuzzySearchItem *src = push_array_no_zero(scratch.arena, DBGI_FuzzySearchItem, total_count);
+  DBGI_FuzzySearchItem *dst = push_array_no_zero(scratch.arena, DBGI_FuzzySearchItem, total_count);
+  U64 *run_offs = push_array_no_zero(scratch.arena, U64, job->partition_count+1);
+  {
+    U64 off = 0;
+    for(U64 idx = 0; idx < job->partition_count; idx += 1)
+    {
+      run_offs[idx] = off;
+      MemoryCopy(src+off, job->partitions[idx].items.v, sizeof(DBGI_FuzzySearchItem)*job->partitions[idx].items.count);
+      off += job->partitions[idx].items.count;
+    }
+    run_offs[job->partition_count] = off;
+  }
+  
+  //- merge sorted runs pairwise; partitions are in element order, so
+  // with an empty query the concatenation is already the final order
+  U64 run_count = job->partition_count;
+  if(job->query.size != 0) for(;run_count > 1;)
+  {
+    U64 next_run_count = 0;
+    for(U64 run_idx = 0; run_idx < run_count; run_idx += 2, next_run_count += 1)
+    {
+      U64 a_off = run_offs[run_idx];
+      U64 a_opl = run_offs[run_idx+1];
+      U64 b_opl = (run_idx+2 <= run_count) ? run_offs[run_idx+2] : a_opl;
+      U64 out_off = a_off;
+      for(U64 a = a_off, b = a_opl; a < a_opl || b < b_opl; out_off += 1)
+      {
+        if(b >= b_opl || (a < a_opl && dbgi_qsort_compare_fuzzy_search_items(&src[a], &src[b]) <= 0))
+        {
+          dst[out_off] = src[a];
+          a += 1;
+        }
+        else
+        {
+          dst[out_off] = src[b];
+          b += 1;
+        }
+      }
+      run_offs[next_run_count] = a_off;
+    }
+    run_offs[next_run_count] = total_count;
+    run_count = next_run_count;
+    Swap(DBGI_FuzzySearchItem *, src, dst);
+  }
+  
+  //- copy out, with match ranges moved to the output arena
+  DBGI_FuzzySearchItemArray items = {0};
+  items.count = total_count;
+  items.v = push_array_no_zero(arena, DBGI_FuzzySearchItem, items.count);
+  for(U64 idx = 0; idx < items.count; idx += 1)
+  {
+    items.v[idx] = src[idx];
+    items.v[idx].match_ranges = fuzzy_match_range_list_copy(arena, &src[idx].match_ranges);
+  }
+  
+  scratch_end(scratch);
+  return items;
+}
+
 internal void
 dbgi_fuzzy_thread__entry_point(void *p)
 {
@@ -1199,113 +1755,79 @@ dbgi_fuzzy_thread__entry_point(void *p)
     DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, exe_path, max_U64);
     RADDBG_Parsed *rdbg = &dbgi->rdbg;
     
-    //- rjf: rdbg * query -> item list
-    U64 table_ptr_off = 0;
-    U64 element_name_idx_off = 0;
+    //- rdbg * target -> element count
     U64 element_count = 0;
-    U64 element_size = 0;
     switch(target)
     {
       // NOTE(rjf): no default!
       case DBGI_FuzzySearchTarget_COUNT:{}break;
-      case DBGI_FuzzySearchTarget_Procedures:
-      {
-        table_ptr_off = OffsetOf(RADDBG_Parsed, procedures);
-        element_name_idx_off = OffsetOf(RADDBG_Procedure, name_string_idx);
-        element_count = rdbg->procedures_count;
-        element_size = sizeof(RADDBG_Procedure);
-      }break;
-      case DBGI_FuzzySearchTarget_GlobalVariables:
-      {
-        table_ptr_off = OffsetOf(RADDBG_Parsed, global_variables);
-        element_name_idx_off = OffsetOf(RADDBG_GlobalVariable, name_string_idx);
-        element_count = rdbg->global_variables_count;
-        element_size = sizeof(RADDBG_GlobalVariable);
-      }break;
-      case DBGI_FuzzySearchTarget_ThreadVariables:
-      {
-        table_ptr_off = OffsetOf(RADDBG_Parsed, thread_variables);
-        element_name_idx_off = OffsetOf(RADDBG_ThreadVariable, name_string_idx);
-        element_count = rdbg->thread_variables_count;
-        element_size = sizeof(RADDBG_ThreadVariable);
-      }break;
-      case DBGI_FuzzySearchTarget_UDTs:
-      {
-        table_ptr_off = OffsetOf(RADDBG_Parsed, udts);
-        element_count = rdbg->udts_count;
-        element_size = sizeof(RADDBG_UDT);
-      }break;
+      case DBGI_FuzzySearchTarget_Procedures:     {element_count = rdbg->procedures_count;}break;
+      case DBGI_FuzzySearchTarget_GlobalVariables:{element_count = rdbg->global_variables_count;}break;
+      case DBGI_FuzzySearchTarget_ThreadVariables:{element_count = rdbg->thread_variables_count;}break;
+      case DBGI_FuzzySearchTarget_UDTs:           {element_count = rdbg->udts_count;}break;
     }
-    DBGI_FuzzySearchItemChunkList items_list = {0};
+    
+    //- build job, splitting elements into partitions
+    DBGI_FuzzySearchJob *job = push_array(scratch.arena, DBGI_FuzzySearchJob, 1);
     if(task_is_good)
     {
-      void *table_base = (U8*)rdbg + table_ptr_off;
-      for(U64 idx = 1; task_is_good && idx < element_count; idx += 1)
+      for(U64 idx = 0; idx < thread->job_arenas_count; idx += 1)
       {
-        void *element = (U8 *)(*(void **)table_base) + element_size*idx;
-        U32 *name_idx_ptr = (U32 *)((U8 *)element + element_name_idx_off);
-        if(target == DBGI_FuzzySearchTarget_UDTs)
-        {
-          RADDBG_UDT *udt = (RADDBG_UDT *)element;
-          RADDBG_TypeNode *type_node = raddbg_element_from_idx(rdbg, type_nodes, udt->self_type_idx);
-          name_idx_ptr = &type_node->user_defined.name_string_idx;
-        }
-        U32 name_idx = *name_idx_ptr;
-        U64 name_size = 0;
-        U8 *name_base = raddbg_string_from_idx(rdbg, name_idx, &name_size);
-        String8 name = str8(name_base, name_size);
-        if(name.size == 0) { continue; }
-        FuzzyMatchRangeList matches = fuzzy_match_find(task_arena, query, name);
-        if(matches.count == matches.needle_part_count)
+        arena_clear(thread->job_arenas[idx]);
+      }
+      job->key = key;
+      job->initial_submit_gen = initial_submit_gen;
+      job->rdbg = rdbg;
+      job->target = target;
+      job->query = query;
+      job->prefilter = fuzzy_match_prefilter_from_needle(scratch.arena, query);
+      job->candidates = dbgi_fuzzy_search_candidates_from_rdbg_target_query(scratch.arena, rdbg, target, query);
+      if(job->candidates.is_narrowed)
+      {
+        job->partition_count = (job->candidates.count + DBGI_FUZZY_SEARCH_PARTITION_SIZE-1) / DBGI_FUZZY_SEARCH_PARTITION_SIZE;
+        job->partitions = push_array(scratch.arena, DBGI_FuzzySearchPartition, job->partition_count);
+        for(U64 idx = 0; idx < job->partition_count; idx += 1)
         {
-          DBGI_FuzzySearchItemChunk *chunk = items_list.last;
-          if(chunk == 0 || chunk->count >= chunk->cap)
-          {
-            chunk = push_array(scratch.arena, DBGI_FuzzySearchItemChunk, 1);
-            chunk->cap = 512;
-            chunk->count = 0;
-            chunk->v = push_array_no_zero(scratch.arena, DBGI_FuzzySearchItem, chunk->cap);
-            SLLQueuePush(items_list.first, items_list.last, chunk);
-            items_list.chunk_count += 1;
-          }
-          chunk->v[chunk->count].idx = idx;
-          chunk->v[chunk->count].match_ranges = matches;
-          chunk->v[chunk->count].missed_size = (name_size > matches.total_dim) ? (name_size-matches.total_dim) : 0;
-          chunk->count += 1;
-          items_list.total_count += 1;
+          job->partitions[idx].element_range = r1u64(idx*DBGI_FUZZY_SEARCH_PARTITION_SIZE, Min((idx+1)*DBGI_FUZZY_SEARCH_PARTITION_SIZE, job->candidates.count));
         }
-        if(idx%100 == 99) OS_MutexScopeR(stripe->rw_mutex)
+      }
+      else
+      {
+        job->partition_count = (Max(element_count, 1)-1 + DBGI_FUZZY_SEARCH_PARTITION_SIZE-1) / DBGI_FUZZY_SEARCH_PARTITION_SIZE;
+        job->partitions = push_array(scratch.arena, DBGI_FuzzySearchPartition, job->partition_count);
+        for(U64 idx = 0; idx < job->partition_count; idx += 1)
         {
-          for(DBGI_FuzzySearchNode *n = slot->first; n != 0; n = n->next)
-          {
-            if(u128_match(n->key, key) && n->submit_gen > initial_submit_gen)
-            {
-              task_is_good = 0;
-              break;
-            }
-          }
+          job->partitions[idx].element_range = r1u64(1 + idx*DBGI_FUZZY_SEARCH_PARTITION_SIZE, Min(1 + (idx+1)*DBGI_FUZZY_SEARCH_PARTITION_SIZE, element_count));
         }
       }
+      job->arenas = thread->job_arenas;
     }
     
-    //- rjf: item list -> item array
-    DBGI_FuzzySearchItemArray items = {0};
-    if(task_is_good)
+    //- run partitions on the worker pool & this thread, then wait for workers
+    if(task_is_good && job->partition_count != 0)
     {
-      items.count = items_list.total_count;
-      items.v = push_array_no_zero(task_arena, DBGI_FuzzySearchItem, items.count);
-      U64 idx = 0;
-      for(DBGI_FuzzySearchItemChunk *chunk = items_list.first; chunk != 0; chunk = chunk->next)
+      OS_MutexScope(dbgi_shared->fuzzy_job_mutex)
       {
-        MemoryCopy(items.v+idx, chunk->v, sizeof(DBGI_FuzzySearchItem)*chunk->count);
-        idx += chunk->count;
+        DLLPushBack(dbgi_shared->first_fuzzy_job, dbgi_shared->last_fuzzy_job, job);
+      }
+      os_condition_variable_broadcast(dbgi_shared->fuzzy_job_cv);
+      dbgi_fuzzy_search_job_do_partitions(job, job->arenas[thread->job_arenas_count-1]);
+      OS_MutexScope(dbgi_shared->fuzzy_job_mutex)
+      {
+        for(;job->active_worker_count != 0;)
+        {
+          os_condition_variable_wait(dbgi_shared->fuzzy_job_cv, dbgi_shared->fuzzy_job_mutex, max_U64);
+        }
+        DLLRemove(dbgi_shared->first_fuzzy_job, dbgi_shared->last_fuzzy_job, job);
       }
+      task_is_good = !ins_atomic_u64_eval(&job->cancelled);
     }
     
-    //- rjf: sort item array
-    if(items.count != 0 && query.size != 0)
+    //- merge & sort per-partition results
+    DBGI_FuzzySearchItemArray items = {0};
+    if(task_is_good)
     {
-      qsort(items.v, items.count, sizeof(DBGI_FuzzySearchItem), (int (*)(const void *, const void *))dbgi_qsort_compare_fuzzy_search_items);
+      items = dbgi_fuzzy_search_items_from_job(task_arena, job);
     }
     
     //- rjf: commit to cache - busyloop on scope touches
@@ -1339,3 +1861,44 @@ dbgi_fuzzy_thread__entry_point(void *p)
     scratch_end(scratch);
   }
 }
+
+internal void
+dbgi_fuzzy_worker_thread__entry_point(void *p)
+{
+  TCTX tctx_;
+  tctx_init_and_equip(&tctx_);
+  ProfThreadName("[dbgi] fuzzy search worker #%I64U", (U64)p);
+  U64 worker_idx = (U64)p;
+  for(;;)
+  {
+    //- wait for a job with unclaimed partitions
+    DBGI_FuzzySearchJob *job = 0;
+    OS_MutexScope(dbgi_shared->fuzzy_job_mutex) for(;;)
+    {
+      for(DBGI_FuzzySearchJob *j = dbgi_shared->first_fuzzy_job; j != 0; j = j->next)
+      {
+        if(ins_atomic_u64_eval(&j->next_partition_idx) < j->partition_count)
+        {
+          job = j;
+          job->active_worker_count += 1;
+          break;
+        }
+      }
+      if(job != 0)
+      {
+        break;
+      }
+      os_condition_variable_wait(dbgi_shared->fuzzy_job_cv, dbgi_shared->fuzzy_job_mutex, max_U64);
+    }
+    
+    //- help out until no partitions remain
+    dbgi_fuzzy_search_job_do_partitions(job, job->arenas[worker_idx]);
+    
+    //- release job
+    OS_MutexScope(dbgi_shared->fuzzy_job_mutex)
+    {
+      job->active_worker_count -= 1;
+    }
+    os_condition_variable_broadcast(dbgi_shared->fuzzy_job_cv);
+  }
+}
@@ -4,6 +4,35 @@
 #ifndef DBGI_H
 #define DBGI_H
 
+////////////////////////////////
+//~ Line Index Types
+
+// NOTE: all units' line tables, flattened into one voff-sorted table
+// per binary. entry i covers [voffs[i], voffs[i+1]); ranges with no line
+// info are covered by entries with a zero unit_idx. searches run over an
+// eytzinger-ordered copy of the entry start voffs, padded to a perfect tree
+// with max_U64s, so every search takes exactly search_depth steps.
+
+typedef struct DBGI_LineIndexEntry DBGI_LineIndexEntry;
+struct DBGI_LineIndexEntry
+{
+  U32 unit_idx;
+  U32 file_idx;
+  U32 line_num;
+  U32 col_first;
+};
+
+typedef struct DBGI_LineIndex DBGI_LineIndex;
+struct DBGI_LineIndex
+{
+  Arena *arena;
+  U64 count;
+  U64 *voffs;
+  DBGI_LineIndexEntry *entries;
+  U64 search_depth;
+  U64 *search_voffs;
+};
+
 ////////////////////////////////
 //~ rjf: Info Bundle Types
 
@@ -19,6 +48,8 @@ struct DBGI_Parse
   FileProperties dbg_props;
   PE_BinInfo pe;
   RADDBG_Parsed rdbg;
+  TG_Graph *type_graph;
+  DBGI_LineIndex *line_index; // built after the parse is stored; 0 until then
 };
 
 ////////////////////////////////
@@ -190,6 +221,56 @@ struct DBGI_FuzzySearchThread
   U8 *u2f_ring_base;
   U64 u2f_ring_write_pos;
   U64 u2f_ring_read_pos;
+  U64 job_arenas_count;
+  Arena **job_arenas;
+};
+
+////////////////////////////////
+//~ Fuzzy Search Parallel Job Types
+
+#define DBGI_FUZZY_SEARCH_PARTITION_SIZE 16384
+
+typedef struct DBGI_FuzzySearchPartition DBGI_FuzzySearchPartition;
+struct DBGI_FuzzySearchPartition
+{
+  Rng1U64 element_range;
+  DBGI_FuzzySearchItemArray items;
+};
+
+typedef struct DBGI_FuzzySearchCandidates DBGI_FuzzySearchCandidates;
+struct DBGI_FuzzySearchCandidates
+{
+  B32 is_narrowed;
+  U32 *v;
+  U64 count;
+};
+
+typedef struct DBGI_FuzzySearchJob DBGI_FuzzySearchJob;
+struct DBGI_FuzzySearchJob
+{
+  // links (guarded by fuzzy job mutex)
+  DBGI_FuzzySearchJob *next;
+  DBGI_FuzzySearchJob *prev;
+  U64 active_worker_count;
+  
+  // task description
+  U128 key;
+  U64 initial_submit_gen;
+  RADDBG_Parsed *rdbg;
+  DBGI_FuzzySearchTarget target;
+  String8 query;
+  FuzzyMatchPrefilter prefilter;
+  DBGI_FuzzySearchCandidates candidates;
+  
+  // partitions & per-participant output arenas; workers use
+  // arenas[worker_idx], the submitting thread uses the last one
+  U64 partition_count;
+  DBGI_FuzzySearchPartition *partitions;
+  Arena **arenas;
+  
+  // atomically-updated progress
+  U64 next_partition_idx;
+  U64 cancelled;
 };
 
 ////////////////////////////////
@@ -311,6 +392,14 @@ struct DBGI_Shared
   OS_Handle *parse_threads;
   U64 fuzzy_thread_count;
   DBGI_FuzzySearchThread *fuzzy_threads;
+  
+  // fuzzy search worker pool
+  OS_Handle fuzzy_job_mutex;
+  OS_Handle fuzzy_job_cv;
+  DBGI_FuzzySearchJob *first_fuzzy_job;
+  DBGI_FuzzySearchJob *last_fuzzy_job;
+  U64 fuzzy_worker_count;
+  OS_Handle *fuzzy_workers;
 };
 
 ////////////////////////////////
@@ -361,6 +450,7 @@ global DBGI_Parse dbgi_parse_nil =
     &raddbg_location_block_nil, 1,
     0, 0,
     0, 0,
+    0, 0,
   },
 };
 
@@ -402,6 +492,17 @@ internal void dbgi_binary_open(String8 exe_path);
 internal void dbgi_binary_close(String8 exe_path);
 internal DBGI_Parse *dbgi_parse_from_exe_path(DBGI_Scope *scope, String8 exe_path, U64 endt_us);
 
+////////////////////////////////
+//~ Line Index Functions
+
+internal void dbgi_line_index__push_entry(U64 *voffs, DBGI_LineIndexEntry *entries, U64 *count, U64 voff, DBGI_LineIndexEntry *entry);
+internal DBGI_LineIndex *dbgi_line_index_alloc(RADDBG_Parsed *rdbg);
+internal void dbgi_line_index_release(DBGI_LineIndex *index);
+internal DBGI_LineIndex *dbgi_line_index_from_parse(DBGI_Parse *parse);
+internal U64 dbgi_line_index__idx_from_voff_rank(DBGI_LineIndex *index, U64 voff, U64 rank);
+internal U64 dbgi_line_index_idx_from_voff(DBGI_LineIndex *index, U64 voff);
+internal void dbgi_line_index_idxs_from_voffs(DBGI_LineIndex *index, U64 *voffs, U64 count, U64 *idxs_out);
+
 ////////////////////////////////
 //~ rjf: Fuzzy Search Cache Functions
 
@@ -426,6 +527,12 @@ internal void dbgi_u2f_dequeue_req(Arena *arena, DBGI_FuzzySearchThread *thread,
 
 internal int dbgi_qsort_compare_fuzzy_search_items(DBGI_FuzzySearchItem *a, DBGI_FuzzySearchItem *b);
 
+internal DBGI_FuzzySearchCandidates dbgi_fuzzy_search_candidates_from_rdbg_target_query(Arena *arena, RADDBG_Parsed *rdbg, DBGI_FuzzySearchTarget target, String8 query);
+internal B32 dbgi_fuzzy_search_job_is_stale(DBGI_FuzzySearchJob *job);
+internal void dbgi_fuzzy_search_job_do_partitions(DBGI_FuzzySearchJob *job, Arena *arena);
+internal DBGI_FuzzySearchItemArray dbgi_fuzzy_search_items_from_job(Arena *arena, DBGI_FuzzySearchJob *job);
+
 internal void dbgi_fuzzy_thread__entry_point(void *p);
+internal void dbgi_fuzzy_worker_thread__entry_point(void *p);
 
 #endif //DBGI_H
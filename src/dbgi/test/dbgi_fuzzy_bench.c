@@ -0,0 +1,285 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Fuzzy symbol search latency over a synthetic procedure table. Drives the
+// dbgi fuzzy search job directly (partitions, per-participant arenas, merge)
+// without the dbgi threads or a real debug info file, in three modes:
+// * full scan: fuzzy_match_find on every name, one partition (the old path)
+// * prefilter: the substring prefilter in front, still one thread
+// * parallel:  prefilter + partitions drained by 1..N threads
+// Every mode's result list must match the full scan's exactly.
+//
+// usage: dbgi_fuzzy_bench [--names:<n>] [--runs:<n>] [--threads:<max>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "path/path.h"
+#include "coff/coff.h"
+#include "pe/pe.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_format/raddbg_format_parse.h"
+#include "regs/regs.h"
+#include "regs/raddbg/regs_raddbg.h"
+#include "type_graph/type_graph.h"
+#include "dbgi/dbgi.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "path/path.c"
+#include "coff/coff.c"
+#include "pe/pe.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_format/raddbg_format_parse.c"
+#include "regs/regs.c"
+#include "regs/raddbg/regs_raddbg.c"
+#include "type_graph/type_graph.c"
+#include "dbgi/dbgi.c"
+
+////////////////////////////////
+//~ Shared State
+
+typedef struct FZB_Shared{
+  DBGI_FuzzySearchJob *job;
+  U64 done_count;
+  OS_Handle done_mutex;
+  OS_Handle done_cv;
+} FZB_Shared;
+
+global FZB_Shared fzb = {0};
+
+global char *fzb_words[] = {
+  "render", "draw", "ui", "box", "text", "font", "cache", "file",
+  "stream", "hash", "store", "parse", "eval", "type", "graph", "thread",
+  "window", "view", "entity", "process", "module", "symbol", "line", "unit",
+  "scope", "local", "member", "enum", "table", "list", "node", "alloc",
+};
+
+////////////////////////////////
+//~ Synthetic Table
+
+static U64
+fzb_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// element 0 is the nil procedure, like in a baked file
+static void
+fzb_rdbg_from_name_count(Arena *arena, RADDBG_Parsed *rdbg, U64 name_count){
+  U64 rng = 0x5EED;
+  U64 word_count = ArrayCount(fzb_words);
+  String8List names = {0};
+  str8_list_push(arena, &names, str8_lit(""));
+  for (U64 i = 1; i <= name_count; i += 1){
+    U64 r = fzb_rand(&rng);
+    String8 name = push_str8f(arena, "%s::%s_%s::%s_%s_%llu",
+                              fzb_words[r%word_count], fzb_words[(r >> 8)%word_count],
+                              fzb_words[(r >> 16)%word_count], fzb_words[(r >> 24)%word_count],
+                              fzb_words[(r >> 32)%word_count], i);
+    str8_list_push(arena, &names, name);
+  }
+  
+  rdbg->string_count = names.node_count;
+  rdbg->string_offs = push_array_no_zero(arena, U32, names.node_count + 1);
+  rdbg->string_data = push_array_no_zero(arena, U8, names.total_size);
+  rdbg->string_data_size = names.total_size;
+  rdbg->procedures_count = names.node_count;
+  rdbg->procedures = push_array(arena, RADDBG_Procedure, names.node_count);
+  U64 off = 0;
+  U64 idx = 0;
+  for (String8Node *n = names.first; n != 0; n = n->next, idx += 1){
+    rdbg->string_offs[idx] = (U32)off;
+    rdbg->procedures[idx].name_string_idx = (U32)idx;
+    MemoryCopy(rdbg->string_data + off, n->string.str, n->string.size);
+    off += n->string.size;
+  }
+  rdbg->string_offs[idx] = (U32)off;
+}
+
+////////////////////////////////
+//~ Job Helpers
+
+static void
+fzb_worker_thread(void *ptr){
+  DBGI_FuzzySearchJob *job = fzb.job;
+  dbgi_fuzzy_search_job_do_partitions(job, job->arenas[(U64)ptr]);
+  OS_MutexScope(fzb.done_mutex){
+    fzb.done_count += 1;
+  }
+  os_condition_variable_broadcast(fzb.done_cv);
+}
+
+// same partitioning as dbgi_fuzzy_thread__entry_point; partition_size of
+// zero puts the whole table in one partition
+static DBGI_FuzzySearchItemArray
+fzb_search(Arena *arena, Arena **job_arenas, RADDBG_Parsed *rdbg, String8 query,
+           B32 use_prefilter, U64 partition_size, U64 thread_count){
+  Temp scratch = scratch_begin(&arena, 1);
+  for (U64 i = 0; i <= thread_count; i += 1){
+    arena_clear(job_arenas[i]);
+  }
+  
+  U64 element_count = rdbg->procedures_count;
+  if (partition_size == 0){
+    partition_size = element_count;
+  }
+  DBGI_FuzzySearchJob *job = push_array(scratch.arena, DBGI_FuzzySearchJob, 1);
+  job->rdbg = rdbg;
+  job->target = DBGI_FuzzySearchTarget_Procedures;
+  job->query = query;
+  if (use_prefilter){
+    job->prefilter = fuzzy_match_prefilter_from_needle(scratch.arena, query);
+  }
+  job->partition_count = (Max(element_count, 1) - 1 + partition_size - 1)/partition_size;
+  job->partitions = push_array(scratch.arena, DBGI_FuzzySearchPartition, job->partition_count);
+  for (U64 idx = 0; idx < job->partition_count; idx += 1){
+    job->partitions[idx].element_range = r1u64(1 + idx*partition_size, Min(1 + (idx + 1)*partition_size, element_count));
+  }
+  job->arenas = job_arenas;
+  
+  // workers use arenas[0..thread_count-1]; with one thread the caller does it all
+  U64 worker_count = thread_count - 1;
+  fzb.job = job;
+  fzb.done_count = 0;
+  for (U64 i = 0; i < worker_count; i += 1){
+    os_release_thread_handle(os_launch_thread(fzb_worker_thread, (void*)i, 0));
+  }
+  dbgi_fuzzy_search_job_do_partitions(job, job_arenas[thread_count]);
+  OS_MutexScope(fzb.done_mutex){
+    for (;fzb.done_count < worker_count;){
+      os_condition_variable_wait(fzb.done_cv, fzb.done_mutex, max_U64);
+    }
+  }
+  
+  DBGI_FuzzySearchItemArray items = dbgi_fuzzy_search_items_from_job(arena, job);
+  scratch_end(scratch);
+  return(items);
+}
+
+static B32
+fzb_items_match(DBGI_FuzzySearchItemArray *a, DBGI_FuzzySearchItemArray *b){
+  B32 result = (a->count == b->count);
+  for (U64 i = 0; result && i < a->count; i += 1){
+    result = (a->v[i].idx == b->v[i].idx && a->v[i].missed_size == b->v[i].missed_size);
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 name_count = 5000000;
+  U64 runs = 3;
+  U64 max_threads = 8;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 names_string = cmd_line_string(&cmd_line, str8_lit("names"));
+    String8 runs_string = cmd_line_string(&cmd_line, str8_lit("runs"));
+    String8 threads_string = cmd_line_string(&cmd_line, str8_lit("threads"));
+    if (names_string.size != 0){
+      try_u64_from_str8_c_rules(names_string, &name_count);
+    }
+    if (runs_string.size != 0){
+      try_u64_from_str8_c_rules(runs_string, &runs);
+    }
+    if (threads_string.size != 0){
+      try_u64_from_str8_c_rules(threads_string, &max_threads);
+    }
+    runs = Max(runs, 1);
+    max_threads = Max(max_threads, 1);
+  }
+  
+  // minimal dbgi state: the job's staleness check looks up its key in the
+  // fuzzy search cache, which stays empty here
+  {
+    Arena *arena = arena_alloc();
+    dbgi_shared = push_array(arena, DBGI_Shared, 1);
+    dbgi_shared->arena = arena;
+    dbgi_shared->fuzzy_search_slots_count = 1;
+    dbgi_shared->fuzzy_search_slots = push_array(arena, DBGI_FuzzySearchSlot, 1);
+    dbgi_shared->fuzzy_search_stripes_count = 1;
+    dbgi_shared->fuzzy_search_stripes = push_array(arena, DBGI_FuzzySearchStripe, 1);
+    dbgi_shared->fuzzy_search_stripes[0].rw_mutex = os_rw_mutex_alloc();
+  }
+  fzb.done_mutex = os_mutex_alloc();
+  fzb.done_cv = os_condition_variable_alloc();
+  Arena **job_arenas = push_array(scratch.arena, Arena*, max_threads + 1);
+  for (U64 i = 0; i <= max_threads; i += 1){
+    job_arenas[i] = arena_alloc();
+  }
+  
+  // build table
+  RADDBG_Parsed rdbg = {0};
+  {
+    U64 begin_us = os_now_microseconds();
+    fzb_rdbg_from_name_count(scratch.arena, &rdbg, name_count);
+    printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+    printf("table: %llu names, %.1f MB of string data, built in %.2fs\n",
+           (unsigned long long)name_count, rdbg.string_data_size/(1024.0*1024.0),
+           (os_now_microseconds() - begin_us)/1000000.0);
+  }
+  
+  // queries
+  String8 queries[] = {
+    str8_lit("draw_box"),
+    str8_lit("font cache"),
+    str8_lit("parse 4999"),
+    str8_lit("thread member alloc"),
+    str8_lit("zqx"),
+  };
+  for (U64 query_idx = 0; query_idx < ArrayCount(queries); query_idx += 1){
+    String8 query = queries[query_idx];
+    Temp temp = temp_begin(scratch.arena);
+    DBGI_FuzzySearchItemArray reference = {0};
+    printf("'%.*s':\n", str8_varg(query));
+    
+    // full scan, prefilter, then prefilter + partitions at 1, 2, 4, ... threads
+    for (U64 mode_idx = 0;; mode_idx += 1){
+      B32 use_prefilter = (mode_idx != 0);
+      U64 partition_size = (mode_idx >= 2) ? DBGI_FUZZY_SEARCH_PARTITION_SIZE : 0;
+      U64 thread_count = (mode_idx >= 2) ? (1ull << (mode_idx - 2)) : 1;
+      if (thread_count > max_threads){
+        break;
+      }
+      U64 total_us = 0;
+      DBGI_FuzzySearchItemArray items = {0};
+      for (U64 run_idx = 0; run_idx < runs; run_idx += 1){
+        U64 begin_us = os_now_microseconds();
+        items = fzb_search(temp.arena, job_arenas, &rdbg, query, use_prefilter, partition_size, thread_count);
+        total_us += os_now_microseconds() - begin_us;
+      }
+      if (mode_idx == 0){
+        reference = items;
+      }
+      else if (!fzb_items_match(&reference, &items)){
+        printf("error: results differ from the full scan (%llu vs %llu items)\n",
+               (unsigned long long)items.count, (unsigned long long)reference.count);
+        return(1);
+      }
+      if (mode_idx < 2){
+        printf("  %-22s %9.2fms, %llu matches\n", use_prefilter ? "prefilter" : "full scan",
+               total_us/(1000.0*runs), (unsigned long long)items.count);
+      }
+      else{
+        printf("  prefilter, %2llu threads  %9.2fms\n", (unsigned long long)thread_count, total_us/(1000.0*runs));
+      }
+    }
+    temp_end(temp);
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
@@ -668,6 +668,53 @@ demon_write_memory(DEMON_Handle process, U64 dst_address, void *src, U64 size){
   return(result);
 }
 
+internal U64
+demon_read_memory_batch(DEMON_Handle process, DEMON_MemoryRead *reads, U64 reads_count){
+  U64 bytes_read = 0;
+  for (U64 idx = 0; idx < reads_count; idx += 1){
+    reads[idx].bytes_read = 0;
+  }
+  if (demon_access_begin()){
+    DEMON_Entity *entity = demon_ent_ptr_from_handle(process);
+    if (entity != 0 &&
+        entity->kind == DEMON_EntityKind_Process){
+      bytes_read = demon_os_read_memory_batch(entity, reads, reads_count);
+    }
+    demon_access_end();
+  }
+  return(bytes_read);
+}
+
+//- target process memory write tracking
+
+internal B32
+demon_memory_write_tracking_reset(DEMON_Handle process){
+  B32 result = 0;
+  if (demon_access_begin()){
+    DEMON_Entity *entity = demon_ent_ptr_from_handle(process);
+    if (entity != 0 &&
+        entity->kind == DEMON_EntityKind_Process){
+      result = demon_os_memory_write_tracking_reset(entity);
+    }
+    demon_access_end();
+  }
+  return(result);
+}
+
+internal B32
+demon_memory_range_was_written(DEMON_Handle process, Rng1U64 range, B32 *was_written_out){
+  B32 result = 0;
+  if (demon_access_begin()){
+    DEMON_Entity *entity = demon_ent_ptr_from_handle(process);
+    if (entity != 0 &&
+        entity->kind == DEMON_EntityKind_Process){
+      result = demon_os_memory_range_was_written(entity, range, was_written_out);
+    }
+    demon_access_end();
+  }
+  return(result);
+}
+
 #define READ_BLOCK_SIZE 4096
 
 internal U64
@@ -31,6 +31,15 @@ struct DEMON_HandleArray
   U64 count;
 };
 
+typedef struct DEMON_MemoryRead DEMON_MemoryRead;
+struct DEMON_MemoryRead
+{
+  void *dst;
+  U64 src_address;
+  U64 size;
+  U64 bytes_read;
+};
+
 ////////////////////////////////
 //~ rjf: Memory Protection Flags
 
@@ -268,6 +277,16 @@ internal U64 demon_read_memory(DEMON_Handle process, void *dst, U64 src_address,
 internal B32 demon_write_memory(DEMON_Handle process, U64 dst_address, void *src, U64 size);
 internal U64 demon_read_memory_amap_aligned(DEMON_Handle process, void *dst, U64 src_address, U64 size);
 internal U64 demon_read_memory_amap(DEMON_Handle process, void *dst, U64 src_address, U64 size);
+internal U64 demon_read_memory_batch(DEMON_Handle process, DEMON_MemoryRead *reads, U64 reads_count);
+
+//- target process memory write tracking
+// NOTE: These are best-effort. `reset` clears the process' record of
+// which pages have been written; `was_written` then reports whether any page
+// overlapping `range` has been written since the last reset. Both return 0 if
+// the backend cannot track writes for this process, in which case callers
+// must assume that all memory may have changed.
+internal B32 demon_memory_write_tracking_reset(DEMON_Handle process);
+internal B32 demon_memory_range_was_written(DEMON_Handle process, Rng1U64 range, B32 *was_written_out);
 
 //- rjf: thread registers reading/writing
 // IMPORTANT(allen): This API is _trusting_ you. You should never modify the data pointed
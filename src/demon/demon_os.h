@@ -79,9 +79,14 @@ internal void demon_os_release_memory(DEMON_Entity *process, U64 vaddr, U64 size
 //- rjf: target process memory reading/writing
 internal U64 demon_os_read_memory(DEMON_Entity *process, void *dst, U64 src_address, U64 size);
 internal B32 demon_os_write_memory(DEMON_Entity *process, U64 dst_address, void *src, U64 size);
+internal U64 demon_os_read_memory_batch(DEMON_Entity *process, DEMON_MemoryRead *reads, U64 reads_count);
 #define demon_os_read_struct(p,dst,src)  demon_os_read_memory((p), (dst), (src), sizeof(*(dst)))
 #define demon_os_write_struct(p,dst,src) demon_os_write_memory((p), (dst), (src), sizeof(*(src)))
 
+//- target process memory write tracking
+internal B32 demon_os_memory_write_tracking_reset(DEMON_Entity *process);
+internal B32 demon_os_memory_range_was_written(DEMON_Entity *process, Rng1U64 range, B32 *was_written_out);
+
 //- rjf: thread registers reading/writing
 internal B32 demon_os_read_regs_x86(DEMON_Entity *thread, REGS_RegBlockX86 *dst);
 internal B32 demon_os_write_regs_x86(DEMON_Entity *thread, REGS_RegBlockX86 *src);
@@ -26,6 +26,9 @@ global U32 demon_lnx_ptrace_options = (PTRACE_O_TRACEEXIT|
                                        PTRACE_O_TRACEVFORK|
                                        PTRACE_O_TRACECLONE);
 
+// 0 = not probed yet, 1 = soft-dirty bits work, -1 = they don't
+global S32 demon_lnx_soft_dirty_support = 0;
+
 ////////////////////////////////
 //~ rjf: Helpers
 
@@ -442,6 +445,61 @@ demon_lnx_read_memory(int memory_fd, void *dst, U64 src, U64 size){
   return(bytes_read);
 }
 
+internal U64
+demon_lnx_read_memory_batch(pid_t pid, int memory_fd, DEMON_MemoryRead *reads, U64 reads_count){
+  // NOTE: process_vm_readv moves many scattered ranges in one syscall;
+  // it stops at the first remote range it cannot read, so from that range on
+  // we finish with pread on /proc/<pid>/mem (which also covers kernels/policies
+  // that refuse process_vm_readv entirely) and then resume batching.
+  U64 result = 0;
+  B32 vm_readv_works = true;
+  struct iovec local_iov[DEMON_LNX_READ_BATCH_MAX];
+  struct iovec remote_iov[DEMON_LNX_READ_BATCH_MAX];
+  for (U64 idx = 0; idx < reads_count;){
+    U64 count = Min(reads_count - idx, DEMON_LNX_READ_BATCH_MAX);
+    
+    // batched read
+    U64 remaining = 0;
+    if (vm_readv_works){
+      for (U64 i = 0; i < count; i += 1){
+        DEMON_MemoryRead *read = &reads[idx + i];
+        local_iov[i].iov_base = read->dst;
+        local_iov[i].iov_len = (size_t)read->size;
+        remote_iov[i].iov_base = (void*)read->src_address;
+        remote_iov[i].iov_len = (size_t)read->size;
+      }
+      ssize_t actual_read = process_vm_readv(pid, local_iov, count, remote_iov, count, 0);
+      if (actual_read == -1 && (errno == ENOSYS || errno == EPERM)){
+        vm_readv_works = false;
+      }
+      if (actual_read > 0){
+        remaining = (U64)actual_read;
+      }
+    }
+    
+    // distribute transferred bytes over ranges, in order
+    U64 done_count = 0;
+    for (;done_count < count && reads[idx + done_count].size <= remaining; done_count += 1){
+      DEMON_MemoryRead *read = &reads[idx + done_count];
+      read->bytes_read = read->size;
+      remaining -= read->size;
+      result += read->size;
+    }
+    
+    // first range not fully transferred -> finish it with pread
+    if (done_count < count){
+      DEMON_MemoryRead *read = &reads[idx + done_count];
+      U64 pre = remaining;
+      read->bytes_read = pre + demon_lnx_read_memory(memory_fd, (U8*)read->dst + pre, read->src_address + pre, read->size - pre);
+      result += read->bytes_read;
+      done_count += 1;
+    }
+    
+    idx += done_count;
+  }
+  return(result);
+}
+
 internal B32
 demon_lnx_write_memory(int memory_fd, U64 dst, void *src, U64 size){
   B32 result = true;
@@ -1863,6 +1921,13 @@ demon_os_read_memory(DEMON_Entity *process, void *dst, U64 src_address, U64 size
   return(result);
 }
 
+internal U64
+demon_os_read_memory_batch(DEMON_Entity *process, DEMON_MemoryRead *reads, U64 reads_count){
+  int memory_fd = (int)process->ext_u64;
+  U64 result = demon_lnx_read_memory_batch((pid_t)process->id, memory_fd, reads, reads_count);
+  return(result);
+}
+
 internal B32
 demon_os_write_memory(DEMON_Entity *process, U64 dst_address, void *src, U64 size){
   int memory_fd = (int)process->ext_u64;
@@ -1870,6 +1935,162 @@ demon_os_write_memory(DEMON_Entity *process, U64 dst_address, void *src, U64 siz
   return(result);
 }
 
+//- target process memory write tracking
+
+internal B32
+demon_lnx_soft_dirty_is_supported(void){
+  // NOTE: kernels built without CONFIG_MEM_SOFT_DIRTY still accept "4" in
+  // clear_refs, but never set bit 55 in pagemap, so every page would look
+  // clean forever. Probe once on one of our own pages: clear, write, and
+  // check that the write shows up.
+  if (demon_lnx_soft_dirty_support == 0){
+    demon_lnx_soft_dirty_support = -1;
+    U64 page_size = (U64)getpagesize();
+    volatile U8 *page = (U8*)mmap(0, page_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (page != MAP_FAILED){
+      page[0] = 1;
+      int clear_refs = open("/proc/self/clear_refs", O_WRONLY);
+      int pagemap = open("/proc/self/pagemap", O_RDONLY);
+      if (clear_refs >= 0 && pagemap >= 0 && write(clear_refs, "4", 1) == 1){
+        page[0] = 2;
+        U64 entry = 0;
+        off_t entry_off = (off_t)(((U64)page/page_size)*sizeof(U64));
+        if (pread(pagemap, &entry, sizeof(entry), entry_off) == sizeof(entry) &&
+            (entry & (1ull << 55)) != 0){
+          demon_lnx_soft_dirty_support = 1;
+        }
+      }
+      if (clear_refs >= 0){
+        close(clear_refs);
+      }
+      if (pagemap >= 0){
+        close(pagemap);
+      }
+      munmap((void*)page, page_size);
+    }
+  }
+  return(demon_lnx_soft_dirty_support > 0);
+}
+
+internal B32
+demon_os_memory_write_tracking_reset(DEMON_Entity *process){
+  // NOTE: writing "4" to clear_refs clears the soft-dirty bits of all
+  // of the process' ptes; the kernel sets them again on the next write.
+  B32 result = false;
+  if (demon_lnx_soft_dirty_is_supported()){
+    Temp scratch = scratch_begin(0, 0);
+    String8 path = push_str8f(scratch.arena, "/proc/%d/clear_refs", (pid_t)process->id);
+    int fd = open((char*)path.str, O_WRONLY);
+    if (fd >= 0){
+      result = (write(fd, "4", 1) == 1);
+      close(fd);
+    }
+    scratch_end(scratch);
+  }
+  return(result);
+}
+
+internal B32
+demon_lnx_range_overlaps_shared_map(pid_t pid, Rng1U64 range){
+  // NOTE: soft-dirty bits only see writes made through this process' own
+  // ptes; pages of a shared mapping can be changed by other processes (or
+  // through other mappings of the same object) without ever setting them.
+  // The maps file is read in one go here, since the byte-at-a-time reader
+  // used for the detailed parse is too slow to run per cached range.
+  B32 result = true;
+  Temp scratch = scratch_begin(0, 0);
+  int maps = demon_lnx_open_maps(pid);
+  if (maps >= 0){
+    String8List chunks = {0};
+    for (;;){
+      U64 chunk_size = KB(16);
+      U8 *chunk = push_array_no_zero(scratch.arena, U8, chunk_size);
+      ssize_t bytes_read = read(maps, chunk, chunk_size);
+      if (bytes_read <= 0){
+        break;
+      }
+      str8_list_push(scratch.arena, &chunks, str8(chunk, (U64)bytes_read));
+    }
+    close(maps);
+    String8 text = str8_list_join(scratch.arena, &chunks, 0);
+    
+    result = false;
+    U8 *ptr = text.str;
+    U8 *opl = text.str + text.size;
+    for (;ptr < opl && !result;){
+      U8 *line_first = ptr;
+      for (;ptr < opl && *ptr != '\n'; ptr += 1);
+      String8 line = str8_range(line_first, ptr);
+      ptr += 1;
+      
+      // "lo-hi rwxp ..."
+      U64 dash_pos = str8_find_needle(line, 0, str8_lit("-"), 0);
+      U64 space_pos = str8_find_needle(line, dash_pos, str8_lit(" "), 0);
+      if (space_pos + 4 < line.size){
+        U64 lo = u64_from_str8(str8_substr(line, r1u64(0, dash_pos)), 16);
+        U64 hi = u64_from_str8(str8_substr(line, r1u64(dash_pos + 1, space_pos)), 16);
+        B32 is_shared = (line.str[space_pos + 4] == 's');
+        if (is_shared && lo < range.max && range.min < hi){
+          result = true;
+        }
+      }
+    }
+  }
+  scratch_end(scratch);
+  return(result);
+}
+
+internal B32
+demon_os_memory_range_was_written(DEMON_Entity *process, Rng1U64 range, B32 *was_written_out){
+  B32 result = false;
+  B32 was_written = false;
+  if (range.max > range.min && demon_lnx_range_overlaps_shared_map((pid_t)process->id, range)){
+    // NOTE: ranges backed by a shared mapping (or whose mappings could not
+    // be read) are conservatively reported as written.
+    result = true;
+    was_written = true;
+  }
+  else if (range.max > range.min){
+    Temp scratch = scratch_begin(0, 0);
+    String8 path = push_str8f(scratch.arena, "/proc/%d/pagemap", (pid_t)process->id);
+    int fd = open((char*)path.str, O_RDONLY);
+    if (fd >= 0){
+      U64 page_size = (U64)getpagesize();
+      U64 first_page = range.min/page_size;
+      U64 opl_page = (range.max + page_size - 1)/page_size;
+      U64 page_count = opl_page - first_page;
+      U64 *entries = push_array_no_zero(scratch.arena, U64, page_count);
+      U64 bytes_needed = page_count*sizeof(U64);
+      ssize_t bytes_read = pread(fd, entries, bytes_needed, first_page*sizeof(U64));
+      if (bytes_read == (ssize_t)bytes_needed){
+        result = true;
+        for (U64 page_idx = 0; page_idx < page_count; page_idx += 1){
+          U64 entry = entries[page_idx];
+          B32 is_present = !!(entry & (1ull << 63));
+          B32 is_swapped = !!(entry & (1ull << 62));
+          B32 is_soft_dirty = !!(entry & (1ull << 55));
+          
+          // NOTE: unmapped pages carry no soft-dirty information, so a
+          // page that vanished (or was never touched) is treated as written.
+          if (is_soft_dirty || (!is_present && !is_swapped)){
+            was_written = true;
+            break;
+          }
+        }
+      }
+      close(fd);
+    }
+    scratch_end(scratch);
+  }
+  else{
+    result = true;
+  }
+  if (was_written_out != 0){
+    *was_written_out = was_written;
+  }
+  return(result);
+}
+
 //- rjf: thread registers reading/writing
 
 internal B32
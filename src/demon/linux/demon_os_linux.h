@@ -18,11 +18,18 @@
 #include <sys/ptrace.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <elf.h>
 #include <dirent.h>
 #include <errno.h>
 
+////////////////////////////////
+//~ Linux Demon Constants
+
+// max ranges per process_vm_readv call (UIO_MAXIOV)
+#define DEMON_LNX_READ_BATCH_MAX 1024
+
 ////////////////////////////////
 //~ NOTE(allen): Linux Demon Types
 
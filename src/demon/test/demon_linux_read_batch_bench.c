@@ -0,0 +1,249 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Syscalls & latency per stop for process memory reads, one pread per range
+// (demon_os_read_memory) vs demon_os_read_memory_batch. A "stop" reads what
+// a stop typically pulls in: a run of stack pages for the unwinder, small
+// scattered reads for watches & locals, and a block of pages for a memory
+// view; a few ranges land on unmapped pages to exercise the fallback. Both
+// paths must produce the same bytes & per-range byte counts.
+//
+// usage: demon_linux_read_batch_bench [--stops:<n>] [--holes:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "regs/regs.h"
+#include "demon/demon_inc.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "regs/regs.c"
+#include "demon/demon_inc.c"
+
+#define RBB_REGION_SIZE MB(8)
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+rbb_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+#if OS_LINUX
+// read syscalls issued by this process so far; process_vm_readv is not
+// counted here, only read/pread & friends
+static U64
+rbb_read_syscall_count(void){
+  U64 result = 0;
+  char buffer[1024];
+  int fd = open("/proc/self/io", O_RDONLY);
+  if (fd >= 0){
+    ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size > 0){
+      String8 text = str8((U8*)buffer, (U64)size);
+      U64 pos = str8_find_needle(text, 0, str8_lit("syscr: "), 0);
+      if (pos < text.size){
+        String8 number = str8_skip(text, pos + 7);
+        number = str8_prefix(number, str8_find_needle(number, 0, str8_lit("\n"), 0));
+        result = u64_from_str8(number, 10);
+      }
+    }
+  }
+  return(result);
+}
+
+// process_vm_readv calls demon_lnx_read_memory_batch makes for `reads`:
+// one per batch, where a batch ends after its first range that can't be
+// fully transferred
+static U64
+rbb_vm_readv_call_count(B8 *read_hits_hole, U64 reads_count){
+  U64 result = 0;
+  for (U64 idx = 0; idx < reads_count;){
+    U64 count = Min(reads_count - idx, DEMON_LNX_READ_BATCH_MAX);
+    U64 done_count = 0;
+    for (;done_count < count && !read_hits_hole[idx + done_count]; done_count += 1);
+    if (done_count < count){
+      done_count += 1;
+    }
+    idx += done_count;
+    result += 1;
+  }
+  return(result);
+}
+#endif
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 stops = 1000;
+  U64 hole_count = 4;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 stops_string = cmd_line_string(&cmd_line, str8_lit("stops"));
+    String8 holes_string = cmd_line_string(&cmd_line, str8_lit("holes"));
+    if (stops_string.size != 0){
+      try_u64_from_str8_c_rules(stops_string, &stops);
+    }
+    if (holes_string.size != 0){
+      try_u64_from_str8_c_rules(holes_string, &hole_count);
+    }
+    stops = Max(stops, 1);
+  }
+
+#if OS_LINUX
+  U64 page_size = (U64)getpagesize();
+  U64 page_count = RBB_REGION_SIZE/page_size;
+  U8 *region = (U8*)mmap(0, RBB_REGION_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  {
+    U64 rng = 7;
+    for (U64 i = 0; i < RBB_REGION_SIZE/sizeof(U64); i += 1){
+      ((U64*)region)[i] = rbb_rand(&rng);
+    }
+  }
+  
+  // holes: pages the child unmaps, in the upper half of the region
+  hole_count = Min(hole_count, page_count/4);
+  U64 *hole_pages = push_array(scratch.arena, U64, hole_count);
+  for (U64 i = 0; i < hole_count; i += 1){
+    hole_pages[i] = page_count/2 + i*(page_count/2/Max(hole_count, 1));
+  }
+  
+  // launch child: unmap holes, report ready, wait to be released
+  int ready_pipe[2];
+  int release_pipe[2];
+  if (pipe(ready_pipe) != 0 || pipe(release_pipe) != 0){
+    printf("error: pipe failed\n");
+    return(1);
+  }
+  pid_t pid = fork();
+  if (pid == 0){
+    for (U64 i = 0; i < hole_count; i += 1){
+      munmap(region + hole_pages[i]*page_size, page_size);
+    }
+    U8 byte = 1;
+    write(ready_pipe[1], &byte, 1);
+    read(release_pipe[0], &byte, 1);
+    _exit(0);
+  }
+  {
+    U8 byte = 0;
+    read(ready_pipe[0], &byte, 1);
+  }
+  DEMON_Entity process = {0};
+  process.kind = DEMON_EntityKind_Process;
+  process.id = (U64)pid;
+  process.ext_u64 = (U64)demon_lnx_open_memory_fd_for_pid(pid);
+  
+  // one stop's reads: 64 stack pages, 192 scattered 64 byte reads, a 32 page
+  // memory view, and one read per hole
+  U64 reads_count = 64 + 192 + 32 + hole_count;
+  DEMON_MemoryRead *reads_a = push_array(scratch.arena, DEMON_MemoryRead, reads_count);
+  DEMON_MemoryRead *reads_b = push_array(scratch.arena, DEMON_MemoryRead, reads_count);
+  B8 *read_hits_hole = push_array(scratch.arena, B8, reads_count);
+  U64 bytes_requested = 0;
+  {
+    U64 rng = 11;
+    U64 read_idx = 0;
+    U64 stack_first_page = 16;
+    for (U64 i = 0; i < 64; i += 1, read_idx += 1){
+      reads_a[read_idx].src_address = (U64)region + (stack_first_page + i)*page_size;
+      reads_a[read_idx].size = page_size;
+    }
+    for (U64 i = 0; i < 192; i += 1, read_idx += 1){
+      U64 page = rbb_rand(&rng)%(page_count/2);
+      reads_a[read_idx].src_address = (U64)region + page*page_size + (rbb_rand(&rng)%(page_size - 64));
+      reads_a[read_idx].size = 64;
+    }
+    U64 view_first_page = page_count/4;
+    for (U64 i = 0; i < 32; i += 1, read_idx += 1){
+      reads_a[read_idx].src_address = (U64)region + (view_first_page + i)*page_size;
+      reads_a[read_idx].size = page_size;
+    }
+    for (U64 i = 0; i < hole_count; i += 1, read_idx += 1){
+      // starts a little before the hole so part of it is readable
+      reads_a[read_idx].src_address = (U64)region + hole_pages[i]*page_size - 128;
+      reads_a[read_idx].size = 256;
+      read_hits_hole[read_idx] = 1;
+    }
+    for (U64 i = 0; i < reads_count; i += 1){
+      bytes_requested += reads_a[i].size;
+      reads_a[i].dst = push_array(scratch.arena, U8, reads_a[i].size);
+      reads_b[i] = reads_a[i];
+      reads_b[i].dst = push_array(scratch.arena, U8, reads_b[i].size);
+    }
+  }
+  
+  // stops, alternating paths
+  U64 single_us_total = 0;
+  U64 batch_us_total = 0;
+  U64 single_syscalls_total = 0;
+  U64 batch_preads_total = 0;
+  for (U64 stop_idx = 0; stop_idx < stops; stop_idx += 1){
+    U64 syscr0 = rbb_read_syscall_count();
+    U64 t0 = os_now_microseconds();
+    for (U64 i = 0; i < reads_count; i += 1){
+      reads_a[i].bytes_read = demon_os_read_memory(&process, reads_a[i].dst, reads_a[i].src_address, reads_a[i].size);
+    }
+    U64 t1 = os_now_microseconds();
+    U64 syscr1 = rbb_read_syscall_count();
+    demon_os_read_memory_batch(&process, reads_b, reads_count);
+    U64 t2 = os_now_microseconds();
+    U64 syscr2 = rbb_read_syscall_count();
+    
+    // each count read is itself one read syscall
+    single_us_total += t1 - t0;
+    batch_us_total += t2 - t1;
+    single_syscalls_total += syscr1 - syscr0 - 1;
+    batch_preads_total += syscr2 - syscr1 - 1;
+    
+    for (U64 i = 0; i < reads_count; i += 1){
+      if (reads_a[i].bytes_read != reads_b[i].bytes_read ||
+          !MemoryMatch(reads_a[i].dst, reads_b[i].dst, reads_a[i].bytes_read)){
+        printf("error: read %llu differs (%llu vs %llu bytes)\n", (unsigned long long)i,
+               (unsigned long long)reads_a[i].bytes_read, (unsigned long long)reads_b[i].bytes_read);
+        return(1);
+      }
+      if (reads_a[i].bytes_read != (read_hits_hole[i] ? 128 : reads_a[i].size)){
+        printf("error: read %llu returned %llu bytes\n", (unsigned long long)i, (unsigned long long)reads_a[i].bytes_read);
+        return(1);
+      }
+    }
+  }
+  {
+    U8 byte = 0;
+    write(release_pipe[1], &byte, 1);
+    waitpid(pid, 0, 0);
+  }
+  
+  U64 vm_readv_calls = rbb_vm_readv_call_count(read_hits_hole, reads_count);
+  printf("%llu stops, %llu reads & %llu bytes per stop, %llu of the reads touch an unmapped page\n",
+         (unsigned long long)stops, (unsigned long long)reads_count,
+         (unsigned long long)bytes_requested, (unsigned long long)hole_count);
+  printf("one pread per range:  %8.1fus per stop, %6.1f syscalls\n",
+         (F64)single_us_total/stops, (F64)single_syscalls_total/stops);
+  printf("batched:              %8.1fus per stop, %6.1f syscalls (%llu process_vm_readv + %.1f pread)\n",
+         (F64)batch_us_total/stops, vm_readv_calls + (F64)batch_preads_total/stops,
+         (unsigned long long)vm_readv_calls, (F64)batch_preads_total/stops);
+#else
+  printf("this benchmark drives the Linux demon backend\n");
+#endif
+
+  scratch_end(scratch);
+  return(0);
+}
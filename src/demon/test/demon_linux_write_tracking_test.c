@@ -0,0 +1,209 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Process memory cache invalidation through demon write tracking. A forked
+// child stands in for the target: every "step" it dirties a few random
+// pages of a region the parent keeps cached as fixed ranges. Around each
+// step the parent does what ctrl does around demon_run: reset tracking,
+// run, then re-read only ranges reported as written (all of them when
+// tracking is unavailable). After every step the cache is compared against
+// the child's real memory; any stale byte fails the test.
+//
+// usage: demon_linux_write_tracking_test [--steps:<n>] [--ranges:<n>]
+//                                        [--range_size:<bytes>] [--writes:<pages per step>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "regs/regs.h"
+#include "demon/demon_inc.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "regs/regs.c"
+#include "demon/demon_inc.c"
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+wtt_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// the child & the parent derive the same written pages from the step index
+static U64
+wtt_page_from_step_write(U64 step_idx, U64 write_idx, U64 page_count){
+  U64 state = (step_idx + 1)*0x9E3779B97F4A7C15ull + write_idx*0xBF58476D1CE4E5B9ull + 1;
+  wtt_rand(&state);
+  return(wtt_rand(&state)%page_count);
+}
+
+#if OS_LINUX
+static void
+wtt_child_main(int cmd_fd, int ack_fd, U8 *region, U64 page_count, U64 page_size, U64 writes){
+  for (;;){
+    U32 step_idx = 0;
+    if (read(cmd_fd, &step_idx, sizeof(step_idx)) != sizeof(step_idx)){
+      break;
+    }
+    for (U64 write_idx = 0; write_idx < writes; write_idx += 1){
+      U64 page = wtt_page_from_step_write(step_idx, write_idx, page_count);
+      region[page*page_size + (step_idx%page_size)] += 1;
+    }
+    // the first page plays the part of the stack; it changes every step
+    region[step_idx%page_size] += 1;
+    if (write(ack_fd, &step_idx, sizeof(step_idx)) != sizeof(step_idx)){
+      break;
+    }
+  }
+  _exit(0);
+}
+#endif
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 steps = 1000;
+  U64 range_count = 200;
+  U64 range_size = KB(16);
+  U64 writes = 4;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 steps_string = cmd_line_string(&cmd_line, str8_lit("steps"));
+    String8 ranges_string = cmd_line_string(&cmd_line, str8_lit("ranges"));
+    String8 range_size_string = cmd_line_string(&cmd_line, str8_lit("range_size"));
+    String8 writes_string = cmd_line_string(&cmd_line, str8_lit("writes"));
+    if (steps_string.size != 0){
+      try_u64_from_str8_c_rules(steps_string, &steps);
+    }
+    if (ranges_string.size != 0){
+      try_u64_from_str8_c_rules(ranges_string, &range_count);
+    }
+    if (range_size_string.size != 0){
+      try_u64_from_str8_c_rules(range_size_string, &range_size);
+    }
+    if (writes_string.size != 0){
+      try_u64_from_str8_c_rules(writes_string, &writes);
+    }
+    range_count = Max(range_count, 1);
+  }
+
+#if OS_LINUX
+  // region shared (copy-on-write) with the child; every page present
+  U64 page_size = (U64)getpagesize();
+  range_size = AlignPow2(Max(range_size, page_size), page_size);
+  U64 region_size = range_count*range_size;
+  U64 page_count = region_size/page_size;
+  U8 *region = (U8*)mmap(0, region_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  MemorySet(region, 0xAB, region_size);
+  
+  // launch child
+  int cmd_pipe[2];
+  int ack_pipe[2];
+  if (pipe(cmd_pipe) != 0 || pipe(ack_pipe) != 0){
+    printf("error: pipe failed\n");
+    return(1);
+  }
+  pid_t pid = fork();
+  if (pid == 0){
+    close(cmd_pipe[1]);
+    close(ack_pipe[0]);
+    wtt_child_main(cmd_pipe[0], ack_pipe[1], region, page_count, page_size, writes);
+  }
+  close(cmd_pipe[0]);
+  close(ack_pipe[1]);
+  DEMON_Entity process = {0};
+  process.kind = DEMON_EntityKind_Process;
+  process.id = (U64)pid;
+  process.ext_u64 = (U64)demon_lnx_open_memory_fd_for_pid(pid);
+  
+  // fill cache
+  U8 *cache = push_array_no_zero(scratch.arena, U8, region_size);
+  U8 *check = push_array_no_zero(scratch.arena, U8, region_size);
+  B8 *range_was_hit = push_array(scratch.arena, B8, range_count);
+  demon_os_read_memory(&process, cache, (U64)region, region_size);
+  
+  // steps
+  U64 tracked_step_count = 0;
+  U64 bytes_read_total = 0;
+  U64 ideal_bytes_total = 0;
+  U64 step_us_total = 0;
+  for (U32 step_idx = 0; step_idx < steps; step_idx += 1){
+    U64 begin_us = os_now_microseconds();
+    B32 is_tracked = demon_os_memory_write_tracking_reset(&process);
+    U64 run_begin_us = os_now_microseconds();
+    U32 ack = 0;
+    if (write(cmd_pipe[1], &step_idx, sizeof(step_idx)) != sizeof(step_idx) ||
+        read(ack_pipe[0], &ack, sizeof(ack)) != sizeof(ack)){
+      printf("error: lost the child at step %u\n", step_idx);
+      return(1);
+    }
+    U64 run_end_us = os_now_microseconds();
+    for (U64 range_idx = 0; range_idx < range_count; range_idx += 1){
+      U64 off = range_idx*range_size;
+      B32 needs_read = 1;
+      if (is_tracked){
+        B32 was_written = 1;
+        if (demon_os_memory_range_was_written(&process, r1u64((U64)region + off, (U64)region + off + range_size), &was_written)){
+          needs_read = was_written;
+        }
+      }
+      if (needs_read){
+        demon_os_read_memory(&process, cache + off, (U64)region + off, range_size);
+        bytes_read_total += range_size;
+      }
+    }
+    U64 end_us = os_now_microseconds();
+    step_us_total += (end_us - begin_us) - (run_end_us - run_begin_us);
+    tracked_step_count += (is_tracked != 0);
+    
+    // what page-exact tracking would have re-read
+    MemoryZero(range_was_hit, range_count);
+    range_was_hit[0] = 1;
+    for (U64 write_idx = 0; write_idx < writes; write_idx += 1){
+      range_was_hit[wtt_page_from_step_write(step_idx, write_idx, page_count)*page_size/range_size] = 1;
+    }
+    for (U64 range_idx = 0; range_idx < range_count; range_idx += 1){
+      ideal_bytes_total += range_was_hit[range_idx] ? range_size : 0;
+    }
+    
+    // cache must match the child's memory
+    demon_os_read_memory(&process, check, (U64)region, region_size);
+    if (!MemoryMatch(check, cache, region_size)){
+      printf("error: stale cache after step %u (tracking %s)\n", step_idx, is_tracked ? "on" : "off");
+      return(1);
+    }
+  }
+  close(cmd_pipe[1]);
+  waitpid(pid, 0, 0);
+  
+  printf("%llu steps, %llu ranges of %llu bytes, %llu pages written per step\n",
+         (unsigned long long)steps, (unsigned long long)range_count,
+         (unsigned long long)range_size, (unsigned long long)writes + 1);
+  printf("write tracking: %s (%llu/%llu steps tracked)\n",
+         tracked_step_count ? "available" : "unavailable, every range re-read",
+         (unsigned long long)tracked_step_count, (unsigned long long)steps);
+  printf("bytes read per step: %.0f (re-read everything: %llu, page-exact: %.0f)\n",
+         (F64)bytes_read_total/steps, (unsigned long long)region_size, (F64)ideal_bytes_total/steps);
+  printf("reset + checks + reads per step: %.1fus\n", (F64)step_us_total/steps);
+#else
+  printf("demon write tracking is only implemented on Linux\n");
+#endif
+
+  scratch_end(scratch);
+  return(0);
+}
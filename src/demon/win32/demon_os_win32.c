@@ -1669,6 +1669,35 @@ demon_os_write_memory(DEMON_Entity *process, U64 dst_address, void *src, U64 siz
   return(result);
 }
 
+internal U64
+demon_os_read_memory_batch(DEMON_Entity *process, DEMON_MemoryRead *reads, U64 reads_count){
+  // NOTE: no vectored cross-process read on Windows; one
+  // ReadProcessMemory per range.
+  DEMON_W32_Ext *process_ext = demon_w32_ext(process);
+  HANDLE handle = process_ext->proc.handle;
+  U64 result = 0;
+  for (U64 idx = 0; idx < reads_count; idx += 1){
+    DEMON_MemoryRead *read = &reads[idx];
+    read->bytes_read = demon_w32_read_memory(handle, read->dst, read->src_address, read->size);
+    result += read->bytes_read;
+  }
+  return(result);
+}
+
+//- target process memory write tracking
+
+internal B32
+demon_os_memory_write_tracking_reset(DEMON_Entity *process){
+  // NOTE: no cheap cross-process dirty-page query on Windows; callers
+  // fall back to treating all memory as possibly changed.
+  return(0);
+}
+
+internal B32
+demon_os_memory_range_was_written(DEMON_Entity *process, Rng1U64 range, B32 *was_written_out){
+  return(0);
+}
+
 //- rjf: thread registers reading/writing
 
 internal B32
@@ -1394,6 +1394,10 @@ df_txti_handle_from_entity(DF_Entity *entity)
   Temp scratch = scratch_begin(0, 0);
   String8 path = df_full_path_from_entity(scratch.arena, entity);
   handle = txti_handle_from_path(path);
+  if(entity->flags & DF_EntityFlag_Output)
+  {
+    txti_set_append_cap(handle, MB(64));
+  }
   scratch_end(scratch);
   return handle;
 }
@@ -3339,42 +3343,106 @@ df_text_line_src2dasm_info_list_array_from_src_line_range(Arena *arena, DF_Entit
 
 //- rjf: voff -> src lookups
 
-internal DF_TextLineDasm2SrcInfo
-df_text_line_dasm2src_info_from_binary_voff(DF_Entity *binary, U64 voff)
+internal void
+df_text_line_dasm2src_infos_from_binary_voffs(DF_Entity *binary, U64 *voffs, U64 count, DF_TextLineDasm2SrcInfo *infos_out)
 {
   Temp scratch = scratch_begin(0, 0);
   DBGI_Scope *scope = dbgi_scope_open();
   String8 path = df_full_path_from_entity(scratch.arena, binary);
   DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, path, 0);
   RADDBG_Parsed *rdbg = &dbgi->rdbg;
-  DF_TextLineDasm2SrcInfo result = {0};
-  result.file = result.binary = &df_g_nil_entity;
-  if(rdbg->unit_vmap != 0 && rdbg->units != 0 && rdbg->source_files != 0)
-  {
-    U64 unit_idx = raddbg_vmap_idx_from_voff(rdbg->unit_vmap, rdbg->unit_vmap_count, voff);
-    RADDBG_Unit *unit = &rdbg->units[unit_idx];
-    RADDBG_ParsedLineInfo unit_line_info = {0};
-    raddbg_line_info_from_unit(rdbg, unit, &unit_line_info);
-    U64 line_info_idx = raddbg_line_info_idx_from_voff(&unit_line_info, voff);
-    if(line_info_idx < unit_line_info.count)
-    {
-      RADDBG_Line *line = &unit_line_info.lines[line_info_idx];
-      RADDBG_Column *column = (line_info_idx < unit_line_info.col_count) ? &unit_line_info.cols[line_info_idx] : 0;
-      RADDBG_SourceFile *file = &rdbg->source_files[line->file_idx];
-      String8 file_normalized_full_path = {0};
-      file_normalized_full_path.str = raddbg_string_from_idx(rdbg, file->normal_full_path_string_idx, &file_normalized_full_path.size);
-      result.binary = binary;
-      if(line->file_idx != 0 && file_normalized_full_path.size != 0)
-      {
-        result.file = df_entity_from_path(file_normalized_full_path, DF_EntityFromPathFlag_All);
+  U32 *file_idxs = push_array(scratch.arena, U32, count);
+  for(U64 idx = 0; idx < count; idx += 1)
+  {
+    MemoryZeroStruct(&infos_out[idx]);
+    infos_out[idx].file = infos_out[idx].binary = &df_g_nil_entity;
+  }
+  
+  //- voffs -> line info, via the binary's flattened line index if it is
+  // built, otherwise via each voff's unit's line table
+  DBGI_LineIndex *line_index = dbgi_line_index_from_parse(dbgi);
+  if(line_index != 0)
+  {
+    U64 *line_idxs = push_array_no_zero(scratch.arena, U64, count);
+    dbgi_line_index_idxs_from_voffs(line_index, voffs, count, line_idxs);
+    for(U64 idx = 0; idx < count; idx += 1)
+    {
+      U64 line_idx = line_idxs[idx];
+      if(line_idx < line_index->count)
+      {
+        DBGI_LineIndexEntry *entry = &line_index->entries[line_idx];
+        infos_out[idx].binary = binary;
+        infos_out[idx].pt = txt_pt(entry->line_num, entry->col_first ? entry->col_first : 1);
+        infos_out[idx].voff_range = r1u64(line_index->voffs[line_idx], line_index->voffs[line_idx+1]);
+        file_idxs[idx] = entry->file_idx;
       }
-      result.pt = txt_pt(line->line_num, column ? column->col_first : 1);
-      result.voff_range = r1u64(unit_line_info.voffs[line_info_idx], unit_line_info.voffs[line_info_idx+1]);
     }
   }
+  else if(rdbg->unit_vmap != 0 && rdbg->units != 0 && rdbg->source_files != 0)
+  {
+    for(U64 idx = 0; idx < count; idx += 1)
+    {
+      U64 voff = voffs[idx];
+      U64 unit_idx = raddbg_vmap_idx_from_voff(rdbg->unit_vmap, rdbg->unit_vmap_count, voff);
+      RADDBG_Unit *unit = &rdbg->units[unit_idx];
+      RADDBG_ParsedLineInfo unit_line_info = {0};
+      raddbg_line_info_from_unit(rdbg, unit, &unit_line_info);
+      
+      // NOTE: raddbg_line_info_idx_from_voff clamps voffs outside of the
+      // unit's line table to its first line; match the line index, which
+      // reports no line for them.
+      if(unit_line_info.count == 0 ||
+         voff < unit_line_info.voffs[0] || unit_line_info.voffs[unit_line_info.count] <= voff)
+      {
+        continue;
+      }
+      U64 line_info_idx = raddbg_line_info_idx_from_voff(&unit_line_info, voff);
+      if(line_info_idx < unit_line_info.count)
+      {
+        RADDBG_Line *line = &unit_line_info.lines[line_info_idx];
+        RADDBG_Column *column = (line_info_idx < unit_line_info.col_count) ? &unit_line_info.cols[line_info_idx] : 0;
+        infos_out[idx].binary = binary;
+        infos_out[idx].pt = txt_pt(line->line_num, column ? column->col_first : 1);
+        infos_out[idx].voff_range = r1u64(unit_line_info.voffs[line_info_idx], unit_line_info.voffs[line_info_idx+1]);
+        file_idxs[idx] = line->file_idx;
+      }
+    }
+  }
+  
+  //- file indices -> file entities; neighboring voffs mostly share a
+  // file, so only look up the path when the file changes
+  U32 last_file_idx = 0;
+  DF_Entity *last_file = &df_g_nil_entity;
+  for(U64 idx = 0; idx < count; idx += 1)
+  {
+    U32 file_idx = file_idxs[idx];
+    if(file_idx != last_file_idx)
+    {
+      last_file_idx = file_idx;
+      last_file = &df_g_nil_entity;
+      if(file_idx != 0 && file_idx < rdbg->source_files_count)
+      {
+        RADDBG_SourceFile *file = &rdbg->source_files[file_idx];
+        String8 file_normalized_full_path = {0};
+        file_normalized_full_path.str = raddbg_string_from_idx(rdbg, file->normal_full_path_string_idx, &file_normalized_full_path.size);
+        if(file_normalized_full_path.size != 0)
+        {
+          last_file = df_entity_from_path(file_normalized_full_path, DF_EntityFromPathFlag_All);
+        }
+      }
+    }
+    infos_out[idx].file = last_file;
+  }
   
   dbgi_scope_close(scope);
   scratch_end(scratch);
+}
+
+internal DF_TextLineDasm2SrcInfo
+df_text_line_dasm2src_info_from_binary_voff(DF_Entity *binary, U64 voff)
+{
+  DF_TextLineDasm2SrcInfo result = {0};
+  df_text_line_dasm2src_infos_from_binary_voffs(binary, &voff, 1, &result);
   return result;
 }
 
@@ -3826,6 +3894,80 @@ df_push_ctrl_msg(CTRL_Msg *msg)
 
 //- rjf: control thread running
 
+//- user breakpoint entity -> ctrl user breakpoints
+
+internal CTRL_UserBreakpointList
+df_ctrl_user_breakpoint_list_from_entity(Arena *arena, DF_Entity *user_bp)
+{
+  CTRL_UserBreakpointList result = {0};
+  DF_Entity *file = df_entity_ancestor_from_kind(user_bp, DF_EntityKind_File);
+  DF_Entity *symb = df_entity_child_from_kind(user_bp, DF_EntityKind_EntryPointName);
+  DF_EntityList overrides = df_possible_overrides_from_entity(arena, file);
+  for(DF_EntityNode *override_n = overrides.first; override_n != 0; override_n = override_n->next)
+  {
+    DF_Entity *override = override_n->entity;
+    DF_Entity *condition_child = df_entity_child_from_kind(user_bp, DF_EntityKind_Condition);
+    String8 condition = condition_child->name;
+    
+    // rjf: generate user breakpoint info depending on breakpoint placement
+    CTRL_UserBreakpointKind ctrl_user_bp_kind = CTRL_UserBreakpointKind_FileNameAndLineColNumber;
+    String8 ctrl_user_bp_string = {0};
+    TxtPt ctrl_user_bp_pt = {0};
+    U64 ctrl_user_bp_u64 = 0;
+    {
+      if(user_bp->flags & DF_EntityFlag_HasTextPoint)
+      {
+        ctrl_user_bp_kind = CTRL_UserBreakpointKind_FileNameAndLineColNumber;
+        ctrl_user_bp_string = df_full_path_from_entity(arena, override);
+        ctrl_user_bp_pt = user_bp->text_point;
+      }
+      else if(user_bp->flags & DF_EntityFlag_HasVAddr)
+      {
+        ctrl_user_bp_kind = CTRL_UserBreakpointKind_VirtualAddress;
+        ctrl_user_bp_u64 = user_bp->vaddr;
+      }
+      else if(!df_entity_is_nil(symb))
+      {
+        ctrl_user_bp_kind = CTRL_UserBreakpointKind_SymbolNameAndOffset;
+        ctrl_user_bp_string = symb->name;
+        ctrl_user_bp_u64 = user_bp->u64;
+      }
+    }
+    
+    // rjf: push user breakpoint to list
+    {
+      CTRL_UserBreakpoint ctrl_user_bp = {ctrl_user_bp_kind};
+      ctrl_user_bp.string = ctrl_user_bp_string;
+      ctrl_user_bp.pt = ctrl_user_bp_pt;
+      ctrl_user_bp.u64 = ctrl_user_bp_u64;
+      ctrl_user_bp.condition = condition;
+      ctrl_user_breakpoint_list_push(arena, &result, &ctrl_user_bp);
+    }
+  }
+  return result;
+}
+
+//- user breakpoint entity -> ctrl-side hit/condition stats
+
+internal CTRL_UserBreakpointStats
+df_ctrl_user_breakpoint_stats_from_entity(DF_Entity *user_bp)
+{
+  Temp scratch = scratch_begin(0, 0);
+  CTRL_UserBreakpointStats result = {0};
+  CTRL_UserBreakpointList ctrl_user_bps = df_ctrl_user_breakpoint_list_from_entity(scratch.arena, user_bp);
+  for(CTRL_UserBreakpointNode *n = ctrl_user_bps.first; n != 0; n = n->next)
+  {
+    CTRL_UserBreakpointStats stats = ctrl_user_breakpoint_stats_from_bp(&n->v);
+    result.hit_count                += stats.hit_count;
+    result.condition_eval_count     += stats.condition_eval_count;
+    result.condition_compile_count  += stats.condition_compile_count;
+    result.condition_filtered_count += stats.condition_filtered_count;
+    result.condition_eval_us        += stats.condition_eval_us;
+  }
+  scratch_end(scratch);
+  return result;
+}
+
 internal void
 df_ctrl_run(DF_RunKind run, DF_Entity *run_thread, CTRL_TrapList *run_traps)
 {
@@ -3855,49 +3997,10 @@ df_ctrl_run(DF_RunKind run, DF_Entity *run_thread, CTRL_TrapList *run_traps)
       {
         continue;
       }
-      DF_Entity *file = df_entity_ancestor_from_kind(user_bp, DF_EntityKind_File);
-      DF_Entity *symb = df_entity_child_from_kind(user_bp, DF_EntityKind_EntryPointName);
-      DF_EntityList overrides = df_possible_overrides_from_entity(scratch.arena, file);
-      for(DF_EntityNode *override_n = overrides.first; override_n != 0; override_n = override_n->next)
-      {
-        DF_Entity *override = override_n->entity;
-        DF_Entity *condition_child = df_entity_child_from_kind(user_bp, DF_EntityKind_Condition);
-        String8 condition = condition_child->name;
-        
-        // rjf: generate user breakpoint info depending on breakpoint placement
-        CTRL_UserBreakpointKind ctrl_user_bp_kind = CTRL_UserBreakpointKind_FileNameAndLineColNumber;
-        String8 ctrl_user_bp_string = {0};
-        TxtPt ctrl_user_bp_pt = {0};
-        U64 ctrl_user_bp_u64 = 0;
-        {
-          if(user_bp->flags & DF_EntityFlag_HasTextPoint)
-          {
-            ctrl_user_bp_kind = CTRL_UserBreakpointKind_FileNameAndLineColNumber;
-            ctrl_user_bp_string = df_full_path_from_entity(scratch.arena, override);
-            ctrl_user_bp_pt = user_bp->text_point;
-          }
-          else if(user_bp->flags & DF_EntityFlag_HasVAddr)
-          {
-            ctrl_user_bp_kind = CTRL_UserBreakpointKind_VirtualAddress;
-            ctrl_user_bp_u64 = user_bp->vaddr;
-          }
-          else if(!df_entity_is_nil(symb))
-          {
-            ctrl_user_bp_kind = CTRL_UserBreakpointKind_SymbolNameAndOffset;
-            ctrl_user_bp_string = symb->name;
-            ctrl_user_bp_u64 = user_bp->u64;
-          }
-        }
-        
-        // rjf: push user breakpoint to list
-        {
-          CTRL_UserBreakpoint ctrl_user_bp = {ctrl_user_bp_kind};
-          ctrl_user_bp.string = ctrl_user_bp_string;
-          ctrl_user_bp.pt = ctrl_user_bp_pt;
-          ctrl_user_bp.u64 = ctrl_user_bp_u64;
-          ctrl_user_bp.condition = condition;
-          ctrl_user_breakpoint_list_push(scratch.arena, &msg.user_bps, &ctrl_user_bp);
-        }
+      CTRL_UserBreakpointList ctrl_user_bps = df_ctrl_user_breakpoint_list_from_entity(scratch.arena, user_bp);
+      for(CTRL_UserBreakpointNode *n = ctrl_user_bps.first; n != 0; n = n->next)
+      {
+        ctrl_user_breakpoint_list_push(scratch.arena, &msg.user_bps, &n->v);
       }
     }
     if(df_state->ctrl_solo_stepping_mode && !df_entity_is_nil(run_thread))
@@ -3993,13 +4096,21 @@ df_eval_parse_ctx_from_process_vaddr(DBGI_Scope *scope, DF_Entity *process, U64
   EVAL_String2NumMap *locals_map = df_query_cached_locals_map_from_binary_voff(binary, voff);
   EVAL_String2NumMap *member_map = df_query_cached_member_map_from_binary_voff(binary, voff);
   
+  //- pick type graph - use the binary's shared graph when possible, so
+  // that resolved types are reused across contexts & frames
+  TG_Graph *type_graph = dbgi->type_graph;
+  if(type_graph == 0 || type_graph->address_size != bit_size_from_arch(arch)/8)
+  {
+    type_graph = tg_graph_begin(bit_size_from_arch(arch)/8, 256);
+  }
+  
   //- rjf: build ctx
   EVAL_ParseCtx ctx = zero_struct;
   {
     ctx.arch            = arch;
     ctx.ip_voff         = voff;
     ctx.rdbg            = rdbg;
-    ctx.type_graph      = tg_graph_begin(bit_size_from_arch(arch)/8, 256);
+    ctx.type_graph      = type_graph;
     ctx.regs_map        = reg_map;
     ctx.reg_alias_map   = reg_alias_map;
     ctx.locals_map      = locals_map;
@@ -4125,6 +4236,131 @@ df_eval_parse_ctx_from_src_loc(DBGI_Scope *scope, DF_Entity *file, TxtPt pt)
   return ctx;
 }
 
+internal DF_EvalCompileCacheNode *
+df_eval_compiled_from_string(EVAL_ParseCtx *parse_ctx, EVAL_String2ExprMap *macro_map, String8 string)
+{
+  ProfBeginFunction();
+  DF_EvalCompileCache *cache = &df_state->eval_compile_cache;
+  if(cache->table_size == 0)
+  {
+    cache->table_size = 1024;
+    cache->table = push_array(cache->arena, DF_EvalCompileCacheSlot, cache->table_size);
+  }
+  
+  //- unpack key. parse contexts' rdbgs always live inside a DBGI_Parse,
+  // whose generation changes when the debug info is reloaded in place.
+  RADDBG_Parsed *rdbg = parse_ctx->rdbg;
+  DBGI_Parse *dbgi = CastFromMember(DBGI_Parse, rdbg, rdbg);
+  U64 dbgi_gen = dbgi->gen;
+  if(cache->last_rdbg != rdbg || cache->last_dbgi_gen != dbgi_gen || cache->last_voff != parse_ctx->ip_voff)
+  {
+    cache->last_rdbg = rdbg;
+    cache->last_dbgi_gen = dbgi_gen;
+    cache->last_voff = parse_ctx->ip_voff;
+    cache->last_voff_range = eval_name_resolution_voff_range_from_raddbg_voff(rdbg, parse_ctx->ip_voff);
+  }
+  Rng1U64 voff_range = cache->last_voff_range;
+  U64 key_parts[] = {IntFromPtr(rdbg), dbgi_gen, (U64)parse_ctx->arch, voff_range.min, voff_range.max, macro_map->content_hash};
+  U64 hash = df_hash_from_seed_string(df_hash_from_string(string), str8((U8 *)key_parts, sizeof(key_parts)));
+  U64 slot_idx = hash%cache->table_size;
+  DF_EvalCompileCacheSlot *slot = &cache->table[slot_idx];
+  
+  //- look up existing
+  DF_EvalCompileCacheNode *node = 0;
+  for(DF_EvalCompileCacheNode *n = slot->first; n != 0; n = n->hash_next)
+  {
+    if(n->rdbg == rdbg &&
+       n->dbgi_gen == dbgi_gen &&
+       n->arch == parse_ctx->arch &&
+       n->voff_range.min == voff_range.min &&
+       n->voff_range.max == voff_range.max &&
+       n->macro_map_hash == macro_map->content_hash &&
+       str8_match(n->string, string, 0))
+    {
+      node = n;
+      break;
+    }
+  }
+  
+  //- miss -> compile
+  if(node == 0)
+  {
+    Temp scratch = scratch_begin(&cache->arena, 1);
+    node = push_array(cache->arena, DF_EvalCompileCacheNode, 1);
+    SLLQueuePush_N(slot->first, slot->last, node, hash_next);
+    cache->node_count += 1;
+    cache->miss_count += 1;
+    node->string         = push_str8_copy(cache->arena, string);
+    node->rdbg           = rdbg;
+    node->dbgi_gen       = dbgi_gen;
+    node->arch           = parse_ctx->arch;
+    node->voff_range     = voff_range;
+    node->macro_map_hash = macro_map->content_hash;
+    
+    //- rjf: lex & parse
+    EVAL_TokenArray tokens = eval_token_array_from_text(scratch.arena, node->string);
+    EVAL_ParseResult parse = eval_parse_expr_from_text_tokens(scratch.arena, parse_ctx, node->string, &tokens);
+    EVAL_ErrorList errors = parse.errors;
+    B32 parse_has_expr = (parse.expr != &eval_expr_nil);
+    B32 parse_is_type = (parse_has_expr && parse.expr->kind == EVAL_ExprKind_TypeIdent);
+    
+    //- rjf: produce IR tree & type
+    EVAL_IRTreeAndType ir_tree_and_type = {&eval_irtree_nil};
+    if(parse_has_expr && errors.count == 0)
+    {
+      ir_tree_and_type = eval_irtree_and_type_from_expr(scratch.arena, parse_ctx->type_graph, rdbg, macro_map, parse.expr, &errors);
+    }
+    
+    //- rjf: get list of ops
+    EVAL_OpList op_list = {0};
+    if(parse_has_expr && ir_tree_and_type.tree != &eval_irtree_nil)
+    {
+      eval_oplist_from_irtree(scratch.arena, ir_tree_and_type.tree, &op_list);
+    }
+    
+    //- rjf: get bytecode string
+    if(parse_has_expr && parse_is_type == 0 && op_list.encoded_size != 0)
+    {
+      node->bytecode = eval_bytecode_from_oplist(cache->arena, &op_list);
+      node->program = eval_program_from_bytecode(cache->arena, node->bytecode);
+    }
+    
+    //- type key -> chain of constructed types down to a graph-independent key
+    TG_Key type_key = ir_tree_and_type.type_key;
+    for(TG_Key k = type_key; k.kind == TG_KeyKind_Cons; k = tg_direct_from_graph_raddbg_key(parse_ctx->type_graph, rdbg, k))
+    {
+      node->type_cons_chain_count += 1;
+    }
+    node->type_cons_chain = push_array(cache->arena, TG_ConsType, node->type_cons_chain_count);
+    for(U64 idx = 0; idx < node->type_cons_chain_count; idx += 1)
+    {
+      TG_Type *type = tg_type_from_graph_raddbg_key(scratch.arena, parse_ctx->type_graph, rdbg, type_key);
+      node->type_cons_chain[idx].kind = type->kind;
+      node->type_cons_chain[idx].direct_type_key = type->direct_type_key;
+      node->type_cons_chain[idx].u64 = type->count;
+      type_key = type->direct_type_key;
+    }
+    node->type_base_key = type_key;
+    
+    //- fill
+    node->mode = ir_tree_and_type.mode;
+    node->is_cast = (parse.expr->kind == EVAL_ExprKind_Cast);
+    for(EVAL_Error *error = errors.first; error != 0; error = error->next)
+    {
+      eval_error(cache->arena, &node->errors, error->kind, error->location, push_str8_copy(cache->arena, error->text));
+    }
+    
+    scratch_end(scratch);
+  }
+  else
+  {
+    cache->hit_count += 1;
+  }
+  
+  ProfEnd();
+  return node;
+}
+
 internal DF_Eval
 df_eval_from_string(Arena *arena, DBGI_Scope *scope, DF_CtrlCtx *ctrl_ctx, EVAL_ParseCtx *parse_ctx, EVAL_String2ExprMap *macro_map, String8 string)
 {
@@ -4167,46 +4403,41 @@ df_eval_from_string(Arena *arena, DBGI_Scope *scope, DF_CtrlCtx *ctrl_ctx, EVAL_
   machine.module_base = &module_base;
   machine.tls_base = &tls_base;
   
-  //- rjf: lex & parse
-  EVAL_TokenArray tokens = eval_token_array_from_text(arena, string);
-  EVAL_ParseResult parse = eval_parse_expr_from_text_tokens(arena, parse_ctx, string, &tokens);
-  EVAL_ErrorList errors = parse.errors;
-  B32 parse_has_expr = (parse.expr != &eval_expr_nil);
-  B32 parse_is_type = (parse_has_expr && parse.expr->kind == EVAL_ExprKind_TypeIdent);
-  
-  //- rjf: produce IR tree & type
-  EVAL_IRTreeAndType ir_tree_and_type = {&eval_irtree_nil};
-  if(parse_has_expr && errors.count == 0)
-  {
-    ir_tree_and_type = eval_irtree_and_type_from_expr(arena, parse_ctx->type_graph, parse_ctx->rdbg, macro_map, parse.expr, &errors);
-  }
+  //- string -> compiled expression (lex, parse, type, & bytecode)
+  DF_EvalCompileCacheNode *compiled = df_eval_compiled_from_string(parse_ctx, macro_map, string);
   
-  //- rjf: get list of ops
-  EVAL_OpList op_list = {0};
-  if(parse_has_expr && ir_tree_and_type.tree != &eval_irtree_nil)
+  //- re-make constructed types in this frame's type graph
+  TG_Key type_key = compiled->type_base_key;
+  for(U64 idx = compiled->type_cons_chain_count; idx > 0; idx -= 1)
   {
-    eval_oplist_from_irtree(arena, ir_tree_and_type.tree, &op_list);
+    TG_ConsType *cons = &compiled->type_cons_chain[idx-1];
+    type_key = tg_cons_type_make(parse_ctx->type_graph, cons->kind, type_key, cons->u64);
   }
   
-  //- rjf: get bytecode string
-  String8 bytecode = {0};
-  if(parse_has_expr && parse_is_type == 0 && op_list.encoded_size != 0)
+  //- copy errors, pointing locations back into the caller's string
+  EVAL_ErrorList errors = {0};
+  for(EVAL_Error *error = compiled->errors.first; error != 0; error = error->next)
   {
-    bytecode = eval_bytecode_from_oplist(arena, &op_list);
+    void *location = 0;
+    if(compiled->string.str <= (U8 *)error->location && (U8 *)error->location <= compiled->string.str + compiled->string.size)
+    {
+      location = string.str + ((U8 *)error->location - compiled->string.str);
+    }
+    eval_error(arena, &errors, error->kind, location, push_str8_copy(arena, error->text));
   }
   
   //- rjf: evaluate
   EVAL_Result eval = {0};
-  if(bytecode.size != 0)
+  if(compiled->program.count != 0)
   {
-    eval = eval_interpret(&machine, bytecode);
+    eval = eval_interpret_program(&machine, &compiled->program);
   }
   
   //- rjf: fill result
   DF_Eval result = zero_struct;
   {
-    result.type_key = ir_tree_and_type.type_key;
-    result.mode = ir_tree_and_type.mode;
+    result.type_key = type_key;
+    result.mode = compiled->mode;
     switch(result.mode)
     {
       default:
@@ -4230,7 +4461,7 @@ df_eval_from_string(Arena *arena, DBGI_Scope *scope, DF_CtrlCtx *ctrl_ctx, EVAL_
   }
   
   //- rjf: apply dynamic type overrides
-  if(parse.expr != 0 && parse.expr->kind != EVAL_ExprKind_Cast)
+  if(!compiled->is_cast)
   {
     result = df_dynamically_typed_eval_from_eval(parse_ctx->type_graph, parse_ctx->rdbg, ctrl_ctx, result);
   }
@@ -6278,8 +6509,17 @@ internal EVAL_String2NumMap *
 df_query_cached_locals_map_from_binary_voff(DF_Entity *binary, U64 voff)
 {
   ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  DBGI_Scope *scope = dbgi_scope_open();
   EVAL_String2NumMap *map = &eval_string2num_map_nil;
   {
+    //- binary * voff -> debug info & scope key
+    String8 binary_path = df_full_path_from_entity(scratch.arena, binary);
+    DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, binary_path, 0);
+    RADDBG_Parsed *rdbg = &dbgi->rdbg;
+    EVAL_ScopeKey scope_key = eval_scope_key_from_raddbg_voff(rdbg, voff);
+    
+    //- look up map for this scope
     DF_RunLocalsCache *cache = &df_state->locals_cache;
     if(cache->table_size == 0)
     {
@@ -6287,37 +6527,41 @@ df_query_cached_locals_map_from_binary_voff(DF_Entity *binary, U64 voff)
       cache->table = push_array(cache->arena, DF_RunLocalsCacheSlot, cache->table_size);
     }
     DF_Handle handle = df_handle_from_entity(binary);
-    U64 hash = df_hash_from_string(str8_struct(&handle));
+    U64 hash = df_hash_from_seed_string(df_hash_from_string(str8_struct(&handle)), str8_struct(&scope_key));
     U64 slot_idx = hash % cache->table_size;
     DF_RunLocalsCacheSlot *slot = &cache->table[slot_idx];
     DF_RunLocalsCacheNode *node = 0;
     for(DF_RunLocalsCacheNode *n = slot->first; n != 0; n = n->hash_next)
     {
-      if(df_handle_match(n->binary, handle) && n->voff == voff)
+      if(df_handle_match(n->binary, handle) && n->dbgi_gen == dbgi->gen && eval_scope_key_match(n->scope_key, scope_key))
       {
         node = n;
         break;
       }
     }
+    
+    //- miss -> build & insert
     if(node == 0)
     {
-      DBGI_Scope *scope = dbgi_scope_open();
-      EVAL_String2NumMap *map = df_push_locals_map_from_binary_voff(cache->arena, scope, binary, voff);
+      EVAL_String2NumMap *map = eval_push_locals_map_from_raddbg_scope_key(cache->arena, rdbg, scope_key);
       if(map->slots_count != 0)
       {
         node = push_array(cache->arena, DF_RunLocalsCacheNode, 1);
         node->binary = handle;
-        node->voff = voff;
+        node->dbgi_gen = dbgi->gen;
+        node->scope_key = scope_key;
         node->locals_map = map;
         SLLQueuePush_N(slot->first, slot->last, node, hash_next);
+        cache->node_count += 1;
       }
-      dbgi_scope_close(scope);
     }
     if(node != 0)
     {
       map = node->locals_map;
     }
   }
+  dbgi_scope_close(scope);
+  scratch_end(scratch);
   ProfEnd();
   return map;
 }
@@ -6326,8 +6570,17 @@ internal EVAL_String2NumMap *
 df_query_cached_member_map_from_binary_voff(DF_Entity *binary, U64 voff)
 {
   ProfBeginFunction();
+  Temp scratch = scratch_begin(0, 0);
+  DBGI_Scope *scope = dbgi_scope_open();
   EVAL_String2NumMap *map = &eval_string2num_map_nil;
   {
+    //- binary * voff -> debug info & scope key
+    String8 binary_path = df_full_path_from_entity(scratch.arena, binary);
+    DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, binary_path, 0);
+    RADDBG_Parsed *rdbg = &dbgi->rdbg;
+    EVAL_ScopeKey scope_key = eval_scope_key_from_raddbg_voff(rdbg, voff);
+    
+    //- look up map for this scope
     DF_RunLocalsCache *cache = &df_state->member_cache;
     if(cache->table_size == 0)
     {
@@ -6335,37 +6588,41 @@ df_query_cached_member_map_from_binary_voff(DF_Entity *binary, U64 voff)
       cache->table = push_array(cache->arena, DF_RunLocalsCacheSlot, cache->table_size);
     }
     DF_Handle handle = df_handle_from_entity(binary);
-    U64 hash = df_hash_from_string(str8_struct(&handle));
+    U64 hash = df_hash_from_seed_string(df_hash_from_string(str8_struct(&handle)), str8_struct(&scope_key));
     U64 slot_idx = hash % cache->table_size;
     DF_RunLocalsCacheSlot *slot = &cache->table[slot_idx];
     DF_RunLocalsCacheNode *node = 0;
     for(DF_RunLocalsCacheNode *n = slot->first; n != 0; n = n->hash_next)
     {
-      if(df_handle_match(n->binary, handle) && n->voff == voff)
+      if(df_handle_match(n->binary, handle) && n->dbgi_gen == dbgi->gen && eval_scope_key_match(n->scope_key, scope_key))
       {
         node = n;
         break;
       }
     }
+    
+    //- miss -> build & insert
     if(node == 0)
     {
-      DBGI_Scope *scope = dbgi_scope_open();
-      EVAL_String2NumMap *map = df_push_member_map_from_binary_voff(cache->arena, scope, binary, voff);
+      EVAL_String2NumMap *map = eval_push_member_map_from_raddbg_scope_key(cache->arena, rdbg, scope_key);
       if(map->slots_count != 0)
       {
         node = push_array(cache->arena, DF_RunLocalsCacheNode, 1);
         node->binary = handle;
-        node->voff = voff;
+        node->dbgi_gen = dbgi->gen;
+        node->scope_key = scope_key;
         node->locals_map = map;
         SLLQueuePush_N(slot->first, slot->last, node, hash_next);
+        cache->node_count += 1;
       }
-      dbgi_scope_close(scope);
     }
     if(node != 0)
     {
       map = node->locals_map;
     }
   }
+  dbgi_scope_close(scope);
+  scratch_end(scratch);
   ProfEnd();
   return map;
 }
@@ -6435,6 +6692,7 @@ df_core_init(String8 user_path, String8 profile_path, DF_StateDeltaHistory *hist
   df_state->tls_base_cache.arena = arena_alloc();
   df_state->locals_cache.arena = arena_alloc();
   df_state->member_cache.arena = arena_alloc();
+  df_state->eval_compile_cache.arena = arena_alloc();
   
   // rjf: set up eval view cache
   df_state->eval_view_cache.slots_count = 4096;
@@ -6928,24 +7186,31 @@ df_core_begin_frame(Arena *arena, DF_CmdList *cmds, F32 dt)
       df_state->tls_base_cache_memgen_idx = new_memgen_idx;
     }
     
-    //- rjf: clear locals cache
-    if(df_state->locals_cache_reggen_idx != new_reggen_idx && !df_ctrl_targets_running())
+    //- clear locals/member caches once they have built up too many entries
+    // (these only depend on debug info, so they're kept across register changes)
     {
-      DF_RunLocalsCache *cache = &df_state->locals_cache;
-      arena_clear(cache->arena);
-      cache->table_size = 0;
-      cache->table = 0;
-      df_state->locals_cache_reggen_idx = new_reggen_idx;
+      DF_RunLocalsCache *caches[] = {&df_state->locals_cache, &df_state->member_cache};
+      for(U64 idx = 0; idx < ArrayCount(caches); idx += 1)
+      {
+        DF_RunLocalsCache *cache = caches[idx];
+        if(cache->node_count >= 4096)
+        {
+          arena_clear(cache->arena);
+          cache->table_size = 0;
+          cache->table = 0;
+          cache->node_count = 0;
+        }
+      }
     }
     
-    //- rjf: clear members cache
-    if(df_state->member_cache_reggen_idx != new_reggen_idx && !df_ctrl_targets_running())
+    //- clear compiled expression cache once it has built up too many stale entries
+    if(df_state->eval_compile_cache.node_count >= 16384)
     {
-      DF_RunLocalsCache *cache = &df_state->member_cache;
+      DF_EvalCompileCache *cache = &df_state->eval_compile_cache;
       arena_clear(cache->arena);
       cache->table_size = 0;
       cache->table = 0;
-      df_state->member_cache_reggen_idx = new_reggen_idx;
+      cache->node_count = 0;
     }
     
     scratch_end(scratch);
@@ -985,13 +985,17 @@ struct DF_RunTLSBaseCache
 };
 
 //- rjf: per-run locals cache
+//
+// NOTE: keyed by the scopes a voff falls in, rather than by voff, so
+// every voff within one scope shares one (immutable) map.
 
 typedef struct DF_RunLocalsCacheNode DF_RunLocalsCacheNode;
 struct DF_RunLocalsCacheNode
 {
   DF_RunLocalsCacheNode *hash_next;
   DF_Handle binary;
-  U64 voff;
+  U64 dbgi_gen;
+  EVAL_ScopeKey scope_key;
   EVAL_String2NumMap *locals_map;
 };
 
@@ -1008,6 +1012,57 @@ struct DF_RunLocalsCache
   Arena *arena;
   U64 table_size;
   DF_RunLocalsCacheSlot *table;
+  U64 node_count;
+};
+
+//- compiled expression cache
+
+typedef struct DF_EvalCompileCacheNode DF_EvalCompileCacheNode;
+struct DF_EvalCompileCacheNode
+{
+  DF_EvalCompileCacheNode *hash_next;
+  
+  // key
+  String8 string;
+  RADDBG_Parsed *rdbg;
+  U64 dbgi_gen;
+  Architecture arch;
+  Rng1U64 voff_range;
+  U64 macro_map_hash;
+  
+  // compiled expression
+  String8 bytecode;
+  EVAL_Program program;
+  EVAL_EvalMode mode;
+  TG_Key type_base_key;
+  TG_ConsType *type_cons_chain; // outermost first; re-made in each frame's graph on hit
+  U64 type_cons_chain_count;
+  EVAL_ErrorList errors;
+  B32 is_cast;
+};
+
+typedef struct DF_EvalCompileCacheSlot DF_EvalCompileCacheSlot;
+struct DF_EvalCompileCacheSlot
+{
+  DF_EvalCompileCacheNode *first;
+  DF_EvalCompileCacheNode *last;
+};
+
+typedef struct DF_EvalCompileCache DF_EvalCompileCache;
+struct DF_EvalCompileCache
+{
+  Arena *arena;
+  U64 table_size;
+  DF_EvalCompileCacheSlot *table;
+  U64 node_count;
+  U64 hit_count;
+  U64 miss_count;
+  
+  // last (rdbg, ip voff) -> name resolution voff range
+  RADDBG_Parsed *last_rdbg;
+  U64 last_dbgi_gen;
+  U64 last_voff;
+  Rng1U64 last_voff_range;
 };
 
 ////////////////////////////////
@@ -1139,11 +1194,12 @@ struct DF_State
   U64 tls_base_cache_reggen_idx;
   U64 tls_base_cache_memgen_idx;
   DF_RunTLSBaseCache tls_base_cache;
-  U64 locals_cache_reggen_idx;
   DF_RunLocalsCache locals_cache;
-  U64 member_cache_reggen_idx;
   DF_RunLocalsCache member_cache;
   
+  // compiled expression cache
+  DF_EvalCompileCache eval_compile_cache;
+  
   // rjf: eval view cache
   DF_EvalViewCache eval_view_cache;
   
@@ -1530,6 +1586,7 @@ internal String8 df_symbol_name_from_process_vaddr(Arena *arena, DF_Entity *proc
 internal DF_TextLineSrc2DasmInfoListArray df_text_line_src2dasm_info_list_array_from_src_line_range(Arena *arena, DF_Entity *file, Rng1S64 line_num_range);
 
 //- rjf: voff -> src lookups
+internal void df_text_line_dasm2src_infos_from_binary_voffs(DF_Entity *binary, U64 *voffs, U64 count, DF_TextLineDasm2SrcInfo *infos_out);
 internal DF_TextLineDasm2SrcInfo df_text_line_dasm2src_info_from_binary_voff(DF_Entity *binary, U64 voff);
 internal DF_TextLineDasm2SrcInfoList df_text_line_dasm2src_info_from_voff(Arena *arena, U64 voff);
 
@@ -1564,6 +1621,10 @@ internal DF_Entity *df_log_from_entity(DF_Entity *entity);
 //- rjf: control message dispatching
 internal void df_push_ctrl_msg(CTRL_Msg *msg);
 
+//- user breakpoint entity -> ctrl user breakpoints
+internal CTRL_UserBreakpointList df_ctrl_user_breakpoint_list_from_entity(Arena *arena, DF_Entity *user_bp);
+internal CTRL_UserBreakpointStats df_ctrl_user_breakpoint_stats_from_entity(DF_Entity *user_bp);
+
 //- rjf: control thread running
 internal void df_ctrl_run(DF_RunKind run, DF_Entity *run_thread, CTRL_TrapList *run_traps);
 
@@ -1576,6 +1637,7 @@ internal CTRL_Event df_ctrl_last_stop_event(void);
 internal B32 df_eval_memory_read(void *u, void *out, U64 addr, U64 size);
 internal EVAL_ParseCtx df_eval_parse_ctx_from_process_vaddr(DBGI_Scope *scope, DF_Entity *process, U64 vaddr);
 internal EVAL_ParseCtx df_eval_parse_ctx_from_src_loc(DBGI_Scope *scope, DF_Entity *file, TxtPt pt);
+internal DF_EvalCompileCacheNode *df_eval_compiled_from_string(EVAL_ParseCtx *parse_ctx, EVAL_String2ExprMap *macro_map, String8 string);
 internal DF_Eval df_eval_from_string(Arena *arena, DBGI_Scope *scope, DF_CtrlCtx *ctrl_ctx, EVAL_ParseCtx *parse_ctx, EVAL_String2ExprMap *macro_map, String8 string);
 internal DF_Eval df_value_mode_eval_from_eval(TG_Graph *graph, RADDBG_Parsed *rdbg, DF_CtrlCtx *ctrl_ctx, DF_Eval eval);
 internal DF_Eval df_dynamically_typed_eval_from_eval(TG_Graph *graph, RADDBG_Parsed *rdbg, DF_CtrlCtx *ctrl_ctx, DF_Eval eval);
@@ -3098,6 +3098,83 @@ df_window_update_and_render(Arena *arena, OS_EventList *events, DF_Window *ws, D
           }
         }
         
+        //- draw file change watching stats
+        {
+          FS_WatchStats fs_stats = fs_watch_stats();
+          TXTI_WatchStats txti_stats = txti_watch_stats();
+          ui_labelf("File Stream Watching:");
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Paths: %I64u watched, %I64u polled, %I64u invalidations",
+                      fs_stats.watched_path_count, fs_stats.polled_path_count, fs_stats.invalidation_count);
+          }
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("OS: %I64u watches, %I64u paths, %I64u events, %I64u overflows",
+                      fs_stats.os.watch_count, fs_stats.os.path_count, fs_stats.os.event_count, fs_stats.os.overflow_count);
+          }
+          ui_labelf("Text Buffer Watching:");
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Buffers: %I64u watched, %I64u polled, %I64u invalidations",
+                      txti_stats.watched_entity_count, txti_stats.polled_entity_count, txti_stats.invalidation_count);
+          }
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("OS: %I64u watches, %I64u paths, %I64u events, %I64u overflows",
+                      txti_stats.os.watch_count, txti_stats.os.path_count, txti_stats.os.event_count, txti_stats.os.overflow_count);
+          }
+        }
+        
+        //- draw hash store stats
+        {
+          HS_Stats stats = hs_stats();
+          ui_labelf("Hash Store:");
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Bytes: %I64u / %I64u budget, %I64u nodes",
+                      stats.byte_count, stats.byte_budget, stats.node_count);
+          }
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Lookups: %I64u hits, %I64u misses", stats.hit_count, stats.miss_count);
+          }
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Evictions: %I64u nodes, %I64u bytes, %I64u pressure passes",
+                      stats.evicted_count, stats.evicted_byte_count, stats.pressure_pass_count);
+          }
+          ui_set_next_pref_width(ui_children_sum(1));
+          ui_set_next_pref_height(ui_children_sum(1));
+          UI_Row
+          {
+            ui_spacer(ui_em(2.f, 1.f));
+            ui_labelf("Chunks: %I64u chunks, %I64u bytes, %I64u hashed, %I64u reused",
+                      stats.chunk_count, stats.chunk_byte_count, stats.chunk_hashed_byte_count, stats.chunk_reused_byte_count);
+          }
+        }
+        
         //- rjf: draw entity file tree
 #if 0
         DF_EntityRec rec = {0};
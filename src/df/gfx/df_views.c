@@ -954,6 +954,7 @@ df_eval_watch_view_build(DF_Window *ws, DF_Panel *panel, DF_View *view, DF_EvalW
     if(errors.count == 0)
     {
       eval_push_leaf_ident_exprs_from_expr__in_place(scratch.arena, &macro_map, parse.expr, &errors);
+      macro_map.content_hash = df_hash_from_seed_string(macro_map.content_hash, root_expr);
     }
   }
   
@@ -2880,7 +2881,6 @@ DF_VIEW_UI_FUNCTION_DEF(SymbolLister)
   DF_Entity *binary = df_binary_file_from_module(module);
   String8 exe_path = df_full_path_from_entity(scratch.arena, binary);
   String8 query = str8(view->query_buffer, view->query_string_size);
-  TG_Graph *graph = tg_graph_begin(bit_size_from_arch(df_architecture_from_entity(thread))/8, 256);
   
   //- rjf: grab state
   typedef struct DF_SymbolListerViewState DF_SymbolListerViewState;
@@ -2894,6 +2894,11 @@ DF_VIEW_UI_FUNCTION_DEF(SymbolLister)
   U128 fuzzy_search_key = {(U64)view, df_hash_from_string(str8_struct(&view))};
   DBGI_Parse *dbgi = dbgi_parse_from_exe_path(scope, exe_path, os_now_microseconds()+100);
   RADDBG_Parsed *rdbg = &dbgi->rdbg;
+  TG_Graph *graph = dbgi->type_graph;
+  if(graph == 0 || graph->address_size != bit_size_from_arch(df_architecture_from_entity(thread))/8)
+  {
+    graph = tg_graph_begin(bit_size_from_arch(df_architecture_from_entity(thread))/8, 256);
+  }
   B32 items_stale = 0;
   DBGI_FuzzySearchItemArray items = dbgi_fuzzy_search_items_from_key_exe_query(scope, fuzzy_search_key, exe_path, query, DBGI_FuzzySearchTarget_Procedures, os_now_microseconds()+100, &items_stale);
   if(items_stale)
@@ -6275,15 +6280,22 @@ DF_VIEW_UI_FUNCTION_DEF(Disassembly)
     {
       DF_Entity *module = df_module_from_process_vaddr(process, disasm_vaddr_rng.min);
       DF_Entity *binary = df_binary_file_from_module(module);
-      for(S64 line_num = visible_line_num_range.min; line_num < visible_line_num_range.max; line_num += 1)
+      U64 line_count = (visible_line_num_range.max > visible_line_num_range.min) ? (U64)(visible_line_num_range.max-visible_line_num_range.min) : 0;
+      U64 *voffs = push_array_no_zero(scratch.arena, U64, line_count);
+      DF_TextLineDasm2SrcInfo *infos = push_array_no_zero(scratch.arena, DF_TextLineDasm2SrcInfo, line_count);
+      for(U64 slice_idx = 0; slice_idx < line_count; slice_idx += 1)
       {
+        S64 line_num = visible_line_num_range.min + (S64)slice_idx;
         U64 vaddr = disasm_vaddr_rng.min + dasm_inst_array_off_from_idx(&insts, line_num-1);
-        U64 voff = df_voff_from_vaddr(module, vaddr);
-        U64 slice_idx = line_num-visible_line_num_range.min;
+        voffs[slice_idx] = df_voff_from_vaddr(module, vaddr);
+      }
+      df_text_line_dasm2src_infos_from_binary_voffs(binary, voffs, line_count, infos);
+      for(U64 slice_idx = 0; slice_idx < line_count; slice_idx += 1)
+      {
         DF_TextLineDasm2SrcInfoNode *dasm2src_n = push_array(scratch.arena, DF_TextLineDasm2SrcInfoNode, 1);
         SLLQueuePush(code_slice_params.line_dasm2src[slice_idx].first, code_slice_params.line_dasm2src[slice_idx].last, dasm2src_n);
         code_slice_params.line_dasm2src[slice_idx].count += 1;
-        dasm2src_n->v = df_text_line_dasm2src_info_from_binary_voff(binary, voff);
+        dasm2src_n->v = infos[slice_idx];
       }
     }
   }
@@ -8466,6 +8478,18 @@ DF_VIEW_UI_FUNCTION_DEF(Breakpoints)
             UI_Font(df_font_from_slot(DF_FontSlot_Code)) df_code_label(1.f, 1, df_rgba_from_theme_color(DF_ThemeColor_CodeDefault), hit_count_string);
           }
           UI_Signal sig = ui_signal_from_box(box);
+          if(sig.hovering)
+          {
+            CTRL_UserBreakpointStats stats = df_ctrl_user_breakpoint_stats_from_entity(entity);
+            if(stats.condition_eval_count != 0) UI_Tooltip
+            {
+              ui_labelf("Condition evaluations: %I64u", stats.condition_eval_count);
+              ui_labelf("Filtered out: %I64u", stats.condition_filtered_count);
+              ui_labelf("Compilations: %I64u", stats.condition_compile_count);
+              ui_labelf("Total evaluation time: %I64u us", stats.condition_eval_us);
+              ui_labelf("Average evaluation time: %.2f us", (F64)stats.condition_eval_us/(F64)stats.condition_eval_count);
+            }
+          }
           if(sig.pressed)
           {
             next_cursor = v2s64(3, (S64)(idx));
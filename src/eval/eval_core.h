@@ -182,6 +182,7 @@ struct EVAL_String2ExprMap
 {
   U64 slots_count;
   EVAL_String2ExprMapSlot *slots;
+  U64 content_hash; // identifies the source text the map was built from, for caching compiled exprs
 };
 
 ////////////////////////////////
@@ -4,621 +4,825 @@
 ////////////////////////////////
 //~ allen: Eval Machine Functions
 
+internal EVAL_Program
+eval_program_from_bytecode(Arena *arena, String8 bytecode){
+  ProfBeginFunction();
+  EVAL_Program program = {0};
+  if (bytecode.size != 0){
+    // decode linearly; at most one instruction per byte, plus End & Bad
+    U64 inst_cap = bytecode.size + 2;
+    
+    // location & condition bytecode is a handful of bytes, so its working
+    // arrays live on the stack; only long programs go to scratch
+    EVAL_Inst local_insts[66];
+    U64 local_next_off_from_idx[66];
+    U32 local_idx_from_off[64];
+    B8 local_is_jump_target[66];
+    S64 local_depth_from_idx[66];
+    EVAL_Inst *insts = local_insts;
+    U64 *next_off_from_idx = local_next_off_from_idx;
+    U32 *idx_from_off = local_idx_from_off;
+    B8 *is_jump_target = local_is_jump_target;
+    S64 *depth_from_idx = local_depth_from_idx;
+    Temp scratch = {0};
+    if (inst_cap > ArrayCount(local_insts)){
+      scratch = scratch_begin(&arena, 1);
+      insts = push_array_no_zero(scratch.arena, EVAL_Inst, inst_cap);
+      next_off_from_idx = push_array_no_zero(scratch.arena, U64, inst_cap);
+      idx_from_off = push_array_no_zero(scratch.arena, U32, bytecode.size);
+      is_jump_target = push_array_no_zero(scratch.arena, B8, inst_cap);
+      depth_from_idx = push_array_no_zero(scratch.arena, S64, inst_cap);
+    }
+    MemorySet(idx_from_off, 0xff, sizeof(U32)*bytecode.size);
+    
+    U64 count = 0;
+    for (U64 off = 0; off < bytecode.size;){
+      EVAL_Inst *inst = &insts[count];
+      MemoryZeroStruct(inst);
+      idx_from_off[off] = (U32)count;
+      count += 1;
+      
+      // opcodes that can't be decoded stop the program when reached
+      RADDBG_EvalOp op = bytecode.str[off];
+      if (op >= RADDBG_EvalOp_COUNT){
+        inst->kind = EVAL_InstKind_Bad;
+        off += 1;
+        next_off_from_idx[count - 1] = off;
+        continue;
+      }
+      U8 ctrlbits = raddbg_eval_opcode_ctrlbits[op];
+      U32 decode_size = RADDBG_DECODEN_FROM_CTRLBITS(ctrlbits);
+      U8 *ptr = bytecode.str + off + 1;
+      if (off + 1 + decode_size > bytecode.size){
+        inst->kind = EVAL_InstKind_Bad;
+        break;
+      }
+      U64 imm = 0;
+      switch (decode_size){
+        case 1: imm = *ptr; break;
+        case 2: imm = *(U16*)ptr; break;
+        case 4: imm = *(U32*)ptr; break;
+        case 8: imm = *(U64*)ptr; break;
+      }
+      inst->kind = (EVAL_InstKind)op;
+      inst->imm = imm;
+      off += 1 + decode_size;
+      next_off_from_idx[count - 1] = off;
+    }
+    U64 end_idx = count;
+    MemoryZeroStruct(&insts[count]);
+    insts[count].kind = EVAL_InstKind_End;
+    count += 1;
+    U64 bad_idx = count;
+    MemoryZeroStruct(&insts[count]);
+    insts[count].kind = EVAL_InstKind_Bad;
+    count += 1;
+    
+    // resolve jumps; jumps are forward only (unsigned immediates), past the
+    // end of the bytecode finishes, and into the middle of an instruction is bad
+    MemoryZero(is_jump_target, sizeof(B8)*count);
+    for (U64 idx = 0; idx < end_idx; idx += 1){
+      EVAL_Inst *inst = &insts[idx];
+      if (inst->kind == EVAL_InstKind_Cond || inst->kind == EVAL_InstKind_Skip){
+        U64 target_off = next_off_from_idx[idx] + inst->imm;
+        U64 target_idx = bad_idx;
+        if (target_off >= bytecode.size){
+          target_idx = end_idx;
+        }
+        else if (idx_from_off[target_off] != max_U32){
+          target_idx = idx_from_off[target_off];
+        }
+        inst->aux = (U32)target_idx;
+        is_jump_target[target_idx] = 1;
+      }
+    }
+    
+    // maximum stack depth; with only forward jumps, one pass in order sees
+    // every incoming edge of an instruction before the instruction itself
+    for (U64 idx = 0; idx < count; idx += 1){
+      depth_from_idx[idx] = -1;
+    }
+    depth_from_idx[0] = 0;
+    U64 max_depth = 0;
+    for (U64 idx = 0; idx < end_idx; idx += 1){
+      EVAL_Inst *inst = &insts[idx];
+      S64 depth = depth_from_idx[idx];
+      if (depth < 0 || inst->kind >= RADDBG_EvalOp_COUNT){
+        continue;
+      }
+      U8 ctrlbits = raddbg_eval_opcode_ctrlbits[inst->kind];
+      S64 pop_count = RADDBG_POPN_FROM_CTRLBITS(ctrlbits);
+      S64 push_count = RADDBG_PUSHN_FROM_CTRLBITS(ctrlbits);
+      if (depth < pop_count){
+        continue;
+      }
+      S64 next_depth = depth - pop_count + push_count;
+      max_depth = Max(max_depth, (U64)next_depth);
+      if (inst->kind == EVAL_InstKind_Cond || inst->kind == EVAL_InstKind_Skip){
+        depth_from_idx[inst->aux] = Max(depth_from_idx[inst->aux], next_depth);
+      }
+      if (inst->kind != EVAL_InstKind_Stop && inst->kind != EVAL_InstKind_Skip){
+        depth_from_idx[idx + 1] = Max(depth_from_idx[idx + 1], next_depth);
+      }
+    }
+    
+    // fuse reads of statically-offset addresses into one instruction; the
+    // fused instruction steps over the read it absorbed
+    for (U64 idx = 0; idx + 1 < end_idx; idx += 1){
+      EVAL_Inst *inst = &insts[idx];
+      EVAL_Inst *next = &insts[idx + 1];
+      if (next->kind == EVAL_InstKind_MemRead && !is_jump_target[idx + 1]){
+        if (inst->kind == EVAL_InstKind_FrameOff){
+          inst->kind = EVAL_InstKind_FrameOffMemRead;
+          inst->aux = (U32)next->imm;
+        }
+        else if (inst->kind == EVAL_InstKind_ModuleOff){
+          inst->kind = EVAL_InstKind_ModuleOffMemRead;
+          inst->aux = (U32)next->imm;
+        }
+      }
+    }
+    
+    program.insts = push_array_no_zero(arena, EVAL_Inst, count);
+    MemoryCopy(program.insts, insts, sizeof(EVAL_Inst)*count);
+    program.count = count;
+    program.max_stack_depth = max_depth;
+    if (scratch.arena != 0){
+      scratch_end(scratch);
+    }
+  }
+  ProfEnd();
+  return(program);
+}
+
+#if COMPILER_CLANG || COMPILER_GCC
+# define EVAL_INTERPRET_COMPUTED_GOTO 1
+#else
+# define EVAL_INTERPRET_COMPUTED_GOTO 0
+#endif
+
 internal EVAL_Result
-eval_interpret(EVAL_Machine *machine, String8 bytecode){
+eval_interpret_program(EVAL_Machine *machine, EVAL_Program *program){
   ProfBeginFunction();
   EVAL_Result result = {0};
   
-  // TODO(allen): We could scan the bytecode and figure out the
-  // maximum depth of the stack
-  Temp scratch = scratch_begin(0, 0);
-  U64 stack_cap = 128;
-  EVAL_Slot *stack = push_array_no_zero(scratch.arena, EVAL_Slot, stack_cap);
+  // the program knows its maximum stack depth, so pushes never need checks
+  EVAL_Slot local_stack[16];
+  EVAL_Slot *stack = local_stack;
+  Temp scratch = {0};
+  if (program->max_stack_depth > ArrayCount(local_stack)){
+    scratch = scratch_begin(0, 0);
+    stack = push_array_no_zero(scratch.arena, EVAL_Slot, program->max_stack_depth);
+  }
   
   U64 stack_count = 0;
-  U8 *ptr = bytecode.str;
-  U8 *opl = bytecode.str + bytecode.size;
+  EVAL_Inst *insts = program->insts;
+  EVAL_Inst *inst = insts;
+  EVAL_Slot *svals = 0;
+  EVAL_Slot nval = {0};
+  if (program->count == 0){
+    goto bad;
+  }
+  
+#if EVAL_INTERPRET_COMPUTED_GOTO
+  static void *op_table[EVAL_InstKind_COUNT] = {
+#define X(N,dec,pop,push) &&op_##N,
+    RADDBG_EvalOpXList(X)
+#undef X
+    &&op_FrameOffMemRead,
+    &&op_ModuleOffMemRead,
+    &&op_End,
+    &&op_Bad,
+  };
+# define EVAL_Op(N) op_##N
+# define EVAL_Dispatch() goto *op_table[inst->kind]
+#else
+# define EVAL_Op(N) case EVAL_InstKind_##N
+# define EVAL_Dispatch() goto dispatch
+#endif
+  
+  // nval is zero at the start of every instruction
+#define EVAL_Pop(n) do{ if (stack_count < (n)){ goto bad; } stack_count -= (n); svals = stack + stack_count; }while(0)
+#define EVAL_PushNext() do{ stack[stack_count] = nval; stack_count += 1; MemoryZeroStruct(&nval); inst += 1; EVAL_Dispatch(); }while(0)
+#define EVAL_Next() do{ inst += 1; EVAL_Dispatch(); }while(0)
   
-  for (;ptr < opl;){
-    // consume opcode
-    RADDBG_EvalOp op = (RADDBG_EvalOp)*ptr;
-    if (op >= RADDBG_EvalOp_COUNT){
-      result.bad_eval = 1;
+#if EVAL_INTERPRET_COMPUTED_GOTO
+  EVAL_Dispatch();
+  {
+#else
+  dispatch:;
+  switch (inst->kind){
+    default: goto bad;
+#endif
+    
+    EVAL_Op(Stop):
+    EVAL_Op(End):
+    {
       goto done;
     }
-    U8 ctrlbits = raddbg_eval_opcode_ctrlbits[op];
-    ptr += 1;
     
-    // decode
-    U64 imm = 0;
+    EVAL_Op(Bad):
     {
-      U32 decode_size = RADDBG_DECODEN_FROM_CTRLBITS(ctrlbits);
-      U8 *next_ptr = ptr + decode_size;
-      if (next_ptr > opl){
-        result.bad_eval = 1;
-        goto done;
-      }
-      // TODO(allen): to improve this:
-      //  gaurantee 8 bytes padding after the end of serialized bytecode
-      //  read 8 bytes and mask
-      switch (decode_size){
-        case 1: imm = *ptr; break;
-        case 2: imm = *(U16*)ptr; break;
-        case 4: imm = *(U32*)ptr; break;
-        case 8: imm = *(U64*)ptr; break;
+      goto bad;
+    }
+    
+    EVAL_Op(Noop):
+    EVAL_Op(ObjectOff):
+    EVAL_Op(CFA):
+    {
+      EVAL_Next();
+    }
+    
+    EVAL_Op(Cond):
+    {
+      EVAL_Pop(1);
+      if (svals[0].u64){
+        inst = insts + inst->aux;
+      }
+      else{
+        inst += 1;
+      }
+      EVAL_Dispatch();
+    }
+    
+    EVAL_Op(Skip):
+    {
+      inst = insts + inst->aux;
+      EVAL_Dispatch();
+    }
+    
+    EVAL_Op(MemRead):
+    {
+      EVAL_Pop(1);
+      U64 addr = svals[0].u64;
+      U64 size = inst->imm;
+      if (machine->memory_read == 0 ||
+          !machine->memory_read(machine->u, &nval, addr, size)){
+        goto bad;
       }
-      ptr = next_ptr;
+      EVAL_PushNext();
     }
     
-    // pop
-    EVAL_Slot *svals = 0;
+    EVAL_Op(FrameOffMemRead):
     {
-      U32 pop_count = RADDBG_POPN_FROM_CTRLBITS(ctrlbits);
-      if (pop_count > stack_count){
-        result.bad_eval = 1;
-        goto done;
+      if (machine->frame_base == 0){
+        goto bad;
       }
-      if (pop_count <= stack_count){
-        stack_count -= pop_count;
-        svals = stack + stack_count;
+      U64 addr = *machine->frame_base + inst->imm;
+      if (machine->memory_read == 0 ||
+          !machine->memory_read(machine->u, &nval, addr, inst->aux)){
+        goto bad;
       }
+      inst += 1;
+      EVAL_PushNext();
     }
     
-    // interpret
-    EVAL_Slot nval = {0};
-    switch (op){
-      case RADDBG_EvalOp_Stop:
-      {
-        goto done;
-      }break;
-      
-      case RADDBG_EvalOp_Noop:
-      {
-        // do nothing
-      }break;
-      
-      case RADDBG_EvalOp_Cond:
-      {
-        if (svals[0].u64){
-          ptr += imm;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Skip:
-      {
-        ptr += imm;
-      }break;
-      
-      case RADDBG_EvalOp_MemRead:
-      {
-        U64 addr = svals[0].u64;
-        U64 size = imm;
-        B32 good_read = 0;
-        if (machine->memory_read != 0 &&
-            machine->memory_read(machine->u, &nval, addr, size)){
-          good_read = 1;
-        }
-        if (!good_read){
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_RegRead:
-      {
-        U8 raddbg_reg_code = (imm&0x0000FF)>>0;
-        U8 byte_size       = (imm&0x00FF00)>>8;
-        U8 byte_off        = (imm&0xFF0000)>>16;
-        REGS_RegCode base_reg_code = regs_reg_code_from_arch_raddbg_code(machine->arch, raddbg_reg_code);
-        REGS_Rng rng = regs_reg_code_rng_table_from_architecture(machine->arch)[base_reg_code];
-        U64 off = (U64)rng.byte_off + byte_off;
-        U64 size = (U64)byte_size;
-        if (off + size <= machine->reg_size){
-          MemoryCopy(&nval, (U8*)machine->reg_data + off, size);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_RegReadDyn:
-      {
-        U64 off  = svals[0].u64;
-        U64 size = bit_size_from_arch(machine->arch)/8;
-        if (off + size <= machine->reg_size){
-          MemoryCopy(&nval, (U8*)machine->reg_data + off, size);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_FrameOff:
-      {
-        if (machine->frame_base != 0){
-          nval.u64 = *machine->frame_base + imm;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_ModuleOff:
-      {
-        if (machine->module_base != 0){
-          nval.u64 = *machine->module_base + imm;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_TLSOff:
-      {
-        if (machine->tls_base != 0){
-          nval.u64 = *machine->tls_base + imm;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_ConstU8:
-      case RADDBG_EvalOp_ConstU16:
-      case RADDBG_EvalOp_ConstU32:
-      case RADDBG_EvalOp_ConstU64:
-      {
-        nval.u64 = imm;
-      }break;
-      
-      case RADDBG_EvalOp_Abs:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.f32 = svals[0].f32;
-          if (svals[0].f32 < 0){
-            nval.f32 = -svals[0].f32;
-          }
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.f64 = svals[0].f64;
-          if (svals[0].f64 < 0){
-            nval.f64 = -svals[0].f64;
-          }
-        }
-        else{
-          nval.s64 = svals[0].s64;
-          if (svals[0].s64 < 0){
-            nval.s64 = -svals[0].s64;
-          }
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Neg:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
+    EVAL_Op(ModuleOffMemRead):
+    {
+      if (machine->module_base == 0){
+        goto bad;
+      }
+      U64 addr = *machine->module_base + inst->imm;
+      if (machine->memory_read == 0 ||
+          !machine->memory_read(machine->u, &nval, addr, inst->aux)){
+        goto bad;
+      }
+      inst += 1;
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(RegRead):
+    {
+      U8 raddbg_reg_code = (inst->imm&0x0000FF)>>0;
+      U8 byte_size       = (inst->imm&0x00FF00)>>8;
+      U8 byte_off        = (inst->imm&0xFF0000)>>16;
+      REGS_RegCode base_reg_code = regs_reg_code_from_arch_raddbg_code(machine->arch, raddbg_reg_code);
+      REGS_Rng rng = regs_reg_code_rng_table_from_architecture(machine->arch)[base_reg_code];
+      U64 off = (U64)rng.byte_off + byte_off;
+      U64 size = (U64)byte_size;
+      if (off + size > machine->reg_size){
+        goto bad;
+      }
+      MemoryCopy(&nval, (U8*)machine->reg_data + off, size);
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(RegReadDyn):
+    {
+      EVAL_Pop(1);
+      U64 off  = svals[0].u64;
+      U64 size = bit_size_from_arch(machine->arch)/8;
+      if (off > machine->reg_size || size > machine->reg_size - off){
+        goto bad;
+      }
+      MemoryCopy(&nval, (U8*)machine->reg_data + off, size);
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(FrameOff):
+    {
+      if (machine->frame_base == 0){
+        goto bad;
+      }
+      nval.u64 = *machine->frame_base + inst->imm;
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(ModuleOff):
+    {
+      if (machine->module_base == 0){
+        goto bad;
+      }
+      nval.u64 = *machine->module_base + inst->imm;
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(TLSOff):
+    {
+      if (machine->tls_base == 0){
+        goto bad;
+      }
+      nval.u64 = *machine->tls_base + inst->imm;
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(ConstU8):
+    EVAL_Op(ConstU16):
+    EVAL_Op(ConstU32):
+    EVAL_Op(ConstU64):
+    {
+      nval.u64 = inst->imm;
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Abs):
+    {
+      EVAL_Pop(1);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.f32 = svals[0].f32;
+        if (svals[0].f32 < 0){
           nval.f32 = -svals[0].f32;
         }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.f64 = svals[0].f64;
+        if (svals[0].f64 < 0){
           nval.f64 = -svals[0].f64;
         }
-        else{
-          nval.u64 = (~svals[0].u64) + 1;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Add:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.f32 = svals[0].f32 + svals[1].f32;
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.f64 = svals[0].f64 + svals[1].f64;
-        }
-        else{
-          nval.u64 = svals[0].u64 + svals[1].u64;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Sub:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.f32 = svals[0].f32 - svals[1].f32;
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.f64 = svals[0].f64 - svals[1].f64;
-        }
-        else{
-          nval.u64 = svals[0].u64 - svals[1].u64;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Mul:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.f32 = svals[0].f32*svals[1].f32;
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.f64 = svals[0].f64*svals[1].f64;
-        }
-        else{
-          nval.u64 = svals[0].u64*svals[1].u64;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Div:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          if (svals[1].f32 != 0.f){
-            nval.f32 = svals[0].f32/svals[1].f32;
-          }
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          if (svals[1].f64 != 0.){
-            nval.f64 = svals[0].f64/svals[1].f64;
-          }
-        }
-        else if (imm == RADDBG_EvalTypeGroup_U ||
-                 imm == RADDBG_EvalTypeGroup_S){
-          if (svals[1].u64 != 0){
-            nval.u64 = svals[0].u64/svals[1].u64;
-          }
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Mod:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          if (svals[1].u64 != 0){
-            nval.u64 = svals[0].u64%svals[1].u64;
-          }
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_LShift:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = svals[0].u64 << svals[1].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_RShift:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U){
-          nval.u64 = svals[0].u64 >> svals[1].u64;
-        }
-        else if (imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = svals[0].s64 >> svals[1].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_BitAnd:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = svals[0].u64&svals[1].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_BitOr:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = svals[0].u64|svals[1].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_BitXor:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = svals[0].u64^svals[1].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_BitNot:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = ~svals[0].u64;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_LogAnd:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].u64 && svals[1].u64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_LogOr:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].u64 || svals[1].u64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_LogNot:
-      {
-        if (imm == RADDBG_EvalTypeGroup_U ||
-            imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (!svals[0].u64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_EqEq:
-      {
-        nval.u64 = (svals[0].u64 == svals[1].u64);
-      }break;
-      
-      case RADDBG_EvalOp_NtEq:
-      {
-        nval.u64 = (svals[0].u64 != svals[1].u64);
-      }break;
-      
-      case RADDBG_EvalOp_LsEq:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.u64 = (svals[0].f32 <= svals[1].f32);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.u64 = (svals[0].f64 <= svals[1].f64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_U){
-          nval.u64 = (svals[0].u64 <= svals[1].u64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].s64 <= svals[1].s64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_GrEq:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.u64 = (svals[0].f32 >= svals[1].f32);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.u64 = (svals[0].f64 >= svals[1].f64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_U){
-          nval.u64 = (svals[0].u64 >= svals[1].u64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].s64 >= svals[1].s64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Less:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.u64 = (svals[0].f32 < svals[1].f32);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.u64 = (svals[0].f64 < svals[1].f64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_U){
-          nval.u64 = (svals[0].u64 < svals[1].u64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].s64 < svals[1].s64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
-        }
-      }break;
-      
-      case RADDBG_EvalOp_Grtr:
-      {
-        if (imm == RADDBG_EvalTypeGroup_F32){
-          nval.u64 = (svals[0].f32 > svals[1].f32);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_F64){
-          nval.u64 = (svals[0].f64 > svals[1].f64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_U){
-          nval.u64 = (svals[0].u64 > svals[1].u64);
-        }
-        else if (imm == RADDBG_EvalTypeGroup_S){
-          nval.u64 = (svals[0].s64 > svals[1].s64);
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
+      }
+      else{
+        nval.s64 = svals[0].s64;
+        if (svals[0].s64 < 0){
+          nval.s64 = -svals[0].s64;
         }
-      }break;
-      
-      case RADDBG_EvalOp_Trunc:
-      {
-        if (0 < imm){
-          U64 mask = 0;
-          if (imm < 64){
-            mask = max_U64 >> (64 - imm);
-          }
-          nval.u64 = svals[0].u64&mask;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Neg):
+    {
+      EVAL_Pop(1);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.f32 = -svals[0].f32;
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.f64 = -svals[0].f64;
+      }
+      else{
+        nval.u64 = (~svals[0].u64) + 1;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Add):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.f32 = svals[0].f32 + svals[1].f32;
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.f64 = svals[0].f64 + svals[1].f64;
+      }
+      else{
+        nval.u64 = svals[0].u64 + svals[1].u64;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Sub):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.f32 = svals[0].f32 - svals[1].f32;
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.f64 = svals[0].f64 - svals[1].f64;
+      }
+      else{
+        nval.u64 = svals[0].u64 - svals[1].u64;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Mul):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.f32 = svals[0].f32*svals[1].f32;
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.f64 = svals[0].f64*svals[1].f64;
+      }
+      else{
+        nval.u64 = svals[0].u64*svals[1].u64;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Div):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        if (svals[1].f32 != 0.f){
+          nval.f32 = svals[0].f32/svals[1].f32;
         }
-      }break;
-      
-      case RADDBG_EvalOp_TruncSigned:
-      {
-        if (0 < imm){
-          U64 mask = 0;
-          if (imm < 64){
-            mask = max_U64 >> (64 - imm);
-          }
-          U64 high = 0;
-          if (svals[0].u64 & (1 << (imm - 1))){
-            high = ~mask;
-          }
-          nval.u64 = high|(svals[0].u64&mask);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        if (svals[1].f64 != 0.){
+          nval.f64 = svals[0].f64/svals[1].f64;
         }
-      }break;
-      
-      case RADDBG_EvalOp_Convert:
-      {
-        U32 in = imm&0xFF;
-        U32 out = (imm >> 8)&0xFF;
-        if (in != out){
-          switch (in + out*RADDBG_EvalTypeGroup_COUNT){
-            case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_U*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.u64 = (U64)svals[0].f32;
-            }break;
-            case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_U*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.u64 = (U64)svals[0].f64;
-            }break;
-            
-            case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_S*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.s64 = (S64)svals[0].f32;
-            }break;
-            case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_S*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.s64 = (S64)svals[0].f64;
-            }break;
-            
-            case RADDBG_EvalTypeGroup_U + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f32 = (F32)svals[0].u64;
-            }break;
-            case RADDBG_EvalTypeGroup_S + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f32 = (F32)svals[0].s64;
-            }break;
-            case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f32 = (F32)svals[0].f64;
-            }break;
-            
-            case RADDBG_EvalTypeGroup_U + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f64 = (F64)svals[0].u64;
-            }break;
-            case RADDBG_EvalTypeGroup_S + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f64 = (F64)svals[0].s64;
-            }break;
-            case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
-            {
-              nval.f64 = (F64)svals[0].f32;
-            }break;
-          }
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_U ||
+               inst->imm == RADDBG_EvalTypeGroup_S){
+        if (svals[1].u64 != 0){
+          nval.u64 = svals[0].u64/svals[1].u64;
         }
-      }break;
-      
-      case RADDBG_EvalOp_Pick:
-      {
-        if (stack_count > imm){
-          nval = stack[stack_count - imm - 1];
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Mod):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        if (svals[1].u64 != 0){
+          nval.u64 = svals[0].u64%svals[1].u64;
         }
-        else{
-          result.bad_eval = 1;
-          goto done;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(LShift):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = svals[0].u64 << svals[1].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(RShift):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U){
+        nval.u64 = svals[0].u64 >> svals[1].u64;
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = svals[0].s64 >> svals[1].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(BitAnd):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = svals[0].u64&svals[1].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(BitOr):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = svals[0].u64|svals[1].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(BitXor):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = svals[0].u64^svals[1].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(BitNot):
+    {
+      EVAL_Pop(1);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = ~svals[0].u64;
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(LogAnd):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].u64 && svals[1].u64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(LogOr):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].u64 || svals[1].u64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(LogNot):
+    {
+      EVAL_Pop(1);
+      if (inst->imm == RADDBG_EvalTypeGroup_U ||
+          inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (!svals[0].u64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(EqEq):
+    {
+      EVAL_Pop(2);
+      nval.u64 = (svals[0].u64 == svals[1].u64);
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(NtEq):
+    {
+      EVAL_Pop(2);
+      nval.u64 = (svals[0].u64 != svals[1].u64);
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(LsEq):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.u64 = (svals[0].f32 <= svals[1].f32);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.u64 = (svals[0].f64 <= svals[1].f64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_U){
+        nval.u64 = (svals[0].u64 <= svals[1].u64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].s64 <= svals[1].s64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(GrEq):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.u64 = (svals[0].f32 >= svals[1].f32);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.u64 = (svals[0].f64 >= svals[1].f64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_U){
+        nval.u64 = (svals[0].u64 >= svals[1].u64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].s64 >= svals[1].s64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Less):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.u64 = (svals[0].f32 < svals[1].f32);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.u64 = (svals[0].f64 < svals[1].f64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_U){
+        nval.u64 = (svals[0].u64 < svals[1].u64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].s64 < svals[1].s64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Grtr):
+    {
+      EVAL_Pop(2);
+      if (inst->imm == RADDBG_EvalTypeGroup_F32){
+        nval.u64 = (svals[0].f32 > svals[1].f32);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_F64){
+        nval.u64 = (svals[0].f64 > svals[1].f64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_U){
+        nval.u64 = (svals[0].u64 > svals[1].u64);
+      }
+      else if (inst->imm == RADDBG_EvalTypeGroup_S){
+        nval.u64 = (svals[0].s64 > svals[1].s64);
+      }
+      else{
+        goto bad;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Trunc):
+    {
+      EVAL_Pop(1);
+      if (0 < inst->imm){
+        U64 mask = 0;
+        if (inst->imm < 64){
+          mask = max_U64 >> (64 - inst->imm);
         }
-      }break;
-      
-      case RADDBG_EvalOp_Pop:
-      {
-        // do nothing - the pop is handled by the control bits
-      }break;
-      
-      case RADDBG_EvalOp_Insert:
-      {
-        if (stack_count > imm){
-          if (imm > 0){
-            EVAL_Slot tval = stack[stack_count - 1];
-            EVAL_Slot *dst = stack + stack_count - 1 - imm;
-            EVAL_Slot *shift = dst + 1;
-            MemoryCopy(shift, dst, imm*sizeof(EVAL_Slot));
-            *dst = tval;
-          }
+        nval.u64 = svals[0].u64&mask;
+      }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(TruncSigned):
+    {
+      EVAL_Pop(1);
+      if (0 < inst->imm){
+        U64 mask = 0;
+        if (inst->imm < 64){
+          mask = max_U64 >> (64 - inst->imm);
         }
-        else{
-          result.bad_eval = 1;
-          goto done;
+        U64 high = 0;
+        if (svals[0].u64 & (1 << (inst->imm - 1))){
+          high = ~mask;
         }
-      }break;
+        nval.u64 = high|(svals[0].u64&mask);
+      }
+      EVAL_PushNext();
     }
     
-    // push
+    EVAL_Op(Convert):
     {
-      U64 push_count = RADDBG_PUSHN_FROM_CTRLBITS(ctrlbits);
-      if (push_count == 1){
-        if (stack_count < stack_cap){
-          stack[stack_count] = nval;
-          stack_count += 1;
-        }
-        else{
-          result.bad_eval = 1;
-          goto done;
+      EVAL_Pop(1);
+      U32 in = inst->imm&0xFF;
+      U32 out = (inst->imm >> 8)&0xFF;
+      if (in != out){
+        switch (in + out*RADDBG_EvalTypeGroup_COUNT){
+          case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_U*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.u64 = (U64)svals[0].f32;
+          }break;
+          case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_U*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.u64 = (U64)svals[0].f64;
+          }break;
+          
+          case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_S*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.s64 = (S64)svals[0].f32;
+          }break;
+          case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_S*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.s64 = (S64)svals[0].f64;
+          }break;
+          
+          case RADDBG_EvalTypeGroup_U + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f32 = (F32)svals[0].u64;
+          }break;
+          case RADDBG_EvalTypeGroup_S + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f32 = (F32)svals[0].s64;
+          }break;
+          case RADDBG_EvalTypeGroup_F64 + RADDBG_EvalTypeGroup_F32*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f32 = (F32)svals[0].f64;
+          }break;
+          
+          case RADDBG_EvalTypeGroup_U + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f64 = (F64)svals[0].u64;
+          }break;
+          case RADDBG_EvalTypeGroup_S + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f64 = (F64)svals[0].s64;
+          }break;
+          case RADDBG_EvalTypeGroup_F32 + RADDBG_EvalTypeGroup_F64*RADDBG_EvalTypeGroup_COUNT:
+          {
+            nval.f64 = (F64)svals[0].f32;
+          }break;
         }
       }
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Pick):
+    {
+      if (stack_count <= inst->imm){
+        goto bad;
+      }
+      nval = stack[stack_count - inst->imm - 1];
+      EVAL_PushNext();
+    }
+    
+    EVAL_Op(Pop):
+    {
+      EVAL_Pop(1);
+      EVAL_Next();
     }
     
+    EVAL_Op(Insert):
+    {
+      U64 imm = inst->imm;
+      if (stack_count <= imm){
+        goto bad;
+      }
+      if (imm > 0){
+        EVAL_Slot tval = stack[stack_count - 1];
+        EVAL_Slot *dst = stack + stack_count - 1 - imm;
+        EVAL_Slot *shift = dst + 1;
+        MemoryCopy(shift, dst, imm*sizeof(EVAL_Slot));
+        *dst = tval;
+      }
+      EVAL_Next();
+    }
   }
-  done:;
   
+#undef EVAL_Op
+#undef EVAL_Dispatch
+#undef EVAL_Pop
+#undef EVAL_PushNext
+#undef EVAL_Next
+  
+  bad:;
+  result.bad_eval = 1;
+  
+  done:;
   if (stack_count == 1){
     result.value = stack[0];
   }
@@ -626,7 +830,18 @@ eval_interpret(EVAL_Machine *machine, String8 bytecode){
     result.bad_eval = 1;
   }
   
-  scratch_end(scratch);
+  if (scratch.arena != 0){
+    scratch_end(scratch);
+  }
   ProfEnd();
   return(result);
-}
\ No newline at end of file
+}
+
+internal EVAL_Result
+eval_interpret(EVAL_Machine *machine, String8 bytecode){
+  Temp scratch = scratch_begin(0, 0);
+  EVAL_Program program = eval_program_from_bytecode(scratch.arena, bytecode);
+  EVAL_Result result = eval_interpret_program(machine, &program);
+  scratch_end(scratch);
+  return(result);
+}
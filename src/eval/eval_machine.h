@@ -37,9 +37,48 @@ struct EVAL_Result{
   B32 bad_eval;
 };
 
+////////////////////////////////
+//~ Eval Program Types
+
+// NOTE: Bytecode is pre-decoded into fixed-size instructions, with
+// immediates extracted, jumps resolved to instruction indices, and the
+// maximum stack depth known up front, so interpreting does no decoding or
+// bounds checks on pushes. Instruction kinds are the bytecode ops, followed
+// by fused and terminal instructions that only exist in decoded programs.
+
+typedef U16 EVAL_InstKind;
+typedef enum EVAL_InstKindEnum{
+#define X(N,dec,pop,push) EVAL_InstKind_##N = RADDBG_EvalOp_##N,
+  RADDBG_EvalOpXList(X)
+#undef X
+  
+  EVAL_InstKind_FrameOffMemRead = RADDBG_EvalOp_COUNT,
+  EVAL_InstKind_ModuleOffMemRead,
+  EVAL_InstKind_End,
+  EVAL_InstKind_Bad,
+  EVAL_InstKind_COUNT
+} EVAL_InstKindEnum;
+
+typedef struct EVAL_Inst EVAL_Inst;
+struct EVAL_Inst{
+  EVAL_InstKind kind;
+  U16 _pad;
+  U32 aux; // Cond/Skip: instruction index to jump to; fused reads: read size
+  U64 imm;
+};
+
+typedef struct EVAL_Program EVAL_Program;
+struct EVAL_Program{
+  EVAL_Inst *insts;
+  U64 count;
+  U64 max_stack_depth;
+};
+
 ////////////////////////////////
 //~ allen: Eval Machine Functions
 
+internal EVAL_Program eval_program_from_bytecode(Arena *arena, String8 bytecode);
+internal EVAL_Result eval_interpret_program(EVAL_Machine *machine, EVAL_Program *program);
 internal EVAL_Result eval_interpret(EVAL_Machine *machine, String8 bytecode);
 
 #endif //EVAL2_MACHINE_H
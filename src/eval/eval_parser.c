@@ -56,8 +56,31 @@ global read_only S64 eval_g_max_precedence = 15;
 ////////////////////////////////
 //~ rjf: Map Building Fast Paths
 
+internal EVAL_ScopeKey
+eval_scope_key_from_raddbg_voff(RADDBG_Parsed *rdbg, U64 voff)
+{
+  EVAL_ScopeKey key = {0};
+  if(rdbg->scope_vmap != 0 && rdbg->scopes != 0)
+  {
+    key.scope_idx = raddbg_vmap_idx_from_voff(rdbg->scope_vmap, rdbg->scope_vmap_count, voff);
+    key.prev_scope_idx = key.scope_idx;
+    if(voff > 0)
+    {
+      key.prev_scope_idx = raddbg_vmap_idx_from_voff(rdbg->scope_vmap, rdbg->scope_vmap_count, voff-1);
+    }
+  }
+  return key;
+}
+
+internal B32
+eval_scope_key_match(EVAL_ScopeKey a, EVAL_ScopeKey b)
+{
+  B32 result = (a.scope_idx == b.scope_idx && a.prev_scope_idx == b.prev_scope_idx);
+  return result;
+}
+
 internal EVAL_String2NumMap *
-eval_push_locals_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff)
+eval_push_locals_map_from_raddbg_scope_key(Arena *arena, RADDBG_Parsed *rdbg, EVAL_ScopeKey key)
 {
   Temp scratch = scratch_begin(&arena, 1);
   
@@ -71,23 +94,21 @@ eval_push_locals_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 vof
   Task *first_task = 0;
   Task *last_task = 0;
   
-  //- rjf: voff -> tightest scope
+  //- key -> tightest scope
   RADDBG_Scope *tightest_scope = 0;
   if(rdbg->scope_vmap != 0 && rdbg->scopes != 0)
   {
-    U64 scope_idx = raddbg_vmap_idx_from_voff(rdbg->scope_vmap, rdbg->scope_vmap_count, voff);
-    RADDBG_Scope *scope = &rdbg->scopes[scope_idx];
+    RADDBG_Scope *scope = &rdbg->scopes[key.scope_idx];
     Task *task = push_array(scratch.arena, Task, 1);
     task->scope = scope;
     SLLQueuePush(first_task, last_task, task);
     tightest_scope = scope;
   }
   
-  //- rjf: voff-1 -> scope
-  if(voff > 0 && rdbg->scope_vmap != 0 && rdbg->scopes != 0)
+  //- key -> scope at voff-1
+  if(rdbg->scope_vmap != 0 && rdbg->scopes != 0)
   {
-    U64 scope_idx = raddbg_vmap_idx_from_voff(rdbg->scope_vmap, rdbg->scope_vmap_count, voff-1);
-    RADDBG_Scope *scope = &rdbg->scopes[scope_idx];
+    RADDBG_Scope *scope = &rdbg->scopes[key.prev_scope_idx];
     if(scope != tightest_scope)
     {
       Task *task = push_array(scratch.arena, Task, 1);
@@ -136,14 +157,21 @@ eval_push_locals_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 vof
 }
 
 internal EVAL_String2NumMap *
-eval_push_member_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff)
+eval_push_locals_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff)
+{
+  EVAL_ScopeKey key = eval_scope_key_from_raddbg_voff(rdbg, voff);
+  EVAL_String2NumMap *map = eval_push_locals_map_from_raddbg_scope_key(arena, rdbg, key);
+  return map;
+}
+
+internal EVAL_String2NumMap *
+eval_push_member_map_from_raddbg_scope_key(Arena *arena, RADDBG_Parsed *rdbg, EVAL_ScopeKey key)
 {
-  //- rjf: voff -> tightest scope
+  //- key -> tightest scope
   RADDBG_Scope *tightest_scope = 0;
   if(rdbg->scope_vmap != 0 && rdbg->scopes != 0)
   {
-    U64 scope_idx = raddbg_vmap_idx_from_voff(rdbg->scope_vmap, rdbg->scope_vmap_count, voff);
-    tightest_scope = &rdbg->scopes[scope_idx];
+    tightest_scope = &rdbg->scopes[key.scope_idx];
   }
   
   //- rjf: tightest scope -> procedure
@@ -198,6 +226,78 @@ eval_push_member_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 vof
   return map;
 }
 
+internal EVAL_String2NumMap *
+eval_push_member_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff)
+{
+  EVAL_ScopeKey key = eval_scope_key_from_raddbg_voff(rdbg, voff);
+  EVAL_String2NumMap *map = eval_push_member_map_from_raddbg_scope_key(arena, rdbg, key);
+  return map;
+}
+
+internal Rng1U64
+eval_name_resolution_voff_range_from_raddbg_voff(RADDBG_Parsed *rdbg, U64 voff)
+{
+  Rng1U64 range = r1u64(voff, voff+1);
+  if(rdbg->scope_vmap != 0 && rdbg->scopes != 0 && rdbg->scope_vmap_count > 1 &&
+     rdbg->scope_vmap[0].voff <= voff && voff < rdbg->scope_vmap[rdbg->scope_vmap_count-1].voff)
+  {
+    //- voff -> vmap entry; the locals map also looks at voff-1, so the
+    // first voff of an entry only ever matches itself
+    U64 first = 0;
+    U64 opl = rdbg->scope_vmap_count-1;
+    for(;opl - first > 1;)
+    {
+      U64 mid = (first + opl)/2;
+      if(rdbg->scope_vmap[mid].voff <= voff)
+      {
+        first = mid;
+      }
+      else
+      {
+        opl = mid;
+      }
+    }
+    RADDBG_VMapEntry *entry = &rdbg->scope_vmap[first];
+    if(entry->voff < voff)
+    {
+      range = r1u64(entry->voff+1, (entry+1)->voff);
+    }
+    
+    //- narrow by every location block boundary of every local in the scope chain
+    for(U64 scope_idx = entry->idx, depth = 0;
+        0 < scope_idx && scope_idx < rdbg->scopes_count && depth < rdbg->scopes_count;
+        scope_idx = rdbg->scopes[scope_idx].parent_scope_idx, depth += 1)
+    {
+      RADDBG_Scope *scope = &rdbg->scopes[scope_idx];
+      U64 local_opl_idx = (U64)scope->local_first + scope->local_count;
+      for(U64 local_idx = scope->local_first; local_idx < local_opl_idx && local_idx < rdbg->locals_count; local_idx += 1)
+      {
+        RADDBG_Local *local_var = &rdbg->locals[local_idx];
+        for(U64 block_idx = local_var->location_first;
+            block_idx < local_var->location_opl && block_idx < rdbg->location_blocks_count;
+            block_idx += 1)
+        {
+          RADDBG_LocationBlock *block = &rdbg->location_blocks[block_idx];
+          if(voff < block->scope_off_first)
+          {
+            range.max = Min(range.max, block->scope_off_first);
+          }
+          else if(voff < block->scope_off_opl)
+          {
+            range.min = Max(range.min, block->scope_off_first);
+            range.max = Min(range.max, block->scope_off_opl);
+          }
+          else
+          {
+            range.min = Max(range.min, block->scope_off_opl);
+          }
+        }
+      }
+    }
+  }
+  return range;
+}
+
 ////////////////////////////////
 //~ rjf: Tokenization Functions
 
@@ -75,6 +75,19 @@ struct EVAL_ParseCtx
   EVAL_String2NumMap *member_map;
 };
 
+////////////////////////////////
+//~ Scope Key Types
+
+// NOTE: the locals & member maps for a voff depend only on the tightest
+// scopes at voff & voff-1, so maps can be shared by every voff in one scope.
+
+typedef struct EVAL_ScopeKey EVAL_ScopeKey;
+struct EVAL_ScopeKey
+{
+  U64 scope_idx;
+  U64 prev_scope_idx;
+};
+
 ////////////////////////////////
 //~ rjf: Globals
 
@@ -85,8 +98,13 @@ global read_only EVAL_ParseResult eval_parse_result_nil = {0, &eval_expr_nil};
 ////////////////////////////////
 //~ rjf: Debug-Info-Driven Map Building Fast Paths
 
+internal EVAL_ScopeKey eval_scope_key_from_raddbg_voff(RADDBG_Parsed *rdbg, U64 voff);
+internal B32 eval_scope_key_match(EVAL_ScopeKey a, EVAL_ScopeKey b);
+internal EVAL_String2NumMap *eval_push_locals_map_from_raddbg_scope_key(Arena *arena, RADDBG_Parsed *rdbg, EVAL_ScopeKey key);
+internal EVAL_String2NumMap *eval_push_member_map_from_raddbg_scope_key(Arena *arena, RADDBG_Parsed *rdbg, EVAL_ScopeKey key);
 internal EVAL_String2NumMap *eval_push_locals_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff);
 internal EVAL_String2NumMap *eval_push_member_map_from_raddbg_voff(Arena *arena, RADDBG_Parsed *rdbg, U64 voff);
+internal Rng1U64 eval_name_resolution_voff_range_from_raddbg_voff(RADDBG_Parsed *rdbg, U64 voff);
 
 ////////////////////////////////
 //~ rjf: Tokenization Functions
@@ -0,0 +1,312 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Eval throughput over location & condition bytecode, comparing the
+// reference interpreter (eval_machine_reference.c, from before programs were
+// pre-decoded), eval_interpret (decode & run on every call), and
+// eval_interpret_program over programs decoded once - as the watch & the
+// breakpoint condition caches hold them. Decoding alone is timed too. Every
+// result must match the reference.
+//
+// --input takes a RADDBG file (e.g. from raddbg_from_pdb) and runs every
+// bytecode location in it. Without it, a synthetic set is built in the
+// shapes the PDB converter & the eval compiler emit:
+// * locals off a frame register: RegRead, signed constant, Add
+//   (pdbconv_location_from_addr_reg_off, cons_bytecode_push_sconst)
+// * the same with MemRead for parameters passed by reference
+// * breakpoint conditions: FrameOff/ModuleOff reads compared to constants,
+//   some joined with LogAnd
+//
+// usage: eval_machine_bench [--input:<file.raddbg>] [--programs:<n>]
+//                           [--evals:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_format/raddbg_format_parse.h"
+#include "regs/regs.h"
+#include "regs/raddbg/regs_raddbg.h"
+#include "eval/eval_machine.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_format/raddbg_format_parse.c"
+#include "regs/regs.c"
+#include "regs/raddbg/regs_raddbg.c"
+#include "eval/eval_machine.c"
+#include "eval/test/eval_machine_reference.c"
+
+////////////////////////////////
+//~ Types
+
+typedef enum EMB_Method{
+  EMB_Method_Reference,
+  EMB_Method_Interpret,
+  EMB_Method_Decode,
+  EMB_Method_Program,
+  EMB_Method_COUNT
+} EMB_Method;
+
+typedef struct EMB_Corpus{
+  String8 *bytecodes;
+  U64 count;
+  U64 byte_count;
+} EMB_Corpus;
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+emb_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+static B32
+emb_memory_read(void *u, void *out, U64 addr, U64 size){
+  U64 value = addr*0x9E3779B97F4A7C15ull;
+  MemoryCopy(out, &value, ClampTop(size, sizeof(value)));
+  return(1);
+}
+
+static U8*
+emb_push_op(U8 *ptr, RADDBG_EvalOp op, U64 imm){
+  U32 decode_size = RADDBG_DECODEN_FROM_CTRLBITS(raddbg_eval_opcode_ctrlbits[op]);
+  ptr[0] = (U8)op;
+  MemoryCopy(ptr + 1, &imm, decode_size);
+  return(ptr + 1 + decode_size);
+}
+
+static U8*
+emb_push_sconst(U8 *ptr, S64 x){
+  if (-0x80 <= x && x <= 0x7F){
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_ConstU8, (U64)x);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_TruncSigned, 8);
+  }
+  else if (-0x8000 <= x && x <= 0x7FFF){
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_ConstU16, (U64)x);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_TruncSigned, 16);
+  }
+  else{
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_ConstU32, (U64)x);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_TruncSigned, 32);
+  }
+  return(ptr);
+}
+
+//- synthetic corpus
+
+static String8
+emb_synthetic_bytecode(Arena *arena, U64 *rng){
+  U8 buffer[64];
+  U8 *ptr = buffer;
+  U64 kind = emb_rand(rng)%100;
+  
+  // locals & by-reference parameters off rbp/rsp
+  if (kind < 75){
+    U8 reg_code = (emb_rand(rng)%2) ? RADDBG_RegisterCode_X64_rbp : RADDBG_RegisterCode_X64_rsp;
+    S64 offset = -(S64)(8 + (emb_rand(rng)%4096)*8);
+    if (emb_rand(rng)%8 == 0){
+      offset -= 0x10000;
+    }
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_RegRead, RADDBG_EncodeRegReadParam(reg_code, 8, 0));
+    ptr = emb_push_sconst(ptr, offset);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_Add, 0);
+    if (kind >= 60){
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_MemRead, 8);
+    }
+  }
+  
+  // conditions: `local > k`, `global == k`, `local > k && ptr != 0`
+  else{
+    RADDBG_EvalOp compare_ops[] = {RADDBG_EvalOp_Grtr, RADDBG_EvalOp_EqEq, RADDBG_EvalOp_Less};
+    B32 is_global = (emb_rand(rng)%3 == 0);
+    ptr = emb_push_op(ptr, is_global ? RADDBG_EvalOp_ModuleOff : RADDBG_EvalOp_FrameOff, emb_rand(rng)%0x1000*8);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_MemRead, 4);
+    ptr = emb_push_op(ptr, RADDBG_EvalOp_ConstU32, emb_rand(rng)%1000);
+    ptr = emb_push_op(ptr, compare_ops[emb_rand(rng)%ArrayCount(compare_ops)], RADDBG_EvalTypeGroup_S);
+    if (kind >= 90){
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_FrameOff, emb_rand(rng)%0x1000*8);
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_MemRead, 8);
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_ConstU8, 0);
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_NtEq, RADDBG_EvalTypeGroup_U);
+      ptr = emb_push_op(ptr, RADDBG_EvalOp_LogAnd, 0);
+    }
+  }
+  
+  String8 result = push_str8_copy(arena, str8(buffer, (U64)(ptr - buffer)));
+  return(result);
+}
+
+//- bytecode locations from a RADDBG file
+
+static EMB_Corpus
+emb_corpus_from_raddbg(Arena *arena, String8 data){
+  EMB_Corpus result = {0};
+  RADDBG_Parsed rdbg = {0};
+  if (raddbg_parse(data.str, data.size, &rdbg) == RADDBG_ParseStatus_Good){
+    result.bytecodes = push_array(arena, String8, rdbg.location_blocks_count);
+    for (U64 i = 0; i < rdbg.location_blocks_count; i += 1){
+      U64 off = rdbg.location_blocks[i].location_data_off;
+      if (off >= rdbg.location_data_size){
+        continue;
+      }
+      RADDBG_LocationKind kind = rdbg.location_data[off];
+      if (kind != RADDBG_LocationKind_AddrBytecodeStream && kind != RADDBG_LocationKind_ValBytecodeStream){
+        continue;
+      }
+      
+      // bytecode runs up to a Stop op
+      U8 *first = rdbg.location_data + off + sizeof(RADDBG_LocationKind);
+      U8 *opl = rdbg.location_data + rdbg.location_data_size;
+      U8 *ptr = first;
+      for (;ptr < opl && *ptr != RADDBG_EvalOp_Stop;){
+        U8 op = *ptr;
+        ptr += 1 + ((op < RADDBG_EvalOp_COUNT) ? RADDBG_DECODEN_FROM_CTRLBITS(raddbg_eval_opcode_ctrlbits[op]) : 0);
+      }
+      ptr = ClampTop(ptr, opl);
+      result.bytecodes[result.count] = str8(first, (U64)(ptr - first));
+      result.byte_count += result.bytecodes[result.count].size;
+      result.count += 1;
+    }
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  String8 input_path = {0};
+  U64 program_count = 100000;
+  U64 eval_count = 4000000;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 programs_string = cmd_line_string(&cmd_line, str8_lit("programs"));
+    String8 evals_string = cmd_line_string(&cmd_line, str8_lit("evals"));
+    input_path = cmd_line_string(&cmd_line, str8_lit("input"));
+    if (programs_string.size != 0){
+      try_u64_from_str8_c_rules(programs_string, &program_count);
+    }
+    if (evals_string.size != 0){
+      try_u64_from_str8_c_rules(evals_string, &eval_count);
+    }
+    program_count = Max(program_count, 1);
+  }
+  
+  // corpus
+  EMB_Corpus corpus = {0};
+  if (input_path.size != 0){
+    OS_Handle file = os_file_open(OS_AccessFlag_Read|OS_AccessFlag_ShareRead, input_path);
+    FileProperties props = os_properties_from_file(file);
+    String8 data = str8(push_array_no_zero(scratch.arena, U8, props.size), props.size);
+    os_file_read(file, r1u64(0, props.size), data.str);
+    os_file_close(file);
+    corpus = emb_corpus_from_raddbg(scratch.arena, data);
+    if (corpus.count == 0){
+      printf("error: no bytecode locations in %.*s\n", str8_varg(input_path));
+      return(1);
+    }
+    printf("input: %.*s\n", str8_varg(input_path));
+  }
+  else{
+    U64 rng = 1;
+    corpus.bytecodes = push_array(scratch.arena, String8, program_count);
+    for (U64 i = 0; i < program_count; i += 1){
+      corpus.bytecodes[i] = emb_synthetic_bytecode(scratch.arena, &rng);
+      corpus.byte_count += corpus.bytecodes[i].size;
+    }
+    corpus.count = program_count;
+    printf("synthetic input\n");
+  }
+  U64 pass_count = Max(1, eval_count/corpus.count);
+  printf("%llu programs, %.1f bytes each on average, %llu passes\n",
+         (unsigned long long)corpus.count, (F64)corpus.byte_count/corpus.count,
+         (unsigned long long)pass_count);
+  
+  // machine
+  U8 regs[2048];
+  for (U64 i = 0; i < sizeof(regs); i += 1){
+    regs[i] = (U8)(i*31 + 7);
+  }
+  U64 frame_base = 0x7ff000;
+  U64 module_base = 0x140000000ull;
+  U64 tls_base = 0x5000;
+  EVAL_Machine machine = {0};
+  machine.arch = Architecture_x64;
+  machine.memory_read = emb_memory_read;
+  machine.reg_data = regs;
+  machine.reg_size = sizeof(regs);
+  machine.frame_base = &frame_base;
+  machine.module_base = &module_base;
+  machine.tls_base = &tls_base;
+  
+  // reference results & decoded programs
+  EVAL_Result *reference = push_array(scratch.arena, EVAL_Result, corpus.count);
+  EVAL_Program *programs = push_array(scratch.arena, EVAL_Program, corpus.count);
+  U64 good_count = 0;
+  for (U64 i = 0; i < corpus.count; i += 1){
+    reference[i] = eval_reference_interpret(&machine, corpus.bytecodes[i]);
+    programs[i] = eval_program_from_bytecode(scratch.arena, corpus.bytecodes[i]);
+    good_count += !reference[i].bad_eval;
+  }
+  printf("%llu of them evaluate\n", (unsigned long long)good_count);
+  
+  // time each method
+  char *method_names[] = {"reference", "eval_interpret", "decode only", "cached program"};
+  F64 ns_per_eval[EMB_Method_COUNT] = {0};
+  U64 mismatch_count = 0;
+  for (U64 method = 0; method < EMB_Method_COUNT; method += 1){
+    U64 check = 0;
+    U64 begin_us = os_now_microseconds();
+    for (U64 pass_idx = 0; pass_idx < pass_count; pass_idx += 1){
+      Temp temp = temp_begin(scratch.arena);
+      for (U64 i = 0; i < corpus.count; i += 1){
+        EVAL_Result result = {0};
+        switch ((EMB_Method)method){
+          case EMB_Method_Reference:{result = eval_reference_interpret(&machine, corpus.bytecodes[i]);}break;
+          case EMB_Method_Interpret:{result = eval_interpret(&machine, corpus.bytecodes[i]);}break;
+          case EMB_Method_Decode:{
+            EVAL_Program program = eval_program_from_bytecode(temp.arena, corpus.bytecodes[i]);
+            check += program.count;
+            continue;
+          }break;
+          case EMB_Method_Program:{result = eval_interpret_program(&machine, &programs[i]);}break;
+        }
+        check += result.value.u64;
+        if (pass_idx == 0 &&
+            (result.bad_eval != reference[i].bad_eval ||
+             !MemoryMatch(&result.value, &reference[i].value, sizeof(result.value)))){
+          mismatch_count += 1;
+        }
+      }
+      temp_end(temp);
+    }
+    U64 elapsed_us = os_now_microseconds() - begin_us;
+    ns_per_eval[method] = 1000.0*elapsed_us/(pass_count*corpus.count);
+    printf("%-15s %7.1fns per program, %7.2fM/s (check %llx)\n", method_names[method],
+           ns_per_eval[method], 1000.0/ns_per_eval[method], (unsigned long long)(check & 0xffff));
+  }
+  printf("eval_interpret / reference:  %.2fx\n", ns_per_eval[EMB_Method_Reference]/ns_per_eval[EMB_Method_Interpret]);
+  printf("cached program / reference:  %.2fx\n", ns_per_eval[EMB_Method_Reference]/ns_per_eval[EMB_Method_Program]);
+  
+  if (mismatch_count != 0){
+    printf("error: %llu results differ from the reference\n", (unsigned long long)mismatch_count);
+    return(1);
+  }
+  scratch_end(scratch);
+  return(0);
+}
@@ -0,0 +1,274 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Differential fuzzer for the eval machine: random bytecode programs are run
+// through the reference interpreter (eval_machine_reference.c, the one from
+// before pre-decoding), eval_interpret, and eval_interpret_program on a
+// decoded program, and every result (value & bad_eval) must match.
+//
+// Programs are mostly the ops locals & conditions compile to, with some of
+// any op, invalid opcodes, truncated immediates, missing bases & memory
+// callbacks, failing memory reads, and short register files mixed in. Cond
+// & Skip jump to instruction starts or past the end - jumps into the middle
+// of an instruction are bad evals in decoded programs, by design. RegReadDyn
+// is left out: the reference pushed the slot under the offset instead of
+// the register read, so it's checked directly instead.
+//
+// usage: eval_machine_fuzz [--iterations:<n>] [--seed:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "regs/regs.h"
+#include "regs/raddbg/regs_raddbg.h"
+#include "eval/eval_machine.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "regs/regs.c"
+#include "regs/raddbg/regs_raddbg.c"
+#include "eval/eval_machine.c"
+#include "eval/test/eval_machine_reference.c"
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+emf_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// fails on every 97th address, otherwise bytes are a function of the address
+static B32
+emf_memory_read(void *u, void *out, U64 addr, U64 size){
+  B32 result = 0;
+  if (addr%97 != 0){
+    U8 *out_bytes = (U8*)out;
+    for (U64 i = 0; i < size && i < sizeof(EVAL_Slot); i += 1){
+      out_bytes[i] = (U8)(((addr + i)*0x9E3779B97F4A7C15ull) >> 56);
+    }
+    result = 1;
+  }
+  return(result);
+}
+
+static U64
+emf_decode_size_from_op(U8 op){
+  U64 result = 0;
+  if (op < RADDBG_EvalOp_COUNT){
+    result = RADDBG_DECODEN_FROM_CTRLBITS(raddbg_eval_opcode_ctrlbits[op]);
+  }
+  return(result);
+}
+
+static B32
+emf_result_match(EVAL_Result a, EVAL_Result b){
+  B32 result = (a.bad_eval == b.bad_eval && MemoryMatch(&a.value, &b.value, sizeof(a.value)));
+  return(result);
+}
+
+static U8
+emf_random_op(U64 *rng, U64 *imm_out){
+  U64 r = emf_rand(rng)%100;
+  U8 op = (U8)(emf_rand(rng)%RADDBG_EvalOp_COUNT);
+  if (r < 2){
+    op = (U8)(RADDBG_EvalOp_COUNT + emf_rand(rng)%20);
+  }
+  else if (r < 40){
+    U8 common_ops[] = {
+      RADDBG_EvalOp_FrameOff, RADDBG_EvalOp_ModuleOff, RADDBG_EvalOp_MemRead,
+      RADDBG_EvalOp_ConstU8, RADDBG_EvalOp_ConstU32, RADDBG_EvalOp_Add,
+      RADDBG_EvalOp_RegRead, RADDBG_EvalOp_Cond, RADDBG_EvalOp_Skip,
+    };
+    op = common_ops[emf_rand(rng)%ArrayCount(common_ops)];
+  }
+  if (op == RADDBG_EvalOp_RegReadDyn){
+    op = RADDBG_EvalOp_Noop;
+  }
+  U64 imm = emf_rand(rng);
+  switch (op){
+    case RADDBG_EvalOp_MemRead:{imm = 1 + emf_rand(rng)%8;}break;
+    case RADDBG_EvalOp_Pick:
+    case RADDBG_EvalOp_Insert:{imm = emf_rand(rng)%4;}break;
+    case RADDBG_EvalOp_Trunc:
+    case RADDBG_EvalOp_TruncSigned:{imm = emf_rand(rng)%70;}break;
+    case RADDBG_EvalOp_RegRead:{
+      imm = RADDBG_EncodeRegReadParam(1 + emf_rand(rng)%16, 1 + emf_rand(rng)%8, emf_rand(rng)%4);
+    }break;
+    case RADDBG_EvalOp_Convert:{imm = (emf_rand(rng)%5) | ((emf_rand(rng)%5) << 8);}break;
+    case RADDBG_EvalOp_FrameOff:
+    case RADDBG_EvalOp_ModuleOff:
+    case RADDBG_EvalOp_TLSOff:{imm = emf_rand(rng)%4096;}break;
+    default:{
+      if (op >= RADDBG_EvalOp_Abs && emf_decode_size_from_op(op) == 1){
+        imm = emf_rand(rng)%6;
+      }
+    }break;
+  }
+  *imm_out = imm;
+  return(op);
+}
+
+static String8
+emf_random_bytecode(U64 *rng, U8 *buffer){
+  // pick ops & immediates; half of the programs only pick ops the stack
+  // can feed & end on one value, so they mostly evaluate
+  U8 ops[16];
+  U64 imms[16];
+  U64 op_count = 1 + emf_rand(rng)%12;
+  B32 balanced = (emf_rand(rng)%2 == 0);
+  U64 depth = 0;
+  for (U64 k = 0; k < op_count; k += 1){
+    U8 op = emf_random_op(rng, &imms[k]);
+    if (balanced){
+      for (U64 retry = 0; retry < 16 && op < RADDBG_EvalOp_COUNT &&
+           RADDBG_POPN_FROM_CTRLBITS(raddbg_eval_opcode_ctrlbits[op]) > depth; retry += 1){
+        op = emf_random_op(rng, &imms[k]);
+      }
+      if (op < RADDBG_EvalOp_COUNT){
+        U8 ctrlbits = raddbg_eval_opcode_ctrlbits[op];
+        depth = depth - ClampTop(RADDBG_POPN_FROM_CTRLBITS(ctrlbits), depth) + RADDBG_PUSHN_FROM_CTRLBITS(ctrlbits);
+      }
+    }
+    ops[k] = op;
+  }
+  if (balanced){
+    for (;depth != 1 && op_count < ArrayCount(ops);){
+      ops[op_count] = (depth == 0) ? RADDBG_EvalOp_ConstU8 : RADDBG_EvalOp_Add;
+      imms[op_count] = emf_rand(rng);
+      depth = (depth == 0) ? 1 : depth - 1;
+      op_count += 1;
+    }
+  }
+  
+  // lay out, then resolve jumps to instruction starts (or past the end)
+  U64 starts[17];
+  U64 size = 0;
+  for (U64 k = 0; k < op_count; k += 1){
+    starts[k] = size;
+    size += 1 + emf_decode_size_from_op(ops[k]);
+  }
+  starts[op_count] = size;
+  for (U64 k = 0; k < op_count; k += 1){
+    if (ops[k] == RADDBG_EvalOp_Cond || ops[k] == RADDBG_EvalOp_Skip){
+      U64 target_k = k + 1 + emf_rand(rng)%(op_count - k + 1);
+      U64 target = (target_k <= op_count) ? starts[target_k] : size + emf_rand(rng)%5;
+      imms[k] = ClampTop(target - starts[k + 1], 255);
+    }
+    buffer[starts[k]] = ops[k];
+    MemoryCopy(buffer + starts[k] + 1, &imms[k], emf_decode_size_from_op(ops[k]));
+  }
+  
+  // sometimes cut the last immediate short
+  if (emf_rand(rng)%8 == 0 && size > 1){
+    size -= 1;
+  }
+  
+  String8 result = str8(buffer, size);
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 iteration_count = 1000000;
+  U64 seed = 88172645463325252ull;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 iterations_string = cmd_line_string(&cmd_line, str8_lit("iterations"));
+    String8 seed_string = cmd_line_string(&cmd_line, str8_lit("seed"));
+    if (iterations_string.size != 0){
+      try_u64_from_str8_c_rules(iterations_string, &iteration_count);
+    }
+    if (seed_string.size != 0){
+      try_u64_from_str8_c_rules(seed_string, &seed);
+    }
+    seed = Max(seed, 1);
+  }
+  
+  // machine state
+  U8 regs[2048];
+  for (U64 i = 0; i < sizeof(regs); i += 1){
+    regs[i] = (U8)(i*31 + 7);
+  }
+  U64 frame_base = 0x7ff000;
+  U64 module_base = 0x140000000ull;
+  U64 tls_base = 0x5000;
+  U64 fail_count = 0;
+  
+  // RegReadDyn reads the register file at the popped offset
+  {
+    U8 bytecode[] = {RADDBG_EvalOp_ConstU8, 16, RADDBG_EvalOp_RegReadDyn};
+    EVAL_Machine machine = {0};
+    machine.arch = Architecture_x64;
+    machine.reg_data = regs;
+    machine.reg_size = sizeof(regs);
+    EVAL_Result result = eval_interpret(&machine, str8(bytecode, sizeof(bytecode)));
+    if (result.bad_eval || !MemoryMatch(&result.value.u64, regs + 16, 8)){
+      printf("error: RegReadDyn did not read the register file\n");
+      fail_count += 1;
+    }
+  }
+  
+  // random programs
+  U64 rng = seed;
+  U64 good_count = 0;
+  U64 mismatch_count = 0;
+  for (U64 iteration_idx = 0; iteration_idx < iteration_count; iteration_idx += 1){
+    Temp temp = temp_begin(scratch.arena);
+    U8 buffer[256];
+    String8 bytecode = emf_random_bytecode(&rng, buffer);
+    
+    EVAL_Machine machine = {0};
+    machine.arch = Architecture_x64;
+    machine.memory_read = (emf_rand(&rng)%16 != 0) ? emf_memory_read : 0;
+    machine.reg_data = regs;
+    machine.reg_size = (emf_rand(&rng)%8 != 0) ? sizeof(regs) : 16;
+    machine.frame_base = (emf_rand(&rng)%10 != 0) ? &frame_base : 0;
+    machine.module_base = (emf_rand(&rng)%10 != 0) ? &module_base : 0;
+    machine.tls_base = &tls_base;
+    
+    EVAL_Result reference = eval_reference_interpret(&machine, bytecode);
+    EVAL_Result interpreted = eval_interpret(&machine, bytecode);
+    EVAL_Program program = eval_program_from_bytecode(temp.arena, bytecode);
+    EVAL_Result from_program = eval_interpret_program(&machine, &program);
+    if (!emf_result_match(reference, interpreted) || !emf_result_match(reference, from_program)){
+      if (mismatch_count < 5){
+        printf("mismatch at iteration %llu, bad_eval %d/%d/%d, bytecode:",
+               (unsigned long long)iteration_idx, reference.bad_eval, interpreted.bad_eval, from_program.bad_eval);
+        for (U64 i = 0; i < bytecode.size; i += 1){
+          printf(" %02x", bytecode.str[i]);
+        }
+        printf("\n");
+      }
+      mismatch_count += 1;
+    }
+    good_count += !reference.bad_eval;
+    temp_end(temp);
+  }
+  printf("%llu programs (%llu evaluate, %llu bad evals), %llu mismatches\n",
+         (unsigned long long)iteration_count, (unsigned long long)good_count,
+         (unsigned long long)(iteration_count - good_count), (unsigned long long)mismatch_count);
+  fail_count += mismatch_count;
+  
+  if (fail_count != 0){
+    return(1);
+  }
+  scratch_end(scratch);
+  return(0);
+}
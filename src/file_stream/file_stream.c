@@ -25,11 +25,16 @@ fs_init(void)
   fs_shared->u2s_ring_cv = os_condition_variable_alloc();
   fs_shared->u2s_ring_mutex = os_mutex_alloc();
   fs_shared->streamer_count = Clamp(1, os_logical_core_count()-1, 4);
-  fs_shared->streamers = push_array(arena, OS_Handle, 1);
+  fs_shared->streamers = push_array(arena, OS_Handle, fs_shared->streamer_count);
   for(U64 idx = 0; idx < fs_shared->streamer_count; idx += 1)
   {
     fs_shared->streamers[idx] = os_launch_thread(fs_streamer_thread__entry_point, (void *)idx, 0);
   }
+  fs_shared->watcher = os_file_watcher_alloc();
+  if(!os_handle_match(fs_shared->watcher, os_handle_zero()))
+  {
+    fs_shared->watcher_thread = os_launch_thread(fs_watcher_thread__entry_point, 0, 0);
+  }
 }
 
 ////////////////////////////////
@@ -64,6 +69,8 @@ fs_hash_from_path(String8 path, U64 rewind_count, U64 endt_us)
         node = push_array(stripe->arena, FS_Node, 1);
         SLLQueuePush(slot->first, slot->last, node);
         node->path = push_str8_copy(stripe->arena, path);
+        node->is_watched = os_file_watcher_add_path(fs_shared->watcher, node->path);
+        ins_atomic_u64_inc_eval(node->is_watched ? &fs_shared->watched_path_count : &fs_shared->polled_path_count);
       }
       if(os_now_microseconds() >= ins_atomic_u64_eval(&node->last_time_requested_us)+1000000 &&
          fs_u2s_enqueue_path(path, endt_us))
@@ -81,10 +88,50 @@ fs_hash_from_path(String8 path, U64 rewind_count, U64 endt_us)
       }
     }
   }
+  else if(rewind_count == 0)
+  {
+    // NOTE: already-loaded, unwatched path -> poll for changes at most
+    // once a second; watched paths are re-streamed by the watcher thread.
+    U64 slot_idx = path_key.u64[0]%fs_shared->slots_count;
+    U64 stripe_idx = slot_idx%fs_shared->stripes_count;
+    FS_Slot *slot = &fs_shared->slots[slot_idx];
+    FS_Stripe *stripe = &fs_shared->stripes[stripe_idx];
+    OS_MutexScopeR(stripe->rw_mutex)
+    {
+      for(FS_Node *n = slot->first; n != 0; n = n->next)
+      {
+        if(str8_match(path, n->path, 0))
+        {
+          U64 now_us = os_now_microseconds();
+          if(!n->is_watched && now_us >= ins_atomic_u64_eval(&n->last_time_requested_us)+1000000)
+          {
+            ins_atomic_u64_eval_assign(&n->last_time_requested_us, now_us);
+            FileProperties props = os_properties_from_file_path(path);
+            if(props.modified != n->timestamp)
+            {
+              fs_u2s_enqueue_path(path, 0);
+            }
+          }
+          break;
+        }
+      }
+    }
+  }
   scratch_end(scratch);
   return result;
 }
 
+internal FS_WatchStats
+fs_watch_stats(void)
+{
+  FS_WatchStats stats = {0};
+  stats.os = os_file_watcher_stats(fs_shared->watcher);
+  stats.watched_path_count = ins_atomic_u64_eval(&fs_shared->watched_path_count);
+  stats.polled_path_count = ins_atomic_u64_eval(&fs_shared->polled_path_count);
+  stats.invalidation_count = ins_atomic_u64_eval(&fs_shared->invalidation_count);
+  return stats;
+}
+
 ////////////////////////////////
 //~ rjf: Streamer Threads
 
@@ -190,3 +237,48 @@ fs_streamer_thread__entry_point(void *p)
     scratch_end(scratch);
   }
 }
+
+////////////////////////////////
+//~ Watcher Thread
+
+internal void
+fs_watcher_thread__entry_point(void *p)
+{
+  TCTX tctx_;
+  tctx_init_and_equip(&tctx_);
+  ThreadName("[fs] watcher");
+  for(;;)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    String8List paths = os_file_watcher_wait(scratch.arena, fs_shared->watcher, max_U64);
+    for(String8Node *n = paths.first; n != 0; n = n->next)
+    {
+      U128 key = hs_hash_from_data(n->string);
+      U64 slot_idx = key.u64[0]%fs_shared->slots_count;
+      U64 stripe_idx = slot_idx%fs_shared->stripes_count;
+      FS_Slot *slot = &fs_shared->slots[slot_idx];
+      FS_Stripe *stripe = &fs_shared->stripes[stripe_idx];
+      B32 is_loaded = 0;
+      OS_MutexScopeR(stripe->rw_mutex)
+      {
+        for(FS_Node *node = slot->first; node != 0; node = node->next)
+        {
+          if(str8_match(node->path, n->string, 0))
+          {
+            is_loaded = (node->timestamp != 0);
+            break;
+          }
+        }
+      }
+      
+      // NOTE: paths which have not finished their first load are already
+      // being (re-)requested by fs_hash_from_path.
+      if(is_loaded)
+      {
+        ins_atomic_u64_inc_eval(&fs_shared->invalidation_count);
+        fs_u2s_enqueue_path(n->string, max_U64);
+      }
+    }
+    scratch_end(scratch);
+  }
+}
@@ -14,6 +14,7 @@ struct FS_Node
   String8 path;
   U64 timestamp;
   U64 last_time_requested_us;
+  B32 is_watched;
 };
 
 typedef struct FS_Slot FS_Slot;
@@ -31,6 +32,18 @@ struct FS_Stripe
   OS_Handle rw_mutex;
 };
 
+////////////////////////////////
+//~ Change Watching Stats
+
+typedef struct FS_WatchStats FS_WatchStats;
+struct FS_WatchStats
+{
+  OS_FileWatcherStats os;
+  U64 watched_path_count;
+  U64 polled_path_count;
+  U64 invalidation_count;
+};
+
 ////////////////////////////////
 //~ rjf: Shared State Bundle
 
@@ -56,6 +69,14 @@ struct FS_Shared
   // rjf: streamer threads
   U64 streamer_count;
   OS_Handle *streamers;
+  
+  // watcher thread (re-streams watched paths on OS change notifications;
+  // paths which could not be watched are re-stat'd by fs_hash_from_path)
+  OS_Handle watcher;
+  OS_Handle watcher_thread;
+  U64 watched_path_count;
+  U64 polled_path_count;
+  U64 invalidation_count;
 };
 
 ////////////////////////////////
@@ -72,6 +93,7 @@ internal void fs_init(void);
 //~ rjf: Cache Interaction
 
 internal U128 fs_hash_from_path(String8 path, U64 rewind_count, U64 endt_us);
+internal FS_WatchStats fs_watch_stats(void);
 
 ////////////////////////////////
 //~ rjf: Streamer Threads
@@ -81,4 +103,9 @@ internal String8 fs_u2s_dequeue_path(Arena *arena);
 
 internal void fs_streamer_thread__entry_point(void *p);
 
+////////////////////////////////
+//~ Watcher Thread
+
+internal void fs_watcher_thread__entry_point(void *p);
+
 #endif // FILE_STREAM_H
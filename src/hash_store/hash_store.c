@@ -18,6 +18,47 @@ hs_hash_from_data(String8 data)
   return u128;
 }
 
+internal int
+hs_qsort_compare_evict_candidate_epoch(HS_EvictCandidate *a, HS_EvictCandidate *b)
+{
+  int result = 0;
+  if(a->last_touch_epoch < b->last_touch_epoch)
+  {
+    result = -1;
+  }
+  else if(a->last_touch_epoch > b->last_touch_epoch)
+  {
+    result = +1;
+  }
+  return result;
+}
+
+internal U64
+hs_chunk_end_from_data(String8 data, U64 start, U64 *fingerprint_out)
+{
+  // NOTE: a gear hash's state only depends on the last 64 bytes, so it is
+  // warmed up over the tail of the minimum chunk rather than the whole thing.
+  U64 *gear = hs_shared->chunk_gear;
+  U64 max_end = Min(data.size, start + HS_CHUNK_MAX_SIZE);
+  U64 end = Min(data.size, start + HS_CHUNK_MIN_SIZE);
+  U64 h = 0;
+  for(U64 idx = end - Min(64, end - start); idx < end; idx += 1)
+  {
+    h = (h << 1) + gear[data.str[idx]];
+  }
+  for(;end < max_end;)
+  {
+    h = (h << 1) + gear[data.str[end]];
+    end += 1;
+    if((h & HS_CHUNK_CUT_MASK) == 0)
+    {
+      break;
+    }
+  }
+  *fingerprint_out = h ^ ((end - start) * 0x9e3779b97f4a7c15ull);
+  return end;
+}
+
 ////////////////////////////////
 //~ rjf: Main Layer Initialization
 
@@ -50,9 +91,51 @@ hs_init(void)
     stripe->rw_mutex = os_rw_mutex_alloc();
     stripe->cv = os_condition_variable_alloc();
   }
+  hs_shared->chunked_min_size = HS_DEFAULT_CHUNKED_MIN_SIZE;
+  hs_shared->chunk_slots_count = 4096;
+  hs_shared->chunk_stripes_count = 64;
+  hs_shared->chunk_slots = push_array(arena, HS_ChunkSlot, hs_shared->chunk_slots_count);
+  hs_shared->chunk_stripes = push_array(arena, HS_Stripe, hs_shared->chunk_stripes_count);
+  hs_shared->chunk_stripes_free_chunks = push_array(arena, HS_Chunk *, hs_shared->chunk_stripes_count);
+  for(U64 idx = 0; idx < hs_shared->chunk_stripes_count; idx += 1)
+  {
+    HS_Stripe *stripe = &hs_shared->chunk_stripes[idx];
+    stripe->arena = arena_alloc();
+    stripe->rw_mutex = os_rw_mutex_alloc();
+    stripe->cv = os_condition_variable_alloc();
+  }
+  {
+    // NOTE: fixed seed - cut points must be the same from run to run
+    U64 x = 0x2545f4914f6cdd1dull;
+    for(U64 idx = 0; idx < ArrayCount(hs_shared->chunk_gear); idx += 1)
+    {
+      x += 0x9e3779b97f4a7c15ull;
+      U64 z = x;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      hs_shared->chunk_gear[idx] = z ^ (z >> 31);
+    }
+  }
+  hs_shared->table_mutex = os_mutex_alloc();
+  hs_shared->table = hs_table_alloc(HS_TABLE_INITIAL_SLOTS_COUNT);
+  hs_shared->reclaim_epoch = 1;
+  hs_shared->tctx_registry_mutex = os_mutex_alloc();
+  hs_shared->byte_budget = HS_DEFAULT_BYTE_BUDGET;
   hs_shared->evictor_thread = os_launch_thread(hs_evictor_thread__entry_point, 0, 0);
 }
 
+internal void
+hs_set_byte_budget(U64 byte_budget)
+{
+  ins_atomic_u64_eval_assign(&hs_shared->byte_budget, byte_budget);
+}
+
+internal void
+hs_set_chunked_min_size(U64 size)
+{
+  ins_atomic_u64_eval_assign(&hs_shared->chunked_min_size, size);
+}
+
 ////////////////////////////////
 //~ rjf: Thread Context Initialization
 
@@ -64,63 +147,489 @@ hs_tctx_ensure_inited(void)
     Arena *arena = arena_alloc();
     hs_tctx = push_array(arena, HS_TCTX, 1);
     hs_tctx->arena = arena;
+    OS_MutexScope(hs_shared->tctx_registry_mutex)
+    {
+      SLLStackPush_N(hs_shared->first_registered_tctx, hs_tctx, next_registered);
+    }
   }
 }
 
+////////////////////////////////
+//~ Lock-Free Read Index
+
+internal HS_Table *
+hs_table_alloc(U64 slots_count)
+{
+  U64 arena_size = AlignPow2(ARENA_HEADER_SIZE + sizeof(HS_Table) + sizeof(HS_Node *)*slots_count, KB(4));
+  Arena *arena = arena_alloc__sized(arena_size, arena_size);
+  HS_Table *table = push_array(arena, HS_Table, 1);
+  table->arena = arena;
+  table->slots_count = slots_count;
+  table->slots = push_array(arena, HS_Node *, slots_count);
+  return table;
+}
+
+internal void
+hs_table_insert__table_locked(HS_Node *node)
+{
+  HS_Table *table = hs_shared->table;
+  
+  //- too full -> rebuild into a new table (growing it if mostly live),
+  // which readers switch over to atomically; the old one is retired
+  if((table->live_count + table->tombstone_count + 1)*4 > table->slots_count*3)
+  {
+    U64 new_slots_count = table->slots_count;
+    if((table->live_count + 1)*2 > table->slots_count)
+    {
+      new_slots_count *= 2;
+    }
+    HS_Table *new_table = hs_table_alloc(new_slots_count);
+    U64 new_mask = new_slots_count-1;
+    for(U64 idx = 0; idx < table->slots_count; idx += 1)
+    {
+      HS_Node *n = table->slots[idx];
+      if(n != 0 && n != HS_TABLE_TOMBSTONE)
+      {
+        U64 new_idx = n->hash.u64[0]&new_mask;
+        for(;new_table->slots[new_idx] != 0; new_idx = (new_idx+1)&new_mask);
+        new_table->slots[new_idx] = n;
+        new_table->live_count += 1;
+      }
+    }
+    ins_atomic_ptr_eval_assign(&hs_shared->table, new_table);
+    hs_retire__table_locked(0, 0, table);
+    table = new_table;
+  }
+  
+  //- fill first free or deleted slot - the hash can't already be here,
+  // since writers check the node lists first
+  U64 mask = table->slots_count-1;
+  U64 idx = node->hash.u64[0]&mask;
+  for(;table->slots[idx] != 0 && table->slots[idx] != HS_TABLE_TOMBSTONE; idx = (idx+1)&mask);
+  if(table->slots[idx] == HS_TABLE_TOMBSTONE)
+  {
+    table->tombstone_count -= 1;
+  }
+  table->live_count += 1;
+  ins_atomic_ptr_eval_assign(&table->slots[idx], node);
+}
+
+internal void
+hs_table_remove__table_locked(HS_Node *node)
+{
+  HS_Table *table = hs_shared->table;
+  U64 mask = table->slots_count-1;
+  for(U64 idx = node->hash.u64[0]&mask; table->slots[idx] != 0; idx = (idx+1)&mask)
+  {
+    if(table->slots[idx] == node)
+    {
+      ins_atomic_ptr_eval_assign(&table->slots[idx], HS_TABLE_TOMBSTONE);
+      table->live_count -= 1;
+      table->tombstone_count += 1;
+      break;
+    }
+  }
+}
+
+internal void
+hs_retire__table_locked(HS_Node *node, U64 stripe_idx, HS_Table *table)
+{
+  HS_Retired *retired = hs_shared->free_retired;
+  if(retired != 0)
+  {
+    SLLStackPop(hs_shared->free_retired);
+  }
+  else
+  {
+    retired = push_array_no_zero(hs_shared->arena, HS_Retired, 1);
+  }
+  MemoryZeroStruct(retired);
+  retired->epoch = ins_atomic_u64_eval(&hs_shared->reclaim_epoch);
+  retired->stripe_idx = stripe_idx;
+  retired->node = node;
+  retired->table = table;
+  SLLQueuePush(hs_shared->first_retired, hs_shared->last_retired, retired);
+}
+
+internal void
+hs_reclaim_retired(void)
+{
+  //- advance epoch; find the oldest epoch any reader may still be in
+  U64 epoch = ins_atomic_u64_inc_eval(&hs_shared->reclaim_epoch);
+  U64 min_read_epoch = epoch;
+  OS_MutexScope(hs_shared->tctx_registry_mutex)
+  {
+    for(HS_TCTX *tctx = hs_shared->first_registered_tctx; tctx != 0; tctx = tctx->next_registered)
+    {
+      U64 read_epoch = ins_atomic_u64_eval(&tctx->read_epoch);
+      if(read_epoch != 0 && read_epoch < min_read_epoch)
+      {
+        min_read_epoch = read_epoch;
+      }
+    }
+  }
+  
+  //- unlink everything retired before that epoch - no reader can still
+  // be holding a pointer to it
+  HS_Retired *first_reclaimable = 0;
+  HS_Retired *last_reclaimable = 0;
+  OS_MutexScope(hs_shared->table_mutex)
+  {
+    HS_Retired *first_kept = 0;
+    HS_Retired *last_kept = 0;
+    for(HS_Retired *r = hs_shared->first_retired, *next = 0; r != 0; r = next)
+    {
+      next = r->next;
+      if(r->epoch < min_read_epoch)
+      {
+        SLLQueuePush(first_reclaimable, last_reclaimable, r);
+      }
+      else
+      {
+        SLLQueuePush(first_kept, last_kept, r);
+      }
+    }
+    hs_shared->first_retired = first_kept;
+    hs_shared->last_retired = last_kept;
+  }
+  
+  //- recycle node structs & release old tables
+  for(HS_Retired *r = first_reclaimable; r != 0; r = r->next)
+  {
+    if(r->node != 0)
+    {
+      HS_Stripe *stripe = &hs_shared->stripes[r->stripe_idx];
+      OS_MutexScopeW(stripe->rw_mutex)
+      {
+        SLLStackPush(hs_shared->stripes_free_nodes[r->stripe_idx], r->node);
+      }
+    }
+    if(r->table != 0)
+    {
+      arena_release(r->table->arena);
+    }
+  }
+  if(first_reclaimable != 0) OS_MutexScope(hs_shared->table_mutex)
+  {
+    last_reclaimable->next = hs_shared->free_retired;
+    hs_shared->free_retired = first_reclaimable;
+  }
+}
+
+internal void
+hs_read_begin(void)
+{
+  hs_tctx_ensure_inited();
+  if(hs_tctx->read_depth == 0)
+  {
+    ins_atomic_u64_eval_assign(&hs_tctx->read_epoch, ins_atomic_u64_eval(&hs_shared->reclaim_epoch));
+  }
+  hs_tctx->read_depth += 1;
+}
+
+internal void
+hs_read_end(void)
+{
+  hs_tctx->read_depth -= 1;
+  if(hs_tctx->read_depth == 0)
+  {
+    ins_atomic_u64_eval_assign(&hs_tctx->read_epoch, 0);
+  }
+}
+
+internal HS_Node *
+hs_node_from_hash__read_guarded(U128 hash)
+{
+  HS_Node *result = 0;
+  HS_Table *table = *(HS_Table *volatile *)&hs_shared->table;
+  HS_Node *volatile *slots = table->slots;
+  U64 mask = table->slots_count-1;
+  for(U64 idx = hash.u64[0]&mask;; idx = (idx+1)&mask)
+  {
+    HS_Node *n = slots[idx];
+    if(n == 0)
+    {
+      break;
+    }
+    if(n != HS_TABLE_TOMBSTONE && u128_match(n->hash, hash))
+    {
+      result = n;
+      break;
+    }
+  }
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: Cache Submission
 
 internal U128
-hs_submit_data(U128 key, Arena **data_arena, String8 data)
+hs_submit_chunked_blob(U128 key, Arena **data_arena, String8 data)
 {
-  U64 key_slot_idx = key.u64[1]%hs_shared->key_slots_count;
-  U64 key_stripe_idx = key_slot_idx%hs_shared->key_stripes_count;
-  HS_KeySlot *key_slot = &hs_shared->key_slots[key_slot_idx];
-  HS_Stripe *key_stripe = &hs_shared->key_stripes[key_stripe_idx];
-  U128 hash = hs_hash_from_data(data);
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- find the key's current version & pin it, so its chunks stay alive
+  // while they're compared against
+  HS_Node *prev_node = 0;
+  {
+    U128 prev_hash = hs_hash_from_key(key, 0);
+    U64 prev_slot_idx = prev_hash.u64[1]%hs_shared->slots_count;
+    U64 prev_stripe_idx = prev_slot_idx%hs_shared->stripes_count;
+    HS_Slot *prev_slot = &hs_shared->slots[prev_slot_idx];
+    HS_Stripe *prev_stripe = &hs_shared->stripes[prev_stripe_idx];
+    if(!u128_match(prev_hash, u128_zero())) OS_MutexScopeR(prev_stripe->rw_mutex)
+    {
+      for(HS_Node *n = prev_slot->first; n != 0; n = n->next)
+      {
+        if(u128_match(n->hash, prev_hash))
+        {
+          if(n->chunk_count != 0)
+          {
+            ins_atomic_u64_inc_eval(&n->scope_ref_count);
+            prev_node = n;
+          }
+          break;
+        }
+      }
+    }
+  }
+  
+  //- build previous version's fingerprint -> chunk index table
+  U64 prev_slots_count = 16;
+  U64 *prev_slots = 0;
+  if(prev_node != 0)
+  {
+    for(;prev_slots_count < prev_node->chunk_count*2; prev_slots_count *= 2);
+    prev_slots = push_array(scratch.arena, U64, prev_slots_count);
+    for(U64 idx = 0; idx < prev_node->chunk_count; idx += 1)
+    {
+      U64 slot_idx = prev_node->chunk_fingerprints[idx]&(prev_slots_count-1);
+      for(;prev_slots[slot_idx] != 0; slot_idx = (slot_idx+1)&(prev_slots_count-1));
+      prev_slots[slot_idx] = idx+1;
+    }
+  }
+  
+  //- cut into chunks - reuse previous version's hashes for chunks which
+  // are byte-for-byte identical, hash the rest
+  U64 chunk_count_max = data.size/HS_CHUNK_MIN_SIZE + 1;
+  U64 chunk_count = 0;
+  Rng1U64 *chunk_ranges = push_array_no_zero(scratch.arena, Rng1U64, chunk_count_max);
+  U128 *chunk_hashes = push_array_no_zero(scratch.arena, U128, chunk_count_max);
+  U64 *chunk_fingerprints = push_array_no_zero(scratch.arena, U64, chunk_count_max);
+  U64 hashed_byte_count = 0;
+  U64 reused_byte_count = 0;
+  for(U64 off = 0; off < data.size;)
+  {
+    U64 fingerprint = 0;
+    U64 end = hs_chunk_end_from_data(data, off, &fingerprint);
+    String8 chunk_data = str8_substr(data, r1u64(off, end));
+    B32 reused = 0;
+    if(prev_node != 0)
+    {
+      for(U64 slot_idx = fingerprint&(prev_slots_count-1); prev_slots[slot_idx] != 0; slot_idx = (slot_idx+1)&(prev_slots_count-1))
+      {
+        U64 prev_idx = prev_slots[slot_idx]-1;
+        HS_Chunk *prev_chunk = prev_node->chunks[prev_idx];
+        if(prev_node->chunk_fingerprints[prev_idx] == fingerprint && str8_match(prev_chunk->data, chunk_data, 0))
+        {
+          chunk_hashes[chunk_count] = prev_chunk->hash;
+          reused = 1;
+          break;
+        }
+      }
+    }
+    if(reused)
+    {
+      reused_byte_count += chunk_data.size;
+    }
+    else
+    {
+      chunk_hashes[chunk_count] = hs_hash_from_data(chunk_data);
+      hashed_byte_count += chunk_data.size;
+    }
+    chunk_ranges[chunk_count] = r1u64(off, end);
+    chunk_fingerprints[chunk_count] = fingerprint;
+    chunk_count += 1;
+    off = end;
+  }
+  ins_atomic_u64_add_eval(&hs_shared->chunk_hashed_byte_count, hashed_byte_count);
+  ins_atomic_u64_add_eval(&hs_shared->chunk_reused_byte_count, reused_byte_count);
+  if(prev_node != 0)
+  {
+    ins_atomic_u64_dec_eval(&prev_node->scope_ref_count);
+  }
+  
+  //- blob hash = hash of its chunk hashes (keyed, so it can never alias
+  // an unchunked blob's hash)
+  U128 hash = {0};
+  {
+    String8 domain = str8_lit("hs_chunked_blob");
+    blake2b((U8 *)&hash.u64[0], sizeof(hash), chunk_hashes, sizeof(chunk_hashes[0])*chunk_count, domain.str, domain.size);
+  }
   U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
   U64 stripe_idx = slot_idx%hs_shared->stripes_count;
   HS_Slot *slot = &hs_shared->slots[slot_idx];
   HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
   
-  //- rjf: commit data to cache - if already there, just bump key refcount
-  OS_MutexScopeW(stripe->rw_mutex)
+  //- blob already stored -> just bump key refcount
+  B32 is_stored = 0;
+  OS_MutexScopeR(stripe->rw_mutex)
   {
-    HS_Node *existing_node = 0;
     for(HS_Node *n = slot->first; n != 0; n = n->next)
     {
       if(u128_match(n->hash, hash))
       {
-        existing_node = n;
+        ins_atomic_u64_inc_eval(&n->key_ref_count);
+        ins_atomic_u64_eval_assign(&n->last_touch_epoch, ins_atomic_u64_eval(&hs_shared->touch_epoch));
+        is_stored = 1;
         break;
       }
     }
-    if(existing_node == 0)
+  }
+  
+  //- not stored -> ref all chunks, copying new ones into this blob's pack
+  if(!is_stored)
+  {
+    Arena *node_arena = arena_alloc();
+    HS_Chunk **chunks = push_array_no_zero(node_arena, HS_Chunk *, chunk_count);
+    U64 *fingerprints = push_array_no_zero(node_arena, U64, chunk_count);
+    MemoryCopy(fingerprints, chunk_fingerprints, sizeof(fingerprints[0])*chunk_count);
+    HS_ChunkPack *pack = 0;
     {
-      HS_Node *node = hs_shared->stripes_free_nodes[stripe_idx];
-      if(node)
+      U64 pack_arena_size = AlignPow2(data.size + ARENA_HEADER_SIZE + sizeof(HS_ChunkPack), KB(64));
+      Arena *pack_arena = arena_alloc__sized(pack_arena_size, KB(64));
+      pack = push_array(pack_arena, HS_ChunkPack, 1);
+      pack->arena = pack_arena;
+      pack->live_count = 1;
+    }
+    for(U64 idx = 0; idx < chunk_count; idx += 1)
+    {
+      U128 chunk_hash = chunk_hashes[idx];
+      U64 chunk_slot_idx = chunk_hash.u64[1]%hs_shared->chunk_slots_count;
+      U64 chunk_stripe_idx = chunk_slot_idx%hs_shared->chunk_stripes_count;
+      HS_ChunkSlot *chunk_slot = &hs_shared->chunk_slots[chunk_slot_idx];
+      HS_Stripe *chunk_stripe = &hs_shared->chunk_stripes[chunk_stripe_idx];
+      OS_MutexScopeW(chunk_stripe->rw_mutex)
       {
-        SLLStackPop(hs_shared->stripes_free_nodes[stripe_idx]);
+        HS_Chunk *chunk = 0;
+        for(HS_Chunk *c = chunk_slot->first; c != 0; c = c->next)
+        {
+          if(u128_match(c->hash, chunk_hash))
+          {
+            chunk = c;
+            break;
+          }
+        }
+        if(chunk == 0)
+        {
+          chunk = hs_shared->chunk_stripes_free_chunks[chunk_stripe_idx];
+          if(chunk)
+          {
+            SLLStackPop(hs_shared->chunk_stripes_free_chunks[chunk_stripe_idx]);
+          }
+          else
+          {
+            chunk = push_array_no_zero(chunk_stripe->arena, HS_Chunk, 1);
+          }
+          MemoryZeroStruct(chunk);
+          String8 chunk_data = str8_substr(data, chunk_ranges[idx]);
+          chunk->hash = chunk_hash;
+          chunk->data.str = push_array_no_zero(pack->arena, U8, chunk_data.size);
+          chunk->data.size = chunk_data.size;
+          MemoryCopy(chunk->data.str, chunk_data.str, chunk_data.size);
+          chunk->pack = pack;
+          ins_atomic_u64_inc_eval(&pack->live_count);
+          DLLPushBack(chunk_slot->first, chunk_slot->last, chunk);
+          chunk_stripe->byte_count += chunk_data.size;
+          chunk_stripe->node_count += 1;
+        }
+        ins_atomic_u64_inc_eval(&chunk->ref_count);
+        chunks[idx] = chunk;
+      }
+    }
+    if(ins_atomic_u64_dec_eval(&pack->live_count) == 0)
+    {
+      arena_release(pack->arena);
+    }
+    
+    //- commit node - the submitted data doubles as the initial view
+    OS_MutexScopeW(stripe->rw_mutex)
+    {
+      HS_Node *existing_node = 0;
+      for(HS_Node *n = slot->first; n != 0; n = n->next)
+      {
+        if(u128_match(n->hash, hash))
+        {
+          existing_node = n;
+          break;
+        }
+      }
+      if(existing_node == 0)
+      {
+        HS_Node *node = hs_shared->stripes_free_nodes[stripe_idx];
+        if(node)
+        {
+          SLLStackPop(hs_shared->stripes_free_nodes[stripe_idx]);
+        }
+        else
+        {
+          node = push_array_no_zero(stripe->arena, HS_Node, 1);
+        }
+        MemoryZeroStruct(node);
+        node->hash = hash;
+        node->arena = node_arena;
+        node->data = data;
+        node->size = data.size;
+        node->key_ref_count = 1;
+        node->last_touch_epoch = ins_atomic_u64_eval(&hs_shared->touch_epoch);
+        node->chunk_count = chunk_count;
+        node->chunks = chunks;
+        node->chunk_fingerprints = fingerprints;
+        node->view_arena = *data_arena;
+        DLLPushBack(slot->first, slot->last, node);
+        OS_MutexScope(hs_shared->table_mutex)
+        {
+          hs_table_insert__table_locked(node);
+        }
+        stripe->byte_count += data.size;
+        stripe->node_count += 1;
+        *data_arena = 0;
+        node_arena = 0;
       }
       else
       {
-        node = push_array(stripe->arena, HS_Node, 1);
+        existing_node->key_ref_count += 1;
       }
-      node->hash = hash;
-      node->arena = *data_arena;
-      node->data = data;
-      node->scope_ref_count = 0;
-      node->key_ref_count = 1;
-      DLLPushBack(slot->first, slot->last, node);
     }
-    else
+    
+    //- lost a race with an identical submission -> undo chunk refs
+    if(node_arena != 0)
     {
-      existing_node->key_ref_count += 1;
-      arena_release(*data_arena);
+      for(U64 idx = 0; idx < chunk_count; idx += 1)
+      {
+        ins_atomic_u64_dec_eval(&chunks[idx]->ref_count);
+      }
+      arena_release(node_arena);
     }
+  }
+  if(*data_arena != 0)
+  {
+    arena_release(*data_arena);
     *data_arena = 0;
   }
   
+  scratch_end(scratch);
+  return hash;
+}
+
+internal void
+hs_commit_hash_to_key(U128 key, U128 hash)
+{
+  U64 key_slot_idx = key.u64[1]%hs_shared->key_slots_count;
+  U64 key_stripe_idx = key_slot_idx%hs_shared->key_stripes_count;
+  HS_KeySlot *key_slot = &hs_shared->key_slots[key_slot_idx];
+  HS_Stripe *key_stripe = &hs_shared->key_stripes[key_stripe_idx];
+  
   //- rjf: commit this hash to key cache
   U128 key_expired_hash = {0};
   OS_MutexScopeW(key_stripe->rw_mutex)
@@ -170,6 +679,74 @@ hs_submit_data(U128 key, Arena **data_arena, String8 data)
       }
     }
   }
+}
+
+internal U128
+hs_submit_data(U128 key, Arena **data_arena, String8 data)
+{
+  //- large -> store as content-defined chunks
+  if(data.size >= ins_atomic_u64_eval(&hs_shared->chunked_min_size))
+  {
+    U128 hash = hs_submit_chunked_blob(key, data_arena, data);
+    hs_commit_hash_to_key(key, hash);
+    return hash;
+  }
+  
+  U128 hash = hs_hash_from_data(data);
+  U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
+  U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+  HS_Slot *slot = &hs_shared->slots[slot_idx];
+  HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+  
+  //- rjf: commit data to cache - if already there, just bump key refcount
+  OS_MutexScopeW(stripe->rw_mutex)
+  {
+    HS_Node *existing_node = 0;
+    for(HS_Node *n = slot->first; n != 0; n = n->next)
+    {
+      if(u128_match(n->hash, hash))
+      {
+        existing_node = n;
+        break;
+      }
+    }
+    if(existing_node == 0)
+    {
+      HS_Node *node = hs_shared->stripes_free_nodes[stripe_idx];
+      if(node)
+      {
+        SLLStackPop(hs_shared->stripes_free_nodes[stripe_idx]);
+      }
+      else
+      {
+        node = push_array_no_zero(stripe->arena, HS_Node, 1);
+      }
+      MemoryZeroStruct(node);
+      node->hash = hash;
+      node->arena = *data_arena;
+      node->data = data;
+      node->size = data.size;
+      node->key_ref_count = 1;
+      node->last_touch_epoch = ins_atomic_u64_eval(&hs_shared->touch_epoch);
+      DLLPushBack(slot->first, slot->last, node);
+      OS_MutexScope(hs_shared->table_mutex)
+      {
+        hs_table_insert__table_locked(node);
+      }
+      stripe->byte_count += data.size;
+      stripe->node_count += 1;
+    }
+    else
+    {
+      existing_node->key_ref_count += 1;
+      existing_node->last_touch_epoch = ins_atomic_u64_eval(&hs_shared->touch_epoch);
+      arena_release(*data_arena);
+    }
+    *data_arena = 0;
+  }
+  
+  //- rjf: commit this hash to key cache
+  hs_commit_hash_to_key(key, hash);
   
   return hash;
 }
@@ -180,7 +757,7 @@ hs_submit_data(U128 key, Arena **data_arena, String8 data)
 internal HS_Scope *
 hs_scope_open(void)
 {
-  hs_tctx_ensure_inited();
+  hs_read_begin();
   HS_Scope *scope = hs_tctx->free_scope;
   if(scope)
   {
@@ -199,33 +776,44 @@ hs_scope_close(HS_Scope *scope)
 {
   for(HS_Touch *touch = scope->top_touch, *next = 0; touch != 0; touch = next)
   {
-    U128 hash = touch->hash;
     next = touch->next;
-    U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
-    U64 stripe_idx = slot_idx%hs_shared->stripes_count;
-    HS_Slot *slot = &hs_shared->slots[slot_idx];
-    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
-    OS_MutexScopeR(stripe->rw_mutex)
-    {
-      for(HS_Node *n = slot->first; n != 0; n = n->next)
-      {
-        if(u128_match(hash, n->hash))
-        {
-          ins_atomic_u64_dec_eval(&n->scope_ref_count);
-          break;
-        }
-      }
-    }
+    ins_atomic_u64_dec_eval(&touch->node->scope_ref_count);
     SLLStackPush(hs_tctx->free_touch, touch);
   }
   SLLStackPush(hs_tctx->free_scope, scope);
+  hs_read_end();
 }
 
-internal void
-hs_scope_touch_node__stripe_r_guarded(HS_Scope *scope, HS_Node *node)
+internal B32
+hs_scope_touch_node__read_guarded(HS_Scope *scope, HS_Node *node)
 {
+  //- already pinned by this scope -> nothing to do; repeated lookups of
+  // one blob within a scope cost one refcount inc/dec pair in total
+  U64 cache_idx = node->hash.u64[1]%ArrayCount(scope->touch_cache);
+  if(scope->touch_cache[cache_idx] == node)
+  {
+    return 1;
+  }
+  
+  //- pin; the evictor may have killed the node after it was found
+  U64 pin = ins_atomic_u64_inc_eval(&node->scope_ref_count);
+  if(pin & HS_NODE_DEAD_BIT)
+  {
+    return 0;
+  }
+  
+  //- the evictor is mid-way through dropping this node's view - wait
+  // for it to finish, by way of the stripe lock it holds meanwhile
+  if(pin & HS_NODE_BUSY_BIT)
+  {
+    U64 slot_idx = node->hash.u64[1]%hs_shared->slots_count;
+    U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+    OS_MutexScopeR(stripe->rw_mutex){}
+  }
+  
+  //- record touch, to unpin on close
   HS_Touch *touch = hs_tctx->free_touch;
-  ins_atomic_u64_inc_eval(&node->scope_ref_count);
   if(touch != 0)
   {
     SLLStackPop(hs_tctx->free_touch);
@@ -235,8 +823,10 @@ hs_scope_touch_node__stripe_r_guarded(HS_Scope *scope, HS_Node *node)
     touch = push_array_no_zero(hs_tctx->arena, HS_Touch, 1);
   }
   MemoryZeroStruct(touch);
-  touch->hash = node->hash;
+  touch->node = node;
   SLLStackPush(scope->top_touch, touch);
+  scope->touch_cache[cache_idx] = node;
+  return 1;
 }
 
 ////////////////////////////////
@@ -270,31 +860,345 @@ hs_data_from_hash(HS_Scope *scope, U128 hash)
   String8 result = {0};
   U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
   U64 stripe_idx = slot_idx%hs_shared->stripes_count;
-  HS_Slot *slot = &hs_shared->slots[slot_idx];
   HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
-  OS_MutexScopeR(stripe->rw_mutex)
+  HS_Node *unviewed_node = 0;
+  
+  //- find & pin - no locks; the open scope keeps `n` from being recycled
+  HS_Node *n = hs_node_from_hash__read_guarded(hash);
+  B32 found = (n != 0 && hs_scope_touch_node__read_guarded(scope, n));
+  if(found)
   {
-    for(HS_Node *n = slot->first; n != 0; n = n->next)
+    U64 touch_epoch = *(volatile U64 *)&hs_shared->touch_epoch;
+    if(n->last_touch_epoch != touch_epoch)
     {
-      if(u128_match(n->hash, hash))
+      ins_atomic_u64_eval_assign(&n->last_touch_epoch, touch_epoch);
+    }
+    U8 *str = *(U8 *volatile *)&n->data.str;
+    result = str8(str, str != 0 ? n->size : 0);
+    if(n->chunk_count != 0 && str == 0)
+    {
+      unviewed_node = n;
+    }
+  }
+  if(!u128_match(hash, u128_zero()))
+  {
+    if(found)
+    {
+      hs_tctx->hit_count += 1;
+    }
+    else
+    {
+      hs_tctx->miss_count += 1;
+    }
+  }
+  
+  //- chunked blob with no contiguous view -> stitch one together; the
+  // scope touch keeps the node, and so its chunks, alive meanwhile
+  if(unviewed_node != 0)
+  {
+    U64 view_arena_size = AlignPow2(unviewed_node->size + ARENA_HEADER_SIZE, KB(4));
+    Arena *view_arena = arena_alloc__sized(view_arena_size, view_arena_size);
+    U8 *view = push_array_no_zero(view_arena, U8, unviewed_node->size);
+    U64 off = 0;
+    for(U64 idx = 0; idx < unviewed_node->chunk_count; idx += 1)
+    {
+      String8 chunk_data = unviewed_node->chunks[idx]->data;
+      MemoryCopy(view + off, chunk_data.str, chunk_data.size);
+      off += chunk_data.size;
+    }
+    OS_MutexScopeW(stripe->rw_mutex)
+    {
+      if(unviewed_node->data.str == 0)
       {
-        result = n->data;
-        hs_scope_touch_node__stripe_r_guarded(scope, n);
-        break;
+        unviewed_node->data = str8(view, unviewed_node->size);
+        unviewed_node->view_arena = view_arena;
+        stripe->byte_count += unviewed_node->size;
+        view_arena = 0;
       }
+      result = unviewed_node->data;
+    }
+    if(view_arena != 0)
+    {
+      arena_release(view_arena);
     }
   }
   return result;
 }
 
+internal String8Array
+hs_chunks_from_hash(Arena *arena, HS_Scope *scope, U128 hash)
+{
+  String8Array result = {0};
+  HS_Node *n = hs_node_from_hash__read_guarded(hash);
+  if(n != 0 && hs_scope_touch_node__read_guarded(scope, n))
+  {
+    U64 touch_epoch = *(volatile U64 *)&hs_shared->touch_epoch;
+    if(n->last_touch_epoch != touch_epoch)
+    {
+      ins_atomic_u64_eval_assign(&n->last_touch_epoch, touch_epoch);
+    }
+    if(n->chunk_count != 0)
+    {
+      result.count = n->chunk_count;
+      result.strings = push_array_no_zero(arena, String8, result.count);
+      for(U64 idx = 0; idx < result.count; idx += 1)
+      {
+        result.strings[idx] = n->chunks[idx]->data;
+      }
+    }
+    else
+    {
+      result.count = 1;
+      result.strings = push_array_no_zero(arena, String8, 1);
+      result.strings[0] = n->data;
+    }
+  }
+  return result;
+}
+
+internal B32
+hs_hash_is_resident(U128 hash)
+{
+  B32 result = 0;
+  hs_read_begin();
+  {
+    HS_Node *n = hs_node_from_hash__read_guarded(hash);
+    result = (n != 0 && !(ins_atomic_u64_eval(&n->scope_ref_count) & HS_NODE_DEAD_BIT));
+  }
+  hs_read_end();
+  return result;
+}
+
+////////////////////////////////
+//~ Stats
+
+internal U64
+hs_evict_gen(void)
+{
+  return ins_atomic_u64_eval(&hs_shared->evict_gen);
+}
+
+internal HS_Stats
+hs_stats(void)
+{
+  HS_Stats stats = {0};
+  stats.byte_budget = ins_atomic_u64_eval(&hs_shared->byte_budget);
+  for(U64 stripe_idx = 0; stripe_idx < hs_shared->stripes_count; stripe_idx += 1)
+  {
+    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+    stats.byte_count += ins_atomic_u64_eval(&stripe->byte_count);
+    stats.node_count += ins_atomic_u64_eval(&stripe->node_count);
+  }
+  OS_MutexScope(hs_shared->tctx_registry_mutex)
+  {
+    for(HS_TCTX *tctx = hs_shared->first_registered_tctx; tctx != 0; tctx = tctx->next_registered)
+    {
+      stats.hit_count  += *(volatile U64 *)&tctx->hit_count;
+      stats.miss_count += *(volatile U64 *)&tctx->miss_count;
+    }
+  }
+  stats.evicted_count = ins_atomic_u64_eval(&hs_shared->evicted_count);
+  stats.evicted_byte_count = ins_atomic_u64_eval(&hs_shared->evicted_byte_count);
+  stats.pressure_pass_count = ins_atomic_u64_eval(&hs_shared->pressure_pass_count);
+  for(U64 stripe_idx = 0; stripe_idx < hs_shared->chunk_stripes_count; stripe_idx += 1)
+  {
+    HS_Stripe *stripe = &hs_shared->chunk_stripes[stripe_idx];
+    stats.chunk_count += ins_atomic_u64_eval(&stripe->node_count);
+    stats.chunk_byte_count += ins_atomic_u64_eval(&stripe->byte_count);
+  }
+  stats.chunk_hashed_byte_count = ins_atomic_u64_eval(&hs_shared->chunk_hashed_byte_count);
+  stats.chunk_reused_byte_count = ins_atomic_u64_eval(&hs_shared->chunk_reused_byte_count);
+  return stats;
+}
+
 ////////////////////////////////
 //~ rjf: Evictor Thread
 
+internal void
+hs_drop_lru_key_refs(U64 bytes_to_free)
+{
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- gather blobs which only key histories keep alive
+  U64 candidates_cap = 0;
+  for(U64 stripe_idx = 0; stripe_idx < hs_shared->stripes_count; stripe_idx += 1)
+  {
+    candidates_cap += ins_atomic_u64_eval(&hs_shared->stripes[stripe_idx].node_count);
+  }
+  U64 candidates_count = 0;
+  HS_EvictCandidate *candidates = push_array_no_zero(scratch.arena, HS_EvictCandidate, candidates_cap);
+  for(U64 slot_idx = 0; slot_idx < hs_shared->slots_count && candidates_count < candidates_cap; slot_idx += 1)
+  {
+    U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+    HS_Slot *slot = &hs_shared->slots[slot_idx];
+    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+    if(slot->first == 0)
+    {
+      continue;
+    }
+    OS_MutexScopeR(stripe->rw_mutex)
+    {
+      for(HS_Node *n = slot->first; n != 0 && candidates_count < candidates_cap; n = n->next)
+      {
+        if(ins_atomic_u64_eval(&n->scope_ref_count) == 0 && ins_atomic_u64_eval(&n->key_ref_count) != 0)
+        {
+          HS_EvictCandidate *c = &candidates[candidates_count];
+          c->hash = n->hash;
+          c->size = n->size;
+          c->last_touch_epoch = ins_atomic_u64_eval(&n->last_touch_epoch);
+          c->key_ref_drop_count = 0;
+          candidates_count += 1;
+        }
+      }
+    }
+  }
+  
+  //- pick least-recently-touched blobs until enough bytes are covered
+  qsort(candidates, candidates_count, sizeof(HS_EvictCandidate), (int (*)(const void *, const void *))hs_qsort_compare_evict_candidate_epoch);
+  U64 victims_count = 0;
+  for(U64 covered_bytes = 0; victims_count < candidates_count && covered_bytes < bytes_to_free; victims_count += 1)
+  {
+    covered_bytes += candidates[victims_count].size;
+  }
+  
+  //- build victim hash -> candidate table
+  U64 victim_slots_count = 16;
+  for(;victim_slots_count < victims_count*2; victim_slots_count *= 2);
+  HS_EvictCandidate **victim_slots = push_array(scratch.arena, HS_EvictCandidate *, victim_slots_count);
+  for(U64 idx = 0; idx < victims_count; idx += 1)
+  {
+    U64 slot_idx = candidates[idx].hash.u64[0]&(victim_slots_count-1);
+    for(;victim_slots[slot_idx] != 0; slot_idx = (slot_idx+1)&(victim_slots_count-1));
+    victim_slots[slot_idx] = &candidates[idx];
+  }
+  
+  //- clear victims out of all key histories
+  if(victims_count != 0)
+  {
+    for(U64 key_stripe_idx = 0; key_stripe_idx < hs_shared->key_stripes_count; key_stripe_idx += 1)
+    {
+      HS_Stripe *key_stripe = &hs_shared->key_stripes[key_stripe_idx];
+      OS_MutexScopeW(key_stripe->rw_mutex)
+      {
+        for(U64 key_slot_idx = key_stripe_idx; key_slot_idx < hs_shared->key_slots_count; key_slot_idx += hs_shared->key_stripes_count)
+        {
+          HS_KeySlot *key_slot = &hs_shared->key_slots[key_slot_idx];
+          for(HS_KeyNode *n = key_slot->first; n != 0; n = n->next)
+          {
+            for(U64 history_idx = 0; history_idx < ArrayCount(n->hash_history); history_idx += 1)
+            {
+              U128 hash = n->hash_history[history_idx];
+              if(u128_match(hash, u128_zero()))
+              {
+                continue;
+              }
+              for(U64 slot_idx = hash.u64[0]&(victim_slots_count-1); victim_slots[slot_idx] != 0; slot_idx = (slot_idx+1)&(victim_slots_count-1))
+              {
+                if(u128_match(victim_slots[slot_idx]->hash, hash))
+                {
+                  victim_slots[slot_idx]->key_ref_drop_count += 1;
+                  MemoryZeroStruct(&n->hash_history[history_idx]);
+                  break;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  
+  //- drop the key refs which were just cleared - the regular eviction
+  // pass then frees these blobs once no scope holds them
+  for(U64 idx = 0; idx < victims_count; idx += 1)
+  {
+    HS_EvictCandidate *c = &candidates[idx];
+    if(c->key_ref_drop_count == 0)
+    {
+      continue;
+    }
+    U64 slot_idx = c->hash.u64[1]%hs_shared->slots_count;
+    U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+    HS_Slot *slot = &hs_shared->slots[slot_idx];
+    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+    OS_MutexScopeR(stripe->rw_mutex)
+    {
+      for(HS_Node *n = slot->first; n != 0; n = n->next)
+      {
+        if(u128_match(n->hash, c->hash))
+        {
+          for(U64 drop_idx = 0; drop_idx < c->key_ref_drop_count; drop_idx += 1)
+          {
+            ins_atomic_u64_dec_eval(&n->key_ref_count);
+          }
+          break;
+        }
+      }
+    }
+  }
+  if(victims_count != 0)
+  {
+    ins_atomic_u64_inc_eval(&hs_shared->evict_gen);
+  }
+  
+  scratch_end(scratch);
+}
+
 internal void
 hs_evictor_thread__entry_point(void *p)
 {
   for(;;)
   {
+    //- advance touch epoch - LRU order is at the granularity of one pass
+    ins_atomic_u64_inc_eval(&hs_shared->touch_epoch);
+    
+    //- recycle node structs & tables which readers can no longer see
+    hs_reclaim_retired();
+    
+    //- over budget, or memory pressure -> evict least-recently-touched
+    {
+      U64 byte_count = 0;
+      for(U64 stripe_idx = 0; stripe_idx < hs_shared->stripes_count; stripe_idx += 1)
+      {
+        byte_count += ins_atomic_u64_eval(&hs_shared->stripes[stripe_idx].byte_count);
+      }
+      for(U64 stripe_idx = 0; stripe_idx < hs_shared->chunk_stripes_count; stripe_idx += 1)
+      {
+        byte_count += ins_atomic_u64_eval(&hs_shared->chunk_stripes[stripe_idx].byte_count);
+      }
+      U64 byte_budget = ins_atomic_u64_eval(&hs_shared->byte_budget);
+      U64 target_byte_count = byte_budget;
+      OS_MemoryPressure pressure = os_memory_pressure();
+      if(pressure.stall_pct >= HS_PRESSURE_STALL_PCT ||
+         (pressure.limit != 0 && pressure.usage >= pressure.limit - pressure.limit/HS_PRESSURE_LIMIT_HEADROOM_DIV))
+      {
+        //- cut once per pressure episode (or per interval, if it persists),
+        // so a pass which runs while pressure lasts doesn't compound the cut
+        U64 now_us = os_now_microseconds();
+        if(!hs_shared->pressure_episode_active ||
+           now_us >= hs_shared->pressure_cut_time_us + HS_PRESSURE_CUT_INTERVAL_US)
+        {
+          U64 floor_byte_count = byte_budget/HS_PRESSURE_FLOOR_DIV;
+          hs_shared->pressure_episode_active = 1;
+          hs_shared->pressure_target_byte_count = Max(byte_count - byte_count/4, floor_byte_count);
+          hs_shared->pressure_cut_time_us = now_us;
+        }
+        target_byte_count = Min(target_byte_count, hs_shared->pressure_target_byte_count);
+        ins_atomic_u64_inc_eval(&hs_shared->pressure_pass_count);
+      }
+      else
+      {
+        hs_shared->pressure_episode_active = 0;
+      }
+      if(byte_count > target_byte_count)
+      {
+        hs_drop_lru_key_refs(byte_count - target_byte_count);
+      }
+    }
+    
+    //- free all blobs which are no longer referenced; drop contiguous
+    // views of chunked blobs which went untouched for a whole pass
+    U64 view_touch_epoch_min = ins_atomic_u64_eval(&hs_shared->touch_epoch) - 1;
     for(U64 slot_idx = 0; slot_idx < hs_shared->slots_count; slot_idx += 1)
     {
       U64 stripe_idx = slot_idx%hs_shared->stripes_count;
@@ -307,7 +1211,8 @@ hs_evictor_thread__entry_point(void *p)
         {
           U64 key_ref_count = ins_atomic_u64_eval(&n->key_ref_count);
           U64 scope_ref_count = ins_atomic_u64_eval(&n->scope_ref_count);
-          if(key_ref_count == 0 && scope_ref_count == 0)
+          if(scope_ref_count == 0 &&
+             (key_ref_count == 0 || (n->view_arena != 0 && ins_atomic_u64_eval(&n->last_touch_epoch) < view_touch_epoch_min)))
           {
             slot_has_work = 1;
             break;
@@ -321,15 +1226,97 @@ hs_evictor_thread__entry_point(void *p)
           next = n->next;
           U64 key_ref_count = ins_atomic_u64_eval(&n->key_ref_count);
           U64 scope_ref_count = ins_atomic_u64_eval(&n->scope_ref_count);
-          if(key_ref_count == 0 && scope_ref_count == 0)
+          if(scope_ref_count != 0)
+          {
+            continue;
+          }
+          if(key_ref_count == 0 &&
+             ins_atomic_u64_eval_cond_assign(&n->scope_ref_count, HS_NODE_DEAD_BIT, 0) == 0)
           {
             DLLRemove(slot->first, slot->last, n);
-            SLLStackPush(hs_shared->stripes_free_nodes[stripe_idx], n);
+            OS_MutexScope(hs_shared->table_mutex)
+            {
+              hs_table_remove__table_locked(n);
+              hs_retire__table_locked(n, stripe_idx, 0);
+            }
+            stripe->byte_count -= n->data.size;
+            stripe->node_count -= 1;
+            ins_atomic_u64_inc_eval(&hs_shared->evicted_count);
+            ins_atomic_u64_add_eval(&hs_shared->evicted_byte_count, n->size);
+            for(U64 idx = 0; idx < n->chunk_count; idx += 1)
+            {
+              ins_atomic_u64_dec_eval(&n->chunks[idx]->ref_count);
+            }
+            if(n->view_arena != 0)
+            {
+              arena_release(n->view_arena);
+            }
             arena_release(n->arena);
           }
+          else if(key_ref_count != 0 && n->view_arena != 0 && ins_atomic_u64_eval(&n->last_touch_epoch) < view_touch_epoch_min &&
+                  ins_atomic_u64_eval_cond_assign(&n->scope_ref_count, HS_NODE_BUSY_BIT, 0) == 0)
+          {
+            stripe->byte_count -= n->data.size;
+            ins_atomic_ptr_eval_assign(&n->data.str, 0);
+            n->data.size = 0;
+            arena_release(n->view_arena);
+            n->view_arena = 0;
+            for(U64 pin = ins_atomic_u64_eval(&n->scope_ref_count);;)
+            {
+              U64 prev_pin = ins_atomic_u64_eval_cond_assign(&n->scope_ref_count, pin & ~HS_NODE_BUSY_BIT, pin);
+              if(prev_pin == pin)
+              {
+                break;
+              }
+              pin = prev_pin;
+            }
+          }
+        }
+      }
+    }
+    
+    //- free all chunks which are no longer referenced by any blob
+    for(U64 chunk_slot_idx = 0; chunk_slot_idx < hs_shared->chunk_slots_count; chunk_slot_idx += 1)
+    {
+      U64 chunk_stripe_idx = chunk_slot_idx%hs_shared->chunk_stripes_count;
+      HS_ChunkSlot *chunk_slot = &hs_shared->chunk_slots[chunk_slot_idx];
+      HS_Stripe *chunk_stripe = &hs_shared->chunk_stripes[chunk_stripe_idx];
+      if(chunk_slot->first == 0)
+      {
+        continue;
+      }
+      B32 slot_has_work = 0;
+      OS_MutexScopeR(chunk_stripe->rw_mutex)
+      {
+        for(HS_Chunk *c = chunk_slot->first; c != 0; c = c->next)
+        {
+          if(ins_atomic_u64_eval(&c->ref_count) == 0)
+          {
+            slot_has_work = 1;
+            break;
+          }
+        }
+      }
+      if(slot_has_work) OS_MutexScopeW(chunk_stripe->rw_mutex)
+      {
+        for(HS_Chunk *c = chunk_slot->first, *next = 0; c != 0; c = next)
+        {
+          next = c->next;
+          if(ins_atomic_u64_eval(&c->ref_count) == 0)
+          {
+            DLLRemove(chunk_slot->first, chunk_slot->last, c);
+            SLLStackPush(hs_shared->chunk_stripes_free_chunks[chunk_stripe_idx], c);
+            chunk_stripe->byte_count -= c->data.size;
+            chunk_stripe->node_count -= 1;
+            if(ins_atomic_u64_dec_eval(&c->pack->live_count) == 0)
+            {
+              arena_release(c->pack->arena);
+            }
+          }
         }
       }
     }
+    
     os_sleep_milliseconds(1000);
   }
 }
@@ -4,6 +4,55 @@
 #ifndef HASH_STORE_H
 #define HASH_STORE_H
 
+////////////////////////////////
+//~ Eviction Tuning
+
+// NOTE: blobs which are referenced by a key's history but not by any
+// open scope are kept until the store exceeds its byte budget; then the least
+// recently touched are evicted by dropping their key references (so the key
+// reads as empty & its producer - e.g. file_stream - re-submits on demand).
+// Under memory pressure the store is shrunk further, to 3/4 of its size -
+// once when pressure is first seen, and again only if it persists for a whole
+// cut interval; it is never shrunk below 1/FLOOR_DIV of the byte budget.
+#define HS_DEFAULT_BYTE_BUDGET            GB(2)
+#define HS_PRESSURE_STALL_PCT             10.f
+#define HS_PRESSURE_LIMIT_HEADROOM_DIV    8
+#define HS_PRESSURE_FLOOR_DIV             4
+#define HS_PRESSURE_CUT_INTERVAL_US       10000000
+
+////////////////////////////////
+//~ Chunking Tuning
+
+// NOTE: blobs at or above the chunked-min-size are split into
+// content-defined chunks (gear rolling hash cut points, as in FastCDC), and
+// stored as a list of chunks; a chunk shared between blobs - e.g. between
+// successive versions of one large, slowly-changing file - is stored once.
+// Chunks which also appear byte-for-byte in the key's previous version take
+// that version's chunk hash instead of being re-hashed. A chunked blob's
+// contiguous data is built on demand by hs_data_from_hash, and dropped again
+// by the evictor once it goes a pass without being touched.
+#define HS_DEFAULT_CHUNKED_MIN_SIZE MB(4)
+#define HS_CHUNK_MIN_SIZE           KB(16)
+#define HS_CHUNK_MAX_SIZE           KB(256)
+#define HS_CHUNK_CUT_MASK           0xffff000000000000ull
+
+////////////////////////////////
+//~ Read Path Tuning
+
+// NOTE: lookups by hash never take a lock. A node is found through an
+// open-addressed index of the node lists (linear probing, rebuilt into a fresh
+// allocation when live + deleted slots pass 3/4), and pinned by bumping its
+// scope refcount. Writers still serialize on the stripe locks, and kill a
+// node by swapping its refcount from 0 to the dead bit - a reader which sees
+// that bit treats the lookup as a miss. Node structs & replaced indices are
+// only recycled once every thread which was inside a scope when they were
+// unlinked has left it (epoch-based reclamation), so readers may look at
+// them without holding anything.
+#define HS_TABLE_INITIAL_SLOTS_COUNT 4096
+#define HS_TABLE_TOMBSTONE           ((HS_Node *)1)
+#define HS_NODE_DEAD_BIT             (1ull<<63)
+#define HS_NODE_BUSY_BIT             (1ull<<62)
+
 ////////////////////////////////
 //~ rjf: Cache Types
 
@@ -23,6 +72,31 @@ struct HS_KeySlot
   HS_KeyNode *last;
 };
 
+typedef struct HS_ChunkPack HS_ChunkPack;
+struct HS_ChunkPack
+{
+  Arena *arena;
+  U64 live_count;
+};
+
+typedef struct HS_Chunk HS_Chunk;
+struct HS_Chunk
+{
+  HS_Chunk *next;
+  HS_Chunk *prev;
+  U128 hash;
+  String8 data;
+  HS_ChunkPack *pack;
+  U64 ref_count;
+};
+
+typedef struct HS_ChunkSlot HS_ChunkSlot;
+struct HS_ChunkSlot
+{
+  HS_Chunk *first;
+  HS_Chunk *last;
+};
+
 typedef struct HS_Node HS_Node;
 struct HS_Node
 {
@@ -31,8 +105,17 @@ struct HS_Node
   U128 hash;
   Arena *arena;
   String8 data;
+  U64 size;
   U64 scope_ref_count;
   U64 key_ref_count;
+  U64 last_touch_epoch;
+  
+  // chunked blobs - `arena` holds the chunk list, `data` is a contiguous
+  // view in `view_arena`, or empty if not currently built
+  U64 chunk_count;
+  HS_Chunk **chunks;
+  U64 *chunk_fingerprints;
+  Arena *view_arena;
 };
 
 typedef struct HS_Slot HS_Slot;
@@ -48,6 +131,60 @@ struct HS_Stripe
   Arena *arena;
   OS_Handle rw_mutex;
   OS_Handle cv;
+  U64 byte_count;
+  U64 node_count;
+};
+
+typedef struct HS_Table HS_Table;
+struct HS_Table
+{
+  Arena *arena;
+  U64 slots_count;
+  U64 live_count;
+  U64 tombstone_count;
+  HS_Node **slots;
+};
+
+typedef struct HS_Retired HS_Retired;
+struct HS_Retired
+{
+  HS_Retired *next;
+  U64 epoch;
+  U64 stripe_idx;
+  HS_Node *node;
+  HS_Table *table;
+};
+
+////////////////////////////////
+//~ Eviction Types
+
+typedef struct HS_EvictCandidate HS_EvictCandidate;
+struct HS_EvictCandidate
+{
+  U128 hash;
+  U64 size;
+  U64 last_touch_epoch;
+  U64 key_ref_drop_count;
+};
+
+////////////////////////////////
+//~ Stats
+
+typedef struct HS_Stats HS_Stats;
+struct HS_Stats
+{
+  U64 byte_budget;
+  U64 byte_count;
+  U64 node_count;
+  U64 hit_count;
+  U64 miss_count;
+  U64 evicted_count;
+  U64 evicted_byte_count;
+  U64 pressure_pass_count;
+  U64 chunk_count;
+  U64 chunk_byte_count;
+  U64 chunk_hashed_byte_count;
+  U64 chunk_reused_byte_count;
 };
 
 ////////////////////////////////
@@ -57,7 +194,7 @@ typedef struct HS_Touch HS_Touch;
 struct HS_Touch
 {
   HS_Touch *next;
-  U128 hash;
+  HS_Node *node;
 };
 
 typedef struct HS_Scope HS_Scope;
@@ -65,6 +202,7 @@ struct HS_Scope
 {
   HS_Scope *next;
   HS_Touch *top_touch;
+  HS_Node *touch_cache[16];
 };
 
 ////////////////////////////////
@@ -74,8 +212,13 @@ typedef struct HS_TCTX HS_TCTX;
 struct HS_TCTX
 {
   Arena *arena;
+  HS_TCTX *next_registered;
   HS_Scope *free_scope;
   HS_Touch *free_touch;
+  U64 read_depth;
+  U64 read_epoch;
+  U64 hit_count;
+  U64 miss_count;
 };
 
 ////////////////////////////////
@@ -93,12 +236,44 @@ struct HS_Shared
   HS_Stripe *stripes;
   HS_Node **stripes_free_nodes;
   
+  // lock-free read index
+  OS_Handle table_mutex;
+  HS_Table *table;
+  HS_Retired *first_retired;
+  HS_Retired *last_retired;
+  HS_Retired *free_retired;
+  U64 reclaim_epoch;
+  OS_Handle tctx_registry_mutex;
+  HS_TCTX *first_registered_tctx;
+  
   // rjf: key cache
   U64 key_slots_count;
   U64 key_stripes_count;
   HS_KeySlot *key_slots;
   HS_Stripe *key_stripes;
   
+  // chunk cache
+  U64 chunked_min_size;
+  U64 chunk_slots_count;
+  U64 chunk_stripes_count;
+  HS_ChunkSlot *chunk_slots;
+  HS_Stripe *chunk_stripes;
+  HS_Chunk **chunk_stripes_free_chunks;
+  U64 chunk_gear[256];
+  U64 chunk_hashed_byte_count;
+  U64 chunk_reused_byte_count;
+  
+  // eviction state
+  U64 byte_budget;
+  U64 touch_epoch;
+  U64 evict_gen;
+  U64 evicted_count;
+  U64 evicted_byte_count;
+  U64 pressure_pass_count;
+  B32 pressure_episode_active;    // only touched by the evictor thread
+  U64 pressure_target_byte_count;
+  U64 pressure_cut_time_us;
+  
   // rjf: evictor thread
   OS_Handle evictor_thread;
 };
@@ -113,20 +288,38 @@ global HS_Shared *hs_shared = 0;
 //~ rjf: Basic Helpers
 
 internal U128 hs_hash_from_data(String8 data);
+internal int hs_qsort_compare_evict_candidate_epoch(HS_EvictCandidate *a, HS_EvictCandidate *b);
+internal U64 hs_chunk_end_from_data(String8 data, U64 start, U64 *fingerprint_out);
 
 ////////////////////////////////
 //~ rjf: Main Layer Initialization
 
 internal void hs_init(void);
+internal void hs_set_byte_budget(U64 byte_budget);
+internal void hs_set_chunked_min_size(U64 size);
 
 ////////////////////////////////
 //~ rjf: Thread Context Initialization
 
 internal void hs_tctx_ensure_inited(void);
 
+////////////////////////////////
+//~ Lock-Free Read Index
+
+internal HS_Table *hs_table_alloc(U64 slots_count);
+internal void hs_table_insert__table_locked(HS_Node *node);
+internal void hs_table_remove__table_locked(HS_Node *node);
+internal void hs_retire__table_locked(HS_Node *node, U64 stripe_idx, HS_Table *table);
+internal void hs_reclaim_retired(void);
+internal void hs_read_begin(void);
+internal void hs_read_end(void);
+internal HS_Node *hs_node_from_hash__read_guarded(U128 hash);
+
 ////////////////////////////////
 //~ rjf: Cache Submission/Derefs
 
+internal U128 hs_submit_chunked_blob(U128 key, Arena **data_arena, String8 data);
+internal void hs_commit_hash_to_key(U128 key, U128 hash);
 internal U128 hs_submit_data(U128 key, Arena **data_arena, String8 data);
 
 ////////////////////////////////
@@ -134,17 +327,26 @@ internal U128 hs_submit_data(U128 key, Arena **data_arena, String8 data);
 
 internal HS_Scope *hs_scope_open(void);
 internal void hs_scope_close(HS_Scope *scope);
-internal void hs_scope_touch_node__stripe_r_guarded(HS_Scope *scope, HS_Node *node);
+internal B32 hs_scope_touch_node__read_guarded(HS_Scope *scope, HS_Node *node);
 
 ////////////////////////////////
 //~ rjf: Cache Lookups
 
 internal U128 hs_hash_from_key(U128 key, U64 rewind_count);
 internal String8 hs_data_from_hash(HS_Scope *scope, U128 hash);
+internal String8Array hs_chunks_from_hash(Arena *arena, HS_Scope *scope, U128 hash);
+internal B32 hs_hash_is_resident(U128 hash);
+
+////////////////////////////////
+//~ Stats
+
+internal U64 hs_evict_gen(void);
+internal HS_Stats hs_stats(void);
 
 ////////////////////////////////
 //~ rjf: Evictor Thread
 
+internal void hs_drop_lru_key_refs(U64 bytes_to_free);
 internal void hs_evictor_thread__entry_point(void *p);
 
 #endif // HASH_STORE_H
@@ -0,0 +1,289 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Read throughput of hash store lookups at 1, 4 & 16 threads, comparing
+// hs_data_from_hash (lock-free index, epoch-protected) against the previous
+// design, which is replayed here over the same store: take the stripe's
+// OS_MutexScopeR, walk the slot list, bump the node's scope refcount & a
+// shared per-stripe hit counter; on scope close, take the stripe lock again
+// & walk the list once per touch to drop the refcount. Each thread opens a
+// scope, does a batch of lookups of random blobs, and closes it, like a UI
+// frame would. Every lookup must return the submitted blob.
+//
+// usage: hs_lookup_bench [--blobs:<n>] [--lookups:<per scope>]
+//                        [--scopes:<per thread>] [--threads:<max>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "hash_store/hash_store.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "hash_store/hash_store.c"
+
+////////////////////////////////
+//~ Types
+
+typedef enum HLB_Mode{
+  HLB_Mode_MutexScopeR,
+  HLB_Mode_LockFree,
+  HLB_Mode_COUNT
+} HLB_Mode;
+
+typedef struct HLB_RefTouch HLB_RefTouch;
+struct HLB_RefTouch{
+  HLB_RefTouch *next;
+  U128 hash;
+};
+
+typedef struct HLB_RefScope{
+  Arena *arena;
+  HLB_RefTouch *top_touch;
+  HLB_RefTouch *free_touch;
+} HLB_RefScope;
+
+typedef struct HLB_Shared{
+  HLB_Mode mode;
+  U128 *hashes;
+  U64 *sizes;
+  U64 blob_count;
+  U64 lookups_per_scope;
+  U64 scopes_per_thread;
+  U64 *stripe_hit_counts;
+  U64 go_gen;
+  U64 done_count;
+  U64 bad_count;
+  OS_Handle mutex;
+  OS_Handle cv;
+} HLB_Shared;
+
+global HLB_Shared hlb = {0};
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+hlb_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+//- previous design, over hs_shared's stripe-locked node lists
+
+static String8
+hlb_ref_data_from_hash(HLB_RefScope *scope, U128 hash){
+  String8 result = {0};
+  U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
+  U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+  HS_Slot *slot = &hs_shared->slots[slot_idx];
+  HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+  B32 found = 0;
+  OS_MutexScopeR(stripe->rw_mutex){
+    for (HS_Node *n = slot->first; n != 0; n = n->next){
+      if (u128_match(n->hash, hash)){
+        U64 touch_epoch = ins_atomic_u64_eval(&hs_shared->touch_epoch);
+        if (n->last_touch_epoch != touch_epoch){
+          ins_atomic_u64_eval_assign(&n->last_touch_epoch, touch_epoch);
+        }
+        result = n->data;
+        found = 1;
+        HLB_RefTouch *touch = scope->free_touch;
+        ins_atomic_u64_inc_eval(&n->scope_ref_count);
+        if (touch != 0){
+          SLLStackPop(scope->free_touch);
+        }
+        else{
+          touch = push_array_no_zero(scope->arena, HLB_RefTouch, 1);
+        }
+        MemoryZeroStruct(touch);
+        touch->hash = n->hash;
+        SLLStackPush(scope->top_touch, touch);
+        break;
+      }
+    }
+  }
+  if (found){
+    ins_atomic_u64_inc_eval(&hlb.stripe_hit_counts[stripe_idx]);
+  }
+  return(result);
+}
+
+static void
+hlb_ref_scope_close(HLB_RefScope *scope){
+  for (HLB_RefTouch *touch = scope->top_touch, *next = 0; touch != 0; touch = next){
+    U128 hash = touch->hash;
+    next = touch->next;
+    U64 slot_idx = hash.u64[1]%hs_shared->slots_count;
+    U64 stripe_idx = slot_idx%hs_shared->stripes_count;
+    HS_Slot *slot = &hs_shared->slots[slot_idx];
+    HS_Stripe *stripe = &hs_shared->stripes[stripe_idx];
+    OS_MutexScopeR(stripe->rw_mutex){
+      for (HS_Node *n = slot->first; n != 0; n = n->next){
+        if (u128_match(hash, n->hash)){
+          ins_atomic_u64_dec_eval(&n->scope_ref_count);
+          break;
+        }
+      }
+    }
+    SLLStackPush(scope->free_touch, touch);
+  }
+  scope->top_touch = 0;
+}
+
+//- reader threads
+
+static void
+hlb_reader_thread(void *ptr){
+  U64 rng = (U64)ptr*0x9E3779B97F4A7C15ull + 1;
+  HLB_RefScope ref_scope = {0};
+  ref_scope.arena = arena_alloc();
+  U64 go_gen = 0;
+  for (;;){
+    OS_MutexScope(hlb.mutex){
+      for (;hlb.go_gen == go_gen;){
+        os_condition_variable_wait(hlb.cv, hlb.mutex, max_U64);
+      }
+      go_gen = hlb.go_gen;
+    }
+    
+    U64 bad_count = 0;
+    for (U64 scope_idx = 0; scope_idx < hlb.scopes_per_thread; scope_idx += 1){
+      if (hlb.mode == HLB_Mode_LockFree){
+        HS_Scope *scope = hs_scope_open();
+        for (U64 i = 0; i < hlb.lookups_per_scope; i += 1){
+          U64 idx = hlb_rand(&rng)%hlb.blob_count;
+          String8 data = hs_data_from_hash(scope, hlb.hashes[idx]);
+          bad_count += (data.size != hlb.sizes[idx] || *(U64*)data.str != idx);
+        }
+        hs_scope_close(scope);
+      }
+      else{
+        for (U64 i = 0; i < hlb.lookups_per_scope; i += 1){
+          U64 idx = hlb_rand(&rng)%hlb.blob_count;
+          String8 data = hlb_ref_data_from_hash(&ref_scope, hlb.hashes[idx]);
+          bad_count += (data.size != hlb.sizes[idx] || *(U64*)data.str != idx);
+        }
+        hlb_ref_scope_close(&ref_scope);
+      }
+    }
+    
+    OS_MutexScope(hlb.mutex){
+      hlb.bad_count += bad_count;
+      hlb.done_count += 1;
+    }
+    os_condition_variable_broadcast(hlb.cv);
+  }
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 blob_count = 2048;
+  U64 lookups_per_scope = 64;
+  U64 scopes_per_thread = 20000;
+  U64 max_threads = 16;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 blobs_string = cmd_line_string(&cmd_line, str8_lit("blobs"));
+    String8 lookups_string = cmd_line_string(&cmd_line, str8_lit("lookups"));
+    String8 scopes_string = cmd_line_string(&cmd_line, str8_lit("scopes"));
+    String8 threads_string = cmd_line_string(&cmd_line, str8_lit("threads"));
+    if (blobs_string.size != 0){
+      try_u64_from_str8_c_rules(blobs_string, &blob_count);
+    }
+    if (lookups_string.size != 0){
+      try_u64_from_str8_c_rules(lookups_string, &lookups_per_scope);
+    }
+    if (scopes_string.size != 0){
+      try_u64_from_str8_c_rules(scopes_string, &scopes_per_thread);
+    }
+    if (threads_string.size != 0){
+      try_u64_from_str8_c_rules(threads_string, &max_threads);
+    }
+    blob_count = Max(blob_count, 1);
+  }
+  
+  // submit blobs; each starts with its index so lookups can be checked
+  hs_init();
+  hlb.hashes = push_array(scratch.arena, U128, blob_count);
+  hlb.sizes = push_array(scratch.arena, U64, blob_count);
+  {
+    U64 rng = 7;
+    for (U64 idx = 0; idx < blob_count; idx += 1){
+      U64 size = 64 + (hlb_rand(&rng)%KB(4))/8*8;
+      Arena *data_arena = arena_alloc();
+      U64 *data = push_array_no_zero(data_arena, U64, size/8);
+      data[0] = idx;
+      for (U64 i = 1; i < size/8; i += 1){
+        data[i] = hlb_rand(&rng);
+      }
+      U128 key = {idx, 0xB10B};
+      hlb.hashes[idx] = hs_submit_data(key, &data_arena, str8((U8*)data, size));
+      hlb.sizes[idx] = size;
+    }
+  }
+  hlb.blob_count = blob_count;
+  hlb.lookups_per_scope = lookups_per_scope;
+  hlb.scopes_per_thread = scopes_per_thread;
+  hlb.stripe_hit_counts = push_array(scratch.arena, U64, hs_shared->stripes_count);
+  hlb.mutex = os_mutex_alloc();
+  hlb.cv = os_condition_variable_alloc();
+  
+  printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+  printf("%llu blobs, %llu lookups per scope, %llu scopes per thread\n",
+         (unsigned long long)blob_count, (unsigned long long)lookups_per_scope,
+         (unsigned long long)scopes_per_thread);
+  
+  // 1, 4, 16 threads, each mode
+  char *mode_names[] = {"OS_MutexScopeR", "lock-free"};
+  U64 threads_launched = 0;
+  for (U64 thread_count = 1; thread_count <= max_threads; thread_count *= 4){
+    for (;threads_launched < thread_count; threads_launched += 1){
+      os_release_thread_handle(os_launch_thread(hlb_reader_thread, (void*)threads_launched, 0));
+    }
+    F64 lookups_per_sec[HLB_Mode_COUNT] = {0};
+    for (U64 mode = 0; mode < HLB_Mode_COUNT; mode += 1){
+      U64 begin_us = 0;
+      OS_MutexScope(hlb.mutex){
+        hlb.mode = (HLB_Mode)mode;
+        hlb.done_count = 0;
+        hlb.go_gen += 1;
+        begin_us = os_now_microseconds();
+      }
+      os_condition_variable_broadcast(hlb.cv);
+      OS_MutexScope(hlb.mutex){
+        for (;hlb.done_count < threads_launched;){
+          os_condition_variable_wait(hlb.cv, hlb.mutex, max_U64);
+        }
+      }
+      U64 elapsed_us = os_now_microseconds() - begin_us;
+      if (hlb.bad_count != 0){
+        printf("error: %llu lookups returned the wrong blob\n", (unsigned long long)hlb.bad_count);
+        return(1);
+      }
+      U64 lookup_count = threads_launched*scopes_per_thread*lookups_per_scope;
+      lookups_per_sec[mode] = lookup_count/(elapsed_us/1000000.0);
+      printf("%2llu threads, %-15s %7.2fM lookups/s (%.1fns each, wall clock)\n",
+             (unsigned long long)threads_launched, mode_names[mode], lookups_per_sec[mode]/1000000.0,
+             1000.0*elapsed_us/lookup_count);
+    }
+    printf("%2llu threads, lock-free / OS_MutexScopeR: %.2fx\n",
+           (unsigned long long)threads_launched, lookups_per_sec[HLB_Mode_LockFree]/lookups_per_sec[HLB_Mode_MutexScopeR]);
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
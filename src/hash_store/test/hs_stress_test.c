@@ -0,0 +1,265 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Stress test for the hash store's lock-free read path. Reader threads look
+// up random keys' latest blobs (hs_hash_from_key -> hs_data_from_hash) and
+// check every byte, while a submitter keeps pushing new versions of random
+// keys and the evictor runs with a byte budget far below the working set.
+// Part of the blobs are big enough to be stored as chunks, so view drops &
+// rebuilds race with the readers too. Each blob's content is a function of
+// the key & version in its header; any mismatch is a corrupt read & fails
+// the test. Misses (evicted blobs) are fine.
+//
+// usage: hs_stress_test [--readers:<n>] [--seconds:<n>] [--keys:<n>]
+//                       [--budget_kb:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "hash_store/hash_store.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "hash_store/hash_store.c"
+
+////////////////////////////////
+//~ Types
+
+typedef struct HST_Shared{
+  U64 key_count;
+  U64 end_us;
+  U64 lookup_count;
+  U64 hit_count;
+  U64 corrupt_count;
+  U64 submit_count;
+  U64 done_count;
+  OS_Handle mutex;
+  OS_Handle cv;
+} HST_Shared;
+
+global HST_Shared hst = {0};
+
+////////////////////////////////
+//~ Blob Content
+
+static U64
+hst_mix(U64 x){
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return(x);
+}
+
+static U64
+hst_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// small blobs for most keys, a few past the chunked size
+static U64
+hst_word_count_from_key(U64 key_idx){
+  U64 size = (key_idx%8 == 0) ? KB(96) + (hst_mix(key_idx)%KB(128)) : 64 + hst_mix(key_idx)%KB(4);
+  return(size/8);
+}
+
+// header (key, version), then words which depend only on the key, except
+// a window which depends on the version - so versions share most chunks
+static U64
+hst_word(U64 key_idx, U64 version, U64 word_count, U64 i){
+  U64 result = 0;
+  U64 window_min = (version*37)%word_count;
+  if (i == 0){
+    result = key_idx;
+  }
+  else if (i == 1){
+    result = version;
+  }
+  else if (window_min <= i && i < window_min + 64){
+    result = hst_mix(key_idx ^ (version << 32) ^ (i << 8));
+  }
+  else{
+    result = hst_mix(key_idx*0x9E3779B97F4A7C15ull + i);
+  }
+  return(result);
+}
+
+static void
+hst_submit(U64 key_idx, U64 version){
+  U64 word_count = hst_word_count_from_key(key_idx);
+  Arena *data_arena = arena_alloc();
+  U64 *data = push_array_no_zero(data_arena, U64, word_count);
+  for (U64 i = 0; i < word_count; i += 1){
+    data[i] = hst_word(key_idx, version, word_count, i);
+  }
+  U128 key = {key_idx, 0x5157};
+  hs_submit_data(key, &data_arena, str8((U8*)data, word_count*8));
+}
+
+static B32
+hst_blob_is_valid(U64 key_idx, String8 data){
+  U64 word_count = hst_word_count_from_key(key_idx);
+  B32 result = (data.size == word_count*8);
+  U64 *words = (U64*)data.str;
+  if (result){
+    U64 version = words[1];
+    for (U64 i = 0; i < word_count; i += 1){
+      if (words[i] != hst_word(key_idx, version, word_count, i)){
+        result = 0;
+        break;
+      }
+    }
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Threads
+
+static void
+hst_thread_done(void){
+  OS_MutexScope(hst.mutex){
+    hst.done_count += 1;
+  }
+  os_condition_variable_broadcast(hst.cv);
+}
+
+static void
+hst_reader_thread(void *ptr){
+  U64 rng = (U64)ptr*0x9E3779B97F4A7C15ull + 1;
+  U64 lookup_count = 0;
+  U64 hit_count = 0;
+  U64 corrupt_count = 0;
+  for (;os_now_microseconds() < hst.end_us;){
+    HS_Scope *scope = hs_scope_open();
+    for (U64 i = 0; i < 32; i += 1){
+      U64 key_idx = hst_rand(&rng)%hst.key_count;
+      U128 key = {key_idx, 0x5157};
+      U128 hash = hs_hash_from_key(key, hst_rand(&rng)%2);
+      String8 data = hs_data_from_hash(scope, hash);
+      lookup_count += 1;
+      if (data.size != 0){
+        hit_count += 1;
+        if (!hst_blob_is_valid(key_idx, data)){
+          corrupt_count += 1;
+        }
+      }
+    }
+    hs_scope_close(scope);
+  }
+  ins_atomic_u64_add_eval(&hst.lookup_count, lookup_count);
+  ins_atomic_u64_add_eval(&hst.hit_count, hit_count);
+  ins_atomic_u64_add_eval(&hst.corrupt_count, corrupt_count);
+  hst_thread_done();
+}
+
+static void
+hst_submitter_thread(void *ptr){
+  U64 rng = 0xC0FFEE;
+  U64 *versions = (U64*)ptr;
+  U64 submit_count = 0;
+  for (;os_now_microseconds() < hst.end_us;){
+    U64 key_idx = hst_rand(&rng)%hst.key_count;
+    versions[key_idx] += 1;
+    hst_submit(key_idx, versions[key_idx]);
+    submit_count += 1;
+  }
+  ins_atomic_u64_add_eval(&hst.submit_count, submit_count);
+  hst_thread_done();
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 reader_count = 8;
+  U64 seconds = 10;
+  U64 key_count = 512;
+  U64 budget_kb = 4096;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 readers_string = cmd_line_string(&cmd_line, str8_lit("readers"));
+    String8 seconds_string = cmd_line_string(&cmd_line, str8_lit("seconds"));
+    String8 keys_string = cmd_line_string(&cmd_line, str8_lit("keys"));
+    String8 budget_string = cmd_line_string(&cmd_line, str8_lit("budget_kb"));
+    if (readers_string.size != 0){
+      try_u64_from_str8_c_rules(readers_string, &reader_count);
+    }
+    if (seconds_string.size != 0){
+      try_u64_from_str8_c_rules(seconds_string, &seconds);
+    }
+    if (keys_string.size != 0){
+      try_u64_from_str8_c_rules(keys_string, &key_count);
+    }
+    if (budget_string.size != 0){
+      try_u64_from_str8_c_rules(budget_string, &budget_kb);
+    }
+    key_count = Max(key_count, 1);
+  }
+  
+  // store with a small budget & chunked blobs from 64KB
+  hs_init();
+  hs_set_byte_budget(KB(budget_kb));
+  hs_set_chunked_min_size(KB(64));
+  U64 *versions = push_array(scratch.arena, U64, key_count);
+  U64 working_set_size = 0;
+  for (U64 key_idx = 0; key_idx < key_count; key_idx += 1){
+    hst_submit(key_idx, 0);
+    working_set_size += hst_word_count_from_key(key_idx)*8;
+  }
+  printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+  printf("%llu readers, 1 submitter, %llus; %llu keys, %.1f MB per version of all keys, %llu KB budget\n",
+         (unsigned long long)reader_count, (unsigned long long)seconds, (unsigned long long)key_count,
+         working_set_size/(1024.0*1024.0), (unsigned long long)budget_kb);
+  
+  // run
+  hst.key_count = key_count;
+  hst.mutex = os_mutex_alloc();
+  hst.cv = os_condition_variable_alloc();
+  hst.end_us = os_now_microseconds() + seconds*1000000;
+  HS_Stats stats_before = hs_stats();
+  for (U64 i = 0; i < reader_count; i += 1){
+    os_release_thread_handle(os_launch_thread(hst_reader_thread, (void*)i, 0));
+  }
+  os_release_thread_handle(os_launch_thread(hst_submitter_thread, versions, 0));
+  OS_MutexScope(hst.mutex){
+    for (;hst.done_count < reader_count + 1;){
+      os_condition_variable_wait(hst.cv, hst.mutex, max_U64);
+    }
+  }
+  HS_Stats stats = hs_stats();
+  
+  printf("lookups: %llu (%llu hits, %llu misses), corrupt reads: %llu\n",
+         (unsigned long long)hst.lookup_count, (unsigned long long)hst.hit_count,
+         (unsigned long long)(hst.lookup_count - hst.hit_count), (unsigned long long)hst.corrupt_count);
+  printf("submits: %llu; evicted: %llu blobs, %.1f MB; %llu nodes, %.1f MB resident; %.1f MB of chunks reused\n",
+         (unsigned long long)hst.submit_count,
+         (unsigned long long)(stats.evicted_count - stats_before.evicted_count),
+         (stats.evicted_byte_count - stats_before.evicted_byte_count)/(1024.0*1024.0),
+         (unsigned long long)stats.node_count, stats.byte_count/(1024.0*1024.0),
+         stats.chunk_reused_byte_count/(1024.0*1024.0));
+  if (hst.corrupt_count != 0){
+    printf("error: corrupt reads\n");
+    return(1);
+  }
+  if (stats.evicted_count == stats_before.evicted_count){
+    printf("error: nothing was evicted; run for longer or lower the budget\n");
+    return(1);
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
@@ -12,6 +12,8 @@ global String8List lnx_cmd_line_args = {0};
 global LNX_Entity lnx_entity_buffer[1024];
 global LNX_Entity *lnx_entity_free = 0;
 global String8 lnx_initial_path = {0};
+global LNX_LargePageKind lnx_large_page_kind = LNX_LargePageKind_Null;
+global U64 lnx_large_page_size = 0;
 thread_static LNX_SafeCallChain *lnx_safe_call_chain = 0;
 
 ////////////////////////////////
@@ -97,6 +99,50 @@ lnx_file_properties_from_stat(FileProperties *out, struct stat *in){
   }
 }
 
+internal void
+lnx_timespec_from_endt_us(struct timespec *out, U64 endt_us){
+  // NOTE: endt_us is in the os_now_microseconds clock, which is
+  // CLOCK_MONOTONIC - condition variables are created on that clock too.
+  out->tv_sec  = (time_t)(endt_us/Million(1));
+  out->tv_nsec = (long)((endt_us%Million(1))*Thousand(1));
+}
+
+internal U64
+lnx_large_page_size_from_meminfo(void){
+  U64 result = MB(2);
+  FILE *file = fopen("/proc/meminfo", "r");
+  if (file != 0){
+    char line[256];
+    for (;fgets(line, sizeof(line), file) != 0;){
+      unsigned long long size_kb = 0;
+      if (sscanf(line, "Hugepagesize: %llu kB", &size_kb) == 1){
+        if (size_kb != 0){
+          result = (U64)size_kb*KB(1);
+        }
+        break;
+      }
+    }
+    fclose(file);
+  }
+  return(result);
+}
+
+internal B32
+lnx_transparent_huge_pages_available(void){
+  B32 result = 0;
+  FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (file != 0){
+    char line[256] = {0};
+    if (fgets(line, sizeof(line), file) != 0){
+      String8 mode = str8_cstring(line);
+      result = (str8_find_needle(mode, 0, str8_lit("[always]"), 0) < mode.size ||
+                str8_find_needle(mode, 0, str8_lit("[madvise]"), 0) < mode.size);
+    }
+    fclose(file);
+  }
+  return(result);
+}
+
 internal String8
 lnx_string_from_signal(int signum){
   String8 result = str8_lit("<unknown-signal>");
@@ -761,6 +807,52 @@ lnx_string_from_errno(int error_number){
   return(result);
 }
 
+internal String8
+lnx_data_from_proc_file_path(Arena *arena, String8 path){
+  // NOTE: procfs/sysfs files report a size of 0, so read until EOF
+  // rather than by os_properties_from_file_path size
+  String8 result = {0};
+  Temp scratch = scratch_begin(&arena, 1);
+  String8 path_copy = push_str8_copy(scratch.arena, path);
+  int fd = open((char*)path_copy.str, O_RDONLY);
+  if(fd >= 0){
+    U64 cap = KB(16);
+    result.str = push_array_no_zero(arena, U8, cap);
+    for(;result.size < cap;){
+      ssize_t read_size = read(fd, result.str + result.size, cap - result.size);
+      if(read_size <= 0){
+        break;
+      }
+      result.size += (U64)read_size;
+    }
+    arena_put_back(arena, cap - result.size);
+    close(fd);
+  }
+  scratch_end(scratch);
+  return(result);
+}
+
+internal U64
+lnx_u64_from_key_value_text(String8 text, String8 key){
+  // NOTE: finds `key` at the start of a line, and parses the decimal
+  // number following it (e.g. "MemTotal:    16318472 kB")
+  U64 result = 0;
+  for(U64 pos = 0; pos < text.size;){
+    pos = str8_find_needle(text, pos, key, 0);
+    if(pos < text.size && (pos == 0 || text.str[pos-1] == '\n')){
+      String8 value = str8_skip(text, pos + key.size);
+      U64 start = 0;
+      for(;start < value.size && char_is_space(value.str[start]); start += 1);
+      U64 end = start;
+      for(;end < value.size && char_is_digit(value.str[end], 10); end += 1);
+      result = u64_from_str8(str8_substr(value, r1u64(start, end)), 10);
+      break;
+    }
+    pos += 1;
+  }
+  return(result);
+}
+
 internal LNX_Entity*
 lnx_alloc_entity(LNX_EntityKind kind){
   pthread_mutex_lock(&lnx_mutex);
@@ -800,6 +892,34 @@ lnx_thread_base(void *ptr){
   return(0);
 }
 
+internal B32
+lnx_cv_wait_rw(LNX_Entity *cv_entity, LNX_Entity *rw_entity, B32 write_mode, U64 endt_us){
+  // NOTE: pthreads has no condition variable wait for rwlocks. The
+  // condition variable's internal mutex is taken before the rwlock is dropped,
+  // and signalers take that same mutex, so a wakeup between dropping the
+  // rwlock & sleeping cannot be lost.
+  B32 result = 1;
+  pthread_mutex_lock(&cv_entity->cv.mutex);
+  pthread_rwlock_unlock(&rw_entity->rw_mutex);
+  if (endt_us == max_U64){
+    pthread_cond_wait(&cv_entity->cv.cond, &cv_entity->cv.mutex);
+  }
+  else{
+    struct timespec endt_ts = {0};
+    lnx_timespec_from_endt_us(&endt_ts, endt_us);
+    int wait_result = pthread_cond_timedwait(&cv_entity->cv.cond, &cv_entity->cv.mutex, &endt_ts);
+    result = (wait_result != ETIMEDOUT);
+  }
+  pthread_mutex_unlock(&cv_entity->cv.mutex);
+  if (write_mode){
+    pthread_rwlock_wrlock(&rw_entity->rw_mutex);
+  }
+  else{
+    pthread_rwlock_rdlock(&rw_entity->rw_mutex);
+  }
+  return(result);
+}
+
 internal void
 lnx_safe_call_sig_handler(int){
   LNX_SafeCallChain *chain = lnx_safe_call_chain;
@@ -864,14 +984,45 @@ os_commit(void *ptr, U64 size){
 
 internal void*
 os_reserve_large(U64 size){
-  NotImplemented;
-  return 0;
+  void *result = 0;
+  
+  // NOTE: hugetlbfs pages are reserved from the pool up front, so a
+  // successful map here can't fault later for lack of huge pages.
+  if (lnx_large_page_kind == LNX_LargePageKind_HugeTLB){
+    result = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (result == MAP_FAILED){
+      result = 0;
+    }
+  }
+  
+  // NOTE: transparent huge pages, or fallback when the hugetlbfs pool is
+  // exhausted. THP can only back large-page-aligned extents, so over-reserve
+  // and trim to an aligned range before advising.
+  if (result == 0){
+    U64 align = lnx_large_page_size;
+    U8 *raw = (U8*)mmap(0, size + align, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (raw != MAP_FAILED){
+      U8 *aligned = (U8*)AlignPow2(IntFromPtr(raw), align);
+      U64 pre_size = (U64)(aligned - raw);
+      U64 post_size = align - pre_size;
+      if (pre_size != 0){
+        munmap(raw, pre_size);
+      }
+      if (post_size != 0){
+        munmap(aligned + size, post_size);
+      }
+      madvise(aligned, size, MADV_HUGEPAGE);
+      result = aligned;
+    }
+  }
+  
+  return(result);
 }
 
 internal B32
 os_commit_large(void *ptr, U64 size){
-  NotImplemented;
-  return 0;
+  B32 result = (mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0);
+  return(result);
 }
 
 internal void
@@ -885,24 +1036,48 @@ os_release(void *ptr, U64 size){
   munmap(ptr, size);
 }
 
-internal void
+internal B32
 os_set_large_pages(B32 flag)
 {
-  NotImplemented;
+  B32 is_ok = 0;
+  if (flag){
+    U64 page_size = lnx_large_page_size_from_meminfo();
+    
+    // NOTE: prefer hugetlbfs if the pool has a page for us; otherwise
+    // use transparent huge pages if the kernel allows them via madvise.
+    LNX_LargePageKind kind = LNX_LargePageKind_Null;
+    void *probe = mmap(0, page_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (probe != MAP_FAILED){
+      munmap(probe, page_size);
+      kind = LNX_LargePageKind_HugeTLB;
+    }
+    else if (lnx_transparent_huge_pages_available()){
+      kind = LNX_LargePageKind_Transparent;
+    }
+    
+    if (kind != LNX_LargePageKind_Null){
+      lnx_large_page_size = page_size;
+      lnx_large_page_kind = kind;
+      is_ok = 1;
+    }
+  }
+  else{
+    lnx_large_page_kind = LNX_LargePageKind_Null;
+    is_ok = 1;
+  }
+  return is_ok;
 }
 
 internal B32
 os_large_pages_enabled(void)
 {
-  NotImplemented;
-  return 0;
+  return (lnx_large_page_kind != LNX_LargePageKind_Null);
 }
 
 internal U64
 os_large_page_size(void)
 {
-  NotImplemented;
-  return 0;
+  return lnx_large_page_size;
 }
 
 internal void*
@@ -983,6 +1158,65 @@ os_logical_core_count(void)
   return get_nprocs();
 }
 
+internal OS_MemoryPressure
+os_memory_pressure(void)
+{
+  OS_MemoryPressure result = {0};
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- PSI - "some avg10=1.23 avg60=..." (kernel >= 4.20)
+  {
+    String8 psi = lnx_data_from_proc_file_path(scratch.arena, str8_lit("/proc/pressure/memory"));
+    U64 avg10_pos = str8_find_needle(psi, 0, str8_lit("avg10="), 0);
+    if(avg10_pos < psi.size)
+    {
+      String8 avg10 = str8_skip(psi, avg10_pos + 6);
+      U64 num_size = 0;
+      for(;num_size < avg10.size && (char_is_digit(avg10.str[num_size], 10) || avg10.str[num_size] == '.'); num_size += 1);
+      result.stall_pct = (F32)f64_from_str8(str8_prefix(avg10, num_size));
+    }
+  }
+  
+  //- cgroup v2 limit - "0::/path" in /proc/self/cgroup; usage excludes
+  // inactive page cache, which the kernel reclaims before we'd be in trouble
+  {
+    String8 cgroup = lnx_data_from_proc_file_path(scratch.arena, str8_lit("/proc/self/cgroup"));
+    U64 v2_pos = str8_find_needle(cgroup, 0, str8_lit("0::"), 0);
+    if(v2_pos < cgroup.size && (v2_pos == 0 || cgroup.str[v2_pos-1] == '\n'))
+    {
+      String8 cgroup_path = str8_skip(cgroup, v2_pos + 3);
+      cgroup_path = str8_prefix(cgroup_path, str8_find_needle(cgroup_path, 0, str8_lit("\n"), 0));
+      String8 max_string  = str8_skip_chop_whitespace(lnx_data_from_proc_file_path(scratch.arena, push_str8f(scratch.arena, "/sys/fs/cgroup%S/memory.max", cgroup_path)));
+      String8 cur_string  = str8_skip_chop_whitespace(lnx_data_from_proc_file_path(scratch.arena, push_str8f(scratch.arena, "/sys/fs/cgroup%S/memory.current", cgroup_path)));
+      String8 stat_string = lnx_data_from_proc_file_path(scratch.arena, push_str8f(scratch.arena, "/sys/fs/cgroup%S/memory.stat", cgroup_path));
+      if(max_string.size != 0 && !str8_match(max_string, str8_lit("max"), 0))
+      {
+        U64 inactive_file = lnx_u64_from_key_value_text(stat_string, str8_lit("inactive_file "));
+        result.limit = u64_from_str8(max_string, 10);
+        result.usage = u64_from_str8(cur_string, 10);
+        result.usage -= Min(result.usage, inactive_file);
+      }
+    }
+  }
+  
+  //- no cgroup limit -> physical memory, with reclaimable memory not
+  // counted as used
+  if(result.limit == 0)
+  {
+    String8 meminfo = lnx_data_from_proc_file_path(scratch.arena, str8_lit("/proc/meminfo"));
+    U64 total_kb = lnx_u64_from_key_value_text(meminfo, str8_lit("MemTotal:"));
+    U64 available_kb = lnx_u64_from_key_value_text(meminfo, str8_lit("MemAvailable:"));
+    if(total_kb != 0 && available_kb != 0)
+    {
+      result.limit = total_kb*1024;
+      result.usage = (total_kb - Min(total_kb, available_kb))*1024;
+    }
+  }
+  
+  scratch_end(scratch);
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: @os_hooks Process Info (Implemented Per-OS)
 
@@ -1116,27 +1350,78 @@ internal OS_Handle
 os_file_open(OS_AccessFlags flags, String8 path)
 {
   OS_Handle file = {0};
-  NotImplemented;
+  Temp scratch = scratch_begin(0, 0);
+  String8 path_copy = push_str8_copy(scratch.arena, path);
+  int open_flags = 0;
+  if(flags & OS_AccessFlag_Read && flags & OS_AccessFlag_Write)
+  {
+    open_flags = O_RDWR|O_CREAT|O_TRUNC;
+  }
+  else if(flags & OS_AccessFlag_Write)
+  {
+    open_flags = O_WRONLY|O_CREAT|O_TRUNC;
+  }
+  else
+  {
+    open_flags = O_RDONLY;
+  }
+  open_flags |= O_CLOEXEC;
+  int fd = open((char *)path_copy.str, open_flags, 0644);
+  if(fd >= 0)
+  {
+    file.u64[0] = (U64)fd;
+  }
+  scratch_end(scratch);
   return file;
 }
 
 internal void
 os_file_close(OS_Handle file)
 {
-  NotImplemented;
+  if(os_handle_match(file, os_handle_zero())) { return; }
+  int fd = (int)file.u64[0];
+  close(fd);
 }
 
 internal U64
 os_file_read(OS_Handle file, Rng1U64 rng, void *out_data)
 {
-  NotImplemented;
-  return 0;
+  if(os_handle_match(file, os_handle_zero())) { return 0; }
+  int fd = (int)file.u64[0];
+  U64 dst_off = 0;
+  U64 src_off = rng.min;
+  U64 bytes_to_read_total = rng.max-rng.min;
+  for(;dst_off < bytes_to_read_total;)
+  {
+    ssize_t bytes_read = pread(fd, (U8 *)out_data + dst_off, bytes_to_read_total-dst_off, (off_t)src_off);
+    if(bytes_read <= 0)
+    {
+      break;
+    }
+    dst_off += bytes_read;
+    src_off += bytes_read;
+  }
+  return dst_off;
 }
 
 internal void
 os_file_write(OS_Handle file, Rng1U64 rng, void *data)
 {
-  NotImplemented;
+  if(os_handle_match(file, os_handle_zero())) { return; }
+  int fd = (int)file.u64[0];
+  U64 src_off = 0;
+  U64 dst_off = rng.min;
+  U64 bytes_to_write_total = rng.max-rng.min;
+  for(;src_off < bytes_to_write_total;)
+  {
+    ssize_t bytes_written = pwrite(fd, (U8 *)data + src_off, bytes_to_write_total-src_off, (off_t)dst_off);
+    if(bytes_written <= 0)
+    {
+      break;
+    }
+    src_off += bytes_written;
+    dst_off += bytes_written;
+  }
 }
 
 internal B32
@@ -1149,7 +1434,13 @@ internal FileProperties
 os_properties_from_file(OS_Handle file)
 {
   FileProperties props = {0};
-  NotImplemented;
+  if(os_handle_match(file, os_handle_zero())) { return props; }
+  int fd = (int)file.u64[0];
+  struct stat st = {0};
+  if(fstat(fd, &st) == 0)
+  {
+    lnx_file_properties_from_stat(&props, &st);
+  }
   return props;
 }
 
@@ -1211,28 +1502,129 @@ os_properties_from_file_path(String8 path)
 internal OS_Handle
 os_file_map_open(OS_AccessFlags flags, OS_Handle file)
 {
-  NotImplemented;
-  OS_Handle handle = {0};
-  return handle;
+  OS_Handle map = {0};
+  if(!os_handle_match(file, os_handle_zero()))
+  {
+    LNX_Entity *entity = lnx_alloc_entity(LNX_EntityKind_FileMap);
+    entity->file_map.fd = dup((int)file.u64[0]);
+    entity->file_map.prot = 0;
+    entity->file_map.first_view = 0;
+    if(flags & OS_AccessFlag_Read)    {entity->file_map.prot |= PROT_READ;}
+    if(flags & OS_AccessFlag_Write)   {entity->file_map.prot |= PROT_WRITE;}
+    if(flags & OS_AccessFlag_Execute) {entity->file_map.prot |= PROT_EXEC;}
+    
+    // NOTE: read-only & shared-write maps alias the page cache directly;
+    // writable maps without ShareWrite get private copy-on-write pages, so
+    // writes through them are never flushed back to the file.
+    if(!(flags & OS_AccessFlag_Write) || flags & OS_AccessFlag_ShareWrite)
+    {
+      entity->file_map.flags = MAP_SHARED;
+    }
+    else
+    {
+      entity->file_map.flags = MAP_PRIVATE;
+    }
+    
+    if(entity->file_map.fd < 0)
+    {
+      lnx_free_entity(entity);
+      entity = 0;
+    }
+    map.u64[0] = IntFromPtr(entity);
+  }
+  return map;
 }
 
 internal void
 os_file_map_close(OS_Handle map)
 {
-  NotImplemented;
+  if(os_handle_match(map, os_handle_zero())) { return; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(map.u64[0]);
+  for(LNX_Entity *view = entity->file_map.first_view, *next = 0; view != 0; view = next)
+  {
+    next = view->file_map_view.next;
+    munmap(view->file_map_view.base, view->file_map_view.size);
+    lnx_free_entity(view);
+  }
+  close(entity->file_map.fd);
+  lnx_free_entity(entity);
 }
 
 internal void *
 os_file_map_view_open(OS_Handle map, OS_AccessFlags flags, Rng1U64 range)
 {
-  NotImplemented;
-  return 0;
+  if(os_handle_match(map, os_handle_zero())) { return 0; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(map.u64[0]);
+  void *result = 0;
+  
+  //- unpack view protection; views can narrow the map's protection, never widen it
+  int prot = 0;
+  if(flags & OS_AccessFlag_Read)    {prot |= PROT_READ;}
+  if(flags & OS_AccessFlag_Write)   {prot |= PROT_WRITE;}
+  if(flags & OS_AccessFlag_Execute) {prot |= PROT_EXEC;}
+  prot &= entity->file_map.prot;
+  
+  //- mmap offsets must be page aligned - map from the containing page
+  U64 page_size = os_page_size();
+  U64 off_aligned = AlignDownPow2(range.min, page_size);
+  U64 off_pre = range.min - off_aligned;
+  U64 size = dim_1u64(range) + off_pre;
+  
+  //- map
+  if(size > off_pre)
+  {
+    int map_flags = entity->file_map.flags;
+    if(size <= LNX_FILE_MAP_POPULATE_MAX)
+    {
+      map_flags |= MAP_POPULATE;
+    }
+    void *base = mmap(0, size, prot, map_flags, entity->file_map.fd, (off_t)off_aligned);
+    if(base != MAP_FAILED)
+    {
+      if(size > LNX_FILE_MAP_POPULATE_MAX)
+      {
+        madvise(base, LNX_FILE_MAP_POPULATE_MAX, MADV_WILLNEED);
+      }
+      LNX_Entity *view = lnx_alloc_entity(LNX_EntityKind_FileMapView);
+      view->file_map_view.base = base;
+      view->file_map_view.size = size;
+      view->file_map_view.ptr  = (U8 *)base + off_pre;
+      pthread_mutex_lock(&lnx_mutex);
+      view->file_map_view.next = entity->file_map.first_view;
+      entity->file_map.first_view = view;
+      pthread_mutex_unlock(&lnx_mutex);
+      result = view->file_map_view.ptr;
+    }
+  }
+  return result;
 }
 
 internal void
 os_file_map_view_close(OS_Handle map, void *ptr)
 {
-  NotImplemented;
+  if(os_handle_match(map, os_handle_zero()) || ptr == 0) { return; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(map.u64[0]);
+  
+  //- munmap needs the view's size - find & unlink its record
+  LNX_Entity *view = 0;
+  pthread_mutex_lock(&lnx_mutex);
+  for(LNX_Entity **slot = &entity->file_map.first_view; *slot != 0; slot = &(*slot)->file_map_view.next)
+  {
+    if((*slot)->file_map_view.ptr == ptr)
+    {
+      view = *slot;
+      *slot = view->file_map_view.next;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&lnx_mutex);
+  
+  //- unmap
+  if(view != 0)
+  {
+    munmap(view->file_map_view.base, view->file_map_view.size);
+    lnx_free_entity(view);
+  }
 }
 
 //- rjf: directory iteration
@@ -1272,6 +1664,302 @@ os_make_directory(String8 path)
   return(result);
 }
 
+//- file change watching
+
+internal void
+lnx_file_watch_report(Arena *arena, String8List *list, LNX_FileWatchName *name, U64 gen)
+{
+  // NOTE: one save commonly produces several events (MODIFY, CLOSE_WRITE,
+  // ATTRIB, ...) - only report each path once per wait.
+  if(name->last_reported_gen != gen)
+  {
+    name->last_reported_gen = gen;
+    str8_list_push(arena, list, push_str8_copy(arena, name->path));
+  }
+}
+
+internal int
+lnx_file_watch_add_dir(int fd, String8 dir_path)
+{
+  Temp scratch = scratch_begin(0, 0);
+  String8 dir_path_copy = push_str8_copy(scratch.arena, dir_path);
+  int wd = inotify_add_watch(fd, (char*)dir_path_copy.str,
+                             IN_CLOSE_WRITE|IN_MODIFY|IN_ATTRIB|IN_CREATE|IN_DELETE|IN_MOVED_TO|IN_MOVED_FROM);
+  scratch_end(scratch);
+  return wd;
+}
+
+internal OS_Handle
+os_file_watcher_alloc(void)
+{
+  OS_Handle result = {0};
+  int fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+  if(fd >= 0)
+  {
+    LNX_Entity *entity = lnx_alloc_entity(LNX_EntityKind_FileWatcher);
+    MemoryZeroStruct(&entity->file_watcher);
+    entity->file_watcher.fd = fd;
+    entity->file_watcher.arena = arena_alloc();
+    pthread_mutex_init(&entity->file_watcher.mutex, 0);
+    result.u64[0] = IntFromPtr(entity);
+  }
+  return result;
+}
+
+internal void
+os_file_watcher_release(OS_Handle watcher)
+{
+  if(os_handle_match(watcher, os_handle_zero())) { return; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(watcher.u64[0]);
+  close(entity->file_watcher.fd);
+  pthread_mutex_destroy(&entity->file_watcher.mutex);
+  arena_release(entity->file_watcher.arena);
+  lnx_free_entity(entity);
+}
+
+internal B32
+os_file_watcher_add_path(OS_Handle watcher, String8 path)
+{
+  if(os_handle_match(watcher, os_handle_zero())) { return 0; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(watcher.u64[0]);
+  B32 result = 0;
+  String8 dir_path = str8_chop_last_slash(path);
+  String8 name = str8_skip_last_slash(path);
+  if(name.size == path.size)
+  {
+    dir_path = str8_lit(".");
+  }
+  else if(dir_path.size == 0)
+  {
+    dir_path = str8_lit("/");
+  }
+  pthread_mutex_lock(&entity->file_watcher.mutex);
+  {
+    Arena *arena = entity->file_watcher.arena;
+    
+    //- find existing directory watch
+    LNX_FileWatchDir *dir = 0;
+    for(LNX_FileWatchDir *d = entity->file_watcher.first_dir; d != 0; d = d->next)
+    {
+      if(str8_match(d->path, dir_path, 0))
+      {
+        dir = d;
+        break;
+      }
+    }
+    
+    //- directory watch was dropped (IN_IGNORED) -> try to re-arm it
+    if(dir != 0 && dir->wd < 0)
+    {
+      int wd = lnx_file_watch_add_dir(entity->file_watcher.fd, dir_path);
+      if(wd >= 0)
+      {
+        dir->wd = wd;
+        entity->file_watcher.stats.watch_count += 1;
+      }
+      else
+      {
+        dir = 0;
+      }
+    }
+    
+    //- no directory watch -> add one; ENOSPC here means
+    // fs.inotify.max_user_watches is exhausted, so the caller polls
+    else if(dir == 0)
+    {
+      int wd = lnx_file_watch_add_dir(entity->file_watcher.fd, dir_path);
+      if(wd >= 0)
+      {
+        for(LNX_FileWatchDir *d = entity->file_watcher.first_dir; d != 0; d = d->next)
+        {
+          if(d->wd == wd)
+          {
+            dir = d;
+            break;
+          }
+        }
+        if(dir == 0)
+        {
+          dir = push_array(arena, LNX_FileWatchDir, 1);
+          dir->wd = wd;
+          dir->path = push_str8_copy(arena, dir_path);
+          SLLQueuePush(entity->file_watcher.first_dir, entity->file_watcher.last_dir, dir);
+          entity->file_watcher.stats.watch_count += 1;
+        }
+      }
+    }
+    
+    //- register name within directory
+    if(dir != 0)
+    {
+      LNX_FileWatchName *n = 0;
+      for(LNX_FileWatchName *existing = dir->first_name; existing != 0; existing = existing->next)
+      {
+        if(str8_match(existing->name, name, 0))
+        {
+          n = existing;
+          break;
+        }
+      }
+      if(n == 0)
+      {
+        n = push_array(arena, LNX_FileWatchName, 1);
+        n->path = push_str8_copy(arena, path);
+        n->name = str8_skip_last_slash(n->path);
+        SLLQueuePush(dir->first_name, dir->last_name, n);
+        entity->file_watcher.stats.path_count += 1;
+      }
+      result = 1;
+    }
+  }
+  pthread_mutex_unlock(&entity->file_watcher.mutex);
+  return result;
+}
+
+internal String8List
+os_file_watcher_wait(Arena *arena, OS_Handle watcher, U64 endt_us)
+{
+  String8List result = {0};
+  if(os_handle_match(watcher, os_handle_zero())) { return result; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(watcher.u64[0]);
+  
+  //- re-arm directory watches dropped by IN_IGNORED (directory deleted,
+  // unmounted). Callers still consider those paths watched, so until the
+  // directory comes back the wait wakes up periodically to retry; once it
+  // does, every path in it is reported, since nothing was seen in between.
+  B32 has_dropped_dirs = 0;
+  pthread_mutex_lock(&entity->file_watcher.mutex);
+  U64 gen = (entity->file_watcher.wait_gen += 1);
+  for(LNX_FileWatchDir *dir = entity->file_watcher.first_dir; dir != 0; dir = dir->next)
+  {
+    if(dir->wd < 0)
+    {
+      int wd = lnx_file_watch_add_dir(entity->file_watcher.fd, dir->path);
+      if(wd >= 0)
+      {
+        dir->wd = wd;
+        entity->file_watcher.stats.watch_count += 1;
+        for(LNX_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+        {
+          lnx_file_watch_report(arena, &result, n, gen);
+        }
+      }
+      else
+      {
+        has_dropped_dirs = 1;
+      }
+    }
+  }
+  pthread_mutex_unlock(&entity->file_watcher.mutex);
+  
+  //- wait for readability
+  int timeout_ms = -1;
+  if(endt_us != max_U64)
+  {
+    U64 now_us = os_now_microseconds();
+    timeout_ms = (endt_us > now_us) ? (int)Min((endt_us - now_us + 999)/1000, (U64)max_S32) : 0;
+  }
+  if(has_dropped_dirs && (timeout_ms < 0 || timeout_ms > 250))
+  {
+    timeout_ms = 250;
+  }
+  if(result.node_count != 0)
+  {
+    timeout_ms = 0;
+  }
+  struct pollfd pfd = {entity->file_watcher.fd, POLLIN, 0};
+  int poll_result = poll(&pfd, 1, timeout_ms);
+  
+  //- drain events, map to watched paths
+  if(poll_result > 0 && pfd.revents & POLLIN)
+  {
+    Temp scratch = scratch_begin(&arena, 1);
+    U64 buffer_size = KB(16);
+    U8 *buffer = push_array_no_zero(scratch.arena, U8, buffer_size);
+    pthread_mutex_lock(&entity->file_watcher.mutex);
+    for(;;)
+    {
+      ssize_t read_size = read(entity->file_watcher.fd, buffer, buffer_size);
+      if(read_size <= 0)
+      {
+        break;
+      }
+      for(U64 off = 0; off + sizeof(struct inotify_event) <= (U64)read_size;)
+      {
+        struct inotify_event *event = (struct inotify_event *)(buffer + off);
+        off += sizeof(struct inotify_event) + event->len;
+        entity->file_watcher.stats.event_count += 1;
+        
+        //- overflow -> events were dropped; report everything
+        if(event->mask & IN_Q_OVERFLOW)
+        {
+          entity->file_watcher.stats.overflow_count += 1;
+          for(LNX_FileWatchDir *dir = entity->file_watcher.first_dir; dir != 0; dir = dir->next)
+          {
+            for(LNX_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+            {
+              lnx_file_watch_report(arena, &result, n, gen);
+            }
+          }
+          continue;
+        }
+        
+        //- find directories; a re-armed watch can share its wd with
+        // another path naming the same directory
+        for(LNX_FileWatchDir *dir = entity->file_watcher.first_dir; dir != 0; dir = dir->next)
+        {
+          if(dir->wd != event->wd)
+          {
+            continue;
+          }
+          
+          //- watch removed (directory deleted / unmounted) -> report its
+          // files one last time; the watch is re-armed by a later wait
+          if(event->mask & IN_IGNORED)
+          {
+            for(LNX_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+            {
+              lnx_file_watch_report(arena, &result, n, gen);
+            }
+            dir->wd = -1;
+            entity->file_watcher.stats.watch_count -= 1;
+            continue;
+          }
+          
+          //- match name
+          if(event->len != 0)
+          {
+            String8 event_name = str8_cstring(event->name);
+            for(LNX_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+            {
+              if(str8_match(n->name, event_name, 0))
+              {
+                lnx_file_watch_report(arena, &result, n, gen);
+                break;
+              }
+            }
+          }
+        }
+      }
+    }
+    pthread_mutex_unlock(&entity->file_watcher.mutex);
+    scratch_end(scratch);
+  }
+  return result;
+}
+
+internal OS_FileWatcherStats
+os_file_watcher_stats(OS_Handle watcher)
+{
+  OS_FileWatcherStats result = {0};
+  if(os_handle_match(watcher, os_handle_zero())) { return result; }
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(watcher.u64[0]);
+  pthread_mutex_lock(&entity->file_watcher.mutex);
+  result = entity->file_watcher.stats;
+  pthread_mutex_unlock(&entity->file_watcher.mutex);
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: @os_hooks Shared Memory (Implemented Per-OS)
 
@@ -1454,20 +2142,20 @@ os_mutex_alloc(void){
 
 internal void
 os_mutex_release(OS_Handle mutex){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.id);
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
   pthread_mutex_destroy(&entity->mutex);
   lnx_free_entity(entity);
 }
 
 internal void
 os_mutex_take_(OS_Handle mutex){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.id);
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
   pthread_mutex_lock(&entity->mutex);
 }
 
 internal void
 os_mutex_drop_(OS_Handle mutex){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.id);
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
   pthread_mutex_unlock(&entity->mutex);
 }
 
@@ -1476,39 +2164,58 @@ os_mutex_drop_(OS_Handle mutex){
 internal OS_Handle
 os_rw_mutex_alloc(void)
 {
-  OS_Handle result = {0};
-  NotImplemented;
-  return result;
+  // entity
+  LNX_Entity *entity = lnx_alloc_entity(LNX_EntityKind_RWMutex);
+  
+  // pthread
+  pthread_rwlockattr_t attr;
+  pthread_rwlockattr_init(&attr);
+  int pthread_result = pthread_rwlock_init(&entity->rw_mutex, &attr);
+  pthread_rwlockattr_destroy(&attr);
+  if (pthread_result != 0){
+    lnx_free_entity(entity);
+    entity = 0;
+  }
+  
+  // cast to opaque handle
+  OS_Handle result = {IntFromPtr(entity)};
+  return(result);
 }
 
 internal void
 os_rw_mutex_release(OS_Handle rw_mutex)
 {
-  NotImplemented;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(rw_mutex.u64[0]);
+  pthread_rwlock_destroy(&entity->rw_mutex);
+  lnx_free_entity(entity);
 }
 
 internal void
 os_rw_mutex_take_r_(OS_Handle mutex)
 {
-  NotImplemented;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
+  pthread_rwlock_rdlock(&entity->rw_mutex);
 }
 
 internal void
 os_rw_mutex_drop_r_(OS_Handle mutex)
 {
-  NotImplemented;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
+  pthread_rwlock_unlock(&entity->rw_mutex);
 }
 
 internal void
 os_rw_mutex_take_w_(OS_Handle mutex)
 {
-  NotImplemented;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
+  pthread_rwlock_wrlock(&entity->rw_mutex);
 }
 
 internal void
 os_rw_mutex_drop_w_(OS_Handle mutex)
 {
-  NotImplemented;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
+  pthread_rwlock_unlock(&entity->rw_mutex);
 }
 
 //- rjf: condition variables
@@ -1521,9 +2228,16 @@ os_condition_variable_alloc(void){
   // pthread
   pthread_condattr_t attr;
   pthread_condattr_init(&attr);
-  int pthread_result = pthread_cond_init(&entity->cond, &attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  int pthread_result = pthread_cond_init(&entity->cv.cond, &attr);
   pthread_condattr_destroy(&attr);
-  if (pthread_result == -1){
+  if (pthread_result == 0){
+    pthread_result = pthread_mutex_init(&entity->cv.mutex, 0);
+    if (pthread_result != 0){
+      pthread_cond_destroy(&entity->cv.cond);
+    }
+  }
+  if (pthread_result != 0){
     lnx_free_entity(entity);
     entity = 0;
   }
@@ -1535,45 +2249,61 @@ os_condition_variable_alloc(void){
 
 internal void
 os_condition_variable_release(OS_Handle cv){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.id);
-  pthread_cond_destroy(&entity->cond);
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  pthread_cond_destroy(&entity->cv.cond);
+  pthread_mutex_destroy(&entity->cv.mutex);
   lnx_free_entity(entity);
 }
 
 internal B32
 os_condition_variable_wait_(OS_Handle cv, OS_Handle mutex, U64 endt_us){
-  B32 result = false;
-  LNX_Entity *entity_cond = (LNX_Entity*)PtrFromInt(cv.id);
-  LNX_Entity *entity_mutex = (LNX_Entity*)PtrFromInt(mutex.id);
-  // TODO(allen): implement the time control
-  pthread_cond_timedwait(&entity_cond->cond, &entity_mutex->mutex);
+  B32 result = 1;
+  LNX_Entity *entity_cond = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  LNX_Entity *entity_mutex = (LNX_Entity*)PtrFromInt(mutex.u64[0]);
+  if (endt_us == max_U64){
+    pthread_cond_wait(&entity_cond->cv.cond, &entity_mutex->mutex);
+  }
+  else{
+    struct timespec endt_ts = {0};
+    lnx_timespec_from_endt_us(&endt_ts, endt_us);
+    int wait_result = pthread_cond_timedwait(&entity_cond->cv.cond, &entity_mutex->mutex, &endt_ts);
+    result = (wait_result != ETIMEDOUT);
+  }
   return(result);
 }
 
 internal B32
 os_condition_variable_wait_rw_r_(OS_Handle cv, OS_Handle mutex_rw, U64 endt_us)
 {
-  NotImplemented;
-  return 0;
+  LNX_Entity *entity_cond = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  LNX_Entity *entity_rw = (LNX_Entity*)PtrFromInt(mutex_rw.u64[0]);
+  B32 result = lnx_cv_wait_rw(entity_cond, entity_rw, 0, endt_us);
+  return(result);
 }
 
 internal B32
 os_condition_variable_wait_rw_w_(OS_Handle cv, OS_Handle mutex_rw, U64 endt_us)
 {
-  NotImplemented;
-  return 0;
+  LNX_Entity *entity_cond = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  LNX_Entity *entity_rw = (LNX_Entity*)PtrFromInt(mutex_rw.u64[0]);
+  B32 result = lnx_cv_wait_rw(entity_cond, entity_rw, 1, endt_us);
+  return(result);
 }
 
 internal void
 os_condition_variable_signal_(OS_Handle cv){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.id);
-  pthread_cond_signal(&entity->cond);
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  pthread_mutex_lock(&entity->cv.mutex);
+  pthread_cond_signal(&entity->cv.cond);
+  pthread_mutex_unlock(&entity->cv.mutex);
 }
 
 internal void
 os_condition_variable_broadcast_(OS_Handle cv){
-  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.id);
-  DontCompile;
+  LNX_Entity *entity = (LNX_Entity*)PtrFromInt(cv.u64[0]);
+  pthread_mutex_lock(&entity->cv.mutex);
+  pthread_cond_broadcast(&entity->cv.cond);
+  pthread_mutex_unlock(&entity->cv.mutex);
 }
 
 //- rjf: cross-process semaphores
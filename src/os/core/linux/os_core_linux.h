@@ -22,6 +22,8 @@
 #include <errno.h>
 #include <dlfcn.h>
 #include <sys/sysinfo.h>
+#include <sys/inotify.h>
+#include <poll.h>
 
 ////////////////////////////////
 //~ NOTE(allen): File Iterator
@@ -39,7 +41,32 @@ enum LNX_EntityKind{
   LNX_EntityKind_Null,
   LNX_EntityKind_Thread,
   LNX_EntityKind_Mutex,
+  LNX_EntityKind_RWMutex,
   LNX_EntityKind_ConditionVariable,
+  LNX_EntityKind_FileMap,
+  LNX_EntityKind_FileMapView,
+  LNX_EntityKind_FileWatcher,
+};
+
+// NOTE: inotify watches are placed on a watched file's parent directory,
+// not on the file itself: editors commonly save by writing a temporary and
+// renaming it over the original, which would silently end a per-inode watch,
+// and many files in one directory then share a single watch.
+typedef struct LNX_FileWatchName LNX_FileWatchName;
+struct LNX_FileWatchName{
+  LNX_FileWatchName *next;
+  String8 name;
+  String8 path;
+  U64 last_reported_gen;
+};
+
+typedef struct LNX_FileWatchDir LNX_FileWatchDir;
+struct LNX_FileWatchDir{
+  LNX_FileWatchDir *next;
+  int wd;
+  String8 path;
+  LNX_FileWatchName *first_name;
+  LNX_FileWatchName *last_name;
 };
 
 struct LNX_Entity{
@@ -53,10 +80,54 @@ struct LNX_Entity{
       pthread_t handle;
     } thread;
     pthread_mutex_t mutex;
-    pthread_cond_t cond;
+    pthread_rwlock_t rw_mutex;
+    struct{
+      pthread_cond_t cond;
+      pthread_mutex_t mutex;
+    } cv;
+    struct{
+      int fd;
+      int prot;
+      int flags;
+      LNX_Entity *first_view;
+    } file_map;
+    struct{
+      LNX_Entity *next;
+      void *base;
+      U64 size;
+      void *ptr;
+    } file_map_view;
+    struct{
+      int fd;
+      Arena *arena;
+      pthread_mutex_t mutex;
+      LNX_FileWatchDir *first_dir;
+      LNX_FileWatchDir *last_dir;
+      U64 wait_gen;
+      OS_FileWatcherStats stats;
+    } file_watcher;
   };
 };
 
+////////////////////////////////
+//~ Large Pages
+
+typedef enum LNX_LargePageKind{
+  LNX_LargePageKind_Null,
+  LNX_LargePageKind_HugeTLB,     // explicit hugetlbfs pool pages (MAP_HUGETLB)
+  LNX_LargePageKind_Transparent, // transparent huge pages (MADV_HUGEPAGE)
+} LNX_LargePageKind;
+
+////////////////////////////////
+//~ File Map Tuning
+
+// NOTE: views at or below this size are prefaulted on open
+// (MAP_POPULATE); larger views (e.g. multi-GB .raddbg files) are mapped lazily
+// and only have this many leading bytes - headers & section tables - hinted
+// with MADV_WILLNEED, so the rest is paged in on first touch straight from the
+// page cache, with no heap copy.
+#define LNX_FILE_MAP_POPULATE_MAX MB(64)
+
 ////////////////////////////////
 //~ NOTE(allen): Safe Call Chain
 
@@ -75,13 +146,22 @@ internal void lnx_date_time_from_tm(DateTime *out, struct tm *in, U32 msec);
 internal void lnx_tm_from_date_time(struct tm *out, DateTime *in);
 internal void lnx_dense_time_from_timespec(DenseTime *out, struct timespec *in);
 internal void lnx_file_properties_from_stat(FileProperties *out, struct stat *in);
+internal void lnx_timespec_from_endt_us(struct timespec *out, U64 endt_us);
+
+internal U64 lnx_large_page_size_from_meminfo(void);
+internal B32 lnx_transparent_huge_pages_available(void);
 
 internal String8 lnx_string_from_signal(int signum);
 internal String8 lnx_string_from_errno(int error_number);
 
+internal String8 lnx_data_from_proc_file_path(Arena *arena, String8 path);
+internal U64 lnx_u64_from_key_value_text(String8 text, String8 key);
+
 internal LNX_Entity* lnx_alloc_entity(LNX_EntityKind kind);
 internal void lnx_free_entity(LNX_Entity *entity);
 internal void* lnx_thread_base(void *ptr);
+internal void lnx_file_watch_report(Arena *arena, String8List *list, LNX_FileWatchName *name, U64 gen);
+internal B32 lnx_cv_wait_rw(LNX_Entity *cv_entity, LNX_Entity *rw_entity, B32 write_mode, U64 endt_us);
 
 internal void lnx_safe_call_sig_handler(int);
 
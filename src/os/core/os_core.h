@@ -80,6 +80,29 @@ struct OS_PathFromUser
   String8 *filter_names;
 };
 
+////////////////////////////////
+//~ Memory Pressure Types
+
+typedef struct OS_MemoryPressure OS_MemoryPressure;
+struct OS_MemoryPressure
+{
+  F32 stall_pct; // % of recent wall time some task stalled on memory (0 if unknown)
+  U64 limit;     // memory limit applying to this process, in bytes (0 if none/unknown)
+  U64 usage;     // bytes currently counted against `limit`
+};
+
+////////////////////////////////
+//~ File Watcher Types
+
+typedef struct OS_FileWatcherStats OS_FileWatcherStats;
+struct OS_FileWatcherStats
+{
+  U64 watch_count;    // OS-level watches (e.g. one per watched directory)
+  U64 path_count;     // paths reported through watches
+  U64 event_count;    // change events received
+  U64 overflow_count; // event queue overflows (all paths reported as changed)
+};
+
 ////////////////////////////////
 //~ allen: Launch Input
 
@@ -230,6 +253,7 @@ internal String8      os_machine_name(void);
 internal U64          os_page_size(void);
 internal U64          os_allocation_granularity(void);
 internal U64          os_logical_core_count(void);
+internal OS_MemoryPressure os_memory_pressure(void);
 
 ////////////////////////////////
 //~ rjf: @os_hooks Process Info (Implemented Per-OS)
@@ -276,6 +300,18 @@ internal void         os_file_iter_end(OS_FileIter *iter);
 //- rjf: directory creation
 internal B32 os_make_directory(String8 path);
 
+//- file change watching
+// NOTE: add_path returns 0 when the path cannot be watched (unsupported
+// platform, watch limits reached, missing directory) - callers must keep
+// polling such paths. wait returns the added paths which changed, all added
+// paths if the OS dropped events, and all paths of a watched directory that
+// was deleted or re-created.
+internal OS_Handle           os_file_watcher_alloc(void);
+internal void                os_file_watcher_release(OS_Handle watcher);
+internal B32                 os_file_watcher_add_path(OS_Handle watcher, String8 path);
+internal String8List         os_file_watcher_wait(Arena *arena, OS_Handle watcher, U64 endt_us);
+internal OS_FileWatcherStats os_file_watcher_stats(OS_Handle watcher);
+
 ////////////////////////////////
 //~ rjf: @os_hooks Shared Memory (Implemented Per-OS)
 
@@ -0,0 +1,218 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Time to first symbol lookup in a RADDBG file, loading it through
+// os_file_read into a heap copy vs os_file_map_view_open, with a cold & a
+// warm page cache. Each run: load -> raddbg_parse -> procedure name map ->
+// lookup -> first voff of the match.
+//
+// usage: os_file_map_bench [--input:<file.raddbg> --name:<procedure>]
+//                          [--symbols:<n>] [--runs:<n>]
+// with no input a synthetic RADDBG is baked to a temporary file first.
+// cold runs drop the file's pages with posix_fadvise; needs a clean file.
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_format/raddbg_format_parse.h"
+#include "raddbg_cons/raddbg_cons.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_format/raddbg_format_parse.c"
+#include "raddbg_cons/raddbg_cons.c"
+#include "raddbg_cons/test/raddbg_cons_test_root.c"
+
+#if OS_LINUX
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+////////////////////////////////
+//~ Types
+
+typedef enum FMB_Mode{
+  FMB_Mode_Read,
+  FMB_Mode_Map,
+  FMB_Mode_COUNT
+} FMB_Mode;
+
+typedef struct FMB_Timing{
+  U64 load_us;
+  U64 total_us;
+  U64 first_voff;
+  B32 found;
+} FMB_Timing;
+
+////////////////////////////////
+//~ Helpers
+
+static void
+fmb_write_baked_data(void *write_ptr, U64 off, void *data, U64 size){
+  OS_Handle file = *(OS_Handle*)write_ptr;
+  os_file_write(file, r1u64(off, off + size), data);
+}
+
+static void
+fmb_drop_page_cache(String8 path){
+#if OS_LINUX
+  Temp scratch = scratch_begin(0, 0);
+  String8 path_copy = push_str8_copy(scratch.arena, path);
+  int fd = open((char*)path_copy.str, O_RDONLY);
+  if (fd >= 0){
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+  scratch_end(scratch);
+#endif
+}
+
+static FMB_Timing
+fmb_time_first_lookup(FMB_Mode mode, String8 path, String8 name){
+  FMB_Timing result = {0};
+  Temp scratch = scratch_begin(0, 0);
+  U64 begin_us = os_now_microseconds();
+  
+  // load
+  OS_Handle file = os_file_open(OS_AccessFlag_Read|OS_AccessFlag_ShareRead, path);
+  FileProperties props = os_properties_from_file(file);
+  OS_Handle map = {0};
+  U8 *data = 0;
+  switch (mode){
+    case FMB_Mode_Read:{
+      data = push_array_no_zero(scratch.arena, U8, props.size);
+      os_file_read(file, r1u64(0, props.size), data);
+    }break;
+    case FMB_Mode_Map:{
+      map = os_file_map_open(OS_AccessFlag_Read, file);
+      data = (U8*)os_file_map_view_open(map, OS_AccessFlag_Read, r1u64(0, props.size));
+    }break;
+  }
+  result.load_us = os_now_microseconds() - begin_us;
+  
+  // parse & lookup
+  RADDBG_Parsed parsed = {0};
+  if (data != 0 && raddbg_parse(data, props.size, &parsed) == RADDBG_ParseStatus_Good){
+    RADDBG_NameMap *mapptr = raddbg_name_map_from_kind(&parsed, RADDBG_NameMapKind_Procedures);
+    RADDBG_ParsedNameMap name_map = {0};
+    raddbg_name_map_parse(&parsed, mapptr, &name_map);
+    RADDBG_NameMapNode *node = raddbg_name_map_lookup(&parsed, &name_map, name.str, name.size);
+    RADDBG_U32 match_count = 0;
+    RADDBG_U32 *matches = raddbg_matches_from_map_node(&parsed, node, &match_count);
+    if (match_count != 0){
+      result.found = 1;
+      result.first_voff = raddbg_first_voff_from_proc(&parsed, matches[0]);
+    }
+  }
+  result.total_us = os_now_microseconds() - begin_us;
+  
+  // release
+  if (mode == FMB_Mode_Map){
+    os_file_map_view_close(map, data);
+    os_file_map_close(map);
+  }
+  os_file_close(file);
+  scratch_end(scratch);
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  String8 input_path = {0};
+  String8 name = {0};
+  U64 symbol_count = 500000;
+  U64 runs = 5;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    input_path = cmd_line_string(&cmd_line, str8_lit("input"));
+    name = cmd_line_string(&cmd_line, str8_lit("name"));
+    String8 symbols_string = cmd_line_string(&cmd_line, str8_lit("symbols"));
+    String8 runs_string = cmd_line_string(&cmd_line, str8_lit("runs"));
+    if (symbols_string.size != 0){
+      try_u64_from_str8_c_rules(symbols_string, &symbol_count);
+    }
+    if (runs_string.size != 0){
+      try_u64_from_str8_c_rules(runs_string, &runs);
+    }
+    runs = Max(runs, 1);
+  }
+  
+  // no input: bake a synthetic file
+  B32 is_synthetic = (input_path.size == 0);
+  if (is_synthetic){
+    input_path = str8_lit("/tmp/os_file_map_bench.raddbg");
+    name = cons_test_symbol_name(scratch.arena, symbol_count - symbol_count%3 - 1);
+    
+    U64 begin_us = os_now_microseconds();
+    CONS_TestRootParams params = {0};
+    params.seed = 1;
+    params.type_count = symbol_count/10;
+    params.unit_count = symbol_count/500 + 1;
+    params.lines_per_unit = 4000;
+    params.symbol_count = symbol_count;
+    CONS_Root *root = cons_test_root_build(scratch.arena, &params);
+    OS_Handle out_file = os_file_open(OS_AccessFlag_Write, input_path);
+    cons_bake_file_stream(scratch.arena, root, fmb_write_baked_data, &out_file);
+    os_file_close(out_file);
+    cons_root_release(root);
+    printf("baked synthetic input in %.2fs\n", (os_now_microseconds() - begin_us)/1000000.0);
+  }
+  if (name.size == 0){
+    printf("error: --input needs --name:<procedure>\n");
+    return(1);
+  }
+  
+  OS_Handle input_file = os_file_open(OS_AccessFlag_Read|OS_AccessFlag_ShareRead, input_path);
+  FileProperties props = os_properties_from_file(input_file);
+  os_file_close(input_file);
+  printf("input: %.*s, %.1f MB, looking up '%.*s'\n",
+         str8_varg(input_path), props.size/(1024.0*1024.0), str8_varg(name));
+  
+  // cold & warm runs for each loading mode
+  char *mode_names[] = {"read", "mmap"};
+  for (U64 pass = 0; pass < 2; pass += 1){
+    B32 cold = (pass == 0);
+    for (U64 mode = 0; mode < FMB_Mode_COUNT; mode += 1){
+      U64 load_us_total = 0;
+      U64 total_us_total = 0;
+      U64 total_us_min = max_U64;
+      if (!cold){
+        fmb_time_first_lookup((FMB_Mode)mode, input_path, name);
+      }
+      for (U64 run_idx = 0; run_idx < runs; run_idx += 1){
+        if (cold){
+          fmb_drop_page_cache(input_path);
+        }
+        FMB_Timing timing = fmb_time_first_lookup((FMB_Mode)mode, input_path, name);
+        if (!timing.found){
+          printf("error: '%.*s' not found\n", str8_varg(name));
+          return(1);
+        }
+        load_us_total += timing.load_us;
+        total_us_total += timing.total_us;
+        total_us_min = Min(total_us_min, timing.total_us);
+      }
+      printf("%s %s: time to first lookup mean %.2fms (min %.2fms), of which load %.2fms\n",
+             cold ? "cold" : "warm", mode_names[mode],
+             total_us_total/(1000.0*runs), total_us_min/1000.0, load_us_total/(1000.0*runs));
+    }
+  }
+  
+  if (is_synthetic){
+    os_delete_file_at_path(input_path);
+  }
+  scratch_end(scratch);
+  return(0);
+}
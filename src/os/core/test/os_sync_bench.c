@@ -0,0 +1,286 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Times the OS layer's synchronization primitives:
+// * uncontended take/drop cost of mutexes & reader/writer mutexes
+// * read-mostly throughput at 1, 4 & 16 threads, rw mutex vs plain mutex
+// * timed condition variable waits: timeout overshoot & signal -> wake latency
+//
+// usage: os_sync_bench [--iters:<n>] [--write_every:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+
+////////////////////////////////
+//~ Shared State
+
+typedef struct SB_Table{
+  U64 slots[16];
+} SB_Table;
+
+typedef struct SB_Shared{
+  // workload
+  B32 use_rw;
+  U64 iters;
+  U64 write_every;
+  OS_Handle mutex;
+  OS_Handle rw_mutex;
+  SB_Table table;
+  U64 write_count;
+  
+  // start & done barriers
+  volatile U64 go;
+  U64 done_count;
+  OS_Handle done_mutex;
+  OS_Handle done_cv;
+  
+  // ping-pong
+  U64 turn;
+  U64 rounds;
+  U64 timeouts;
+  OS_Handle pp_cv;
+} SB_Shared;
+
+global SB_Shared sb = {0};
+global U64 sb_sink = 0;
+
+////////////////////////////////
+//~ Helpers
+
+static void
+sb_done(void){
+  OS_MutexScope(sb.done_mutex){
+    sb.done_count += 1;
+  }
+  os_condition_variable_broadcast(sb.done_cv);
+}
+
+static void
+sb_wait_done(U64 count){
+  OS_MutexScope(sb.done_mutex){
+    for (;sb.done_count < count;){
+      os_condition_variable_wait(sb.done_cv, sb.done_mutex, max_U64);
+    }
+  }
+}
+
+static U64
+sb_table_sum(SB_Table *table){
+  U64 result = 0;
+  for (U64 i = 0; i < ArrayCount(table->slots); i += 1){
+    result += table->slots[i];
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Read-Mostly Worker
+
+static void
+sb_read_mostly_thread(void *ptr){
+  U64 seed = (U64)ptr*0x9E3779B97F4A7C15ull + 1;
+  U64 sink = 0;
+  for (;!sb.go;){}
+  for (U64 i = 0; i < sb.iters; i += 1){
+    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+    B32 is_write = (seed % sb.write_every) == 0;
+    if (sb.use_rw){
+      if (is_write){
+        OS_MutexScopeW(sb.rw_mutex){
+          sb.table.slots[seed & 15] += 1;
+          sb.write_count += 1;
+        }
+      }
+      else{
+        OS_MutexScopeR(sb.rw_mutex){
+          sink += sb_table_sum(&sb.table);
+        }
+      }
+    }
+    else{
+      OS_MutexScope(sb.mutex){
+        if (is_write){
+          sb.table.slots[seed & 15] += 1;
+          sb.write_count += 1;
+        }
+        else{
+          sink += sb_table_sum(&sb.table);
+        }
+      }
+    }
+  }
+  ins_atomic_u64_add_eval(&sb_sink, sink);
+  sb_done();
+}
+
+static F64
+sb_run_read_mostly(B32 use_rw, U64 thread_count){
+  MemoryZeroStruct(&sb.table);
+  sb.use_rw = use_rw;
+  sb.write_count = 0;
+  sb.done_count = 0;
+  sb.go = 0;
+  for (U64 i = 0; i < thread_count; i += 1){
+    os_release_thread_handle(os_launch_thread(sb_read_mostly_thread, (void*)(i + 1), 0));
+  }
+  U64 begin_us = os_now_microseconds();
+  sb.go = 1;
+  sb_wait_done(thread_count);
+  U64 end_us = os_now_microseconds();
+  
+  // every write must have landed exactly once
+  if (sb_table_sum(&sb.table) != sb.write_count){
+    printf("error: table sum %llu != write count %llu\n",
+           (unsigned long long)sb_table_sum(&sb.table), (unsigned long long)sb.write_count);
+    exit(1);
+  }
+  
+  F64 ops = (F64)(sb.iters*thread_count);
+  return(ops/(F64)(end_us - begin_us));
+}
+
+////////////////////////////////
+//~ Ping-Pong Worker
+
+// two threads take turns; each waits (with a deadline) for the other to flip
+// `turn`, so every round trip is two signal -> wake handoffs
+
+static void
+sb_ping_pong_thread(void *ptr){
+  U64 me = (U64)ptr;
+  for (U64 i = 0; i < sb.rounds; i += 1){
+    OS_MutexScopeW(sb.rw_mutex){
+      for (;sb.turn != me;){
+        if (!os_condition_variable_wait_rw_w(sb.pp_cv, sb.rw_mutex, os_now_microseconds() + 1000000)){
+          sb.timeouts += 1;
+        }
+      }
+      sb.turn = !me;
+    }
+    os_condition_variable_broadcast(sb.pp_cv);
+  }
+  sb_done();
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  sb.iters = 1000000;
+  sb.write_every = 32;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 iters_string = cmd_line_string(&cmd_line, str8_lit("iters"));
+    String8 write_every_string = cmd_line_string(&cmd_line, str8_lit("write_every"));
+    if (iters_string.size != 0){
+      try_u64_from_str8_c_rules(iters_string, &sb.iters);
+    }
+    if (write_every_string.size != 0){
+      try_u64_from_str8_c_rules(write_every_string, &sb.write_every);
+    }
+    sb.write_every = Max(sb.write_every, 1);
+  }
+  
+  // setup
+  sb.mutex = os_mutex_alloc();
+  sb.rw_mutex = os_rw_mutex_alloc();
+  sb.done_mutex = os_mutex_alloc();
+  sb.done_cv = os_condition_variable_alloc();
+  sb.pp_cv = os_condition_variable_alloc();
+  printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+  
+  // uncontended take/drop
+  {
+    U64 n = sb.iters*4;
+    U64 t0 = os_now_microseconds();
+    for (U64 i = 0; i < n; i += 1){ os_mutex_take(sb.mutex); os_mutex_drop(sb.mutex); }
+    U64 t1 = os_now_microseconds();
+    for (U64 i = 0; i < n; i += 1){ os_rw_mutex_take_r(sb.rw_mutex); os_rw_mutex_drop_r(sb.rw_mutex); }
+    U64 t2 = os_now_microseconds();
+    for (U64 i = 0; i < n; i += 1){ os_rw_mutex_take_w(sb.rw_mutex); os_rw_mutex_drop_w(sb.rw_mutex); }
+    U64 t3 = os_now_microseconds();
+    printf("uncontended take+drop (ns): mutex %.1f, rw read %.1f, rw write %.1f\n",
+           1000.0*(t1 - t0)/n, 1000.0*(t2 - t1)/n, 1000.0*(t3 - t2)/n);
+  }
+  
+  // read-mostly throughput
+  printf("read-mostly, 1 write per %llu ops (Mops/s):\n", (unsigned long long)sb.write_every);
+  {
+    U64 thread_counts[] = {1, 4, 16};
+    for (U64 i = 0; i < ArrayCount(thread_counts); i += 1){
+      F64 mutex_mops = sb_run_read_mostly(0, thread_counts[i]);
+      F64 rw_mops = sb_run_read_mostly(1, thread_counts[i]);
+      printf("  %2llu threads: mutex %.2f, rw mutex %.2f\n",
+             (unsigned long long)thread_counts[i], mutex_mops, rw_mops);
+    }
+  }
+  
+  // timed waits with no signal: must time out, near the deadline
+  {
+    U64 wait_us_list[] = {1000, 10000};
+    for (U64 i = 0; i < ArrayCount(wait_us_list); i += 1){
+      U64 wait_us = wait_us_list[i];
+      U64 tries = 50;
+      U64 signaled = 0;
+      U64 overshoot_total = 0;
+      U64 overshoot_max = 0;
+      for (U64 try_idx = 0; try_idx < tries; try_idx += 1){
+        U64 begin_us = os_now_microseconds();
+        U64 endt_us = begin_us + wait_us;
+        B32 result = 0;
+        OS_MutexScope(sb.mutex){
+          result = os_condition_variable_wait(sb.done_cv, sb.mutex, endt_us);
+        }
+        U64 end_us = os_now_microseconds();
+        U64 overshoot = (end_us > endt_us) ? end_us - endt_us : 0;
+        signaled += (result != 0);
+        overshoot_total += overshoot;
+        overshoot_max = Max(overshoot_max, overshoot);
+        if (end_us < endt_us){
+          printf("error: %lluus wait returned %lluus early\n",
+                 (unsigned long long)wait_us, (unsigned long long)(endt_us - end_us));
+          exit(1);
+        }
+      }
+      printf("timed wait %5lluus: overshoot mean %.1fus, max %lluus, %llu/%llu reported signaled\n",
+             (unsigned long long)wait_us, (F64)overshoot_total/tries, (unsigned long long)overshoot_max,
+             (unsigned long long)signaled, (unsigned long long)tries);
+      if (signaled != 0){
+        exit(1);
+      }
+    }
+  }
+  
+  // signal -> wake latency, through rw-mutex waits
+  {
+    sb.rounds = sb.iters/20;
+    sb.turn = 0;
+    sb.timeouts = 0;
+    sb.done_count = 0;
+    U64 begin_us = os_now_microseconds();
+    os_release_thread_handle(os_launch_thread(sb_ping_pong_thread, (void*)0, 0));
+    os_release_thread_handle(os_launch_thread(sb_ping_pong_thread, (void*)1, 0));
+    sb_wait_done(2);
+    U64 end_us = os_now_microseconds();
+    printf("rw-mutex cv ping-pong: %.2fus per handoff over %llu round trips, %llu deadline timeouts\n",
+           (F64)(end_us - begin_us)/(2*sb.rounds), (unsigned long long)sb.rounds,
+           (unsigned long long)sb.timeouts);
+    if (sb.timeouts != 0){
+      exit(1);
+    }
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
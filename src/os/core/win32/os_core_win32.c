@@ -464,6 +464,19 @@ os_logical_core_count(void)
   return sysinfo.dwNumberOfProcessors;
 }
 
+internal OS_MemoryPressure
+os_memory_pressure(void)
+{
+  OS_MemoryPressure result = {0};
+  MEMORYSTATUSEX status = {sizeof(status)};
+  if(GlobalMemoryStatusEx(&status))
+  {
+    result.limit = status.ullTotalPhys;
+    result.usage = status.ullTotalPhys - status.ullAvailPhys;
+  }
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: @os_hooks Process Info (Implemented Per-OS)
 
@@ -1002,6 +1015,351 @@ os_make_directory(String8 path)
   return(result);
 }
 
+//- file change watching
+
+internal void
+w32_file_watch_report(Arena *arena, String8List *list, W32_FileWatchName *name, U64 gen)
+{
+  // NOTE: one save commonly produces several notifications (size, last
+  // write, attributes, ...) - only report each path once per wait.
+  if(name->last_reported_gen != gen)
+  {
+    name->last_reported_gen = gen;
+    str8_list_push(arena, list, push_str8_copy(arena, name->path));
+  }
+}
+
+internal B32
+w32_file_watch_arm_dir(W32_Entity *entity, W32_FileWatchDir *dir)
+{
+  B32 result = 0;
+  
+  //- open directory & attach it to the watcher's completion port
+  if(dir->handle == 0)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    String16 path16 = str16_from_8(scratch.arena, dir->path);
+    HANDLE handle = CreateFileW((WCHAR*)path16.str, FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, 0, OPEN_EXISTING,
+                                FILE_FLAG_BACKUP_SEMANTICS|FILE_FLAG_OVERLAPPED, 0);
+    scratch_end(scratch);
+    if(handle != INVALID_HANDLE_VALUE)
+    {
+      if(CreateIoCompletionPort(handle, entity->file_watcher.port, (ULONG_PTR)dir, 0) != 0)
+      {
+        dir->handle = handle;
+      }
+      else
+      {
+        CloseHandle(handle);
+      }
+    }
+  }
+  
+  //- issue the next read; completions arrive through the port
+  if(dir->handle != 0)
+  {
+    MemoryZeroStruct(&dir->overlapped);
+    if(ReadDirectoryChangesW(dir->handle, dir->buffer, W32_FILE_WATCH_BUFFER_SIZE, 0,
+                             FILE_NOTIFY_CHANGE_FILE_NAME|FILE_NOTIFY_CHANGE_LAST_WRITE|
+                             FILE_NOTIFY_CHANGE_SIZE|FILE_NOTIFY_CHANGE_ATTRIBUTES|FILE_NOTIFY_CHANGE_CREATION,
+                             0, &dir->overlapped, 0))
+    {
+      result = 1;
+    }
+    else
+    {
+      w32_file_watch_disarm_dir(entity, dir);
+    }
+  }
+  return result;
+}
+
+internal void
+w32_file_watch_disarm_dir(W32_Entity *entity, W32_FileWatchDir *dir)
+{
+  // NOTE: only called when no read is outstanding on the handle - either it
+  // failed to issue, or its completion was already dequeued.
+  if(dir->handle != 0)
+  {
+    CloseHandle(dir->handle);
+    dir->handle = 0;
+  }
+}
+
+internal OS_Handle
+os_file_watcher_alloc(void)
+{
+  OS_Handle result = {0};
+  HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, 0, 0, 1);
+  if(port != 0)
+  {
+    W32_Entity *entity = w32_alloc_entity(W32_EntityKind_FileWatcher);
+    entity->file_watcher.port = port;
+    entity->file_watcher.arena = arena_alloc();
+    InitializeCriticalSection(&entity->file_watcher.mutex);
+    result.u64[0] = IntFromPtr(entity);
+  }
+  return result;
+}
+
+internal void
+os_file_watcher_release(OS_Handle watcher)
+{
+  if(os_handle_match(watcher, os_handle_zero())) { return; }
+  W32_Entity *entity = (W32_Entity*)PtrFromInt(watcher.u64[0]);
+  for(W32_FileWatchDir *dir = entity->file_watcher.first_dir; dir != 0; dir = dir->next)
+  {
+    if(dir->handle != 0)
+    {
+      // NOTE: the kernel writes into dir->buffer until the read completes,
+      // so wait for the cancellation before the arena goes away.
+      DWORD bytes = 0;
+      CancelIoEx(dir->handle, &dir->overlapped);
+      GetOverlappedResult(dir->handle, &dir->overlapped, &bytes, 1);
+      CloseHandle(dir->handle);
+    }
+  }
+  CloseHandle(entity->file_watcher.port);
+  DeleteCriticalSection(&entity->file_watcher.mutex);
+  arena_release(entity->file_watcher.arena);
+  w32_free_entity(entity);
+}
+
+internal B32
+os_file_watcher_add_path(OS_Handle watcher, String8 path)
+{
+  if(os_handle_match(watcher, os_handle_zero())) { return 0; }
+  W32_Entity *entity = (W32_Entity*)PtrFromInt(watcher.u64[0]);
+  B32 result = 0;
+  String8 dir_path = str8_chop_last_slash(path);
+  String8 name = str8_skip_last_slash(path);
+  Temp scratch = scratch_begin(0, 0);
+  if(name.size == path.size)
+  {
+    dir_path = str8_lit(".");
+  }
+  else if(dir_path.size == 0 || dir_path.str[dir_path.size-1] == ':')
+  {
+    // NOTE: "C:" names the drive's current directory, not its root
+    dir_path = push_str8f(scratch.arena, "%S\\", dir_path);
+  }
+  EnterCriticalSection(&entity->file_watcher.mutex);
+  {
+    Arena *arena = entity->file_watcher.arena;
+    
+    //- find existing directory watch
+    W32_FileWatchDir *dir = 0;
+    for(W32_FileWatchDir *d = entity->file_watcher.first_dir; d != 0; d = d->next)
+    {
+      if(str8_match(d->path, dir_path, StringMatchFlag_CaseInsensitive|StringMatchFlag_SlashInsensitive))
+      {
+        dir = d;
+        break;
+      }
+    }
+    
+    //- directory watch was dropped (deleted, unmounted) -> try to re-arm it
+    if(dir != 0 && dir->handle == 0)
+    {
+      if(w32_file_watch_arm_dir(entity, dir))
+      {
+        entity->file_watcher.stats.watch_count += 1;
+      }
+      else
+      {
+        dir = 0;
+      }
+    }
+    
+    //- no directory watch -> add one
+    else if(dir == 0)
+    {
+      dir = push_array(arena, W32_FileWatchDir, 1);
+      dir->path = push_str8_copy(arena, dir_path);
+      dir->buffer = push_array_no_zero(arena, U8, W32_FILE_WATCH_BUFFER_SIZE);
+      if(w32_file_watch_arm_dir(entity, dir))
+      {
+        SLLQueuePush(entity->file_watcher.first_dir, entity->file_watcher.last_dir, dir);
+        entity->file_watcher.stats.watch_count += 1;
+      }
+      else
+      {
+        dir = 0;
+      }
+    }
+    
+    //- register name within directory
+    if(dir != 0)
+    {
+      W32_FileWatchName *n = 0;
+      for(W32_FileWatchName *existing = dir->first_name; existing != 0; existing = existing->next)
+      {
+        if(str8_match(existing->name, name, StringMatchFlag_CaseInsensitive))
+        {
+          n = existing;
+          break;
+        }
+      }
+      if(n == 0)
+      {
+        n = push_array(arena, W32_FileWatchName, 1);
+        n->path = push_str8_copy(arena, path);
+        n->name = str8_skip_last_slash(n->path);
+        SLLQueuePush(dir->first_name, dir->last_name, n);
+        entity->file_watcher.stats.path_count += 1;
+      }
+      result = 1;
+    }
+  }
+  LeaveCriticalSection(&entity->file_watcher.mutex);
+  scratch_end(scratch);
+  return result;
+}
+
+internal String8List
+os_file_watcher_wait(Arena *arena, OS_Handle watcher, U64 endt_us)
+{
+  String8List result = {0};
+  if(os_handle_match(watcher, os_handle_zero()))
+  {
+    os_sleep_milliseconds(w32_sleep_ms_from_endt_us(endt_us));
+    return result;
+  }
+  W32_Entity *entity = (W32_Entity*)PtrFromInt(watcher.u64[0]);
+  
+  //- re-arm directory watches that were dropped; as on Linux, wake up
+  // periodically to retry while any are missing, and report all of a
+  // directory's paths once its watch is back.
+  B32 has_dropped_dirs = 0;
+  EnterCriticalSection(&entity->file_watcher.mutex);
+  U64 gen = (entity->file_watcher.wait_gen += 1);
+  for(W32_FileWatchDir *dir = entity->file_watcher.first_dir; dir != 0; dir = dir->next)
+  {
+    if(dir->handle == 0)
+    {
+      if(w32_file_watch_arm_dir(entity, dir))
+      {
+        entity->file_watcher.stats.watch_count += 1;
+        for(W32_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+        {
+          w32_file_watch_report(arena, &result, n, gen);
+        }
+      }
+      else
+      {
+        has_dropped_dirs = 1;
+      }
+    }
+  }
+  LeaveCriticalSection(&entity->file_watcher.mutex);
+  
+  //- wait for the first completion, then drain the rest without blocking
+  DWORD timeout_ms = w32_sleep_ms_from_endt_us(endt_us);
+  if(has_dropped_dirs && timeout_ms > 250)
+  {
+    timeout_ms = 250;
+  }
+  if(result.node_count != 0)
+  {
+    timeout_ms = 0;
+  }
+  for(;;)
+  {
+    DWORD bytes = 0;
+    ULONG_PTR key = 0;
+    OVERLAPPED *overlapped = 0;
+    BOOL ok = GetQueuedCompletionStatus(entity->file_watcher.port, &bytes, &key, &overlapped, timeout_ms);
+    DWORD error = ok ? 0 : GetLastError();
+    if(overlapped == 0)
+    {
+      break;
+    }
+    timeout_ms = 0;
+    W32_FileWatchDir *dir = (W32_FileWatchDir *)key;
+    EnterCriticalSection(&entity->file_watcher.mutex);
+    B32 report_all = 0;
+    
+    //- notifications were dropped -> report everything in the directory
+    if(!ok && error == ERROR_NOTIFY_ENUM_DIR)
+    {
+      ok = 1;
+      report_all = 1;
+      entity->file_watcher.stats.overflow_count += 1;
+    }
+    
+    //- read failed (directory deleted, handle invalidated) -> report its
+    // files one last time; the watch is re-armed by a later wait
+    else if(!ok)
+    {
+      report_all = 1;
+      w32_file_watch_disarm_dir(entity, dir);
+      entity->file_watcher.stats.watch_count -= 1;
+    }
+    
+    //- zero bytes -> buffer overflowed & notifications were dropped
+    else if(bytes == 0)
+    {
+      report_all = 1;
+      entity->file_watcher.stats.overflow_count += 1;
+    }
+    
+    //- match notified names
+    else
+    {
+      Temp scratch = scratch_begin(&arena, 1);
+      for(U64 off = 0; off + sizeof(FILE_NOTIFY_INFORMATION) <= bytes;)
+      {
+        FILE_NOTIFY_INFORMATION *info = (FILE_NOTIFY_INFORMATION *)(dir->buffer + off);
+        entity->file_watcher.stats.event_count += 1;
+        String8 info_name = str8_from_16(scratch.arena, str16((U16 *)info->FileName, info->FileNameLength/sizeof(WCHAR)));
+        for(W32_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+        {
+          if(str8_match(n->name, info_name, StringMatchFlag_CaseInsensitive))
+          {
+            w32_file_watch_report(arena, &result, n, gen);
+            break;
+          }
+        }
+        if(info->NextEntryOffset == 0)
+        {
+          break;
+        }
+        off += info->NextEntryOffset;
+      }
+      scratch_end(scratch);
+    }
+    
+    //- queue the next read
+    if(ok && !w32_file_watch_arm_dir(entity, dir))
+    {
+      report_all = 1;
+      entity->file_watcher.stats.watch_count -= 1;
+    }
+    if(report_all)
+    {
+      for(W32_FileWatchName *n = dir->first_name; n != 0; n = n->next)
+      {
+        w32_file_watch_report(arena, &result, n, gen);
+      }
+    }
+    LeaveCriticalSection(&entity->file_watcher.mutex);
+  }
+  return result;
+}
+
+internal OS_FileWatcherStats
+os_file_watcher_stats(OS_Handle watcher)
+{
+  OS_FileWatcherStats result = {0};
+  if(os_handle_match(watcher, os_handle_zero())) { return result; }
+  W32_Entity *entity = (W32_Entity*)PtrFromInt(watcher.u64[0]);
+  EnterCriticalSection(&entity->file_watcher.mutex);
+  result = entity->file_watcher.stats;
+  LeaveCriticalSection(&entity->file_watcher.mutex);
+  return result;
+}
+
 ////////////////////////////////
 //~ rjf: @os_hooks Shared Memory (Implemented Per-OS)
 
@@ -46,9 +46,36 @@ typedef enum W32_EntityKind
   W32_EntityKind_Mutex,
   W32_EntityKind_RWMutex,
   W32_EntityKind_ConditionVariable,
+  W32_EntityKind_FileWatcher,
 }
 W32_EntityKind;
 
+////////////////////////////////
+//~ File Watching
+
+#define W32_FILE_WATCH_BUFFER_SIZE KB(16)
+
+typedef struct W32_FileWatchName W32_FileWatchName;
+struct W32_FileWatchName
+{
+  W32_FileWatchName *next;
+  String8 name;
+  String8 path;
+  U64 last_reported_gen;
+};
+
+typedef struct W32_FileWatchDir W32_FileWatchDir;
+struct W32_FileWatchDir
+{
+  W32_FileWatchDir *next;
+  String8 path;
+  HANDLE handle;
+  OVERLAPPED overlapped;
+  U8 *buffer;
+  W32_FileWatchName *first_name;
+  W32_FileWatchName *last_name;
+};
+
 typedef struct W32_Entity W32_Entity;
 struct W32_Entity
 {
@@ -65,6 +92,15 @@ struct W32_Entity
     CRITICAL_SECTION mutex;
     SRWLOCK rw_mutex;
     CONDITION_VARIABLE cv;
+    struct{
+      HANDLE port;
+      Arena *arena;
+      CRITICAL_SECTION mutex;
+      W32_FileWatchDir *first_dir;
+      W32_FileWatchDir *last_dir;
+      U64 wait_gen;
+      OS_FileWatcherStats stats;
+    } file_watcher;
   };
 };
 
@@ -88,4 +124,9 @@ internal void w32_free_entity(W32_Entity *entity);
 //- rjf: threads
 internal DWORD w32_thread_base(void *ptr);
 
+//- file watching
+internal void w32_file_watch_report(Arena *arena, String8List *list, W32_FileWatchName *name, U64 gen);
+internal B32 w32_file_watch_arm_dir(W32_Entity *entity, W32_FileWatchDir *dir);
+internal void w32_file_watch_disarm_dir(W32_Entity *entity, W32_FileWatchDir *dir);
+
 #endif //WIN32_H
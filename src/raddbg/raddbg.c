@@ -656,22 +656,24 @@ entry_point(int argc, char **argv)
         out = pdbconv_convert(scratch.arena, params);
       }
       
-      //- rjf: bake file
+      //- bake file; sections are written as they're finished
       if(out != 0 && params->output_name.size > 0)
       {
-        String8List baked = {0};
-        cons_bake_file(scratch.arena, out->root, &baked);
-        U64 off = 0;
-        for(String8Node *node = baked.first; node != 0; node = node->next)
-        {
-          os_file_write(out_file, r1u64(off, off+node->string.size), node->string.str);
-          off += node->string.size;
-        }
+        cons_bake_file_stream(scratch.arena, out->root, pdbconv_write_baked_data, &out_file);
       }
       
       //- rjf: close output file
       os_file_close(out_file);
       
+      //- release parse worker arenas
+      if(out != 0)
+      {
+        for(U64 idx = 0; idx < out->worker_arena_count; idx += 1)
+        {
+          arena_release(out->worker_arenas[idx]);
+        }
+      }
+      
       scratch_end(scratch);
     }break;
     
@@ -14,6 +14,8 @@ cons_root_new(CONS_RootParams *params){
   // fill in root parameters
   {
     result->addr_size = params->addr_size;
+    result->bake_thread_count = params->bake_thread_count;
+    result->bake_trigram_maps = params->bake_trigram_maps;
   }
   
   // setup singular types
@@ -67,9 +69,119 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
   ProfBegin("cons_bake_file");
   str8_serial_begin(arena, out);
   
-  // setup cons helpers
   CONS__DSections dss = {0};
-  cons__dsection(arena, &dss, 0, 0, RADDBG_DataSectionTag_NULL);
+  cons__bake_sections(arena, root, &dss);
+  
+  // layout
+  // * the header and data section table have to be initialized "out of order"
+  // * so that the rest of the system can avoid this tricky order-layout interdependence stuff
+  RADDBG_Header *header = push_array(arena, RADDBG_Header, 1);
+  RADDBG_DataSection *dstable = push_array(arena, RADDBG_DataSection, dss.count);
+  str8_serial_push_align(arena, out, 8);
+  U64 header_off = out->total_size;
+  str8_list_push(arena, out, str8_struct(header));
+  str8_serial_push_align(arena, out, 8);
+  U64 data_section_off = out->total_size;
+  str8_list_push(arena, out, str8((U8 *)dstable, sizeof(*dstable)*dss.count));
+  {
+    header->magic = RADDBG_MAGIC_CONSTANT;
+    header->encoding_version = RADDBG_ENCODING_VERSION;
+    header->data_section_off = data_section_off;
+    header->data_section_count = dss.count;
+  }
+  {
+    U64 test_dss_count = 0;
+    for (CONS__DSectionNode *node = dss.first;
+         node != 0;
+         node = node->next){
+      test_dss_count += 1;
+    }
+    Assert(test_dss_count == dss.count);
+    
+    RADDBG_DataSection *ptr = dstable;
+    for (CONS__DSectionNode *node = dss.first;
+         node != 0;
+         node = node->next, ptr += 1){
+      U64 data_section_offset = 0;
+      if(node->size != 0)
+      {
+        str8_serial_push_align(arena, out, 8);
+        data_section_offset = out->total_size;
+        str8_list_push(arena, out, str8((U8 *)node->data, node->size));
+      }
+      ptr->tag = node->tag;
+      ptr->encoding = RADDBG_DataSectionEncoding_Unpacked;
+      ptr->off = data_section_offset;
+      ptr->encoded_size = node->size;
+      ptr->unpacked_size = node->size;
+    }
+    Assert(ptr == dstable + dss.count);
+  }
+  
+  ProfEnd();
+}
+
+static void
+cons_bake_file_stream(Arena *arena, CONS_Root *root, CONS_BakeWriteFunction *write, void *write_ptr){
+  ProfBegin("cons_bake_file_stream");
+  
+  CONS__DSections dss = {0};
+  dss.write = write;
+  dss.write_ptr = write_ptr;
+  dss.node_arena = arena_alloc();
+  cons__bake_sections(arena, root, &dss);
+  
+  // make sure every section is out; without a reservation nothing has been
+  // written yet, so reserve exactly
+  if (!dss.reserved){
+    cons__dsections_reserve(&dss, dss.count);
+  }
+  
+  // NOTE: the reservation is an upper bound; if more sections than that were
+  // baked, the reserved space stays zero & the table goes after the last
+  // section instead - the header points at it either way
+  U64 table_off = dss.table_off;
+  if (dss.count > dss.reserved_count){
+    static U8 zeros[8] = {0};
+    table_off = AlignPow2(dss.write_off, 8);
+    if (table_off > dss.write_off){
+      write(write_ptr, dss.write_off, zeros, table_off - dss.write_off);
+    }
+  }
+  
+  // patch in the data section table & header
+  {
+    RADDBG_DataSection *dstable = push_array(dss.node_arena, RADDBG_DataSection, dss.count);
+    RADDBG_DataSection *ptr = dstable;
+    for (CONS__DSectionNode *node = dss.first;
+         node != 0;
+         node = node->next, ptr += 1){
+      ptr->tag = node->tag;
+      ptr->encoding = RADDBG_DataSectionEncoding_Unpacked;
+      ptr->off = node->off;
+      ptr->encoded_size = node->size;
+      ptr->unpacked_size = node->size;
+    }
+    write(write_ptr, table_off, dstable, sizeof(*dstable)*dss.count);
+    
+    RADDBG_Header *header = push_array(dss.node_arena, RADDBG_Header, 1);
+    header->magic = RADDBG_MAGIC_CONSTANT;
+    header->encoding_version = RADDBG_ENCODING_VERSION;
+    header->data_section_off = table_off;
+    header->data_section_count = dss.count;
+    write(write_ptr, 0, header, sizeof(*header));
+  }
+  
+  arena_release(dss.node_arena);
+  ProfEnd();
+}
+
+static void
+cons__bake_sections(Arena *arena, CONS_Root *root, CONS__DSections *dss){
+  ProfBegin("cons__bake_sections");
+  
+  // setup cons helpers
+  cons__dsection(arena, dss, 0, 0, RADDBG_DataSectionTag_NULL);
   
   CONS__BakeCtx *bctx = cons__bake_ctx_begin();
   
@@ -85,7 +197,7 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
     tli->exe_hash = cons_tli->exe_hash;
     tli->voff_max = cons_tli->voff_max;
   }
-  cons__dsection(arena, &dss, tli, sizeof(*tli), RADDBG_DataSectionTag_TopLevelInfo);
+  cons__dsection(arena, dss, tli, sizeof(*tli), RADDBG_DataSectionTag_TopLevelInfo);
   
   // binary sections array
   {
@@ -102,20 +214,34 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       dsec->foff_first = ssec->foff_first;
       dsec->foff_opl   = ssec->foff_opl;
     }
-    cons__dsection(arena, &dss, sections, sizeof(*sections)*count, RADDBG_DataSectionTag_BinarySections);
+    cons__dsection(arena, dss, sections, sizeof(*sections)*count, RADDBG_DataSectionTag_BinarySections);
+  }
+  
+  Temp scratch = scratch_begin(&arena, 1);
+  CONS__BakeTasks *tasks = push_array(scratch.arena, CONS__BakeTasks, 1);
+  tasks->arena = arena;
+  if (dss->write != 0){
+    // streaming: types & symbols get their own arena, released once written
+    tasks->arena = arena_alloc();
   }
+  tasks->bctx = bctx;
+  tasks->root = root;
   
   // units array
   // * pass for per-unit information including:
   // * top-level unit information
-  // * combining line info for whole unit
+  // * gathering line info for whole unit (paths are interned here, in order)
+  U32 unit_count = root->unit_count;
+  RADDBG_Unit *units = push_array(arena, RADDBG_Unit, unit_count);
+  tasks->unit_lines_gathered = push_array(scratch.arena, CONS__UnitLinesGathered*, unit_count);
+  tasks->unit_lines = push_array(scratch.arena, CONS__UnitLinesCombined*, unit_count);
+  tasks->unit_count = unit_count;
   {
-    U32 count = root->unit_count;
-    RADDBG_Unit *units = push_array(arena, RADDBG_Unit, count);
     RADDBG_Unit *dunit = units;
+    CONS__UnitLinesGathered **gathered_ptr = tasks->unit_lines_gathered;
     for (CONS_Unit *sunit = root->unit_first;
          sunit != 0;
-         sunit = sunit->next_order, dunit += 1){
+         sunit = sunit->next_order, dunit += 1, gathered_ptr += 1){
       // strings & paths
       U32 unit_name = cons__string(bctx, sunit->unit_name);
       U32 cmp_name  = cons__string(bctx, sunit->compiler_name);
@@ -134,143 +260,228 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       dunit->language                 = sunit->language;
       
       // line info (voff -> file*line*col)
-      CONS_LineSequenceNode *first_seq = sunit->line_seq_first;
-      CONS__UnitLinesCombined *lines = cons__unit_combine_lines(arena, bctx, first_seq);
-      
-      U32 line_count = lines->line_count;
-      if (line_count > 0){
-        dunit->line_info_voffs_data_idx =
-          cons__dsection(arena, &dss, lines->voffs, sizeof(U64)*(line_count + 1),
-                         RADDBG_DataSectionTag_LineInfoVoffs);
-        dunit->line_info_data_idx =
-          cons__dsection(arena, &dss, lines->lines, sizeof(RADDBG_Line)*line_count,
-                         RADDBG_DataSectionTag_LineInfoData);
-        if (lines->cols != 0){
-          dunit->line_info_col_data_idx =
-            cons__dsection(arena, &dss, lines->cols, sizeof(RADDBG_Column)*line_count,
-                           RADDBG_DataSectionTag_LineInfoColumns);
-        }
-        dunit->line_info_count = line_count;
+      *gathered_ptr = cons__unit_gather_lines(scratch.arena, bctx, sunit->line_seq_first);
+    }
+  }
+  
+  // source files
+  // * the set of source files with line info is known once every unit has gathered its lines
+  {
+    U32 count = 0;
+    for (CONS__SrcNode *src_node = bctx->tree->src_first;
+         src_node != 0;
+         src_node = src_node->next){
+      count += 1;
+    }
+    tasks->src_nodes = push_array(scratch.arena, CONS__SrcNode*, count);
+    tasks->src_lines = push_array(scratch.arena, CONS__SrcLinesCombined*, count);
+    tasks->src_count = count;
+    
+    CONS__SrcNode **src_node_ptr = tasks->src_nodes;
+    for (CONS__SrcNode *src_node = bctx->tree->src_first;
+         src_node != 0;
+         src_node = src_node->next, src_node_ptr += 1){
+      *src_node_ptr = src_node;
+    }
+  }
+  
+  // source file name mapping
+  {
+    CONS__NameMap* map = cons__name_map_for_kind(root, RADDBG_NameMapKind_NormalSourcePaths);
+    for (U32 i = 0; i < tasks->src_count; i += 1){
+      CONS__SrcNode *src_node = tasks->src_nodes[i];
+      if (src_node->idx != 0){
+        cons__name_map_add_pair(root, map, src_node->normal_full_path, src_node->idx);
       }
     }
+  }
+  
+  // gather names by element index for each searchable table
+  if (root->bake_trigram_maps){
+    U32 *name_counts = tasks->trigram_name_counts;
+    name_counts[RADDBG_TrigramMapKind_GlobalVariables] = 1 + root->symbol_kind_counts[CONS_SymbolKind_GlobalVariable];
+    name_counts[RADDBG_TrigramMapKind_ThreadVariables] = 1 + root->symbol_kind_counts[CONS_SymbolKind_ThreadVariable];
+    name_counts[RADDBG_TrigramMapKind_Procedures]      = 1 + root->symbol_kind_counts[CONS_SymbolKind_Procedure];
+    name_counts[RADDBG_TrigramMapKind_UDTs]            = root->type_udt_count;
     
-    cons__dsection(arena, &dss, units, sizeof(*units)*count, RADDBG_DataSectionTag_Units);
+    String8 **names = tasks->trigram_names;
+    for (U32 i = 1; i < RADDBG_TrigramMapKind_COUNT; i += 1){
+      names[i] = push_array(scratch.arena, String8, name_counts[i]);
+    }
+    
+    for (CONS_Symbol *node = root->first_symbol;
+         node != 0;
+         node = node->next_order){
+      RADDBG_TrigramMapKind kind = RADDBG_TrigramMapKind_NULL;
+      switch (node->kind){
+        default:{}break;
+        case CONS_SymbolKind_GlobalVariable:{kind = RADDBG_TrigramMapKind_GlobalVariables;}break;
+        case CONS_SymbolKind_ThreadVariable:{kind = RADDBG_TrigramMapKind_ThreadVariables;}break;
+        case CONS_SymbolKind_Procedure:     {kind = RADDBG_TrigramMapKind_Procedures;}break;
+      }
+      if (kind != RADDBG_TrigramMapKind_NULL && node->idx < name_counts[kind]){
+        names[kind][node->idx] = node->name;
+      }
+    }
+    
+    for (CONS_TypeUDT *udt = root->first_udt;
+         udt != 0;
+         udt = udt->next_order){
+      if (udt->idx < name_counts[RADDBG_TrigramMapKind_UDTs]){
+        names[RADDBG_TrigramMapKind_UDTs][udt->idx] = udt->self_type->name;
+      }
+    }
   }
   
-  // source file line info baking
-  // * pass for "source_combine_line" for each source file -
-  // * can only be run after a pass that does "unit_combine_lines" for each unit.
-  for (CONS__SrcNode *src_node = bctx->tree->src_first;
-       src_node != 0;
-       src_node = src_node->next){
-    CONS__LineMapFragment *first_fragment = src_node->first_fragment;
-    CONS__SrcLinesCombined *lines = cons__source_combine_lines(arena, first_fragment);
+  // run the spine (types & symbols) next to the independent tasks
+  CONS__TaskBatch *batch = cons__task_batch_alloc(scratch.arena, root->bake_thread_count);
+  {
+    U64 task_count = CONS__BakeTask_FixedCount + tasks->src_count + tasks->unit_count;
+    cons__task_batch_run(batch, cons__bake_task, tasks, task_count);
+  }
+  
+  // every remaining section is accounted for now - reserve the table (streaming only)
+  // * per unit: line voffs, lines, columns; then the units array
+  // * per source file: line numbers, ranges, voffs
+  // * unit vmap, 4 type sections, 10 symbol sections
+  // * name maps & trigram maps: 2 per map, plus their arrays
+  // * file paths, source files, string table, string data, index runs
+  {
+    U32 max_count = (dss->count + 3*unit_count + 1 + 3*tasks->src_count + 1 + 4 + 10 +
+                     2*RADDBG_NameMapKind_COUNT + 1 + 2*RADDBG_TrigramMapKind_COUNT + 1 + 5);
+    cons__dsections_reserve(dss, max_count);
+  }
+  
+  // unit line info & units array
+  for (U32 i = 0; i < unit_count; i += 1){
+    RADDBG_Unit *dunit = &units[i];
+    CONS__UnitLinesCombined *lines = tasks->unit_lines[i];
+    
+    U32 line_count = lines->line_count;
+    if (line_count > 0){
+      U64 voffs_size = sizeof(U64)*(line_count + 1);
+      dunit->line_info_voffs_data_idx =
+        cons__dsection_copy(arena, dss, lines->voffs, voffs_size,
+                            RADDBG_DataSectionTag_LineInfoVoffs);
+      U64 lines_size = sizeof(RADDBG_Line)*line_count;
+      dunit->line_info_data_idx =
+        cons__dsection_copy(arena, dss, lines->lines, lines_size,
+                            RADDBG_DataSectionTag_LineInfoData);
+      if (lines->cols != 0){
+        U64 cols_size = sizeof(RADDBG_Column)*line_count;
+        dunit->line_info_col_data_idx =
+          cons__dsection_copy(arena, dss, lines->cols, cols_size,
+                              RADDBG_DataSectionTag_LineInfoColumns);
+      }
+      dunit->line_info_count = line_count;
+    }
+  }
+  cons__dsection(arena, dss, units, sizeof(*units)*unit_count, RADDBG_DataSectionTag_Units);
+  
+  // source file line info
+  for (U32 i = 0; i < tasks->src_count; i += 1){
+    CONS__SrcNode *src_node = tasks->src_nodes[i];
+    CONS__SrcLinesCombined *lines = tasks->src_lines[i];
     U32 line_count = lines->line_count;
     
     if (line_count > 0){
       src_node->line_map_count = line_count;
       
+      U64 nums_size = sizeof(*lines->line_nums)*line_count;
       src_node->line_map_nums_data_idx =
-        cons__dsection(arena, &dss, lines->line_nums, sizeof(*lines->line_nums)*line_count,
-                       RADDBG_DataSectionTag_LineMapNumbers);
+        cons__dsection_copy(arena, dss, lines->line_nums, nums_size,
+                            RADDBG_DataSectionTag_LineMapNumbers);
       
+      U64 ranges_size = sizeof(*lines->line_ranges)*(line_count + 1);
       src_node->line_map_range_data_idx =
-        cons__dsection(arena, &dss, lines->line_ranges, sizeof(*lines->line_ranges)*(line_count + 1),
-                       RADDBG_DataSectionTag_LineMapRanges);
+        cons__dsection_copy(arena, dss, lines->line_ranges, ranges_size,
+                            RADDBG_DataSectionTag_LineMapRanges);
       
+      U64 voffs_size = sizeof(*lines->voffs)*lines->voff_count;
       src_node->line_map_voff_data_idx =
-        cons__dsection(arena, &dss, lines->voffs, sizeof(*lines->voffs)*lines->voff_count,
-                       RADDBG_DataSectionTag_LineMapVoffs);
-    }
-  }
-  
-  // source file name mapping
-  {
-    CONS__NameMap* map = cons__name_map_for_kind(root, RADDBG_NameMapKind_NormalSourcePaths);
-    for (CONS__SrcNode *src_node = bctx->tree->src_first;
-         src_node != 0;
-         src_node = src_node->next){
-      if (src_node->idx != 0){
-        cons__name_map_add_pair(root, map, src_node->normal_full_path, src_node->idx);
-      }
+        cons__dsection_copy(arena, dss, lines->voffs, voffs_size,
+                            RADDBG_DataSectionTag_LineMapVoffs);
     }
   }
   
-  // unit vmap baking
+  // unit vmap
   {
-    CONS__VMap *vmap = cons__vmap_from_unit_ranges(arena,
-                                                   root->unit_vmap_range_first,
-                                                   root->unit_vmap_range_count);
-    
+    CONS__VMap *vmap = tasks->unit_vmap;
     U64 vmap_size = sizeof(*vmap->vmap)*(vmap->count + 1);
-    cons__dsection(arena, &dss, vmap->vmap, vmap_size, RADDBG_DataSectionTag_UnitVmap);
+    cons__dsection_copy(arena, dss, vmap->vmap, vmap_size,
+                        RADDBG_DataSectionTag_UnitVmap);
   }
   
-  // type info baking
+  // type info
   {
-    CONS__TypeData *types = cons__type_data_combine(arena, root, bctx);
+    CONS__TypeData *types = tasks->types;
     
     U64 type_nodes_size = sizeof(*types->type_nodes)*types->type_node_count;
-    cons__dsection(arena, &dss, types->type_nodes, type_nodes_size, RADDBG_DataSectionTag_TypeNodes);
+    cons__dsection(arena, dss, types->type_nodes, type_nodes_size, RADDBG_DataSectionTag_TypeNodes);
     
     U64 udt_size = sizeof(*types->udts)*types->udt_count;
-    cons__dsection(arena, &dss, types->udts, udt_size, RADDBG_DataSectionTag_UDTs);
+    cons__dsection(arena, dss, types->udts, udt_size, RADDBG_DataSectionTag_UDTs);
     
     U64 member_size = sizeof(*types->members)*types->member_count;
-    cons__dsection(arena, &dss, types->members, member_size, RADDBG_DataSectionTag_Members);
+    cons__dsection(arena, dss, types->members, member_size, RADDBG_DataSectionTag_Members);
     
     U64 enum_member_size = sizeof(*types->enum_members)*types->enum_member_count;
-    cons__dsection(arena, &dss, types->enum_members, enum_member_size, RADDBG_DataSectionTag_EnumMembers);
+    cons__dsection(arena, dss, types->enum_members, enum_member_size, RADDBG_DataSectionTag_EnumMembers);
   }
   
-  // symbol info baking
+  // symbol info
   {
-    CONS__SymbolData *symbol_data = cons__symbol_data_combine(arena, root, bctx);
+    CONS__SymbolData *symbol_data = tasks->symbol_data;
     
     U64 global_variables_size =
       sizeof(*symbol_data->global_variables)*symbol_data->global_variable_count;
-    cons__dsection(arena, &dss, symbol_data->global_variables, global_variables_size,
+    cons__dsection(arena, dss, symbol_data->global_variables, global_variables_size,
                    RADDBG_DataSectionTag_GlobalVariables);
     
     CONS__VMap *global_vmap = symbol_data->global_vmap;
     U64 global_vmap_size = sizeof(*global_vmap->vmap)*(global_vmap->count + 1);
-    cons__dsection(arena, &dss, global_vmap->vmap, global_vmap_size,
+    cons__dsection(arena, dss, global_vmap->vmap, global_vmap_size,
                    RADDBG_DataSectionTag_GlobalVmap);
     
     U64 thread_variables_size =
       sizeof(*symbol_data->thread_variables)*symbol_data->thread_variable_count;
-    cons__dsection(arena, &dss, symbol_data->thread_variables, thread_variables_size,
+    cons__dsection(arena, dss, symbol_data->thread_variables, thread_variables_size,
                    RADDBG_DataSectionTag_ThreadVariables);
     
     U64 procedures_size = sizeof(*symbol_data->procedures)*symbol_data->procedure_count;
-    cons__dsection(arena, &dss, symbol_data->procedures, procedures_size,
+    cons__dsection(arena, dss, symbol_data->procedures, procedures_size,
                    RADDBG_DataSectionTag_Procedures);
     
     U64 scopes_size = sizeof(*symbol_data->scopes)*symbol_data->scope_count;
-    cons__dsection(arena, &dss, symbol_data->scopes, scopes_size, RADDBG_DataSectionTag_Scopes);
+    cons__dsection(arena, dss, symbol_data->scopes, scopes_size, RADDBG_DataSectionTag_Scopes);
     
     U64 scope_voffs_size = sizeof(*symbol_data->scope_voffs)*symbol_data->scope_voff_count;
-    cons__dsection(arena, &dss, symbol_data->scope_voffs, scope_voffs_size,
+    cons__dsection(arena, dss, symbol_data->scope_voffs, scope_voffs_size,
                    RADDBG_DataSectionTag_ScopeVoffData);
     
     CONS__VMap *scope_vmap = symbol_data->scope_vmap;
     U64 scope_vmap_size = sizeof(*scope_vmap->vmap)*(scope_vmap->count + 1);
-    cons__dsection(arena, &dss, scope_vmap->vmap, scope_vmap_size, RADDBG_DataSectionTag_ScopeVmap);
+    cons__dsection(arena, dss, scope_vmap->vmap, scope_vmap_size, RADDBG_DataSectionTag_ScopeVmap);
     
     U64 local_size = sizeof(*symbol_data->locals)*symbol_data->local_count;
-    cons__dsection(arena, &dss, symbol_data->locals, local_size, RADDBG_DataSectionTag_Locals);
+    cons__dsection(arena, dss, symbol_data->locals, local_size, RADDBG_DataSectionTag_Locals);
     
     U64 location_blocks_size =
       sizeof(*symbol_data->location_blocks)*symbol_data->location_block_count;
-    cons__dsection(arena, &dss, symbol_data->location_blocks, location_blocks_size,
+    cons__dsection(arena, dss, symbol_data->location_blocks, location_blocks_size,
                    RADDBG_DataSectionTag_LocationBlocks);
     
     U64 location_data_size = symbol_data->location_data_size;
-    cons__dsection(arena, &dss, symbol_data->location_data, location_data_size,
+    cons__dsection(arena, dss, symbol_data->location_data, location_data_size,
                    RADDBG_DataSectionTag_LocationData);
   }
   
+  if (tasks->arena != arena){
+    arena_release(tasks->arena);
+  }
+  
   // name map baking
+  // * interning happens here, after types & symbols, in map order
   {
     U32 name_map_count = 0;
     for (U32 i = 0; i < RADDBG_NameMapKind_COUNT; i += 1){
@@ -285,28 +496,59 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
     for (U32 i = 0; i < RADDBG_NameMapKind_COUNT; i += 1){
       CONS__NameMap *map = root->name_maps[i];
       if (map != 0){
-        CONS__NameMapBaked *baked = cons__name_map_bake(arena, root, bctx, map);
+        Temp temp = temp_begin(arena);
+        CONS__NameMapBaked *baked = cons__name_map_bake(arena, root, bctx, map, tasks->name_map_sbuckets[i]);
         
         name_map_ptr->kind = i;
         name_map_ptr->bucket_data_idx =
-          cons__dsection(arena, &dss, baked->buckets, sizeof(*baked->buckets)*baked->bucket_count,
+          cons__dsection(arena, dss, baked->buckets, sizeof(*baked->buckets)*baked->bucket_count,
                          RADDBG_DataSectionTag_NameMapBuckets);
         name_map_ptr->node_data_idx =
-          cons__dsection(arena, &dss, baked->nodes, sizeof(*baked->nodes)*baked->node_count,
+          cons__dsection(arena, dss, baked->nodes, sizeof(*baked->nodes)*baked->node_count,
                          RADDBG_DataSectionTag_NameMapNodes);
         name_map_ptr += 1;
+        cons__dsections_release_temp(dss, temp);
       }
     }
     
-    cons__dsection(arena, &dss, name_maps, sizeof(*name_maps)*name_map_count,
+    cons__dsection(arena, dss, name_maps, sizeof(*name_maps)*name_map_count,
                    RADDBG_DataSectionTag_NameMaps);
   }
   
+  // name trigram maps
+  if (root->bake_trigram_maps){
+    U32 trigram_map_count = RADDBG_TrigramMapKind_COUNT - 1;
+    RADDBG_TrigramMap *trigram_maps = push_array(arena, RADDBG_TrigramMap, trigram_map_count);
+    
+    RADDBG_TrigramMap *trigram_map_ptr = trigram_maps;
+    for (U32 i = 1; i < RADDBG_TrigramMapKind_COUNT; i += 1, trigram_map_ptr += 1){
+      CONS__TrigramMapBaked *baked = tasks->trigram_maps[i];
+      
+      U64 entries_size = sizeof(*baked->entries)*baked->entry_count;
+      U64 postings_size = sizeof(*baked->postings)*baked->posting_count;
+      trigram_map_ptr->kind = i;
+      trigram_map_ptr->entry_data_idx =
+        cons__dsection_copy(arena, dss, baked->entries, entries_size,
+                            RADDBG_DataSectionTag_TrigramMapEntries);
+      trigram_map_ptr->posting_data_idx =
+        cons__dsection_copy(arena, dss, baked->postings, postings_size,
+                            RADDBG_DataSectionTag_TrigramMapPostings);
+    }
+    
+    cons__dsection(arena, dss, trigram_maps, sizeof(*trigram_maps)*trigram_map_count,
+                   RADDBG_DataSectionTag_TrigramMaps);
+  }
+  
+  // everything task-produced has been copied out by now
+  cons__task_batch_release(batch);
+  scratch_end(scratch);
+  
   ////////////////////////////////
   // LATE PART: baking loose structures and creating final layout
   
   // generate data sections for file paths
   {
+    Temp temp = temp_begin(arena);
     U32 count = bctx->tree->count;
     RADDBG_FilePathNode *nodes = push_array(arena, RADDBG_FilePathNode, count);
     
@@ -329,11 +571,13 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       }
     }
     
-    cons__dsection(arena, &dss, nodes, sizeof(*nodes)*count, RADDBG_DataSectionTag_FilePathNodes);
+    cons__dsection(arena, dss, nodes, sizeof(*nodes)*count, RADDBG_DataSectionTag_FilePathNodes);
+    cons__dsections_release_temp(dss, temp);
   }
   
   // generate data sections for files
   {
+    Temp temp = temp_begin(arena);
     U32 count = bctx->tree->src_count;
     RADDBG_SourceFile *src_files = push_array(arena, RADDBG_SourceFile, count);
     
@@ -349,11 +593,13 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       out_src_file->line_map_voff_data_idx = node->line_map_voff_data_idx;
     }
     
-    cons__dsection(arena, &dss, src_files, sizeof(*src_files)*count, RADDBG_DataSectionTag_SourceFiles);
+    cons__dsection(arena, dss, src_files, sizeof(*src_files)*count, RADDBG_DataSectionTag_SourceFiles);
+    cons__dsections_release_temp(dss, temp);
   }
   
   // generate data sections for strings
   {
+    Temp temp = temp_begin(arena);
     U32 *str_offs = push_array_no_zero(arena, U32, bctx->strs.count + 1);
     
     U32 off_cursor = 0;
@@ -381,13 +627,15 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       }
     }
     
-    cons__dsection(arena, &dss, str_offs, sizeof(*str_offs)*(bctx->strs.count + 1),
+    cons__dsection(arena, dss, str_offs, sizeof(*str_offs)*(bctx->strs.count + 1),
                    RADDBG_DataSectionTag_StringTable);
-    cons__dsection(arena, &dss, buf, off_cursor, RADDBG_DataSectionTag_StringData);
+    cons__dsection(arena, dss, buf, off_cursor, RADDBG_DataSectionTag_StringData);
+    cons__dsections_release_temp(dss, temp);
   }
   
   // generate data sections for index runs
   {
+    Temp temp = temp_begin(arena);
     U32 *idx_data = push_array_no_zero(arena, U32, bctx->idxs.idx_count);
     
     {
@@ -402,54 +650,9 @@ cons_bake_file(Arena *arena, CONS_Root *root, String8List *out){
       Assert(out_ptr == opl);
     }
     
-    cons__dsection(arena, &dss, idx_data, sizeof(*idx_data)*bctx->idxs.idx_count,
+    cons__dsection(arena, dss, idx_data, sizeof(*idx_data)*bctx->idxs.idx_count,
                    RADDBG_DataSectionTag_IndexRuns);
-  }
-  
-  // layout
-  // * the header and data section table have to be initialized "out of order"
-  // * so that the rest of the system can avoid this tricky order-layout interdependence stuff
-  RADDBG_Header *header = push_array(arena, RADDBG_Header, 1);
-  RADDBG_DataSection *dstable = push_array(arena, RADDBG_DataSection, dss.count);
-  str8_serial_push_align(arena, out, 8);
-  U64 header_off = out->total_size;
-  str8_list_push(arena, out, str8_struct(header));
-  str8_serial_push_align(arena, out, 8);
-  U64 data_section_off = out->total_size;
-  str8_list_push(arena, out, str8((U8 *)dstable, sizeof(*dstable)*dss.count));
-  {
-    header->magic = RADDBG_MAGIC_CONSTANT;
-    header->encoding_version = RADDBG_ENCODING_VERSION;
-    header->data_section_off = data_section_off;
-    header->data_section_count = dss.count;
-  }
-  {
-    U64 test_dss_count = 0;
-    for (CONS__DSectionNode *node = dss.first;
-         node != 0;
-         node = node->next){
-      test_dss_count += 1;
-    }
-    Assert(test_dss_count == dss.count);
-    
-    RADDBG_DataSection *ptr = dstable;
-    for (CONS__DSectionNode *node = dss.first;
-         node != 0;
-         node = node->next, ptr += 1){
-      U64 data_section_offset = 0;
-      if(node->size != 0)
-      {
-        str8_serial_push_align(arena, out, 8);
-        data_section_offset = out->total_size;
-        str8_list_push(arena, out, str8((U8 *)node->data, node->size));
-      }
-      ptr->tag = node->tag;
-      ptr->encoding = RADDBG_DataSectionEncoding_Unpacked;
-      ptr->off = data_section_offset;
-      ptr->encoded_size = node->size;
-      ptr->unpacked_size = node->size;
-    }
-    Assert(ptr == dstable + dss.count);
+    cons__dsections_release_temp(dss, temp);
   }
   
   cons__bake_ctx_release(bctx);
@@ -1868,22 +2071,91 @@ static U32
 cons__dsection(Arena *arena, CONS__DSections *dss, void *data, U64 size, RADDBG_DataSectionTag tag){
   U32 result = dss->count;
   
-  CONS__DSectionNode *node = push_array(arena, CONS__DSectionNode, 1);
+  // NOTE: when streaming, section data may be released right after this
+  // call, so nodes have to live somewhere else
+  Arena *node_arena = (dss->write != 0) ? dss->node_arena : arena;
+  CONS__DSectionNode *node = push_array(node_arena, CONS__DSectionNode, 1);
   SLLQueuePush(dss->first, dss->last, node);
   node->data = data;
   node->size = size;
   node->tag = tag;
   dss->count += 1;
   
+  if (dss->reserved){
+    cons__dsection_write(dss, node);
+  }
+  
+  return(result);
+}
+
+static U32
+cons__dsection_copy(Arena *arena, CONS__DSections *dss, void *data, U64 size, RADDBG_DataSectionTag tag){
+  // data that does not outlive the bake only has to be copied if it isn't written right away
+  void *section_data = data;
+  if (!dss->reserved){
+    section_data = push_array_no_zero(arena, U8, size);
+    MemoryCopy(section_data, data, size);
+  }
+  U32 result = cons__dsection(arena, dss, section_data, size, tag);
   return(result);
 }
 
+static void
+cons__dsection_write(CONS__DSections *dss, CONS__DSectionNode *node){
+  static U8 zeros[8] = {0};
+  if (node->size != 0){
+    U64 off = AlignPow2(dss->write_off, 8);
+    if (off > dss->write_off){
+      dss->write(dss->write_ptr, dss->write_off, zeros, off - dss->write_off);
+    }
+    dss->write(dss->write_ptr, off, node->data, node->size);
+    node->off = off;
+    dss->write_off = off + node->size;
+  }
+  node->data = 0;
+}
+
+static void
+cons__dsections_reserve(CONS__DSections *dss, U32 max_count){
+  if (dss->write != 0 && !dss->reserved){
+    max_count = Max(max_count, dss->count);
+    dss->reserved = 1;
+    dss->reserved_count = max_count;
+    dss->table_off = AlignPow2(sizeof(RADDBG_Header), 8);
+    dss->write_off = dss->table_off + sizeof(RADDBG_DataSection)*max_count;
+    
+    // zero the header & table space; both get patched in at the end
+    U8 *zeros = push_array(dss->node_arena, U8, dss->write_off);
+    dss->write(dss->write_ptr, 0, zeros, dss->write_off);
+    
+    // write out everything that was waiting on the reservation
+    for (CONS__DSectionNode *node = dss->first;
+         node != 0;
+         node = node->next){
+      cons__dsection_write(dss, node);
+    }
+  }
+}
+
+static void
+cons__dsections_release_temp(CONS__DSections *dss, Temp temp){
+  // sections built in this temp have been written if streaming - otherwise they stay
+  if (dss->reserved){
+    temp_end(temp);
+  }
+}
+
 static CONS__BakeCtx*
 cons__bake_ctx_begin(void){
   Arena *arena = arena_alloc();
   CONS__BakeCtx *result = push_array(arena, CONS__BakeCtx, 1);
   result->arena = arena;
   
+  // NOTE: bucket tables start small & double as they fill; fixed tables
+  // sized for the largest inputs were 256MB of zeroed memory on every bake
+  cons__strings_rehash(arena, &result->strs, 1 << 16);
+  cons__idx_runs_rehash(arena, &result->idxs, 1 << 16);
+  
   cons__string(result, str8_lit(""));
   
   cons__idx_run(result, 0, 0);
@@ -1913,7 +2185,7 @@ cons__string(CONS__BakeCtx *bctx, String8 str){
   CONS__Strings *strs = &bctx->strs;
   
   U64 hash = raddbg_hash(str.str, str.size);
-  U64 bucket_idx = hash%ArrayCount(strs->buckets);
+  U64 bucket_idx = hash%strs->buckets_count;
   
   // look for a match
   CONS__StringNode *match = 0;
@@ -1938,6 +2210,10 @@ cons__string(CONS__BakeCtx *bctx, String8 str){
     SLLQueuePush_N(strs->order_first, strs->order_last, node, order_next);
     SLLStackPush_N(strs->buckets[bucket_idx], node, bucket_next);
     
+    if (strs->count > strs->buckets_count){
+      cons__strings_rehash(arena, strs, strs->buckets_count*2);
+    }
+    
     match = node;
   }
   
@@ -1948,6 +2224,20 @@ cons__string(CONS__BakeCtx *bctx, String8 str){
   return(result);
 }
 
+static void
+cons__strings_rehash(Arena *arena, CONS__Strings *strs, U64 buckets_count){
+  // NOTE: pushing in order keeps each chain newest-first, as it was
+  CONS__StringNode **buckets = push_array(arena, CONS__StringNode*, buckets_count);
+  for (CONS__StringNode *node = strs->order_first;
+       node != 0;
+       node = node->order_next){
+    U64 bucket_idx = node->hash%buckets_count;
+    SLLStackPush_N(buckets[bucket_idx], node, bucket_next);
+  }
+  strs->buckets = buckets;
+  strs->buckets_count = buckets_count;
+}
+
 static U64
 cons__idx_run_hash(U32 *idx_run, U32 count){
   U64 hash = 5381;
@@ -1965,7 +2255,7 @@ cons__idx_run(CONS__BakeCtx *bctx, U32 *idx_run, U32 count){
   CONS__IdxRuns *idxs = &bctx->idxs;
   
   U64 hash = cons__idx_run_hash(idx_run, count);
-  U64 bucket_idx = hash%ArrayCount(idxs->buckets);
+  U64 bucket_idx = hash%idxs->buckets_count;
   
   // look for a match
   CONS__IdxRunNode *match = 0;
@@ -2006,6 +2296,10 @@ cons__idx_run(CONS__BakeCtx *bctx, U32 *idx_run, U32 count){
     SLLQueuePush_N(idxs->order_first, idxs->order_last, node, order_next);
     SLLStackPush_N(idxs->buckets[bucket_idx], node, bucket_next);
     
+    if (idxs->count > idxs->buckets_count){
+      cons__idx_runs_rehash(arena, idxs, idxs->buckets_count*2);
+    }
+    
     match = node;
   }
   
@@ -2016,6 +2310,19 @@ cons__idx_run(CONS__BakeCtx *bctx, U32 *idx_run, U32 count){
   return(result);
 }
 
+static void
+cons__idx_runs_rehash(Arena *arena, CONS__IdxRuns *idxs, U64 buckets_count){
+  CONS__IdxRunNode **buckets = push_array(arena, CONS__IdxRunNode*, buckets_count);
+  for (CONS__IdxRunNode *node = idxs->order_first;
+       node != 0;
+       node = node->order_next){
+    U64 bucket_idx = node->hash%buckets_count;
+    SLLStackPush_N(buckets[bucket_idx], node, bucket_next);
+  }
+  idxs->buckets = buckets;
+  idxs->buckets_count = buckets_count;
+}
+
 static CONS__PathNode*
 cons__paths_new_node(CONS__BakeCtx *bctx){
   CONS__PathTree *tree = bctx->tree;
@@ -2153,142 +2460,259 @@ cons__normal_string_from_path_node_build(Arena *arena, CONS__PathNode *node, Str
 //- cons sort helper
 
 static CONS__SortKey*
-cons__sort_key_array(Arena *arena, CONS__SortKey *keys, U64 count){
+cons__sort_key_array(Arena *arena, CONS__SortKey *keys, U64 count, U64 thread_count){
   // This sort is designed to take advantage of lots of pre-existing sorted ranges.
   // Most line info is already sorted or close to already sorted.
   // Similarly most vmap data has lots of pre-sorted ranges. etc. etc.
   // Also - this sort should be a "stable" sort. In the use case of sorting vmap
   // ranges, we want to be able to rely on order, so it needs to be preserved here.
+  // Interleaved tables (eg. line info from LTCG) can have lots of very short
+  // ranges though - those go to a radix sort instead.
   
   ProfBegin("cons__sort_key_array");
-  Temp scratch = scratch_begin(&arena, 1);
   
   CONS__SortKey *result = 0;
   
-  if (count <= 1){
+  // count pre-sorted ranges & find which key bytes vary
+  U64 run_count = 0;
+  U32 digit_mask = 0;
+  if (count > 0){
+    U64 first_key = keys[0].key;
+    U64 diff_bits = 0;
+    run_count = 1;
+    for (U64 i = 1; i < count; i += 1){
+      run_count += (keys[i - 1].key > keys[i].key);
+      diff_bits |= (keys[i].key ^ first_key);
+    }
+    for (U32 byte_idx = 0; byte_idx < 8; byte_idx += 1){
+      if (((diff_bits >> (byte_idx*8)) & 0xFF) != 0){
+        digit_mask |= (1 << byte_idx);
+      }
+    }
+  }
+  
+  // NOTE: merging does one pass per doubling of the range size; radix
+  // does one pass per varying key byte, but its scattered writes make each
+  // pass about twice the cost of a merge pass.
+  U64 merge_pass_count = (run_count > 1) ? (64 - clz64(run_count - 1)) : 0;
+  U64 radix_pass_count = count_bits_set32(digit_mask);
+  B32 use_radix = (count >= CONS__SORT_RADIX_MIN_COUNT && radix_pass_count*2 < merge_pass_count);
+  
+  if (count <= 1 || run_count <= 1){
     result = keys;
   }
+  else if (use_radix){
+    result = cons__sort_key_array_radix(arena, keys, count, digit_mask, thread_count);
+  }
   else{
-    CONS__OrderedRange *ranges_first = 0;
-    CONS__OrderedRange *ranges_last = 0;
-    U64 range_count = 0;
-    {
-      U64 pos = 0;
-      for (;pos < count;){
-        // identify ordered range
-        U64 first = pos;
-        U64 opl = pos + 1;
-        for (; opl < count && keys[opl - 1].key <= keys[opl].key; opl += 1);
-        
-        // generate an ordered range node
-        CONS__OrderedRange *new_range = push_array(scratch.arena, CONS__OrderedRange, 1);
-        SLLQueuePush(ranges_first, ranges_last, new_range);
-        range_count += 1;
-        new_range->first = first;
-        new_range->opl = opl;
-        
-        // update pos
-        pos = opl;
-      }
-    }
-    
-    if (range_count == 1){
-      result = keys;
-    }
-    else{
-      CONS__SortKey *keys_swap = push_array_no_zero(arena, CONS__SortKey, count);
-      
-      CONS__SortKey *src = keys;
-      CONS__SortKey *dst = keys_swap;
+    result = cons__sort_key_array_merge(arena, keys, count);
+  }
+  
+#if 0
+  // assert sortedness
+  for (U64 i = 1; i < count; i += 1){
+    Assert(result[i - 1].key <= result[i].key);
+  }
+#endif
+  
+  ProfEnd();
+  
+  return(result);
+}
+
+static CONS__SortKey*
+cons__sort_key_array_merge(Arena *arena, CONS__SortKey *keys, U64 count){
+  ProfBegin("cons__sort_key_array_merge");
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  CONS__SortKey *result = 0;
+  
+  CONS__OrderedRange *ranges_first = 0;
+  CONS__OrderedRange *ranges_last = 0;
+  U64 range_count = 0;
+  {
+    U64 pos = 0;
+    for (;pos < count;){
+      // identify ordered range
+      U64 first = pos;
+      U64 opl = pos + 1;
+      for (; opl < count && keys[opl - 1].key <= keys[opl].key; opl += 1);
       
-      CONS__OrderedRange *src_ranges = ranges_first;
-      CONS__OrderedRange *dst_ranges = 0;
-      CONS__OrderedRange *dst_ranges_last = 0;
+      // generate an ordered range node
+      CONS__OrderedRange *new_range = push_array(scratch.arena, CONS__OrderedRange, 1);
+      SLLQueuePush(ranges_first, ranges_last, new_range);
+      range_count += 1;
+      new_range->first = first;
+      new_range->opl = opl;
       
+      // update pos
+      pos = opl;
+    }
+  }
+  
+  if (range_count == 1){
+    result = keys;
+  }
+  else{
+    CONS__SortKey *keys_swap = push_array_no_zero(arena, CONS__SortKey, count);
+    
+    CONS__SortKey *src = keys;
+    CONS__SortKey *dst = keys_swap;
+    
+    CONS__OrderedRange *src_ranges = ranges_first;
+    CONS__OrderedRange *dst_ranges = 0;
+    CONS__OrderedRange *dst_ranges_last = 0;
+    
+    for (;;){
+      // begin a pass
       for (;;){
-        // begin a pass
+        // end pass when out of ranges
+        if (src_ranges == 0){
+          break;
+        }
+        
+        // get first range
+        CONS__OrderedRange *range1 = src_ranges;
+        SLLStackPop(src_ranges);
+        
+        // if this range is the whole array, we are done
+        if (range1->first == 0 && range1->opl == count){
+          result = src;
+          goto merge_done;
+        }
+        
+        // if there is not a second range, save this range for next time and end this pass
+        if (src_ranges == 0){
+          U64 first = range1->first;
+          MemoryCopy(dst + first, src + first, sizeof(*src)*(range1->opl - first));
+          SLLQueuePush(dst_ranges, dst_ranges_last, range1);
+          break;
+        }
+        
+        // get second range
+        CONS__OrderedRange *range2 = src_ranges;
+        SLLStackPop(src_ranges);
+        
+        Assert(range1->opl == range2->first);
+        
+        // merge these ranges
+        U64 jd = range1->first;
+        U64 j1 = range1->first;
+        U64 j1_opl = range1->opl;
+        U64 j2 = range2->first;
+        U64 j2_opl = range2->opl;
         for (;;){
-          // end pass when out of ranges
-          if (src_ranges == 0){
-            break;
-          }
-          
-          // get first range
-          CONS__OrderedRange *range1 = src_ranges;
-          SLLStackPop(src_ranges);
-          
-          // if this range is the whole array, we are done
-          if (range1->first == 0 && range1->opl == count){
-            result = src;
-            goto sort_done;
-          }
-          
-          // if there is not a second range, save this range for next time and end this pass
-          if (src_ranges == 0){
-            U64 first = range1->first;
-            MemoryCopy(dst + first, src + first, sizeof(*src)*(range1->opl - first));
-            SLLQueuePush(dst_ranges, dst_ranges_last, range1);
-            break;
-          }
-          
-          // get second range
-          CONS__OrderedRange *range2 = src_ranges;
-          SLLStackPop(src_ranges);
-          
-          Assert(range1->opl == range2->first);
-          
-          // merge these ranges
-          U64 jd = range1->first;
-          U64 j1 = range1->first;
-          U64 j1_opl = range1->opl;
-          U64 j2 = range2->first;
-          U64 j2_opl = range2->opl;
-          for (;;){
-            if (src[j1].key <= src[j2].key){
-              MemoryCopy(dst + jd, src + j1, sizeof(*src));
-              j1 += 1;
-              jd += 1;
-              if (j1 >= j1_opl){
-                break;
-              }
-            }
-            else{
-              MemoryCopy(dst + jd, src + j2, sizeof(*src));
-              j2 += 1;
-              jd += 1;
-              if (j2 >= j2_opl){
-                break;
-              }
+          if (src[j1].key <= src[j2].key){
+            MemoryCopy(dst + jd, src + j1, sizeof(*src));
+            j1 += 1;
+            jd += 1;
+            if (j1 >= j1_opl){
+              break;
             }
           }
-          if (j1 < j1_opl){
-            MemoryCopy(dst + jd, src + j1, sizeof(*src)*(j1_opl - j1));
-          }
           else{
-            MemoryCopy(dst + jd, src + j2, sizeof(*src)*(j2_opl - j2));
+            MemoryCopy(dst + jd, src + j2, sizeof(*src));
+            j2 += 1;
+            jd += 1;
+            if (j2 >= j2_opl){
+              break;
+            }
           }
-          
-          // save this as one range
-          range1->opl = range2->opl;
-          SLLQueuePush(dst_ranges, dst_ranges_last, range1);
+        }
+        if (j1 < j1_opl){
+          MemoryCopy(dst + jd, src + j1, sizeof(*src)*(j1_opl - j1));
+        }
+        else{
+          MemoryCopy(dst + jd, src + j2, sizeof(*src)*(j2_opl - j2));
         }
         
-        // end pass by swapping buffers and range nodes
-        Swap(CONS__SortKey*, src, dst);
-        src_ranges = dst_ranges;
-        dst_ranges = 0;
-        dst_ranges_last = 0;
+        // save this as one range
+        range1->opl = range2->opl;
+        SLLQueuePush(dst_ranges, dst_ranges_last, range1);
       }
+      
+      // end pass by swapping buffers and range nodes
+      Swap(CONS__SortKey*, src, dst);
+      src_ranges = dst_ranges;
+      dst_ranges = 0;
+      dst_ranges_last = 0;
     }
   }
-  sort_done:;
+  merge_done:;
   
-#if 0
-  // assert sortedness
-  for (U64 i = 1; i < count; i += 1){
-    Assert(result[i - 1].key <= result[i].key);
+  scratch_end(scratch);
+  ProfEnd();
+  
+  return(result);
+}
+
+static CONS__SortKey*
+cons__sort_key_array_radix(Arena *arena, CONS__SortKey *keys, U64 count, U32 digit_mask, U64 thread_count){
+  ProfBegin("cons__sort_key_array_radix");
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  // split into chunks with their own histograms
+  U64 chunk_count = 1;
+  if (thread_count > 1 && count >= CONS__SORT_PARALLEL_MIN_COUNT){
+    chunk_count = thread_count;
+  }
+  
+  CONS__RadixSortPass *pass = push_array(scratch.arena, CONS__RadixSortPass, 1);
+  pass->src = keys;
+  pass->dst = push_array_no_zero(arena, CONS__SortKey, count);
+  pass->count = count;
+  pass->chunk_size = (count + chunk_count - 1)/chunk_count;
+  pass->chunk_count = chunk_count;
+  pass->chunk_offs = push_array_no_zero(scratch.arena, U64, chunk_count*256);
+  
+  CONS__TaskBatch *batch = 0;
+  if (chunk_count > 1){
+    batch = cons__task_batch_alloc(scratch.arena, thread_count);
   }
-#endif
+  
+  // one stable counting pass per varying byte, least significant first
+  for (U32 byte_idx = 0; byte_idx < 8; byte_idx += 1){
+    if (digit_mask & (1 << byte_idx)){
+      pass->shift = byte_idx*8;
+      
+      // count
+      if (batch != 0){
+        cons__task_batch_run(batch, cons__radix_sort_hist_task, pass, chunk_count);
+      }
+      else{
+        cons__radix_sort_hist_task(0, pass, 0);
+      }
+      
+      // counts -> write cursors
+      // * digit-major, chunk-minor, so equal digits keep their input order across chunks
+      U64 off = 0;
+      for (U64 digit = 0; digit < 256; digit += 1){
+        for (U64 chunk_idx = 0; chunk_idx < chunk_count; chunk_idx += 1){
+          U64 *slot = &pass->chunk_offs[chunk_idx*256 + digit];
+          U64 digit_count = *slot;
+          *slot = off;
+          off += digit_count;
+        }
+      }
+      Assert(off == count);
+      
+      // scatter
+      if (batch != 0){
+        cons__task_batch_run(batch, cons__radix_sort_scatter_task, pass, chunk_count);
+      }
+      else{
+        cons__radix_sort_scatter_task(0, pass, 0);
+      }
+      
+      Swap(CONS__SortKey*, pass->src, pass->dst);
+    }
+  }
+  
+  if (batch != 0){
+    cons__task_batch_release(batch);
+  }
+  
+  CONS__SortKey *result = pass->src;
   
   scratch_end(scratch);
   ProfEnd();
@@ -2296,12 +2720,43 @@ cons__sort_key_array(Arena *arena, CONS__SortKey *keys, U64 count){
   return(result);
 }
 
+static void
+cons__radix_sort_hist_task(Arena *arena, void *ptr, U64 chunk_idx){
+  CONS__RadixSortPass *pass = (CONS__RadixSortPass*)ptr;
+  U64 first = ClampTop(chunk_idx*pass->chunk_size, pass->count);
+  U64 opl = ClampTop(first + pass->chunk_size, pass->count);
+  U64 *counts = pass->chunk_offs + chunk_idx*256;
+  U32 shift = pass->shift;
+  
+  MemoryZero(counts, sizeof(*counts)*256);
+  CONS__SortKey *src = pass->src;
+  for (U64 i = first; i < opl; i += 1){
+    counts[(src[i].key >> shift) & 0xFF] += 1;
+  }
+}
+
+static void
+cons__radix_sort_scatter_task(Arena *arena, void *ptr, U64 chunk_idx){
+  CONS__RadixSortPass *pass = (CONS__RadixSortPass*)ptr;
+  U64 first = ClampTop(chunk_idx*pass->chunk_size, pass->count);
+  U64 opl = ClampTop(first + pass->chunk_size, pass->count);
+  U64 *offs = pass->chunk_offs + chunk_idx*256;
+  U32 shift = pass->shift;
+  
+  CONS__SortKey *src = pass->src;
+  CONS__SortKey *dst = pass->dst;
+  for (U64 i = first; i < opl; i += 1){
+    U64 digit = (src[i].key >> shift) & 0xFF;
+    dst[offs[digit]] = src[i];
+    offs[digit] += 1;
+  }
+}
+
 
 //- cons intermediate unit line info
-static CONS__UnitLinesCombined*
-cons__unit_combine_lines(Arena *arena, CONS__BakeCtx *bctx, CONS_LineSequenceNode *first_seq){
-  ProfBegin("cons__unit_combine_lines");
-  Temp scratch = scratch_begin(&arena, 1);
+static CONS__UnitLinesGathered*
+cons__unit_gather_lines(Arena *arena, CONS__BakeCtx *bctx, CONS_LineSequenceNode *first_seq){
+  ProfBegin("cons__unit_gather_lines");
   
   // gather up all line info into two arrays
   //  keys: sortable array; pairs voffs with line info records; null records are sequence enders
@@ -2316,8 +2771,8 @@ cons__unit_combine_lines(Arena *arena, CONS__BakeCtx *bctx, CONS_LineSequenceNod
   }
   
   U64 key_count = line_count + seq_count;
-  CONS__SortKey *line_keys = push_array_no_zero(scratch.arena, CONS__SortKey, key_count);
-  CONS__LineRec *line_recs = push_array_no_zero(scratch.arena, CONS__LineRec, line_count);
+  CONS__SortKey *line_keys = push_array_no_zero(arena, CONS__SortKey, key_count);
+  CONS__LineRec *line_recs = push_array_no_zero(arena, CONS__LineRec, line_count);
   
   {
     CONS__SortKey *key_ptr = line_keys;
@@ -2356,8 +2811,25 @@ cons__unit_combine_lines(Arena *arena, CONS__BakeCtx *bctx, CONS_LineSequenceNod
     }
   }
   
+  CONS__UnitLinesGathered *result = push_array(arena, CONS__UnitLinesGathered, 1);
+  result->keys = line_keys;
+  result->recs = line_recs;
+  result->key_count = key_count;
+  
+  ProfEnd();
+  
+  return(result);
+}
+
+static CONS__UnitLinesCombined*
+cons__unit_combine_lines(Arena *arena, CONS__UnitLinesGathered *gathered){
+  ProfBegin("cons__unit_combine_lines");
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  U64 key_count = gathered->key_count;
+  
   // sort
-  CONS__SortKey *sorted_line_keys = cons__sort_key_array(scratch.arena, line_keys, key_count);
+  CONS__SortKey *sorted_line_keys = cons__sort_key_array(scratch.arena, gathered->keys, key_count, 1);
   
   // TODO(allen): do a pass over sorted keys to make sure duplicate keys are sorted with
   // null record first, and no more than one null record and one non-null record
@@ -2466,7 +2938,7 @@ cons__source_combine_lines(Arena *arena, CONS__LineMapFragment *first){
   }
   
   // sort
-  CONS__SortKey *sorted_keys = cons__sort_key_array(scratch.arena, keys, line_count);
+  CONS__SortKey *sorted_keys = cons__sort_key_array(scratch.arena, keys, line_count, 1);
   
   // bake result
   U32 *line_nums = push_array_no_zero(arena, U32, line_count);
@@ -2505,11 +2977,12 @@ cons__source_combine_lines(Arena *arena, CONS__LineMapFragment *first){
 
 //- cons intermediate vmap type
 static CONS__VMap*
-cons__vmap_from_markers(Arena *arena, CONS__VMapMarker *markers, CONS__SortKey *keys, U64 marker_count){
+cons__vmap_from_markers(Arena *arena, CONS__VMapMarker *markers, CONS__SortKey *keys, U64 marker_count,
+                        U64 thread_count){
   Temp scratch = scratch_begin(&arena, 1);
   
   // sort markers
-  CONS__SortKey *sorted_keys = cons__sort_key_array(scratch.arena, keys, marker_count);
+  CONS__SortKey *sorted_keys = cons__sort_key_array(scratch.arena, keys, marker_count, thread_count);
   
   // determine if an extra vmap entry for zero is needed
   U32 extra_vmap_entry = 0;
@@ -2656,7 +3129,7 @@ cons__vmap_from_markers(Arena *arena, CONS__VMapMarker *markers, CONS__SortKey *
 
 //- cons intermediate unit vmap
 static CONS__VMap*
-cons__vmap_from_unit_ranges(Arena *arena, CONS_UnitVMapRange *first, U64 count){
+cons__vmap_from_unit_ranges(Arena *arena, CONS_UnitVMapRange *first, U64 count, U64 thread_count){
   Temp scratch = scratch_begin(&arena, 1);
   
   // count necessary markers
@@ -2693,7 +3166,7 @@ cons__vmap_from_unit_ranges(Arena *arena, CONS_UnitVMapRange *first, U64 count){
   }
   
   // construct vmap
-  CONS__VMap *result = cons__vmap_from_markers(arena, markers, keys, marker_count);
+  CONS__VMap *result = cons__vmap_from_markers(arena, markers, keys, marker_count, thread_count);
   
   scratch_end(scratch);
   
@@ -2708,7 +3181,7 @@ cons__type_data_combine(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx){
   
   // fill type nodes
   U32 type_count = root->type_count;
-  RADDBG_TypeNode *type_nodes = push_array_no_zero(arena, RADDBG_TypeNode, type_count);
+  RADDBG_TypeNode *type_nodes = push_array(arena, RADDBG_TypeNode, type_count);
   
   {
     RADDBG_TypeNode *ptr = type_nodes;
@@ -2787,13 +3260,13 @@ cons__type_data_combine(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx){
   
   // fill udts
   U32 udt_count = root->type_udt_count;
-  RADDBG_UDT *udts = push_array_no_zero(arena, RADDBG_UDT, udt_count);
+  RADDBG_UDT *udts = push_array(arena, RADDBG_UDT, udt_count);
   
   U32 member_count = root->total_member_count;
-  RADDBG_Member *members = push_array_no_zero(arena, RADDBG_Member, member_count);
+  RADDBG_Member *members = push_array(arena, RADDBG_Member, member_count);
   
   U32 enum_member_count = root->total_enum_val_count;
-  RADDBG_EnumMember *enum_members = push_array_no_zero(arena, RADDBG_EnumMember, enum_member_count);
+  RADDBG_EnumMember *enum_members = push_array(arena, RADDBG_EnumMember, enum_member_count);
   
   {
     RADDBG_UDT *ptr = udts;
@@ -3063,7 +3536,8 @@ cons__symbol_data_combine(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx){
            marker_ptr - markers == marker_count);
     
     // construct vmap
-    global_vmap = cons__vmap_from_markers(arena, markers, keys, marker_count);
+    global_vmap = cons__vmap_from_markers(arena, markers, keys, marker_count,
+                                          root->bake_thread_count);
   }
   
   // allocate scope array
@@ -3260,7 +3734,8 @@ cons__symbol_data_combine(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx){
       }
     }
     
-    scope_vmap = cons__vmap_from_markers(arena, markers, keys, marker_count);
+    scope_vmap = cons__vmap_from_markers(arena, markers, keys, marker_count,
+                                         root->bake_thread_count);
   }
   
   // fill result
@@ -3292,26 +3767,34 @@ cons__symbol_data_combine(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx){
 
 //- cons serializer for name maps
 
-static CONS__NameMapBaked*
-cons__name_map_bake(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx, CONS__NameMap *map){
-  Temp scratch = scratch_begin(&arena, 1);
-  
+static CONS__NameMapSemiBucket*
+cons__name_map_semi_buckets(Arena *arena, CONS__NameMap *map){
   U32 bucket_count = map->name_count;
-  U32 node_count = map->name_count;
   
   // setup the final bucket layouts
-  CONS__NameMapSemiBucket *sbuckets = push_array(scratch.arena, CONS__NameMapSemiBucket, bucket_count);
+  CONS__NameMapSemiBucket *sbuckets = push_array(arena, CONS__NameMapSemiBucket, bucket_count);
   for (CONS__NameMapNode *node = map->first;
        node != 0;
        node = node->order_next){
     U64 hash = raddbg_hash(node->string.str, node->string.size);
     U64 bi = hash%bucket_count;
-    CONS__NameMapSemiNode *snode = push_array(scratch.arena, CONS__NameMapSemiNode, 1);
+    CONS__NameMapSemiNode *snode = push_array(arena, CONS__NameMapSemiNode, 1);
     SLLQueuePush(sbuckets[bi].first, sbuckets[bi].last, snode);
     snode->node = node;
     sbuckets[bi].count += 1;
   }
   
+  return(sbuckets);
+}
+
+static CONS__NameMapBaked*
+cons__name_map_bake(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx, CONS__NameMap *map,
+                    CONS__NameMapSemiBucket *sbuckets){
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  U32 bucket_count = map->name_count;
+  U32 node_count = map->name_count;
+  
   // allocate tables
   RADDBG_NameMapBucket *buckets = push_array(arena, RADDBG_NameMapBucket, bucket_count);
   RADDBG_NameMapNode *nodes = push_array_no_zero(arena, RADDBG_NameMapNode, node_count);
@@ -3376,3 +3859,242 @@ cons__name_map_bake(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx, CONS__Na
   result->node_count = node_count;
   return(result);
 }
+
+//- cons serializer for trigram maps
+
+static CONS__TrigramMapBaked*
+cons__trigram_map_bake(Arena *arena, String8 *names, U32 name_count){
+  ProfBegin("cons__trigram_map_bake");
+  Temp scratch = scratch_begin(&arena, 1);
+  
+  // gather (trigram, name index) pairs; scratch is sized by the trigrams the
+  // names actually contain rather than by the 24-bit trigram space
+  U64 pair_count = 0;
+  for (U32 idx = 1; idx < name_count; idx += 1){
+    if (names[idx].size >= 3){
+      pair_count += names[idx].size - 2;
+    }
+  }
+  CONS__SortKey *pairs = push_array_no_zero(scratch.arena, CONS__SortKey, pair_count);
+  {
+    CONS__SortKey *pair_ptr = pairs;
+    for (U32 idx = 1; idx < name_count; idx += 1){
+      String8 name = names[idx];
+      for (U64 off = 0; off + 3 <= name.size; off += 1, pair_ptr += 1){
+        U32 trigram = raddbg_trigram_from_ptr(name.str + off);
+        pair_ptr->key = ((U64)trigram << 32) | idx;
+        pair_ptr->val = 0;
+      }
+    }
+  }
+  
+  // sorting groups each trigram's postings in index order; repeats of a
+  // trigram within one name end up adjacent & are dropped below
+  CONS__SortKey *sorted = cons__sort_key_array(scratch.arena, pairs, pair_count, 1);
+  
+  // count entries & postings
+  U32 posting_count = 0;
+  U32 entry_count = 0;
+  for (U64 i = 0; i < pair_count; i += 1){
+    if (i == 0 || sorted[i].key != sorted[i - 1].key){
+      posting_count += 1;
+      if (i == 0 || (sorted[i].key >> 32) != (sorted[i - 1].key >> 32)){
+        entry_count += 1;
+      }
+    }
+  }
+  
+  // allocate tables
+  RADDBG_TrigramMapEntry *entries = push_array_no_zero(arena, RADDBG_TrigramMapEntry, entry_count);
+  U32 *postings = push_array_no_zero(arena, U32, posting_count);
+  
+  // fill entries & postings
+  {
+    RADDBG_TrigramMapEntry *entry_ptr = 0;
+    U32 entry_off = 0;
+    U32 posting_off = 0;
+    for (U64 i = 0; i < pair_count; i += 1){
+      if (i != 0 && sorted[i].key == sorted[i - 1].key){
+        continue;
+      }
+      U32 trigram = (U32)(sorted[i].key >> 32);
+      if (i == 0 || trigram != (U32)(sorted[i - 1].key >> 32)){
+        entry_ptr = &entries[entry_off];
+        entry_off += 1;
+        entry_ptr->trigram = trigram;
+        entry_ptr->posting_first = posting_off;
+        entry_ptr->posting_count = 0;
+      }
+      postings[posting_off] = (U32)sorted[i].key;
+      entry_ptr->posting_count += 1;
+      posting_off += 1;
+    }
+    Assert(entry_off == entry_count);
+    Assert(posting_off == posting_count);
+  }
+  
+  scratch_end(scratch);
+  
+  CONS__TrigramMapBaked *result = push_array(arena, CONS__TrigramMapBaked, 1);
+  result->entries = entries;
+  result->postings = postings;
+  result->entry_count = entry_count;
+  result->posting_count = posting_count;
+  ProfEnd();
+  return(result);
+}
+
+//- cons parallel bake
+
+static CONS__TaskBatch*
+cons__task_batch_alloc(Arena *arena, U64 worker_count){
+  CONS__TaskBatch *batch = push_array(arena, CONS__TaskBatch, 1);
+  batch->worker_count = ClampBot(worker_count, 1);
+  batch->worker_arenas = push_array(arena, Arena*, batch->worker_count);
+  batch->worker_threads = push_array(arena, OS_Handle, batch->worker_count);
+  batch->workers = push_array(arena, CONS__TaskWorker, batch->worker_count);
+  for (U64 i = 0; i < batch->worker_count; i += 1){
+    batch->worker_arenas[i] = arena_alloc();
+    batch->workers[i].batch = batch;
+    batch->workers[i].worker_idx = i;
+  }
+  batch->mutex = os_mutex_alloc();
+  batch->cv = os_condition_variable_alloc();
+  return(batch);
+}
+
+static void
+cons__task_batch_release(CONS__TaskBatch *batch){
+  for (U64 i = 0; i < batch->worker_count; i += 1){
+    arena_release(batch->worker_arenas[i]);
+  }
+  os_condition_variable_release(batch->cv);
+  os_mutex_release(batch->mutex);
+}
+
+static void
+cons__task_batch_run(CONS__TaskBatch *batch, CONS__TaskFunction *func, void *ptr, U64 task_count){
+  ProfBeginFunction();
+  batch->func = func;
+  batch->ptr = ptr;
+  batch->task_count = task_count;
+  batch->next_task_idx = 1;
+  batch->done_worker_count = 0;
+  
+  // launch helpers; the calling thread is worker 0
+  U64 helper_count = ClampTop(batch->worker_count, task_count);
+  helper_count = (helper_count > 0) ? helper_count - 1 : 0;
+  for (U64 i = 1; i <= helper_count; i += 1){
+    batch->worker_threads[i] = os_launch_thread(cons__task_batch_worker_entry_point, &batch->workers[i], 0);
+  }
+  
+  // NOTE: task 0 always runs on the calling thread, so it may push to arenas
+  // only the caller owns - those can be the caller's scratch arenas, which
+  // other tasks on this thread begin & end temps on
+  if (task_count > 0){
+    func(batch->worker_arenas[0], ptr, 0);
+  }
+  
+  // help out
+  cons__task_batch_do_tasks(batch, 0);
+  
+  // wait for the helpers to finish their last tasks
+  if (helper_count > 0){
+    OS_MutexScope(batch->mutex){
+      for (;batch->done_worker_count < helper_count;){
+        os_condition_variable_wait(batch->cv, batch->mutex, max_U64);
+      }
+    }
+    for (U64 i = 1; i <= helper_count; i += 1){
+      os_release_thread_handle(batch->worker_threads[i]);
+    }
+  }
+  ProfEnd();
+}
+
+static void
+cons__task_batch_do_tasks(CONS__TaskBatch *batch, U64 worker_idx){
+  Arena *arena = batch->worker_arenas[worker_idx];
+  for (;;){
+    U64 task_idx = ins_atomic_u64_inc_eval(&batch->next_task_idx) - 1;
+    if (task_idx >= batch->task_count){
+      break;
+    }
+    batch->func(arena, batch->ptr, task_idx);
+  }
+}
+
+static void
+cons__task_batch_worker_entry_point(void *ptr){
+  TCTX tctx_ = {0};
+  tctx_init_and_equip(&tctx_);
+  CONS__TaskWorker *worker = (CONS__TaskWorker*)ptr;
+  CONS__TaskBatch *batch = worker->batch;
+  ThreadName("[cons] bake worker #%I64u", worker->worker_idx);
+  
+  cons__task_batch_do_tasks(batch, worker->worker_idx);
+  
+  // NOTE: helpers only live for one batch, so drop the scratch
+  // arenas here; the batch may be torn down as soon as we report.
+  for (U64 i = 0; i < ArrayCount(tctx_.arenas); i += 1){
+    arena_release(tctx_.arenas[i]);
+  }
+  OS_MutexScope(batch->mutex){
+    batch->done_worker_count += 1;
+    os_condition_variable_broadcast(batch->cv);
+  }
+}
+
+static void
+cons__bake_task(Arena *arena, void *ptr, U64 task_idx){
+  CONS__BakeTasks *tasks = (CONS__BakeTasks*)ptr;
+  CONS_Root *root = tasks->root;
+  
+  U64 src_first = CONS__BakeTask_FixedCount;
+  U64 unit_first = src_first + tasks->src_count;
+  
+  // spine: the only task that interns, and the only one that uses the output arena
+  // * it's task 0, so it runs on the thread that owns the output arena
+  if (task_idx == CONS__BakeTask_Spine){
+    tasks->types = cons__type_data_combine(tasks->arena, root, tasks->bctx);
+    tasks->symbol_data = cons__symbol_data_combine(tasks->arena, root, tasks->bctx);
+  }
+  
+  // unit vmap
+  else if (task_idx == CONS__BakeTask_UnitVMap){
+    tasks->unit_vmap = cons__vmap_from_unit_ranges(arena,
+                                                   root->unit_vmap_range_first,
+                                                   root->unit_vmap_range_count,
+                                                   root->bake_thread_count);
+  }
+  
+  // trigram maps
+  else if (task_idx < CONS__BakeTask_TrigramMapOpl){
+    U32 kind = (U32)(task_idx - CONS__BakeTask_TrigramMapFirst);
+    if (kind != RADDBG_TrigramMapKind_NULL && root->bake_trigram_maps){
+      tasks->trigram_maps[kind] =
+        cons__trigram_map_bake(arena, tasks->trigram_names[kind], tasks->trigram_name_counts[kind]);
+    }
+  }
+  
+  // name map buckets
+  else if (task_idx < CONS__BakeTask_NameMapOpl){
+    U32 kind = (U32)(task_idx - CONS__BakeTask_NameMapFirst);
+    CONS__NameMap *map = root->name_maps[kind];
+    if (map != 0){
+      tasks->name_map_sbuckets[kind] = cons__name_map_semi_buckets(arena, map);
+    }
+  }
+  
+  // source line info
+  else if (task_idx < unit_first){
+    U64 i = task_idx - src_first;
+    tasks->src_lines[i] = cons__source_combine_lines(arena, tasks->src_nodes[i]->first_fragment);
+  }
+  
+  // unit line info
+  else{
+    U64 i = task_idx - unit_first;
+    tasks->unit_lines[i] = cons__unit_combine_lines(arena, tasks->unit_lines_gathered[i]);
+  }
+}
@@ -57,6 +57,14 @@ typedef struct CONS_RootParams{
   U32 bucket_count_scopes;
   U32 bucket_count_locals;
   U32 bucket_count_types;
+  
+  // threads used by cons_bake_file
+  // * zero or one bakes everything on the calling thread
+  U64 bake_thread_count;
+  
+  // optional sections
+  // * trigram maps narrow fuzzy name searches, at the cost of bake time & file size
+  B8 bake_trigram_maps;
 } CONS_RootParams;
 
 static CONS_Root* cons_root_new(CONS_RootParams *params);
@@ -64,7 +72,14 @@ static void       cons_root_release(CONS_Root *root);
 
 
 //- baking
+// * cons_bake_file builds the whole file in memory
+// * cons_bake_file_stream hands each data section to `write` as soon as it is
+//   final and releases it where it can; the header & section table are written
+//   last, into space reserved at the start of the file
+typedef void CONS_BakeWriteFunction(void *write_ptr, U64 off, void *data, U64 size);
+
 static void cons_bake_file(Arena *arena, CONS_Root *root, String8List *out);
+static void cons_bake_file_stream(Arena *arena, CONS_Root *root, CONS_BakeWriteFunction *write, void *write_ptr);
 
 
 //- errors
@@ -544,6 +559,8 @@ struct CONS_Root{
   //////// Contextual Information
   
   U64 addr_size;
+  U64 bake_thread_count;
+  B8 bake_trigram_maps;
   
   //////// Info Declared By User
   
@@ -619,6 +636,7 @@ typedef struct CONS__DSectionNode{
   struct CONS__DSectionNode *next;
   void *data;
   U64 size;
+  U64 off; // (streaming only)
   RADDBG_DataSectionTag tag;
 } CONS__DSectionNode;
 
@@ -626,6 +644,16 @@ typedef struct CONS__DSections{
   CONS__DSectionNode *first;
   CONS__DSectionNode *last;
   U32 count;
+  
+  // streaming
+  // * sections are held until the table size is reserved, then written immediately
+  CONS_BakeWriteFunction *write;
+  void *write_ptr;
+  Arena *node_arena;
+  B32 reserved;
+  U32 reserved_count;
+  U64 table_off;
+  U64 write_off;
 } CONS__DSections;
 
 //- cons intermediate strings
@@ -640,7 +668,8 @@ typedef struct CONS__StringNode{
 typedef struct CONS__Strings{
   CONS__StringNode *order_first;
   CONS__StringNode *order_last;
-  CONS__StringNode *buckets[1<<24];
+  CONS__StringNode **buckets;
+  U64 buckets_count;
   U32 count;
 } CONS__Strings;
 
@@ -657,7 +686,8 @@ typedef struct CONS__IdxRunNode{
 typedef struct CONS__IdxRuns{
   CONS__IdxRunNode *order_first;
   CONS__IdxRunNode *order_last;
-  CONS__IdxRunNode *buckets[1<<24];
+  CONS__IdxRunNode **buckets;
+  U64 buckets_count;
   U32 count;
   U32 idx_count;
 } CONS__IdxRuns;
@@ -715,16 +745,25 @@ typedef struct CONS__BakeCtx{
 } CONS__BakeCtx;
 
 //- cons intermediate functions
-static U32 cons__dsection(Arena *arena, CONS__DSections *dss,
-                          void *data, U64 size, RADDBG_DataSectionTag tag);
+static void cons__bake_sections(Arena *arena, CONS_Root *root, CONS__DSections *dss);
+
+static U32  cons__dsection(Arena *arena, CONS__DSections *dss,
+                           void *data, U64 size, RADDBG_DataSectionTag tag);
+static U32  cons__dsection_copy(Arena *arena, CONS__DSections *dss,
+                                void *data, U64 size, RADDBG_DataSectionTag tag);
+static void cons__dsection_write(CONS__DSections *dss, CONS__DSectionNode *node);
+static void cons__dsections_reserve(CONS__DSections *dss, U32 max_count);
+static void cons__dsections_release_temp(CONS__DSections *dss, Temp temp);
 
 static CONS__BakeCtx* cons__bake_ctx_begin(void);
 static void           cons__bake_ctx_release(CONS__BakeCtx *bake_ctx);
 
 static U32 cons__string(CONS__BakeCtx *bctx, String8 str);
+static void cons__strings_rehash(Arena *arena, CONS__Strings *strs, U64 buckets_count);
 
 static U64 cons__idx_run_hash(U32 *idx_run, U32 count);
 static U32 cons__idx_run(CONS__BakeCtx *bctx, U32 *idx_run, U32 count);
+static void cons__idx_runs_rehash(Arena *arena, CONS__IdxRuns *idxs, U64 buckets_count);
 
 static CONS__PathNode* cons__paths_new_node(CONS__BakeCtx *bctx);
 static CONS__PathNode* cons__paths_sub_path(CONS__BakeCtx *bctx, CONS__PathNode *dir, String8 sub_dir);
@@ -752,7 +791,28 @@ typedef struct CONS__OrderedRange{
   U64 opl;
 } CONS__OrderedRange;
 
-static CONS__SortKey* cons__sort_key_array(Arena *arena, CONS__SortKey *keys, U64 count);
+// NOTE: inputs with many short runs sort faster with an LSD radix sort
+// over just the key bytes that vary; large ones split each radix pass into
+// chunks with their own histograms so the passes can run on several threads.
+#define CONS__SORT_RADIX_MIN_COUNT    4096
+#define CONS__SORT_PARALLEL_MIN_COUNT (1 << 18)
+
+typedef struct CONS__RadixSortPass{
+  CONS__SortKey *src;
+  CONS__SortKey *dst;
+  U64 count;
+  U64 chunk_size;
+  U64 chunk_count;
+  U64 *chunk_offs; // [chunk_count*256]
+  U32 shift;
+} CONS__RadixSortPass;
+
+static CONS__SortKey* cons__sort_key_array(Arena *arena, CONS__SortKey *keys, U64 count, U64 thread_count);
+static CONS__SortKey* cons__sort_key_array_merge(Arena *arena, CONS__SortKey *keys, U64 count);
+static CONS__SortKey* cons__sort_key_array_radix(Arena *arena, CONS__SortKey *keys, U64 count,
+                                                 U32 digit_mask, U64 thread_count);
+static void           cons__radix_sort_hist_task(Arena *arena, void *ptr, U64 chunk_idx);
+static void           cons__radix_sort_scatter_task(Arena *arena, void *ptr, U64 chunk_idx);
 
 
 //- cons serializer for unit line info
@@ -770,8 +830,15 @@ typedef struct CONS__UnitLinesCombined{
   U32 line_count;
 } CONS__UnitLinesCombined;
 
-static CONS__UnitLinesCombined* cons__unit_combine_lines(Arena *arena, CONS__BakeCtx *bctx,
-                                                         CONS_LineSequenceNode *first);
+typedef struct CONS__UnitLinesGathered{
+  CONS__SortKey *keys;
+  CONS__LineRec *recs;
+  U64 key_count;
+} CONS__UnitLinesGathered;
+
+static CONS__UnitLinesGathered* cons__unit_gather_lines(Arena *arena, CONS__BakeCtx *bctx,
+                                                        CONS_LineSequenceNode *first);
+static CONS__UnitLinesCombined* cons__unit_combine_lines(Arena *arena, CONS__UnitLinesGathered *gathered);
 
 //- cons serializer for source line info
 typedef struct CONS__SrcLinesCombined{
@@ -814,10 +881,11 @@ typedef struct CONS__VMapRangeTracker{
 } CONS__VMapRangeTracker;
 
 static CONS__VMap* cons__vmap_from_markers(Arena *arena, CONS__VMapMarker *markers, CONS__SortKey *keys,
-                                           U64 marker_count);
+                                           U64 marker_count, U64 thread_count);
 
 //- cons serializer for unit vmap
-static CONS__VMap* cons__vmap_from_unit_ranges(Arena *arena, CONS_UnitVMapRange *first, U64 count);
+static CONS__VMap* cons__vmap_from_unit_ranges(Arena *arena, CONS_UnitVMapRange *first, U64 count,
+                                               U64 thread_count);
 
 //- cons serializer for types
 typedef struct CONS__TypeData{
@@ -891,6 +959,103 @@ typedef struct CONS__NameMapBaked{
   U32 node_count;
 } CONS__NameMapBaked;
 
-static CONS__NameMapBaked* cons__name_map_bake(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx, CONS__NameMap *map);
+static CONS__NameMapSemiBucket* cons__name_map_semi_buckets(Arena *arena, CONS__NameMap *map);
+static CONS__NameMapBaked* cons__name_map_bake(Arena *arena, CONS_Root *root, CONS__BakeCtx *bctx, CONS__NameMap *map,
+                                               CONS__NameMapSemiBucket *sbuckets);
+
+//- cons serializer for trigram maps
+typedef struct CONS__TrigramMapBaked{
+  RADDBG_TrigramMapEntry *entries;
+  U32 *postings;
+  U32 entry_count;
+  U32 posting_count;
+} CONS__TrigramMapBaked;
+
+static CONS__TrigramMapBaked* cons__trigram_map_bake(Arena *arena, String8 *names, U32 name_count);
+
+//- cons parallel bake
+// NOTE: string, index run, and path interning decide the index layout
+// of the file, so all of it stays on one "spine" task that bakes types and
+// symbols in the serial order (name maps intern after the batch, still in
+// order). line info, vmaps, trigram maps, and name map bucketing don't
+// intern, so they run as independent tasks next to the spine. data sections
+// are emitted in the serial order after the batch, so the output does not
+// depend on the thread count.
+
+typedef void CONS__TaskFunction(Arena *arena, void *ptr, U64 task_idx);
+
+typedef struct CONS__TaskBatch{
+  CONS__TaskFunction *func;
+  void *ptr;
+  U64 task_count;
+  U64 next_task_idx;
+  
+  U64 worker_count;
+  Arena **worker_arenas;
+  OS_Handle *worker_threads;
+  struct CONS__TaskWorker *workers;
+  
+  // worker completion (guarded by mutex)
+  OS_Handle mutex;
+  OS_Handle cv;
+  U64 done_worker_count;
+} CONS__TaskBatch;
+
+typedef struct CONS__TaskWorker{
+  CONS__TaskBatch *batch;
+  U64 worker_idx;
+} CONS__TaskWorker;
+
+typedef enum CONS__BakeTask{
+  CONS__BakeTask_Spine,
+  CONS__BakeTask_UnitVMap,
+  CONS__BakeTask_TrigramMapFirst,
+  CONS__BakeTask_TrigramMapOpl = CONS__BakeTask_TrigramMapFirst + RADDBG_TrigramMapKind_COUNT,
+  CONS__BakeTask_NameMapFirst = CONS__BakeTask_TrigramMapOpl,
+  CONS__BakeTask_NameMapOpl = CONS__BakeTask_NameMapFirst + RADDBG_NameMapKind_COUNT,
+  // followed by one task per source file, then one per unit
+  CONS__BakeTask_FixedCount = CONS__BakeTask_NameMapOpl,
+} CONS__BakeTask;
+
+typedef struct CONS__BakeTasks{
+  // output arena & interning state (spine task only)
+  Arena *arena;
+  CONS__BakeCtx *bctx;
+  CONS_Root *root;
+  
+  // unit line info
+  CONS__UnitLinesGathered **unit_lines_gathered;
+  CONS__UnitLinesCombined **unit_lines;
+  U32 unit_count;
+  
+  // source line info
+  CONS__SrcNode **src_nodes;
+  CONS__SrcLinesCombined **src_lines;
+  U32 src_count;
+  
+  // unit vmap
+  CONS__VMap *unit_vmap;
+  
+  // trigram maps
+  String8 *trigram_names[RADDBG_TrigramMapKind_COUNT];
+  U32 trigram_name_counts[RADDBG_TrigramMapKind_COUNT];
+  CONS__TrigramMapBaked *trigram_maps[RADDBG_TrigramMapKind_COUNT];
+  
+  // name map buckets
+  CONS__NameMapSemiBucket *name_map_sbuckets[RADDBG_NameMapKind_COUNT];
+  
+  // spine
+  CONS__TypeData *types;
+  CONS__SymbolData *symbol_data;
+} CONS__BakeTasks;
+
+static CONS__TaskBatch* cons__task_batch_alloc(Arena *arena, U64 worker_count);
+static void             cons__task_batch_release(CONS__TaskBatch *batch);
+static void             cons__task_batch_run(CONS__TaskBatch *batch, CONS__TaskFunction *func, void *ptr,
+                                             U64 task_count);
+static void             cons__task_batch_do_tasks(CONS__TaskBatch *batch, U64 worker_idx);
+static void             cons__task_batch_worker_entry_point(void *ptr);
+
+static void  cons__bake_task(Arena *arena, void *ptr, U64 task_idx);
 
 #endif //RADDBG_CONS_H
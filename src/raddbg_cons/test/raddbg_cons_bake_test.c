@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Regression test for the parallel bake: a synthetic CONS_Root is baked with
+// bake_thread_count 0 (serial), 1, 2, 4 & 8, both through cons_bake_file and
+// cons_bake_file_stream, and every output must be byte-identical to the
+// serial bake of the same path. Exits non-zero on any mismatch.
+//
+// usage: raddbg_cons_bake_test [--symbols:<n>] [--seed:<n>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_cons/raddbg_cons.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_cons/raddbg_cons.c"
+#include "raddbg_cons/test/raddbg_cons_test_root.c"
+
+////////////////////////////////
+//~ Helpers
+
+typedef struct CBT_Buffer{
+  Arena *arena;
+  U8 *data;
+  U64 size;
+  U64 cap;
+} CBT_Buffer;
+
+static void
+cbt_write_baked_data(void *write_ptr, U64 off, void *data, U64 size){
+  CBT_Buffer *buffer = (CBT_Buffer*)write_ptr;
+  if (off + size > buffer->cap){
+    U64 new_cap = Max(buffer->cap*2, off + size);
+    U8 *new_data = push_array(buffer->arena, U8, new_cap);
+    MemoryCopy(new_data, buffer->data, buffer->size);
+    buffer->data = new_data;
+    buffer->cap = new_cap;
+  }
+  MemoryCopy(buffer->data + off, data, size);
+  buffer->size = Max(buffer->size, off + size);
+}
+
+static String8
+cbt_bake(Arena *arena, CONS_TestRootParams *params, B32 stream){
+  String8 result = {0};
+  Temp scratch = scratch_begin(&arena, 1);
+  CONS_Root *root = cons_test_root_build(scratch.arena, params);
+  if (stream){
+    CBT_Buffer buffer = {0};
+    buffer.arena = arena_alloc();
+    cons_bake_file_stream(scratch.arena, root, cbt_write_baked_data, &buffer);
+    result = push_str8_copy(arena, str8(buffer.data, buffer.size));
+    arena_release(buffer.arena);
+  }
+  else{
+    String8List out = {0};
+    cons_bake_file(scratch.arena, root, &out);
+    result = str8_list_join(arena, &out, 0);
+  }
+  cons_root_release(root);
+  scratch_end(scratch);
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 symbol_count = 20000;
+  U64 seed = 1;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 symbols_string = cmd_line_string(&cmd_line, str8_lit("symbols"));
+    String8 seed_string = cmd_line_string(&cmd_line, str8_lit("seed"));
+    if (symbols_string.size != 0){
+      try_u64_from_str8_c_rules(symbols_string, &symbol_count);
+    }
+    if (seed_string.size != 0){
+      try_u64_from_str8_c_rules(seed_string, &seed);
+    }
+  }
+  
+  CONS_TestRootParams params = {0};
+  params.seed = seed;
+  params.type_count = symbol_count/10;
+  params.unit_count = symbol_count/500 + 1;
+  params.lines_per_unit = 2000;
+  params.symbol_count = symbol_count;
+  params.bake_trigram_maps = 1;
+  
+  // serial reference, then each thread count, for both bake paths
+  U64 thread_counts[] = {1, 2, 4, 8};
+  char *path_names[] = {"cons_bake_file", "cons_bake_file_stream"};
+  U64 mismatch_count = 0;
+  for (U64 stream = 0; stream < 2; stream += 1){
+    Temp temp = temp_begin(scratch.arena);
+    params.bake_thread_count = 0;
+    U64 begin_us = os_now_microseconds();
+    String8 reference = cbt_bake(temp.arena, &params, (B32)stream);
+    printf("%s, serial:    %9llu bytes, %7.1fms\n", path_names[stream],
+           (unsigned long long)reference.size, (os_now_microseconds() - begin_us)/1000.0);
+    for (U64 i = 0; i < ArrayCount(thread_counts); i += 1){
+      params.bake_thread_count = thread_counts[i];
+      begin_us = os_now_microseconds();
+      String8 baked = cbt_bake(temp.arena, &params, (B32)stream);
+      U64 elapsed_us = os_now_microseconds() - begin_us;
+      B32 match = (baked.size == reference.size && MemoryMatch(baked.str, reference.str, baked.size));
+      printf("%s, %llu threads: %9llu bytes, %7.1fms, %s\n", path_names[stream],
+             (unsigned long long)thread_counts[i], (unsigned long long)baked.size,
+             elapsed_us/1000.0, match ? "identical" : "MISMATCH");
+      if (!match){
+        U64 first_diff = 0;
+        for (;first_diff < Min(baked.size, reference.size) && baked.str[first_diff] == reference.str[first_diff]; first_diff += 1);
+        printf("  first difference at byte %llu\n", (unsigned long long)first_diff);
+        mismatch_count += 1;
+      }
+    }
+    temp_end(temp);
+  }
+  
+  if (mismatch_count != 0){
+    printf("error: %llu bakes differ from the serial bake\n", (unsigned long long)mismatch_count);
+    return(1);
+  }
+  scratch_end(scratch);
+  return(0);
+}
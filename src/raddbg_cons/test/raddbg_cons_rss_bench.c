@@ -0,0 +1,135 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Peak resident memory of baking a synthetic CONS_Root to a file, either
+// with cons_bake_file (whole file built as a String8List, then written) or
+// with cons_bake_file_stream (sections written as they are finalized).
+// Peak RSS is a per-process high water mark, so each invocation measures
+// one mode; run it once per mode with the same arguments & compare. The
+// peak after building the root is printed too, so the bake's own share can
+// be told apart from the root's.
+//
+// usage: raddbg_cons_rss_bench --mode:<memory|stream> [--symbols:<n>]
+//                              [--out:<file>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_cons/raddbg_cons.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_cons/raddbg_cons.c"
+#include "raddbg_cons/test/raddbg_cons_test_root.c"
+
+#if OS_LINUX
+# include <sys/resource.h>
+#elif OS_WINDOWS
+# include <psapi.h>
+#endif
+
+////////////////////////////////
+//~ Helpers
+
+static U64
+crb_peak_rss(void){
+  U64 result = 0;
+#if OS_LINUX
+  struct rusage usage = {0};
+  if (getrusage(RUSAGE_SELF, &usage) == 0){
+    result = (U64)usage.ru_maxrss*1024;
+  }
+#elif OS_WINDOWS
+  PROCESS_MEMORY_COUNTERS counters = {0};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))){
+    result = counters.PeakWorkingSetSize;
+  }
+#endif
+  return(result);
+}
+
+static void
+crb_write_baked_data(void *write_ptr, U64 off, void *data, U64 size){
+  OS_Handle file = *(OS_Handle*)write_ptr;
+  os_file_write(file, r1u64(off, off + size), data);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 symbol_count = 400000;
+  String8 mode = {0};
+  String8 out_path = str8_lit("raddbg_cons_rss_bench.raddbg");
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 symbols_string = cmd_line_string(&cmd_line, str8_lit("symbols"));
+    String8 out_string = cmd_line_string(&cmd_line, str8_lit("out"));
+    mode = cmd_line_string(&cmd_line, str8_lit("mode"));
+    if (symbols_string.size != 0){
+      try_u64_from_str8_c_rules(symbols_string, &symbol_count);
+    }
+    if (out_string.size != 0){
+      out_path = out_string;
+    }
+  }
+  B32 stream = str8_match(mode, str8_lit("stream"), 0);
+  if (!stream && !str8_match(mode, str8_lit("memory"), 0)){
+    printf("error: --mode must be memory or stream\n");
+    return(1);
+  }
+  
+  // build the root
+  CONS_TestRootParams params = {0};
+  params.seed = 1;
+  params.type_count = symbol_count/10;
+  params.unit_count = symbol_count/500 + 1;
+  params.lines_per_unit = 2000;
+  params.symbol_count = symbol_count;
+  params.bake_trigram_maps = 1;
+  U64 begin_us = os_now_microseconds();
+  CONS_Root *root = cons_test_root_build(scratch.arena, &params);
+  U64 root_peak_rss = crb_peak_rss();
+  printf("root: %llu symbols, %llu units, built in %.2fs, peak RSS %.1f MB\n",
+         (unsigned long long)symbol_count, (unsigned long long)params.unit_count,
+         (os_now_microseconds() - begin_us)/1000000.0, root_peak_rss/(1024.0*1024.0));
+  
+  // bake & write
+  begin_us = os_now_microseconds();
+  OS_Handle out_file = os_file_open(OS_AccessFlag_Write, out_path);
+  if (stream){
+    cons_bake_file_stream(scratch.arena, root, crb_write_baked_data, &out_file);
+  }
+  else{
+    String8List out = {0};
+    cons_bake_file(scratch.arena, root, &out);
+    U64 off = 0;
+    for (String8Node *node = out.first; node != 0; node = node->next){
+      os_file_write(out_file, r1u64(off, off + node->string.size), node->string.str);
+      off += node->string.size;
+    }
+  }
+  os_file_close(out_file);
+  U64 bake_us = os_now_microseconds() - begin_us;
+  U64 peak_rss = crb_peak_rss();
+  
+  OS_Handle file = os_file_open(OS_AccessFlag_Read|OS_AccessFlag_ShareRead, out_path);
+  FileProperties props = os_properties_from_file(file);
+  os_file_close(file);
+  printf("%s bake: %.1f MB file in %.2fs, peak RSS %.1f MB (%.1f MB over the root)\n",
+         stream ? "stream" : "memory", props.size/(1024.0*1024.0), bake_us/1000000.0,
+         peak_rss/(1024.0*1024.0), (peak_rss - root_peak_rss)/(1024.0*1024.0));
+  
+  cons_root_release(root);
+  scratch_end(scratch);
+  return(0);
+}
@@ -0,0 +1,275 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Sort throughput of cons__sort_key_array's two paths - run merging &
+// LSD radix (1, 2, 4, 8 threads) - and of the heuristic that picks between
+// them, over key distributions shaped like the bake's:
+// * line table:   one unit's line voffs, already sorted
+// * vmap:         64 sorted runs of ranges, overlapping in voff
+// * ltcg lines:   many sequences interleaved a few lines at a time, as in
+//                 line info from link-time code generation
+// * name hashes:  random 32-bit name hashes
+// --input takes raw little-endian U64 keys (e.g. dumped from a conversion
+// at the cons__sort_key_array call) instead. Every path's output, values
+// included, must match the merge sort's, so stability is checked too.
+//
+// usage: raddbg_cons_sort_bench [--count:<n>] [--runs:<n>] [--input:<file>]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "raddbg_format/raddbg_format.h"
+#include "raddbg_cons/raddbg_cons.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "raddbg_format/raddbg_format.c"
+#include "raddbg_cons/raddbg_cons.c"
+
+////////////////////////////////
+//~ Types
+
+typedef enum CSB_Method{
+  CSB_Method_Merge,
+  CSB_Method_Radix,
+  CSB_Method_Picked,
+} CSB_Method;
+
+typedef struct CSB_Distribution{
+  char *name;
+  U64 *keys;
+  U64 count;
+} CSB_Distribution;
+
+////////////////////////////////
+//~ Key Distributions
+
+static U64
+csb_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+static U64*
+csb_line_table_keys(Arena *arena, U64 count){
+  U64 *keys = push_array_no_zero(arena, U64, count);
+  U64 rng = 1;
+  U64 voff = 0x1000;
+  for (U64 i = 0; i < count; i += 1){
+    voff += 1 + csb_rand(&rng)%12;
+    keys[i] = voff;
+  }
+  return(keys);
+}
+
+static U64*
+csb_vmap_keys(Arena *arena, U64 count){
+  U64 *keys = push_array_no_zero(arena, U64, count);
+  U64 rng = 2;
+  U64 run_count = 64;
+  U64 run_size = (count + run_count - 1)/run_count;
+  for (U64 i = 0; i < count;){
+    U64 voff = 0x1000 + csb_rand(&rng)%0x1000000;
+    for (U64 j = 0; j < run_size && i < count; j += 1, i += 1){
+      voff += 16 + csb_rand(&rng)%256;
+      keys[i] = voff;
+    }
+  }
+  return(keys);
+}
+
+static U64*
+csb_ltcg_line_keys(Arena *arena, U64 count){
+  U64 *keys = push_array_no_zero(arena, U64, count);
+  U64 rng = 3;
+  U64 sequence_count = 4096;
+  U64 *sequence_voffs = push_array_no_zero(arena, U64, sequence_count);
+  for (U64 i = 0; i < sequence_count; i += 1){
+    sequence_voffs[i] = 0x1000 + csb_rand(&rng)%0x4000000;
+  }
+  for (U64 i = 0; i < count;){
+    U64 sequence_idx = csb_rand(&rng)%sequence_count;
+    U64 take = 1 + csb_rand(&rng)%4;
+    for (U64 j = 0; j < take && i < count; j += 1, i += 1){
+      sequence_voffs[sequence_idx] += 1 + csb_rand(&rng)%8;
+      keys[i] = sequence_voffs[sequence_idx];
+    }
+  }
+  return(keys);
+}
+
+static U64*
+csb_name_hash_keys(Arena *arena, U64 count){
+  U64 *keys = push_array_no_zero(arena, U64, count);
+  U64 rng = 4;
+  for (U64 i = 0; i < count; i += 1){
+    keys[i] = csb_rand(&rng) & 0xFFFFFFFF;
+  }
+  return(keys);
+}
+
+////////////////////////////////
+//~ Helpers
+
+static U32
+csb_digit_mask_from_keys(U64 *keys, U64 count){
+  U64 diff_bits = 0;
+  for (U64 i = 1; i < count; i += 1){
+    diff_bits |= keys[i] ^ keys[0];
+  }
+  U32 result = 0;
+  for (U32 byte_idx = 0; byte_idx < 8; byte_idx += 1){
+    if (((diff_bits >> (byte_idx*8)) & 0xFF) != 0){
+      result |= (1 << byte_idx);
+    }
+  }
+  return(result);
+}
+
+// values carry the input position, so equal keys expose any reordering
+static CONS__SortKey*
+csb_sort(Arena *arena, CSB_Distribution *dist, CSB_Method method, U64 thread_count, U64 *us_out){
+  CONS__SortKey *keys = push_array_no_zero(arena, CONS__SortKey, dist->count);
+  for (U64 i = 0; i < dist->count; i += 1){
+    keys[i].key = dist->keys[i];
+    keys[i].val = (void*)i;
+  }
+  U64 begin_us = os_now_microseconds();
+  CONS__SortKey *result = 0;
+  switch (method){
+    case CSB_Method_Merge:{
+      result = cons__sort_key_array_merge(arena, keys, dist->count);
+    }break;
+    case CSB_Method_Radix:{
+      U32 digit_mask = csb_digit_mask_from_keys(dist->keys, dist->count);
+      result = cons__sort_key_array_radix(arena, keys, dist->count, digit_mask, thread_count);
+    }break;
+    case CSB_Method_Picked:{
+      result = cons__sort_key_array(arena, keys, dist->count, thread_count);
+    }break;
+  }
+  *us_out = os_now_microseconds() - begin_us;
+  return(result);
+}
+
+static U64
+csb_run_count(U64 *keys, U64 count){
+  U64 result = (count != 0);
+  for (U64 i = 1; i < count; i += 1){
+    result += (keys[i - 1] > keys[i]);
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 count = 4000000;
+  U64 runs = 3;
+  String8 input_path = {0};
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 count_string = cmd_line_string(&cmd_line, str8_lit("count"));
+    String8 runs_string = cmd_line_string(&cmd_line, str8_lit("runs"));
+    input_path = cmd_line_string(&cmd_line, str8_lit("input"));
+    if (count_string.size != 0){
+      try_u64_from_str8_c_rules(count_string, &count);
+    }
+    if (runs_string.size != 0){
+      try_u64_from_str8_c_rules(runs_string, &runs);
+    }
+    count = Max(count, 2);
+    runs = Max(runs, 1);
+  }
+  
+  // distributions
+  CSB_Distribution dists[4] = {0};
+  U64 dist_count = 0;
+  if (input_path.size != 0){
+    OS_Handle file = os_file_open(OS_AccessFlag_Read|OS_AccessFlag_ShareRead, input_path);
+    FileProperties props = os_properties_from_file(file);
+    dists[0].name = "input";
+    dists[0].count = props.size/sizeof(U64);
+    dists[0].keys = push_array_no_zero(scratch.arena, U64, dists[0].count);
+    os_file_read(file, r1u64(0, dists[0].count*sizeof(U64)), dists[0].keys);
+    os_file_close(file);
+    dist_count = 1;
+  }
+  else{
+    dists[0].name = "line table";
+    dists[0].keys = csb_line_table_keys(scratch.arena, count);
+    dists[1].name = "vmap";
+    dists[1].keys = csb_vmap_keys(scratch.arena, count);
+    dists[2].name = "ltcg lines";
+    dists[2].keys = csb_ltcg_line_keys(scratch.arena, count);
+    dists[3].name = "name hashes";
+    dists[3].keys = csb_name_hash_keys(scratch.arena, count);
+    for (U64 i = 0; i < 4; i += 1){
+      dists[i].count = count;
+    }
+    dist_count = 4;
+  }
+  printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+  
+  Arena *reference_arena = arena_alloc();
+  for (U64 dist_idx = 0; dist_idx < dist_count; dist_idx += 1){
+    CSB_Distribution *dist = &dists[dist_idx];
+    U32 digit_mask = csb_digit_mask_from_keys(dist->keys, dist->count);
+    printf("%s: %llu keys, %llu sorted runs, %u varying key bytes\n", dist->name,
+           (unsigned long long)dist->count, (unsigned long long)csb_run_count(dist->keys, dist->count),
+           count_bits_set32(digit_mask));
+    
+    // merge sort is the reference; only its last run is kept
+    CONS__SortKey *reference = 0;
+    struct {CSB_Method method; U64 thread_count; char *name;} cases[] = {
+      {CSB_Method_Merge,  1, "merge"},
+      {CSB_Method_Radix,  1, "radix, 1 thread"},
+      {CSB_Method_Radix,  2, "radix, 2 threads"},
+      {CSB_Method_Radix,  4, "radix, 4 threads"},
+      {CSB_Method_Radix,  8, "radix, 8 threads"},
+      {CSB_Method_Picked, 1, "picked, 1 thread"},
+      {CSB_Method_Picked, 8, "picked, 8 threads"},
+    };
+    for (U64 case_idx = 0; case_idx < ArrayCount(cases); case_idx += 1){
+      U64 us_total = 0;
+      U64 us_min = max_U64;
+      for (U64 run_idx = 0; run_idx < runs; run_idx += 1){
+        Temp temp = temp_begin(scratch.arena);
+        Arena *arena = temp.arena;
+        if (case_idx == 0){
+          arena_clear(reference_arena);
+          arena = reference_arena;
+        }
+        U64 us = 0;
+        CONS__SortKey *sorted = csb_sort(arena, dist, cases[case_idx].method, cases[case_idx].thread_count, &us);
+        us_total += us;
+        us_min = Min(us_min, us);
+        if (case_idx == 0){
+          reference = sorted;
+        }
+        else if (!MemoryMatch(sorted, reference, sizeof(*sorted)*dist->count)){
+          printf("error: %s differs from the merge sort\n", cases[case_idx].name);
+          return(1);
+        }
+        temp_end(temp);
+      }
+      printf("  %-18s %8.1fM keys/s (best %.1fms)\n", cases[case_idx].name,
+             dist->count*runs/(F64)us_total, us_min/1000.0);
+    }
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
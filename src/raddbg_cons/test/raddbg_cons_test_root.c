@@ -0,0 +1,187 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Deterministic synthetic CONS_Root for the raddbg_cons tests & benchmarks.
+// Include after raddbg_cons.c. Sizes scale with the params; the same params
+// (including seed) always produce the same root.
+
+////////////////////////////////
+//~ Synthetic Root Params
+
+typedef struct CONS_TestRootParams{
+  U64 seed;
+  U64 type_count;
+  U64 unit_count;
+  U64 lines_per_unit;
+  U64 symbol_count;
+  U64 bake_thread_count;
+  B8 bake_trigram_maps;
+} CONS_TestRootParams;
+
+////////////////////////////////
+//~ Synthetic Root Helpers
+
+static U64
+cons_test_rand(U64 *state){
+  U64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// symbol i is a procedure when i%3 == 2, so lookups can name one directly
+static String8
+cons_test_symbol_name(Arena *arena, U64 symbol_idx){
+  String8 result = {0};
+  if (symbol_idx%3 == 2){
+    result = push_str8f(arena, "ns%llu::Class%llu::proc_%llu",
+                        symbol_idx%37, symbol_idx%1013, symbol_idx);
+  }
+  else{
+    result = push_str8f(arena, "ns%llu::g_var_%llu", symbol_idx%37, symbol_idx);
+  }
+  return(result);
+}
+
+static CONS_Root*
+cons_test_root_build(Arena *arena, CONS_TestRootParams *params){
+  U64 rng = params->seed*0x9E3779B97F4A7C15ull + 1;
+  
+  CONS_RootParams root_params = {0};
+  root_params.addr_size = 8;
+  root_params.bucket_count_units = params->unit_count;
+  root_params.bucket_count_symbols = params->symbol_count;
+  root_params.bucket_count_scopes = params->symbol_count;
+  root_params.bucket_count_locals = params->symbol_count;
+  root_params.bucket_count_types = params->type_count;
+  root_params.bake_thread_count = params->bake_thread_count;
+  root_params.bake_trigram_maps = params->bake_trigram_maps;
+  CONS_Root *root = cons_root_new(&root_params);
+  
+  // top level info
+  U64 voff_max = 0x1000 + params->unit_count*(params->lines_per_unit*8 + 64);
+  CONS_TopLevelInfo tli = {0};
+  tli.architecture = RADDBG_Arch_X64;
+  tli.exe_name = str8_lit("synthetic.exe");
+  tli.exe_hash = params->seed;
+  tli.voff_max = voff_max;
+  cons_set_top_level_info(root, &tli);
+  
+  // types: basics, then a random mix of constructed & user defined types
+  U64 type_count = Max(params->type_count, 8);
+  CONS_Type **types = push_array(arena, CONS_Type*, type_count);
+  U64 type_fill = 0;
+  types[type_fill++] = cons_type_basic(root, RADDBG_TypeKind_S32, str8_lit("int"));
+  types[type_fill++] = cons_type_basic(root, RADDBG_TypeKind_U8, str8_lit("char"));
+  types[type_fill++] = cons_type_basic(root, RADDBG_TypeKind_F64, str8_lit("double"));
+  types[type_fill++] = cons_type_basic(root, RADDBG_TypeKind_U64, str8_lit("u64"));
+  for (;type_fill < type_count; type_fill += 1){
+    U64 i = type_fill;
+    CONS_Type *type = 0;
+    switch (cons_test_rand(&rng)%5){
+      case 0:{
+        type = cons_type_pointer(root, types[cons_test_rand(&rng)%type_fill], RADDBG_TypeKind_Ptr);
+      }break;
+      case 1:{
+        type = cons_type_array(root, types[cons_test_rand(&rng)%type_fill], 1 + cons_test_rand(&rng)%16);
+      }break;
+      case 2:{
+        CONS_TypeList list = {0};
+        U64 param_count = cons_test_rand(&rng)%4;
+        for (U64 j = 0; j < param_count; j += 1){
+          cons_type_list_push(arena, &list, types[cons_test_rand(&rng)%type_fill]);
+        }
+        type = cons_type_proc(root, types[cons_test_rand(&rng)%type_fill], &list);
+      }break;
+      case 3:{
+        type = cons_type_udt(root, RADDBG_TypeKind_Struct, push_str8f(arena, "Struct%llu", i), 64);
+        U64 member_count = 1 + cons_test_rand(&rng)%6;
+        for (U64 j = 0; j < member_count; j += 1){
+          cons_type_add_member_data_field(root, type, push_str8f(arena, "mem%llu", cons_test_rand(&rng)%40),
+                                          types[cons_test_rand(&rng)%type_fill], j*8);
+        }
+        cons_type_set_source_coordinates(root, type, push_str8f(arena, "c:/src/hdr/file%llu.h", i%70), 10 + i, 1);
+      }break;
+      default:{
+        type = cons_type_enum(root, types[0], push_str8f(arena, "Enum%llu", i));
+        U64 val_count = 1 + cons_test_rand(&rng)%5;
+        for (U64 j = 0; j < val_count; j += 1){
+          cons_type_add_enum_val(root, type, push_str8f(arena, "EV%llu", cons_test_rand(&rng)%100), j);
+        }
+      }break;
+    }
+    types[type_fill] = type;
+  }
+  
+  // units & line info
+  U64 voff = 0x1000;
+  for (U64 unit_idx = 0; unit_idx < params->unit_count; unit_idx += 1){
+    CONS_Unit *unit = cons_unit_handle_from_user_id(root, unit_idx);
+    CONS_UnitInfo info = {0};
+    info.unit_name = push_str8f(arena, "unit%llu", unit_idx);
+    info.compiler_name = str8_lit("cc");
+    info.source_file = push_str8f(arena, "c:/src/file%llu.c", unit_idx);
+    info.object_file = push_str8f(arena, "c:/obj/file%llu.obj", unit_idx);
+    info.build_path = str8_lit("c:/build");
+    info.language = RADDBG_Language_C;
+    cons_unit_set_info(root, unit, &info);
+    
+    U64 unit_first = voff;
+    U64 lines_left = Max(params->lines_per_unit, 1);
+    for (;lines_left > 0;){
+      U64 line_count = 1 + cons_test_rand(&rng)%256;
+      line_count = Min(line_count, lines_left);
+      lines_left -= line_count;
+      CONS_LineSequence seq = {0};
+      seq.file_name = push_str8f(arena, "c:/src/file%llu.c", cons_test_rand(&rng)%(params->unit_count + 60));
+      seq.voffs = push_array(arena, U64, line_count + 1);
+      seq.line_nums = push_array(arena, U32, line_count);
+      seq.line_count = line_count;
+      for (U64 j = 0; j < line_count; j += 1){
+        seq.voffs[j] = voff;
+        seq.line_nums[j] = 1 + cons_test_rand(&rng)%2000;
+        voff += 1 + cons_test_rand(&rng)%12;
+      }
+      seq.voffs[line_count] = voff;
+      cons_unit_add_line_sequence(root, unit, &seq);
+    }
+    cons_unit_vmap_add_range(root, unit, unit_first, voff);
+    voff += 16;
+  }
+  
+  // symbols; procedures get a scope & a few locals
+  for (U64 symbol_idx = 0; symbol_idx < params->symbol_count; symbol_idx += 1){
+    CONS_Symbol *symbol = cons_symbol_handle_from_user_id(root, symbol_idx);
+    B32 is_proc = (symbol_idx%3 == 2);
+    CONS_SymbolInfo info = {0};
+    info.kind = is_proc ? CONS_SymbolKind_Procedure : CONS_SymbolKind_GlobalVariable;
+    info.name = cons_test_symbol_name(arena, symbol_idx);
+    info.link_name = push_str8f(arena, "?link%llu@@", symbol_idx);
+    info.type = types[cons_test_rand(&rng)%type_count];
+    info.offset = cons_test_rand(&rng)%voff;
+    if (is_proc){
+      CONS_Scope *scope = cons_scope_handle_from_user_id(root, symbol_idx);
+      U64 first = cons_test_rand(&rng)%voff;
+      cons_scope_add_voff_range(root, scope, first, first + 1 + cons_test_rand(&rng)%200);
+      info.root_scope = scope;
+      U64 local_count = cons_test_rand(&rng)%4;
+      for (U64 j = 0; j < local_count; j += 1){
+        CONS_Local *local = cons_local_handle_from_user_id(root, symbol_idx*4 + j);
+        CONS_LocalInfo local_info = {0};
+        local_info.kind = RADDBG_LocalKind_Variable;
+        local_info.scope = scope;
+        local_info.name = push_str8f(arena, "local%llu", cons_test_rand(&rng)%30);
+        local_info.type = types[cons_test_rand(&rng)%type_count];
+        cons_local_set_basic_info(root, local, &local_info);
+        CONS_LocationSet *locset = cons_location_set_from_local(root, local);
+        cons_location_set_add_case(root, locset, first, first + 10,
+                                   cons_location_addr_reg_plus_u16(root, 1, j*8));
+      }
+    }
+    cons_symbol_set_info(root, symbol, &info);
+  }
+  
+  return(root);
+}
@@ -54,6 +54,32 @@ pdb_convert_params_from_cmd_line(Arena *arena, CmdLine *cmdline){
     result->output_name = cmd_line_string(cmdline, str8_lit("out"));
   }
   
+  // memory options
+  if (cmd_line_has_flag(cmdline, str8_lit("large_pages"))){
+    result->large_pages = 1;
+  }
+  
+  // threading options
+  {
+    result->thread_count = os_logical_core_count();
+    String8 threads_string = cmd_line_string(cmdline, str8_lit("threads"));
+    if (threads_string.size > 0){
+      U64 thread_count = 0;
+      if (try_u64_from_str8_c_rules(threads_string, &thread_count) && thread_count > 0){
+        result->thread_count = thread_count;
+      }
+      else{
+        str8_list_pushf(arena, &result->errors,
+                        "invalid thread count '%.*s'", str8_varg(threads_string));
+      }
+    }
+  }
+  
+  // optional output sections
+  if (cmd_line_has_flag(cmdline, str8_lit("trigram_maps"))){
+    result->trigram_maps = 1;
+  }
+  
   // error options
   if (cmd_line_has_flag(cmdline, str8_lit("hide_errors"))){
     String8List vals = cmd_line_strings(cmdline, str8_lit("hide_errors"));
@@ -2869,6 +2895,325 @@ pdbconv_link_name_find(PDBCONV_LinkNameMap *map, U64 voff){
   return(result);
 }
 
+////////////////////////////////
+//~ Parallel Parse Functions
+
+static PDBCONV_TaskPool*
+pdbconv_task_pool_alloc(Arena *arena, U64 worker_count){
+  PDBCONV_TaskPool *pool = push_array(arena, PDBCONV_TaskPool, 1);
+  pool->worker_count = ClampBot(worker_count, 1);
+  pool->worker_arenas = push_array(arena, Arena*, pool->worker_count);
+  pool->worker_threads = push_array(arena, OS_Handle, pool->worker_count);
+  pool->mutex = os_mutex_alloc();
+  pool->cv = os_condition_variable_alloc();
+  pool->worker_arenas[0] = arena;
+  pool->live_worker_count = pool->worker_count - 1;
+  for (U64 i = 1; i < pool->worker_count; i += 1){
+    PDBCONV_TaskWorker *worker = push_array(arena, PDBCONV_TaskWorker, 1);
+    worker->pool = pool;
+    worker->worker_idx = i;
+    pool->worker_arenas[i] = arena_alloc();
+    pool->worker_threads[i] = os_launch_thread(pdbconv_task_pool_worker_entry_point, worker, 0);
+  }
+  return(pool);
+}
+
+static void
+pdbconv_task_pool_release(PDBCONV_TaskPool *pool){
+  // wait for all workers to leave, so the pool can be torn down
+  OS_MutexScope(pool->mutex){
+    pool->exit = 1;
+    os_condition_variable_broadcast(pool->cv);
+    for (;pool->live_worker_count > 0;){
+      os_condition_variable_wait(pool->cv, pool->mutex, max_U64);
+    }
+  }
+  for (U64 i = 1; i < pool->worker_count; i += 1){
+    os_release_thread_handle(pool->worker_threads[i]);
+  }
+  os_condition_variable_release(pool->cv);
+  os_mutex_release(pool->mutex);
+}
+
+static void
+pdbconv_task_pool_run(PDBCONV_TaskPool *pool, PDBCONV_TaskFunction *func, void *ptr, U64 task_count){
+  if (pool->worker_count == 1 || task_count <= 1){
+    for (U64 i = 0; i < task_count; i += 1){
+      func(pool->worker_arenas[0], ptr, i);
+    }
+  }
+  else{
+    // post batch
+    OS_MutexScope(pool->mutex){
+      pool->batch_func = func;
+      pool->batch_ptr = ptr;
+      pool->batch_task_count = task_count;
+      pool->batch_next_task_idx = 0;
+      pool->batch_done_worker_count = 0;
+      pool->batch_gen += 1;
+    }
+    os_condition_variable_broadcast(pool->cv);
+    
+    // help out
+    pdbconv_task_pool_do_tasks(pool, 0);
+    
+    // wait for the other workers to finish their last tasks
+    OS_MutexScope(pool->mutex){
+      for (;pool->batch_done_worker_count < pool->worker_count - 1;){
+        os_condition_variable_wait(pool->cv, pool->mutex, max_U64);
+      }
+    }
+  }
+}
+
+static void
+pdbconv_task_pool_do_tasks(PDBCONV_TaskPool *pool, U64 worker_idx){
+  Arena *arena = pool->worker_arenas[worker_idx];
+  for (;;){
+    U64 task_idx = ins_atomic_u64_inc_eval(&pool->batch_next_task_idx) - 1;
+    if (task_idx >= pool->batch_task_count){
+      break;
+    }
+    pool->batch_func(arena, pool->batch_ptr, task_idx);
+  }
+}
+
+static void
+pdbconv_task_pool_worker_entry_point(void *ptr){
+  TCTX tctx_ = {0};
+  tctx_init_and_equip(&tctx_);
+  PDBCONV_TaskWorker *worker = (PDBCONV_TaskWorker*)ptr;
+  PDBCONV_TaskPool *pool = worker->pool;
+  ThreadName("[pdbconv] worker #%I64u", worker->worker_idx);
+  
+  U64 seen_gen = 0;
+  for (B32 done = 0; !done;){
+    // wait for a new batch, or exit
+    B32 has_batch = 0;
+    OS_MutexScope(pool->mutex){
+      for (;pool->batch_gen == seen_gen && !pool->exit;){
+        os_condition_variable_wait(pool->cv, pool->mutex, max_U64);
+      }
+      if (pool->batch_gen != seen_gen){
+        seen_gen = pool->batch_gen;
+        has_batch = 1;
+      }
+      else{
+        pool->live_worker_count -= 1;
+        done = 1;
+      }
+    }
+    
+    // do tasks until none are left, then report
+    if (has_batch){
+      pdbconv_task_pool_do_tasks(pool, worker->worker_idx);
+      OS_MutexScope(pool->mutex){
+        pool->batch_done_worker_count += 1;
+      }
+    }
+    os_condition_variable_broadcast(pool->cv);
+  }
+}
+
+static PDBCONV_LeafPieces
+pdbconv_leaf_pieces_from_tpi(Arena *arena, PDB_TpiParsed *tpi, String8 hash_data, U64 piece_count_target){
+  PDBCONV_LeafPieces result = {0};
+  result.data = pdb_leaf_data_from_tpi(tpi);
+  
+  // offset hints: (itype, leaf offset) pairs in ascending order
+  U64 hints_first = ClampTop(tpi->itype_off, hash_data.size);
+  U64 hints_opl = ClampTop((U64)tpi->itype_off + tpi->itype_size, hash_data.size);
+  U64 hint_count = (hints_opl - hints_first)/sizeof(PDB_TpiOffHint);
+  PDB_TpiOffHint *hints = (PDB_TpiOffHint*)(hash_data.str + hints_first);
+  
+  // cut at the first hint past each minimum piece size
+  U64 piece_size_min = result.data.size/ClampBot(piece_count_target, 1);
+  piece_size_min = ClampBot(piece_size_min, PDBCONV_LEAF_PIECE_MIN_SIZE);
+  result.ranges = push_array_no_zero(arena, Rng1U64, hint_count + 1);
+  U64 piece_first = 0;
+  for (U64 i = 0; i < hint_count; i += 1){
+    U64 off = hints[i].off;
+    if (piece_first < off && off < result.data.size && off - piece_first >= piece_size_min){
+      result.ranges[result.count] = r1u64(piece_first, off);
+      result.count += 1;
+      piece_first = off;
+    }
+  }
+  result.ranges[result.count] = r1u64(piece_first, result.data.size);
+  result.count += 1;
+  result.recs = push_array(arena, CV_RecRangeArray, result.count);
+  return(result);
+}
+
+static CV_LeafParsed*
+pdbconv_leaf_from_pieces(Arena *arena, PDBCONV_LeafPieces *pieces, CV_TypeId itype_first){
+  // every piece but the last must end exactly on its last record - otherwise
+  // a hint was not on a record boundary, and the pieces can't be trusted
+  B32 pieces_are_good = 1;
+  U64 total_count = 0;
+  for (U64 i = 0; i < pieces->count; i += 1){
+    CV_RecRangeArray *recs = &pieces->recs[i];
+    if (i + 1 < pieces->count){
+      U64 piece_size = dim_1u64(pieces->ranges[i]);
+      CV_RecRange *last = recs->ranges + recs->count - 1;
+      if (recs->count == 0 || last->off + last->hdr.size != piece_size){
+        pieces_are_good = 0;
+        break;
+      }
+    }
+    total_count += recs->count;
+  }
+  
+  // stitch, rebasing each piece's offsets onto the whole leaf data
+  CV_LeafParsed *result = 0;
+  if (pieces_are_good){
+    result = push_array(arena, CV_LeafParsed, 1);
+    result->data = pieces->data;
+    result->itype_first = itype_first;
+    result->itype_opl = itype_first + total_count;
+    result->leaf_ranges.ranges = push_array_no_zero(arena, CV_RecRange, total_count);
+    result->leaf_ranges.count = total_count;
+    CV_RecRange *out = result->leaf_ranges.ranges;
+    for (U64 i = 0; i < pieces->count; i += 1){
+      CV_RecRangeArray *recs = &pieces->recs[i];
+      U64 base_off = pieces->ranges[i].min;
+      for (U64 j = 0; j < recs->count; j += 1, out += 1){
+        *out = recs->ranges[j];
+        out->off += base_off;
+      }
+    }
+  }
+  return(result);
+}
+
+static void
+pdbconv_stream_task(Arena *arena, void *ptr, U64 task_idx){
+  PDBCONV_ParseTasks *tasks = (PDBCONV_ParseTasks*)ptr;
+  MSF_Parsed *msf = tasks->msf;
+  PDB_DbiParsed *dbi = tasks->dbi;
+  switch (task_idx){
+    // parse tpi/ipi & their hashes
+    case PDBCONV_StreamTask_Tpi:
+    case PDBCONV_StreamTask_Ipi:
+    {
+      B32 is_ipi = (task_idx == PDBCONV_StreamTask_Ipi);
+      PDB_TpiParsed *tpi = 0;
+      PDB_TpiHashParsed *tpi_hash = 0;
+      ProfScope(is_ipi ? "parse ipi" : "parse tpi"){
+        String8 tpi_data = msf_data_from_stream(msf, is_ipi ? PDB_FixedStream_Ipi : PDB_FixedStream_Tpi);
+        tpi = pdb_tpi_from_data(arena, tpi_data);
+      }
+      if (tpi != 0) ProfScope(is_ipi ? "parse ipi hash" : "parse tpi hash"){
+        String8 hash_data = msf_data_from_stream(msf, tpi->hash_sn);
+        String8 aux_data = msf_data_from_stream(msf, tpi->hash_sn_aux);
+        tpi_hash = pdb_tpi_hash_from_data(arena, tasks->strtbl, tpi, hash_data, aux_data);
+      }
+      if (is_ipi){
+        tasks->ipi = tpi;
+        tasks->ipi_hash = tpi_hash;
+      }
+      else{
+        tasks->tpi = tpi;
+        tasks->tpi_hash = tpi_hash;
+      }
+    }break;
+    
+    // parse coff sections & dbi's section contributions
+    case PDBCONV_StreamTask_CoffSections:
+    if (dbi != 0){
+      ProfScope("parse coff sections"){
+        MSF_StreamNumber section_stream = dbi->dbg_streams[PDB_DbiStream_SECTION_HEADER];
+        String8 section_data = msf_data_from_stream(msf, section_stream);
+        tasks->coff_sections = pdb_coff_section_array_from_data(arena, section_data);
+      }
+      if (tasks->coff_sections != 0) ProfScope("parse dbi section contributions"){
+        String8 section_contribution_data = pdb_data_from_dbi_range(dbi, PDB_DbiRange_SecCon);
+        tasks->comp_unit_contributions =
+          pdb_comp_unit_contribution_array_from_data(arena, section_contribution_data, tasks->coff_sections);
+      }
+    }break;
+    
+    // parse gsi
+    case PDBCONV_StreamTask_Gsi:
+    if (dbi != 0) ProfScope("parse gsi"){
+      String8 gsi_data = msf_data_from_stream(msf, dbi->gsi_sn);
+      tasks->gsi = pdb_gsi_from_data(arena, gsi_data);
+    }break;
+    
+    // parse psi
+    case PDBCONV_StreamTask_Psi:
+    if (dbi != 0) ProfScope("parse psi"){
+      String8 psi_data = msf_data_from_stream(msf, dbi->psi_sn);
+      String8 psi_data_gsi_part = str8_range(psi_data.str + sizeof(PDB_PsiHeader),
+                                             psi_data.str + psi_data.size);
+      tasks->psi_gsi_part = pdb_gsi_from_data(arena, psi_data_gsi_part);
+    }break;
+    
+    // parse sym
+    case PDBCONV_StreamTask_Sym:
+    if (dbi != 0) ProfScope("parse sym"){
+      String8 sym_data = msf_data_from_stream(msf, dbi->sym_sn);
+      tasks->sym = cv_sym_from_data(arena, sym_data, 4);
+    }break;
+    
+    // parse compilation units
+    case PDBCONV_StreamTask_CompUnits:
+    if (dbi != 0) ProfScope("parse compilation units"){
+      String8 mod_info_data = pdb_data_from_dbi_range(dbi, PDB_DbiRange_ModuleInfo);
+      tasks->comp_units = pdb_comp_unit_array_from_data(arena, mod_info_data);
+    }break;
+  }
+}
+
+static void
+pdbconv_unit_task(Arena *arena, void *ptr, U64 task_idx){
+  PDBCONV_ParseTasks *tasks = (PDBCONV_ParseTasks*)ptr;
+  U64 idx = task_idx;
+  
+  // parse a piece of tpi leaves
+  if (idx < tasks->tpi_pieces.count){
+    ProfScope("parse tpi leaves piece"){
+      Temp scratch = scratch_begin(&arena, 1);
+      String8 piece_data = str8_substr(tasks->tpi_pieces.data, tasks->tpi_pieces.ranges[idx]);
+      CV_RecRangeStream *stream = cv_rec_range_stream_from_data(scratch.arena, piece_data, 1);
+      tasks->tpi_pieces.recs[idx] = cv_rec_range_array_from_stream(arena, stream);
+      scratch_end(scratch);
+    }
+    return;
+  }
+  idx -= tasks->tpi_pieces.count;
+  
+  // parse a piece of ipi leaves
+  if (idx < tasks->ipi_pieces.count){
+    ProfScope("parse ipi leaves piece"){
+      Temp scratch = scratch_begin(&arena, 1);
+      String8 piece_data = str8_substr(tasks->ipi_pieces.data, tasks->ipi_pieces.ranges[idx]);
+      CV_RecRangeStream *stream = cv_rec_range_stream_from_data(scratch.arena, piece_data, 1);
+      tasks->ipi_pieces.recs[idx] = cv_rec_range_array_from_stream(arena, stream);
+      scratch_end(scratch);
+    }
+    return;
+  }
+  idx -= tasks->ipi_pieces.count;
+  
+  // parse syms for a compilation unit
+  if (idx < tasks->comp_unit_count){
+    PDB_CompUnit *unit = tasks->comp_units->units[idx];
+    String8 sym_data = pdb_data_from_unit_range(tasks->msf, unit, PDB_DbiCompUnitRange_Symbols);
+    tasks->sym_for_unit[idx] = cv_sym_from_data(arena, sym_data, 4);
+    return;
+  }
+  idx -= tasks->comp_unit_count;
+  
+  // parse c13 for a compilation unit
+  if (idx < tasks->comp_unit_count){
+    PDB_CompUnit *unit = tasks->comp_units->units[idx];
+    String8 c13_data = pdb_data_from_unit_range(tasks->msf, unit, PDB_DbiCompUnitRange_C13);
+    tasks->c13_for_unit[idx] = cv_c13_from_data(arena, c13_data, tasks->strtbl, tasks->coff_sections);
+    return;
+  }
+}
+
 ////////////////////////////////
 //~ Conversion Path
 
@@ -2928,155 +3273,106 @@ str8_list_pushf(arena, &out->errors, fmt, __VA_ARGS__);\
     PARSE_CHECK_ERROR(dbi, "DBI");
   }
   
-  // parse tpi
-  PDB_TpiParsed *tpi = 0;
-  if (msf != 0) ProfScope("parse tpi"){
-    String8 tpi_data = msf_data_from_stream(msf, PDB_FixedStream_Tpi);
-    tpi = pdb_tpi_from_data(arena, tpi_data);
-    
+  // parse the independent streams concurrently
+  PDBCONV_ParseTasks *tasks = push_array(arena, PDBCONV_ParseTasks, 1);
+  tasks->msf = msf;
+  tasks->strtbl = strtbl;
+  tasks->dbi = dbi;
+  PDBCONV_TaskPool *task_pool = 0;
+  if (msf != 0) ProfScope("parse streams"){
+    task_pool = pdbconv_task_pool_alloc(arena, params->thread_count);
+    pdbconv_task_pool_run(task_pool, pdbconv_stream_task, tasks, PDBCONV_StreamTask_COUNT);
+  }
+  PDB_TpiParsed *tpi = tasks->tpi;
+  PDB_TpiParsed *ipi = tasks->ipi;
+  PDB_TpiHashParsed *tpi_hash = tasks->tpi_hash;
+  PDB_TpiHashParsed *ipi_hash = tasks->ipi_hash;
+  PDB_CoffSectionArray *coff_sections = tasks->coff_sections;
+  U64 coff_section_count = (coff_sections != 0) ? coff_sections->count : 0;
+  PDB_GsiParsed *gsi = tasks->gsi;
+  PDB_GsiParsed *psi_gsi_part = tasks->psi_gsi_part;
+  CV_SymParsed *sym = tasks->sym;
+  PDB_CompUnitArray *comp_units = tasks->comp_units;
+  U64 comp_unit_count = (comp_units != 0) ? comp_units->count : 0;
+  PDB_CompUnitContributionArray *comp_unit_contributions = tasks->comp_unit_contributions;
+  U64 comp_unit_contribution_count = (comp_unit_contributions != 0) ? comp_unit_contributions->count : 0;
+  if (msf != 0){
     PARSE_CHECK_ERROR(tpi, "TPI");
-  }
-  
-  // parse ipi
-  PDB_TpiParsed *ipi = 0;
-  if (msf != 0) ProfScope("parse ipi"){
-    String8 ipi_data = msf_data_from_stream(msf, PDB_FixedStream_Ipi);
-    ipi = pdb_tpi_from_data(arena, ipi_data);
-    
     PARSE_CHECK_ERROR(ipi, "IPI");
   }
-  
-  // parse coff sections
-  PDB_CoffSectionArray *coff_sections = 0;
-  U64 coff_section_count = 0;
-  if (dbi != 0) ProfScope("parse coff sections"){
-    MSF_StreamNumber section_stream = dbi->dbg_streams[PDB_DbiStream_SECTION_HEADER];
-    String8 section_data = msf_data_from_stream(msf, section_stream);
-    coff_sections = pdb_coff_section_array_from_data(arena, section_data);
-    coff_section_count = coff_sections->count;
-    
+  if (dbi != 0){
     PARSE_CHECK_ERROR(coff_sections, "coff sections");
+    PARSE_CHECK_ERROR(gsi, "GSI");
+    PARSE_CHECK_ERROR(psi_gsi_part, "PSI");
   }
   
-  // parse gsi
-  PDB_GsiParsed *gsi = 0;
-  if (dbi != 0) ProfScope("parse gsi"){
-    String8 gsi_data = msf_data_from_stream(msf, dbi->gsi_sn);
-    gsi = pdb_gsi_from_data(arena, gsi_data);
-    
-    PARSE_CHECK_ERROR(gsi, "GSI");
+  // split tpi/ipi leaf data into pieces at the hash streams' offset hints
+  if (tpi != 0){
+    String8 hash_data = msf_data_from_stream(msf, tpi->hash_sn);
+    tasks->tpi_pieces = pdbconv_leaf_pieces_from_tpi(arena, tpi, hash_data, task_pool->worker_count*4);
+  }
+  if (ipi != 0){
+    String8 hash_data = msf_data_from_stream(msf, ipi->hash_sn);
+    tasks->ipi_pieces = pdbconv_leaf_pieces_from_tpi(arena, ipi, hash_data, task_pool->worker_count*4);
   }
   
-  // parse psi
-  PDB_GsiParsed *psi_gsi_part = 0;
-  if (dbi != 0) ProfScope("parse psi"){
-    String8 psi_data = msf_data_from_stream(msf, dbi->psi_sn);
-    String8 psi_data_gsi_part = str8_range(psi_data.str + sizeof(PDB_PsiHeader),
-                                           psi_data.str + psi_data.size);
-    psi_gsi_part = pdb_gsi_from_data(arena, psi_data_gsi_part);
-    
-    PARSE_CHECK_ERROR(psi_gsi_part, "PSI");
+  // parse leaf pieces, and syms & c13 for each compilation unit, concurrently
+  tasks->comp_unit_count = comp_unit_count;
+  tasks->sym_for_unit = push_array(arena, CV_SymParsed*, comp_unit_count);
+  tasks->c13_for_unit = push_array(arena, CV_C13Parsed*, comp_unit_count);
+  if (task_pool != 0) ProfScope("parse leaves & units"){
+    U64 task_count = tasks->tpi_pieces.count + tasks->ipi_pieces.count + comp_unit_count*2;
+    pdbconv_task_pool_run(task_pool, pdbconv_unit_task, tasks, task_count);
   }
+  CV_SymParsed **sym_for_unit = tasks->sym_for_unit;
+  CV_C13Parsed **c13_for_unit = tasks->c13_for_unit;
   
-  // parse tpi hash
-  PDB_TpiHashParsed *tpi_hash = 0;
-  if (tpi != 0) ProfScope("parse tpi hash"){
-    String8 hash_data = msf_data_from_stream(msf, tpi->hash_sn);
-    String8 aux_data = msf_data_from_stream(msf, tpi->hash_sn_aux);
-    tpi_hash = pdb_tpi_hash_from_data(arena, strtbl, tpi, hash_data, aux_data);
-    
-    PARSE_CHECK_ERROR(tpi_hash, "TPI hash table");
+  // workers are done; their arenas hold parse results, so go to the output
+  if (task_pool != 0){
+    pdbconv_task_pool_release(task_pool);
+    out->worker_arenas = task_pool->worker_arenas + 1;
+    out->worker_arena_count = task_pool->worker_count - 1;
   }
   
-  // parse tpi leaves
+  // stitch tpi leaves - if a hint was off, parse them in one go instead
   CV_LeafParsed *tpi_leaf = 0;
   if (tpi != 0) ProfScope("parse tpi leaves"){
-    String8 leaf_data = pdb_leaf_data_from_tpi(tpi);
-    tpi_leaf = cv_leaf_from_data(arena, leaf_data, tpi->itype_first);
+    PARSE_CHECK_ERROR(tpi_hash, "TPI hash table");
     
-    PARSE_CHECK_ERROR(tpi_hash, "TPI leaf data");
-  }
-  
-  // parse ipi hash
-  PDB_TpiHashParsed *ipi_hash = 0;
-  if (ipi != 0) ProfScope("parse ipi hash"){
-    String8 hash_data = msf_data_from_stream(msf, ipi->hash_sn);
-    String8 aux_data = msf_data_from_stream(msf, ipi->hash_sn_aux);
-    ipi_hash = pdb_tpi_hash_from_data(arena, strtbl, ipi, hash_data, aux_data);
+    tpi_leaf = pdbconv_leaf_from_pieces(arena, &tasks->tpi_pieces, tpi->itype_first);
+    if (tpi_leaf == 0){
+      tpi_leaf = cv_leaf_from_data(arena, tasks->tpi_pieces.data, tpi->itype_first);
+    }
     
-    PARSE_CHECK_ERROR(tpi_hash, "IPI hash table");
+    PARSE_CHECK_ERROR(tpi_hash, "TPI leaf data");
   }
   
-  // parse ipi leaves
+  // stitch ipi leaves
   CV_LeafParsed *ipi_leaf = 0;
   if (ipi != 0) ProfScope("parse ipi leaves"){
-    String8 leaf_data = pdb_leaf_data_from_tpi(ipi);
-    ipi_leaf = cv_leaf_from_data(arena, leaf_data, ipi->itype_first);
+    PARSE_CHECK_ERROR(tpi_hash, "IPI hash table");
+    
+    ipi_leaf = pdbconv_leaf_from_pieces(arena, &tasks->ipi_pieces, ipi->itype_first);
+    if (ipi_leaf == 0){
+      ipi_leaf = cv_leaf_from_data(arena, tasks->ipi_pieces.data, ipi->itype_first);
+    }
     
     PARSE_CHECK_ERROR(tpi_hash, "IPI leaf data");
   }
   
-  // parse sym
-  CV_SymParsed *sym = 0;
-  if (dbi != 0) ProfScope("parse sym"){
-    String8 sym_data = msf_data_from_stream(msf, dbi->sym_sn);
-    sym = cv_sym_from_data(arena, sym_data, 4);
-    
+  if (dbi != 0){
     PARSE_CHECK_ERROR(tpi_hash, "public SYM data");
-  }
-  
-  // parse compilation units
-  PDB_CompUnitArray *comp_units = 0;
-  U64 comp_unit_count = 0;
-  if (dbi != 0) ProfScope("parse compilation units"){
-    String8 mod_info_data = pdb_data_from_dbi_range(dbi, PDB_DbiRange_ModuleInfo);
-    comp_units = pdb_comp_unit_array_from_data(arena, mod_info_data);
-    comp_unit_count = comp_units->count;
-    
     PARSE_CHECK_ERROR(comp_units, "module info");
   }
-  
-  // parse dbi's section contributions
-  PDB_CompUnitContributionArray *comp_unit_contributions = 0;
-  U64 comp_unit_contribution_count = 0;
-  if (dbi != 0 && coff_sections != 0) ProfScope("parse dbi section contributions"){
-    String8 section_contribution_data = pdb_data_from_dbi_range(dbi, PDB_DbiRange_SecCon);
-    comp_unit_contributions =
-      pdb_comp_unit_contribution_array_from_data(arena, section_contribution_data, coff_sections);
-    comp_unit_contribution_count = comp_unit_contributions->count;
-    
+  if (dbi != 0 && coff_sections != 0){
     PARSE_CHECK_ERROR(comp_unit_contributions, "module contributions");
   }
-  
-  // parse syms for each compilation unit
-  CV_SymParsed **sym_for_unit = push_array(arena, CV_SymParsed*, comp_unit_count);
-  if (comp_units != 0) ProfScope("parse symbols"){
-    PDB_CompUnit **unit_ptr = comp_units->units;
-    for (U64 i = 0; i < comp_unit_count; i += 1, unit_ptr += 1){
-      CV_SymParsed *unit_sym = 0;
-      {
-        String8 sym_data = pdb_data_from_unit_range(msf, *unit_ptr, PDB_DbiCompUnitRange_Symbols);
-        unit_sym = cv_sym_from_data(arena, sym_data, 4);
-      }
-      PARSE_CHECK_ERROR(unit_sym, "module (i=%llu) SYM data", i);
-      
-      sym_for_unit[i] = unit_sym;
+  if (comp_units != 0){
+    for (U64 i = 0; i < comp_unit_count; i += 1){
+      PARSE_CHECK_ERROR(sym_for_unit[i], "module (i=%llu) SYM data", i);
     }
-  }
-  
-  // parse c13 for each compilation unit
-  CV_C13Parsed **c13_for_unit = push_array(arena, CV_C13Parsed*, comp_unit_count);
-  if (comp_units != 0) ProfScope("parse c13s"){
-    PDB_CompUnit **unit_ptr = comp_units->units;
-    for (U64 i = 0; i < comp_unit_count; i += 1, unit_ptr += 1){
-      CV_C13Parsed *unit_c13 = 0;
-      {
-        String8 c13_data = pdb_data_from_unit_range(msf, *unit_ptr, PDB_DbiCompUnitRange_C13);
-        unit_c13 = cv_c13_from_data(arena, c13_data, strtbl, coff_sections);
-      }
-      PARSE_CHECK_ERROR(unit_c13, "module (i=%llu) C13 line info", i);
-      
-      c13_for_unit[i] = unit_c13;
+    for (U64 i = 0; i < comp_unit_count; i += 1){
+      PARSE_CHECK_ERROR(c13_for_unit[i], "module (i=%llu) C13 line info", i);
     }
   }
   
@@ -3323,6 +3619,9 @@ str8_list_pushf(arena, &out->errors, fmt, __VA_ARGS__);\
     root_params.bucket_count_locals = symbol_count_prediction;
     root_params.bucket_count_types = tpi->itype_opl;
     
+    root_params.bake_thread_count = params->thread_count;
+    root_params.bake_trigram_maps = params->trigram_maps;
+    
     CONS_Root *root = cons_root_new(&root_params);
     out->root = root;
     
@@ -3479,3 +3778,9 @@ str8_list_pushf(arena, &out->errors, fmt, __VA_ARGS__);\
   
   return out;
 }
+
+static void
+pdbconv_write_baked_data(void *write_ptr, U64 off, void *data, U64 size){
+  OS_Handle file = *(OS_Handle*)write_ptr;
+  os_file_write(file, r1u64(off, off + size), data);
+}
@@ -16,6 +16,11 @@ typedef struct PDBCONV_Params{
   
   String8 output_name;
   
+  B8 large_pages;
+  U64 thread_count;
+  
+  B8 trigram_maps;
+  
   struct{
     B8 input;
     B8 output;
@@ -242,6 +247,107 @@ static void    pdbconv_link_name_save(Arena *arena, PDBCONV_LinkNameMap *map,
                                       U64 voff, String8 name);
 static String8 pdbconv_link_name_find(PDBCONV_LinkNameMap *map, U64 voff);
 
+////////////////////////////////
+//~ Parallel Parse Types
+
+// NOTE: the parse phase runs on a task pool: the independent streams
+// (TPI, IPI, GSI, PSI, public syms, ...) are parsed concurrently, then the
+// TPI/IPI leaf data, and each compilation unit's symbols & C13 lines. leaf
+// data is split at the TPI hash stream's offset hints, which mark record
+// boundaries, into pieces of at least PDBCONV_LEAF_PIECE_MIN_SIZE. each
+// worker allocates from its own arena; worker 0 is the calling thread and
+// uses the caller's arena.
+
+#define PDBCONV_LEAF_PIECE_MIN_SIZE MB(1)
+
+typedef void PDBCONV_TaskFunction(Arena *arena, void *ptr, U64 task_idx);
+
+typedef struct PDBCONV_TaskPool{
+  U64 worker_count;
+  Arena **worker_arenas;
+  OS_Handle *worker_threads;
+  OS_Handle mutex;
+  OS_Handle cv;
+  
+  // current batch (guarded by mutex, except for task claiming)
+  U64 batch_gen;
+  PDBCONV_TaskFunction *batch_func;
+  void *batch_ptr;
+  U64 batch_task_count;
+  U64 batch_next_task_idx;
+  U64 batch_done_worker_count;
+  
+  // shutdown
+  B32 exit;
+  U64 live_worker_count;
+} PDBCONV_TaskPool;
+
+typedef struct PDBCONV_TaskWorker{
+  PDBCONV_TaskPool *pool;
+  U64 worker_idx;
+} PDBCONV_TaskWorker;
+
+typedef enum PDBCONV_StreamTask{
+  PDBCONV_StreamTask_Tpi,
+  PDBCONV_StreamTask_Ipi,
+  PDBCONV_StreamTask_CoffSections,
+  PDBCONV_StreamTask_Gsi,
+  PDBCONV_StreamTask_Psi,
+  PDBCONV_StreamTask_Sym,
+  PDBCONV_StreamTask_CompUnits,
+  PDBCONV_StreamTask_COUNT
+} PDBCONV_StreamTask;
+
+typedef struct PDBCONV_LeafPieces{
+  String8 data;
+  U64 count;
+  Rng1U64 *ranges;
+  CV_RecRangeArray *recs;
+} PDBCONV_LeafPieces;
+
+typedef struct PDBCONV_ParseTasks{
+  // inputs
+  MSF_Parsed *msf;
+  PDB_Strtbl *strtbl;
+  PDB_DbiParsed *dbi;
+  
+  // stream tasks
+  PDB_TpiParsed *tpi;
+  PDB_TpiHashParsed *tpi_hash;
+  PDB_TpiParsed *ipi;
+  PDB_TpiHashParsed *ipi_hash;
+  PDB_CoffSectionArray *coff_sections;
+  PDB_CompUnitContributionArray *comp_unit_contributions;
+  PDB_GsiParsed *gsi;
+  PDB_GsiParsed *psi_gsi_part;
+  CV_SymParsed *sym;
+  PDB_CompUnitArray *comp_units;
+  
+  // leaf & unit tasks
+  PDBCONV_LeafPieces tpi_pieces;
+  PDBCONV_LeafPieces ipi_pieces;
+  U64 comp_unit_count;
+  CV_SymParsed **sym_for_unit;
+  CV_C13Parsed **c13_for_unit;
+} PDBCONV_ParseTasks;
+
+////////////////////////////////
+//~ Parallel Parse Functions
+
+static PDBCONV_TaskPool *pdbconv_task_pool_alloc(Arena *arena, U64 worker_count);
+static void pdbconv_task_pool_release(PDBCONV_TaskPool *pool);
+static void pdbconv_task_pool_run(PDBCONV_TaskPool *pool, PDBCONV_TaskFunction *func, void *ptr, U64 task_count);
+static void pdbconv_task_pool_do_tasks(PDBCONV_TaskPool *pool, U64 worker_idx);
+static void pdbconv_task_pool_worker_entry_point(void *ptr);
+
+static PDBCONV_LeafPieces pdbconv_leaf_pieces_from_tpi(Arena *arena, PDB_TpiParsed *tpi, String8 hash_data,
+                                                       U64 piece_count_target);
+static CV_LeafParsed *pdbconv_leaf_from_pieces(Arena *arena, PDBCONV_LeafPieces *pieces,
+                                               CV_TypeId itype_first);
+
+static void pdbconv_stream_task(Arena *arena, void *ptr, U64 task_idx);
+static void pdbconv_unit_task(Arena *arena, void *ptr, U64 task_idx);
+
 ////////////////////////////////
 //~ Conversion Output Type
 
@@ -252,6 +358,11 @@ struct PDBCONV_Out
   CONS_Root *root;
   String8List dump;
   String8List errors;
+  
+  // arenas of the parse workers other than the calling thread; they hold
+  // parse results the output refers to, so live as long as the output
+  Arena **worker_arenas;
+  U64 worker_arena_count;
 };
 
 ////////////////////////////////
@@ -259,4 +370,7 @@ struct PDBCONV_Out
 
 static PDBCONV_Out *pdbconv_convert(Arena *arena, PDBCONV_Params *params);
 
+// CONS_BakeWriteFunction for cons_bake_file_stream; `write_ptr` is an OS_Handle*
+static void pdbconv_write_baked_data(void *write_ptr, U64 off, void *data, U64 size);
+
 #endif //RADDBG_FROM_PDB_H
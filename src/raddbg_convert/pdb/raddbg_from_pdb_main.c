@@ -38,6 +38,13 @@
 
 int
 main(int argc, char **argv){
+  //- enable large pages before the thread context & first arena are
+  // reserved, so that the main & scratch arenas get them too
+  B32 large_pages_enabled = 0;
+  if (cmd_line_argcv_has_flag(argc, argv, str8_lit("large_pages"))){
+    large_pages_enabled = os_set_large_pages(1);
+  }
+  
   local_persist TCTX main_thread_tctx = {0};
   tctx_init_and_equip(&main_thread_tctx);
 #if PROFILE_TELEMETRY
@@ -70,17 +77,31 @@ main(int argc, char **argv){
     }
   }
   
+  //- report large pages, which were enabled before any arena was reserved
+  if(params->large_pages)
+  {
+    if(large_pages_enabled)
+    {
+      fprintf(stderr, "large pages: enabled (%llu KB pages)\n", (unsigned long long)(os_large_page_size()/KB(1)));
+    }
+    else
+    {
+      fprintf(stderr, "large pages: not available, using normal pages\n");
+    }
+  }
+  
   //- rjf: open output file
   String8 output_name = push_str8_copy(arena, params->output_name);
-  FILE *out_file = fopen((char*)output_name.str, "wb");
-  if(out_file == 0 && !params->hide_errors.output)
+  OS_Handle out_file = os_file_open(OS_AccessFlag_Write, output_name);
+  B32 out_file_is_good = !os_handle_match(out_file, os_handle_zero());
+  if(!out_file_is_good && !params->hide_errors.output)
   {
     fprintf(stderr, "error(output): could not open output file\n");
   }
   
   //- rjf: convert
   PDBCONV_Out *out = 0;
-  if(out_file != 0)
+  if(out_file_is_good)
   {
     out = pdbconv_convert(arena, params);
   }
@@ -94,21 +115,22 @@ main(int argc, char **argv){
     }
   }
   
-  //- rjf: bake file
+  //- bake file; sections are written as they're finished
   if(out != 0 && out->good_parse && params->output_name.size > 0 && out->good_parse)
   {
-    String8List baked = {0};
-    cons_bake_file(arena, out->root, &baked);
-    for(String8Node *node = baked.first; node != 0; node = node->next)
-    {
-      fwrite(node->string.str, node->string.size, 1, out_file);
-    }
+    cons_bake_file_stream(arena, out->root, pdbconv_write_baked_data, &out_file);
   }
   
   //- rjf: close output file
-  if(out_file != 0)
+  os_file_close(out_file);
+  
+  //- release parse worker arenas
+  if(out != 0)
   {
-    fclose(out_file);
+    for(U64 idx = 0; idx < out->worker_arena_count; idx += 1)
+    {
+      arena_release(out->worker_arenas[idx]);
+    }
   }
   
   ProfEndCapture();
@@ -14,6 +14,19 @@ raddbg_hash(RADDBG_U8 *ptr, RADDBG_U64 size){
   return(result);
 }
 
+RADDBG_PROC RADDBG_U32
+raddbg_trigram_from_ptr(RADDBG_U8 *ptr){
+  RADDBG_U32 result = 0;
+  for (RADDBG_U32 i = 0; i < 3; i += 1){
+    RADDBG_U8 c = ptr[i];
+    if ('A' <= c && c <= 'Z'){
+      c += 'a' - 'A';
+    }
+    result |= ((RADDBG_U32)c) << (i*8);
+  }
+  return(result);
+}
+
 RADDBG_PROC RADDBG_U32
 raddbg_size_from_basic_type_kind(RADDBG_TypeKind kind){
   RADDBG_U32 result = 0;
@@ -272,6 +272,7 @@ X(Locals,              0x0015)\
 X(LocationBlocks,      0x0016)\
 X(LocationData,        0x0017)\
 X(NameMaps,            0x0018)\
+X(TrigramMaps,         0x0019)\
 Y(PRIMARY_COUNT)\
 X(SKIP,                RADDBG_DataSectionTag_SECONDARY|0x0000)\
 X(LineInfoVoffs,       RADDBG_DataSectionTag_SECONDARY|0x0001)\
@@ -281,7 +282,9 @@ X(LineMapNumbers,      RADDBG_DataSectionTag_SECONDARY|0x0004)\
 X(LineMapRanges,       RADDBG_DataSectionTag_SECONDARY|0x0005)\
 X(LineMapVoffs,        RADDBG_DataSectionTag_SECONDARY|0x0006)\
 X(NameMapBuckets,      RADDBG_DataSectionTag_SECONDARY|0x0007)\
-X(NameMapNodes,        RADDBG_DataSectionTag_SECONDARY|0x0008)
+X(NameMapNodes,        RADDBG_DataSectionTag_SECONDARY|0x0008)\
+X(TrigramMapEntries,   RADDBG_DataSectionTag_SECONDARY|0x0009)\
+X(TrigramMapPostings,  RADDBG_DataSectionTag_SECONDARY|0x000A)
 
 typedef RADDBG_U32 RADDBG_DataSectionTag;
 typedef enum RADDBG_DataSectionTagEnum{
@@ -751,6 +754,44 @@ typedef struct RADDBG_NameMapNode{
   RADDBG_U32 match_idx_or_idx_run_first;
 } RADDBG_NameMapNode;
 
+//- name trigram map types
+#define RADDBG_TrigramMapXList(X)\
+X(NULL,            0)\
+X(GlobalVariables, 1)\
+X(ThreadVariables, 2)\
+X(Procedures,      3)\
+X(UDTs,            4)
+
+typedef RADDBG_U32 RADDBG_TrigramMapKind;
+typedef enum RADDBG_TrigramMapKindEnum{
+#define X(N,C) RADDBG_TrigramMapKind_##N = C,
+  RADDBG_TrigramMapXList(X)
+#undef X
+  
+  RADDBG_TrigramMapKind_COUNT
+} RADDBG_TrigramMapKindEnum;
+
+// NOTE: trigram maps are an optional acceleration structure for
+// substring searches over element names. every 3-byte window of a name is
+// folded to lower case (ASCII only) and packed as (b0 | b1<<8 | b2<<16).
+// entries are sorted by trigram; each entry names a run of postings, which
+// are the sorted, unique element indices (into the table named by the map
+// kind) of all elements whose names contain that trigram. an element whose
+// name contains a substring s must appear in the posting run of every
+// trigram of s, so intersecting those runs gives a superset of the matches.
+
+typedef struct RADDBG_TrigramMap{
+  RADDBG_TrigramMapKind kind;
+  RADDBG_U32 entry_data_idx;
+  RADDBG_U32 posting_data_idx;
+} RADDBG_TrigramMap;
+
+typedef struct RADDBG_TrigramMapEntry{
+  RADDBG_U32 trigram;
+  RADDBG_U32 posting_first;
+  RADDBG_U32 posting_count;
+} RADDBG_TrigramMapEntry;
+
 
 ////////////////////////////////
 // Eval Bytecode
@@ -907,6 +948,7 @@ static RADDBG_U8 raddbg_eval_opcode_ctrlbits[] = {
 // Functions
 
 RADDBG_PROC RADDBG_U64 raddbg_hash(RADDBG_U8 *ptr, RADDBG_U64 size);
+RADDBG_PROC RADDBG_U32 raddbg_trigram_from_ptr(RADDBG_U8 *ptr);
 RADDBG_PROC RADDBG_U32 raddbg_size_from_basic_type_kind(RADDBG_TypeKind kind);
 RADDBG_PROC RADDBG_U32 raddbg_addr_size_from_arch(RADDBG_Arch arch);
 
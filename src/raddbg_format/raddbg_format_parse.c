@@ -194,6 +194,20 @@ raddbg_parse(RADDBG_U8 *data, RADDBG_U64 size, RADDBG_Parsed *out){
       }
     }
     
+    {
+      raddbg_parse__extract_primary(out, out->trigram_maps, &out->trigram_maps_count,
+                                    RADDBG_DataSectionTag_TrigramMaps);
+      
+      RADDBG_TrigramMap *trigram_map_ptr = out->trigram_maps;
+      RADDBG_TrigramMap *trigram_map_opl = out->trigram_maps + out->trigram_maps_count;
+      for (; trigram_map_ptr < trigram_map_opl; trigram_map_ptr += 1){
+        if (trigram_map_ptr->kind < RADDBG_TrigramMapKind_COUNT &&
+            out->trigram_maps_by_kind[trigram_map_ptr->kind] == 0){
+          out->trigram_maps_by_kind[trigram_map_ptr->kind] = trigram_map_ptr;
+        }
+      }
+    }
+    
 #if !defined(RADDBG_DISABLE_NILS)
     if(out->binary_sections == 0)                { out->binary_sections        = &raddbg_binary_section_nil;           out->binary_sections_count = 1; }
     if(out->file_paths == 0)                     { out->file_paths             = &raddbg_file_path_node_nil;           out->file_paths_count = 1; }
@@ -511,6 +525,64 @@ raddbg_matches_from_map_node(RADDBG_Parsed *p, RADDBG_NameMapNode *node,
   return(result);
 }
 
+//- trigram maps
+
+RADDBG_PROC RADDBG_TrigramMap*
+raddbg_trigram_map_from_kind(RADDBG_Parsed *p, RADDBG_TrigramMapKind kind){
+  RADDBG_TrigramMap *result = 0;
+  if (0 < kind && kind < RADDBG_TrigramMapKind_COUNT){
+    result = p->trigram_maps_by_kind[kind];
+  }
+  return(result);
+}
+
+RADDBG_PROC void
+raddbg_trigram_map_parse(RADDBG_Parsed *p, RADDBG_TrigramMap *mapptr, RADDBG_ParsedTrigramMap *out){
+  out->entries = 0;
+  out->postings = 0;
+  out->entry_count = 0;
+  out->posting_count = 0;
+  if (mapptr != 0){
+    out->entries = (RADDBG_TrigramMapEntry*)
+      raddbg_data_from_dsec(p, mapptr->entry_data_idx, sizeof(RADDBG_TrigramMapEntry),
+                            RADDBG_DataSectionTag_TrigramMapEntries, &out->entry_count);
+    out->postings = (RADDBG_U32*)
+      raddbg_data_from_dsec(p, mapptr->posting_data_idx, sizeof(RADDBG_U32),
+                            RADDBG_DataSectionTag_TrigramMapPostings, &out->posting_count);
+  }
+}
+
+RADDBG_PROC RADDBG_U32*
+raddbg_trigram_map_postings_from_trigram(RADDBG_ParsedTrigramMap *map, RADDBG_U32 trigram,
+                                         RADDBG_U32 *n_out){
+  RADDBG_U32 *result = 0;
+  *n_out = 0;
+  
+  // find i such that: (entries[i].trigram == trigram)
+  RADDBG_U64 first = 0;
+  RADDBG_U64 opl   = map->entry_count;
+  for (;first < opl;){
+    RADDBG_U64 mid = (first + opl)/2;
+    RADDBG_TrigramMapEntry *entry = &map->entries[mid];
+    if (entry->trigram < trigram){
+      first = mid + 1;
+    }
+    else if (entry->trigram > trigram){
+      opl = mid;
+    }
+    else{
+      RADDBG_U64 posting_opl = (RADDBG_U64)entry->posting_first + entry->posting_count;
+      if (posting_opl <= map->posting_count){
+        result = map->postings + entry->posting_first;
+        *n_out = entry->posting_count;
+      }
+      break;
+    }
+  }
+  
+  return(result);
+}
+
 //- common helpers
 
 RADDBG_PROC RADDBG_U64
@@ -69,10 +69,13 @@ typedef struct RADDBG_Parsed{
   RADDBG_U64             location_data_size;
   RADDBG_NameMap*        name_maps;
   RADDBG_U64             name_maps_count;
+  RADDBG_TrigramMap*     trigram_maps;
+  RADDBG_U64             trigram_maps_count;
   
   // other helpers
   
   RADDBG_NameMap* name_maps_by_kind[RADDBG_NameMapKind_COUNT];
+  RADDBG_TrigramMap* trigram_maps_by_kind[RADDBG_TrigramMapKind_COUNT];
   
 } RADDBG_Parsed;
 
@@ -124,6 +127,13 @@ typedef struct RADDBG_ParsedNameMap{
   RADDBG_U64 node_count;
 } RADDBG_ParsedNameMap;
 
+typedef struct RADDBG_ParsedTrigramMap{
+  RADDBG_TrigramMapEntry *entries; // [entry_count] sorted by trigram
+  RADDBG_U32 *postings;            // [posting_count]
+  RADDBG_U64 entry_count;
+  RADDBG_U64 posting_count;
+} RADDBG_ParsedTrigramMap;
+
 ////////////////////////////////
 //~ Global Nils
 
@@ -196,6 +206,17 @@ raddbg_name_map_lookup(RADDBG_Parsed *p, RADDBG_ParsedNameMap *map,
 RADDBG_PROC RADDBG_U32*
 raddbg_matches_from_map_node(RADDBG_Parsed *p, RADDBG_NameMapNode *node, RADDBG_U32 *n_out);
 
+//- trigram maps
+RADDBG_PROC RADDBG_TrigramMap*
+raddbg_trigram_map_from_kind(RADDBG_Parsed *p, RADDBG_TrigramMapKind kind);
+
+RADDBG_PROC void
+raddbg_trigram_map_parse(RADDBG_Parsed *p, RADDBG_TrigramMap *mapptr, RADDBG_ParsedTrigramMap *out);
+
+RADDBG_PROC RADDBG_U32*
+raddbg_trigram_map_postings_from_trigram(RADDBG_ParsedTrigramMap *map, RADDBG_U32 trigram,
+                                         RADDBG_U32 *n_out);
+
 
 //- common helpers
 RADDBG_PROC RADDBG_U64
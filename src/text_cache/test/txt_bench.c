@@ -0,0 +1,219 @@
+// Copyright (c) 2024 Epic Games Tools
+// Licensed under the MIT license (https://opensource.org/license/mit/)
+
+// Throughput of the text cache's line splitting & C/C++ lexing on a
+// synthetic source file:
+// * line splitting: scalar byte loop vs txt_line_end_idx_from_string
+// * lexing: serial vs chunked on a lex worker pool of 1, 2, 4, 8 workers
+// Line ranges & token arrays must match the scalar/serial results exactly.
+//
+// usage: txt_bench [--size_mb:<n>] [--runs:<n>] [--crlf]
+
+#include "base/base_inc.h"
+#include "os/os_inc.h"
+#include "hash_store/hash_store.h"
+#include "text_cache/text_cache.h"
+
+#include "base/base_inc.c"
+#include "os/os_inc.c"
+#include "hash_store/hash_store.c"
+#include "text_cache/text_cache.c"
+
+////////////////////////////////
+//~ Helpers
+
+typedef U64 TXTB_LineEndFunction(String8 string, U64 start_idx);
+
+static U64
+txtb_line_end_idx_scalar(String8 string, U64 start_idx){
+  U64 idx = Min(start_idx, string.size);
+  for (;idx < string.size; idx += 1){
+    if (string.str[idx] == '\n' || string.str[idx] == '\r'){
+      break;
+    }
+  }
+  return(idx);
+}
+
+// same counting & range building as txt_parse_thread__entry_point
+static Rng1U64*
+txtb_line_ranges_from_string(Arena *arena, String8 data, TXTB_LineEndFunction *line_end, U64 *count_out){
+  U64 line_count = 1;
+  for (U64 idx = line_end(data, 0); idx < data.size; idx = line_end(data, idx + 1)){
+    if (data.str[idx] == '\r'){
+      idx += 1;
+    }
+    line_count += 1;
+  }
+  Rng1U64 *ranges = push_array_no_zero(arena, Rng1U64, line_count);
+  U64 line_start_idx = 0;
+  for (U64 line_idx = 0; line_idx < line_count; line_idx += 1){
+    U64 line_end_idx = line_end(data, line_start_idx);
+    ranges[line_idx] = r1u64(line_start_idx, line_end_idx);
+    line_start_idx = line_end_idx + 1;
+    if (line_end_idx < data.size && data.str[line_end_idx] == '\r'){
+      line_start_idx += 1;
+    }
+    line_start_idx = Min(line_start_idx, data.size);
+  }
+  *count_out = line_count;
+  return(ranges);
+}
+
+static String8
+txtb_synthetic_source(Arena *arena, U64 size, B32 crlf){
+  String8List lines = {0};
+  char *nl = crlf ? "\r\n" : "\n";
+  U64 rng = 3;
+  for (U64 i = 0; lines.total_size < size; i += 1){
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    switch (rng%8){
+      case 0: str8_list_pushf(arena, &lines, "static int func_%llu(int a, char *b){ // entry %llu%s", i, rng%1000, nl); break;
+      case 1: str8_list_pushf(arena, &lines, "  x += 0x%llx; y = \"str \\\" esc %llu\";%s", rng, i, nl); break;
+      case 2: str8_list_pushf(arena, &lines, "/* block comment %llu%s   spans lines */%s", i, nl, nl); break;
+      case 3: str8_list_pushf(arena, &lines, "#define MACRO_%llu(x) \\%s  ((x)*%llu)%s", i, nl, rng%97, nl); break;
+      case 4: str8_list_pushf(arena, &lines, "  return a + 'c' - 1.5e3f;%s}%s", nl, nl); break;
+      case 5: str8_list_pushf(arena, &lines, "%s", nl); break;
+      case 6: str8_list_pushf(arena, &lines, "    if(a >= b && c != d) { e <<= 2; } else { f->g[h] = ~i; }%s", nl); break;
+      default: str8_list_pushf(arena, &lines, "  struct S%llu *p = (struct S%llu *)malloc(sizeof(*p));%s", i, i, nl); break;
+    }
+  }
+  String8 result = str8_list_join(arena, &lines, 0);
+  return(result);
+}
+
+static B32
+txtb_tokens_match(TXT_TokenArray *a, TXT_TokenArray *b){
+  B32 result = (a->count == b->count);
+  for (U64 i = 0; result && i < a->count; i += 1){
+    result = (a->v[i].kind == b->v[i].kind &&
+              a->v[i].range.min == b->v[i].range.min &&
+              a->v[i].range.max == b->v[i].range.max);
+  }
+  return(result);
+}
+
+////////////////////////////////
+//~ Entry Point
+
+int
+main(int argument_count, char **arguments){
+  local_persist TCTX main_thread_tctx = {0};
+  tctx_init_and_equip(&main_thread_tctx);
+  os_init(argument_count, arguments);
+  Temp scratch = scratch_begin(0, 0);
+  
+  // parse arguments
+  U64 size_mb = 64;
+  U64 runs = 3;
+  B32 crlf = 0;
+  {
+    String8List command_line_arguments = os_get_command_line_arguments();
+    CmdLine cmd_line = cmd_line_from_string_list(scratch.arena, command_line_arguments);
+    String8 size_string = cmd_line_string(&cmd_line, str8_lit("size_mb"));
+    String8 runs_string = cmd_line_string(&cmd_line, str8_lit("runs"));
+    if (size_string.size != 0){
+      try_u64_from_str8_c_rules(size_string, &size_mb);
+    }
+    if (runs_string.size != 0){
+      try_u64_from_str8_c_rules(runs_string, &runs);
+    }
+    crlf = cmd_line_has_flag(&cmd_line, str8_lit("crlf"));
+    runs = Max(runs, 1);
+  }
+  
+  // the scalar/serial results are kept in their own arena for comparison;
+  // each run drops the previous run's results
+  Arena *reference_arena = arena_alloc();
+  String8 data = txtb_synthetic_source(scratch.arena, MB(size_mb), crlf);
+  F64 data_mb = data.size/(1024.0*1024.0);
+  printf("logical cores: %llu\n", (unsigned long long)os_logical_core_count());
+  printf("input: %.1f MB synthetic C, %s line ends\n", data_mb, crlf ? "CRLF" : "LF");
+  
+  // line splitting
+  {
+    TXTB_LineEndFunction *functions[] = {txtb_line_end_idx_scalar, txt_line_end_idx_from_string};
+    char *names[] = {"scalar", "txt_line_end_idx_from_string"};
+    Rng1U64 *reference = 0;
+    U64 reference_count = 0;
+    for (U64 function_idx = 0; function_idx < ArrayCount(functions); function_idx += 1){
+      Arena *arena = (function_idx == 0) ? reference_arena : scratch.arena;
+      U64 us_total = 0;
+      Rng1U64 *ranges = 0;
+      U64 count = 0;
+      Temp temp = temp_begin(arena);
+      for (U64 run_idx = 0; run_idx < runs; run_idx += 1){
+        temp_end(temp);
+        U64 begin_us = os_now_microseconds();
+        ranges = txtb_line_ranges_from_string(arena, data, functions[function_idx], &count);
+        us_total += os_now_microseconds() - begin_us;
+      }
+      if (function_idx == 0){
+        reference = ranges;
+        reference_count = count;
+      }
+      else if (count != reference_count || !MemoryMatch(ranges, reference, count*sizeof(Rng1U64))){
+        printf("error: line ranges differ from the scalar split\n");
+        return(1);
+      }
+      printf("line split, %-30s %8.1f MB/s (%llu lines)\n", names[function_idx],
+             data_mb*runs/(us_total/1000000.0), (unsigned long long)count);
+      if (function_idx != 0){
+        temp_end(temp);
+      }
+    }
+  }
+  
+  // lexing: txt_shared == 0 lexes serially; then grow a worker pool
+  {
+    TXT_TokenArray reference = {0};
+    U64 worker_counts[] = {0, 1, 2, 4, 8};
+    U64 workers_launched = 0;
+    for (U64 i = 0; i < ArrayCount(worker_counts); i += 1){
+      U64 worker_count = worker_counts[i];
+      if (worker_count != 0 && txt_shared == 0){
+        Arena *shared_arena = arena_alloc();
+        txt_shared = push_array(shared_arena, TXT_Shared, 1);
+        txt_shared->arena = shared_arena;
+        txt_shared->lex_job_mutex = os_mutex_alloc();
+        txt_shared->lex_job_cv = os_condition_variable_alloc();
+      }
+      for (;workers_launched < worker_count; workers_launched += 1){
+        os_release_thread_handle(os_launch_thread(txt_lex_worker_thread__entry_point, (void*)workers_launched, 0));
+      }
+      if (txt_shared != 0){
+        txt_shared->lex_worker_count = workers_launched;
+      }
+      
+      Arena *arena = (worker_count == 0) ? reference_arena : scratch.arena;
+      U64 us_total = 0;
+      TXT_TokenArray tokens = {0};
+      Temp temp = temp_begin(arena);
+      for (U64 run_idx = 0; run_idx < runs; run_idx += 1){
+        temp_end(temp);
+        U64 begin_us = os_now_microseconds();
+        tokens = txt_token_array_from_string__c_cpp(arena, 0, data);
+        us_total += os_now_microseconds() - begin_us;
+      }
+      if (worker_count == 0){
+        reference = tokens;
+        printf("lex, serial                    %8.1f MB/s (%llu tokens)\n",
+               data_mb*runs/(us_total/1000000.0), (unsigned long long)tokens.count);
+      }
+      else if (!txtb_tokens_match(&reference, &tokens)){
+        printf("error: chunked lex with %llu workers differs from the serial lex\n", (unsigned long long)worker_count);
+        return(1);
+      }
+      else{
+        printf("lex, chunked, %2llu workers       %8.1f MB/s\n",
+               (unsigned long long)worker_count, data_mb*runs/(us_total/1000000.0));
+      }
+      if (worker_count != 0){
+        temp_end(temp);
+      }
+    }
+  }
+  
+  scratch_end(scratch);
+  return(0);
+}
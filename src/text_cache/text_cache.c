@@ -29,6 +29,40 @@ txt_lang_kind_from_extension(String8 extension)
   return kind;
 }
 
+internal U64
+txt_line_end_idx_from_string(String8 string, U64 start_idx)
+{
+  U64 idx = Min(start_idx, string.size);
+  B32 found = 0;
+#if ARCH_X64
+  __m128i lf_v = _mm_set1_epi8('\n');
+  __m128i cr_v = _mm_set1_epi8('\r');
+  for(; !found && idx + 32 <= string.size; idx += 32)
+  {
+    __m128i block0 = _mm_loadu_si128((__m128i *)(string.str + idx));
+    __m128i block1 = _mm_loadu_si128((__m128i *)(string.str + idx + 16));
+    __m128i eq0 = _mm_or_si128(_mm_cmpeq_epi8(block0, lf_v), _mm_cmpeq_epi8(block0, cr_v));
+    __m128i eq1 = _mm_or_si128(_mm_cmpeq_epi8(block1, lf_v), _mm_cmpeq_epi8(block1, cr_v));
+    U32 mask = (U32)_mm_movemask_epi8(eq0) | ((U32)_mm_movemask_epi8(eq1) << 16);
+    if(mask != 0)
+    {
+      idx += ctz32(mask);
+      found = 1;
+      break;
+    }
+  }
+#endif
+  for(; !found && idx < string.size; idx += 1)
+  {
+    if(string.str[idx] == '\n' || string.str[idx] == '\r')
+    {
+      found = 1;
+      break;
+    }
+  }
+  return idx;
+}
+
 ////////////////////////////////
 //~ rjf: Token Type Functions
 
@@ -91,13 +125,10 @@ txt_token_array_from_list(Arena *arena, TXT_TokenList *list)
 ////////////////////////////////
 //~ rjf: Lexing Functions
 
-internal TXT_TokenArray
-txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, String8 string)
+internal U64
+txt_lex_string_range__c_cpp(Arena *arena, TXT_TokenChunkList *tokens_out, U64 *bytes_processed_counter, String8 string, U64 start_idx, U64 sync_min_idx)
 {
-  Temp scratch = scratch_begin(&arena, 1);
-  
-  //- rjf: generate token list
-  TXT_TokenChunkList tokens = {0};
+  U64 sync_idx = string.size+1;
   {
     B32 comment_is_single_line = 0;
     B32 string_is_char = 0;
@@ -105,12 +136,23 @@ txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, S
     U64 active_token_start_idx = 0;
     B32 escaped = 0;
     B32 next_escaped = 0;
-    U64 byte_process_start_idx = 0;
-    for(U64 idx = 0; idx <= string.size;)
+    U64 byte_process_start_idx = start_idx;
+    for(U64 idx = start_idx; idx <= string.size;)
     {
       U8 byte      = (idx+0 < string.size) ? (string.str[idx+0]) : 0;
       U8 next_byte = (idx+1 < string.size) ? (string.str[idx+1]) : 0;
       
+      // past the sync point & back in a fresh lexer state -> stop
+      if(idx >= sync_min_idx && active_token_kind == TXT_TokenKind_Null && !escaped)
+      {
+        if(bytes_processed_counter != 0)
+        {
+          ins_atomic_u64_add_eval(bytes_processed_counter, (idx-byte_process_start_idx));
+        }
+        sync_idx = idx;
+        break;
+      }
+      
       // rjf: update counter
       if(bytes_processed_counter != 0 && ((idx-byte_process_start_idx) >= 1000 || idx == string.size))
       {
@@ -168,7 +210,7 @@ txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, S
         else
         {
           TXT_Token token = {TXT_TokenKind_Error, r1u64(idx, idx+1)};
-          txt_token_chunk_list_push(scratch.arena, &tokens, 4096, &token);
+          txt_token_chunk_list_push(arena, tokens_out, 4096, &token);
         }
       }
       
@@ -357,7 +399,7 @@ txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, S
         }
         
         // rjf: push
-        txt_token_chunk_list_push(scratch.arena, &tokens, 4096, &token);
+        txt_token_chunk_list_push(arena, tokens_out, 4096, &token);
         
         // rjf: increment by ender padding
         idx += ender_pad;
@@ -371,13 +413,134 @@ txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, S
       escaped = next_escaped;
     }
   }
+  return sync_idx;
+}
+
+internal TXT_TokenArray
+txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, String8 string)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  TXT_TokenArray result = {0};
+  
+  //- small input, or no worker pool -> lex serially
+  if(string.size < TXT_LEX_PARALLEL_MIN_SIZE || txt_shared == 0 || txt_shared->lex_worker_count == 0)
+  {
+    TXT_TokenChunkList tokens = {0};
+    txt_lex_string_range__c_cpp(scratch.arena, &tokens, bytes_processed_counter, string, 0, max_U64);
+    result = txt_token_array_from_chunk_list(arena, &tokens);
+  }
+  
+  //- large input -> lex line-aligned chunks in parallel, then stitch
+  else
+  {
+    //- build job, splitting the string at the first non-whitespace byte
+    // after a line end (whitespace tokens span line ends, so the lexer is only
+    // ever back in a fresh state at a non-whitespace byte)
+    TXT_LexJob *job = push_array(scratch.arena, TXT_LexJob, 1);
+    job->string = string;
+    job->bytes_processed_counter = bytes_processed_counter;
+    job->chunks = push_array(scratch.arena, TXT_LexChunk, (string.size + TXT_LEX_PARALLEL_CHUNK_SIZE-1) / TXT_LEX_PARALLEL_CHUNK_SIZE);
+    for(U64 chunk_start_idx = 0; chunk_start_idx < string.size;)
+    {
+      U64 chunk_end_idx = string.size;
+      if(chunk_start_idx + TXT_LEX_PARALLEL_CHUNK_SIZE < string.size)
+      {
+        chunk_end_idx = txt_line_end_idx_from_string(string, chunk_start_idx + TXT_LEX_PARALLEL_CHUNK_SIZE);
+        for(;chunk_end_idx < string.size && char_is_space(string.str[chunk_end_idx]); chunk_end_idx += 1);
+      }
+      TXT_LexChunk *chunk = &job->chunks[job->chunks_count];
+      chunk->arena = arena_alloc();
+      chunk->range = r1u64(chunk_start_idx, chunk_end_idx);
+      job->chunks_count += 1;
+      chunk_start_idx = chunk_end_idx;
+    }
+    
+    //- run chunks on the worker pool & this thread, then wait for workers
+    OS_MutexScope(txt_shared->lex_job_mutex)
+    {
+      DLLPushBack(txt_shared->first_lex_job, txt_shared->last_lex_job, job);
+    }
+    os_condition_variable_broadcast(txt_shared->lex_job_cv);
+    txt_lex_job_do_chunks(job);
+    OS_MutexScope(txt_shared->lex_job_mutex)
+    {
+      for(;job->active_worker_count != 0;)
+      {
+        os_condition_variable_wait(txt_shared->lex_job_cv, txt_shared->lex_job_mutex, max_U64);
+      }
+      DLLRemove(txt_shared->first_lex_job, txt_shared->last_lex_job, job);
+    }
+    
+    //- stitch chunks - take a chunk's tokens as-is if the lexer was
+    // synced at its start, otherwise re-lex from the last sync point
+    TXT_TokenChunkList **lists = push_array(scratch.arena, TXT_TokenChunkList *, job->chunks_count);
+    U64 lists_count = 0;
+    U64 sync_idx = 0;
+    for(U64 chunk_idx = 0; chunk_idx < job->chunks_count && sync_idx <= string.size; chunk_idx += 1)
+    {
+      TXT_LexChunk *chunk = &job->chunks[chunk_idx];
+      B32 is_last = (chunk_idx+1 == job->chunks_count);
+      if(sync_idx == chunk->range.min)
+      {
+        lists[lists_count] = &chunk->tokens;
+        lists_count += 1;
+        sync_idx = chunk->sync_idx;
+      }
+      else if(sync_idx < chunk->range.max || is_last)
+      {
+        TXT_TokenChunkList *tokens = push_array(scratch.arena, TXT_TokenChunkList, 1);
+        sync_idx = txt_lex_string_range__c_cpp(scratch.arena, tokens, 0, string, sync_idx, is_last ? max_U64 : chunk->range.max);
+        lists[lists_count] = tokens;
+        lists_count += 1;
+      }
+    }
+    
+    //- token lists -> token array
+    for(U64 idx = 0; idx < lists_count; idx += 1)
+    {
+      result.count += lists[idx]->token_count;
+    }
+    result.v = push_array_no_zero(arena, TXT_Token, result.count);
+    U64 token_idx = 0;
+    for(U64 idx = 0; idx < lists_count; idx += 1)
+    {
+      for(TXT_TokenChunkNode *n = lists[idx]->first; n != 0; n = n->next)
+      {
+        MemoryCopy(result.v+token_idx, n->v, n->count*sizeof(TXT_Token));
+        token_idx += n->count;
+      }
+    }
+    
+    //- release chunk arenas
+    for(U64 chunk_idx = 0; chunk_idx < job->chunks_count; chunk_idx += 1)
+    {
+      arena_release(job->chunks[chunk_idx].arena);
+    }
+  }
   
-  //- rjf: token list -> token array
-  TXT_TokenArray result = txt_token_array_from_chunk_list(arena, &tokens);
   scratch_end(scratch);
   return result;
 }
 
+////////////////////////////////
+//~ Parallel Lexing
+
+internal void
+txt_lex_job_do_chunks(TXT_LexJob *job)
+{
+  for(;;)
+  {
+    U64 chunk_idx = ins_atomic_u64_inc_eval(&job->next_chunk_idx)-1;
+    if(chunk_idx >= job->chunks_count)
+    {
+      break;
+    }
+    TXT_LexChunk *chunk = &job->chunks[chunk_idx];
+    U64 sync_min_idx = (chunk_idx+1 < job->chunks_count) ? chunk->range.max : max_U64;
+    chunk->sync_idx = txt_lex_string_range__c_cpp(chunk->arena, &chunk->tokens, job->bytes_processed_counter, job->string, chunk->range.min, sync_min_idx);
+  }
+}
+
 ////////////////////////////////
 //~ rjf: Main Layer Initialization
 
@@ -418,6 +581,14 @@ txt_init(void)
   {
     txt_shared->parse_threads[idx] = os_launch_thread(txt_parse_thread__entry_point, (void *)idx, 0);
   }
+  txt_shared->lex_job_mutex = os_mutex_alloc();
+  txt_shared->lex_job_cv = os_condition_variable_alloc();
+  txt_shared->lex_worker_count = Clamp(1, os_logical_core_count()-1, 16);
+  txt_shared->lex_workers = push_array(arena, OS_Handle, txt_shared->lex_worker_count);
+  for(U64 idx = 0; idx < txt_shared->lex_worker_count; idx += 1)
+  {
+    txt_shared->lex_workers[idx] = os_launch_thread(txt_lex_worker_thread__entry_point, (void *)idx, 0);
+  }
   txt_shared->evictor_thread = os_launch_thread(txt_evictor_thread__entry_point, 0, 0);
 }
 
@@ -749,40 +920,32 @@ txt_parse_thread__entry_point(void *p)
       
       //- rjf: count # of lines
       U64 line_count = 1;
-      U64 byte_process_start_idx = 0;
-      for(U64 idx = 0; idx < data.size; idx += 1)
+      for(U64 idx = txt_line_end_idx_from_string(data, 0); idx < data.size; idx = txt_line_end_idx_from_string(data, idx+1))
       {
-        if(data.str[idx] == '\n' || data.str[idx] == '\r')
+        line_count += 1;
+        if(data.str[idx] == '\r')
         {
-          line_count += 1;
-          if(data.str[idx] == '\r')
-          {
-            idx += 1;
-          }
+          idx += 1;
         }
       }
       
       //- rjf: allocate & store line ranges
       info.lines_count = line_count;
       info.lines_ranges = push_array_no_zero(info_arena, Rng1U64, info.lines_count);
-      U64 line_idx = 0;
       U64 line_start_idx = 0;
-      for(U64 idx = 0; idx <= data.size; idx += 1)
+      for(U64 line_idx = 0; line_idx < info.lines_count; line_idx += 1)
       {
-        if(idx == data.size || data.str[idx] == '\n' || data.str[idx] == '\r')
+        U64 line_end_idx = txt_line_end_idx_from_string(data, line_start_idx);
+        Rng1U64 line_range = r1u64(line_start_idx, line_end_idx);
+        U64 line_size = dim_1u64(line_range);
+        info.lines_ranges[line_idx] = line_range;
+        info.lines_max_size = Max(info.lines_max_size, line_size);
+        line_start_idx = line_end_idx+1;
+        if(line_end_idx < data.size && data.str[line_end_idx] == '\r')
         {
-          Rng1U64 line_range = r1u64(line_start_idx, idx);
-          U64 line_size = dim_1u64(line_range);
-          info.lines_ranges[line_idx] = line_range;
-          info.lines_max_size = Max(info.lines_max_size, line_size);
-          line_idx += 1;
-          line_start_idx = idx+1;
-          if(idx < data.size && data.str[idx] == '\r')
-          {
-            line_start_idx += 1;
-            idx += 1;
-          }
+          line_start_idx += 1;
         }
+        line_start_idx = Min(line_start_idx, data.size);
       }
       
       //- rjf: lang -> lex function
@@ -854,6 +1017,45 @@ txt_parse_thread__entry_point(void *p)
   }
 }
 
+internal void
+txt_lex_worker_thread__entry_point(void *p)
+{
+  TCTX tctx_ = {0};
+  tctx_init_and_equip(&tctx_);
+  for(;;)
+  {
+    //- wait for a job with unclaimed chunks
+    TXT_LexJob *job = 0;
+    OS_MutexScope(txt_shared->lex_job_mutex) for(;;)
+    {
+      for(TXT_LexJob *j = txt_shared->first_lex_job; j != 0; j = j->next)
+      {
+        if(ins_atomic_u64_eval(&j->next_chunk_idx) < j->chunks_count)
+        {
+          job = j;
+          job->active_worker_count += 1;
+          break;
+        }
+      }
+      if(job != 0)
+      {
+        break;
+      }
+      os_condition_variable_wait(txt_shared->lex_job_cv, txt_shared->lex_job_mutex, max_U64);
+    }
+    
+    //- help out until no chunks remain
+    txt_lex_job_do_chunks(job);
+    
+    //- release job
+    OS_MutexScope(txt_shared->lex_job_mutex)
+    {
+      job->active_worker_count -= 1;
+    }
+    os_condition_variable_broadcast(txt_shared->lex_job_cv);
+  }
+}
+
 ////////////////////////////////
 //~ rjf: Evictor Threads
 
@@ -912,3 +1114,4 @@ txt_evictor_thread__entry_point(void *p)
     os_sleep_milliseconds(1000);
   }
 }
+
@@ -107,6 +107,48 @@ struct TXT_TextInfo
 
 typedef TXT_TokenArray TXT_LangLexFunctionType(Arena *arena, U64 *bytes_processed_counter, String8 string);
 
+////////////////////////////////
+//~ Parallel Lexing Types
+
+// NOTE: large inputs are lexed in line-aligned chunks on the lex
+// worker pool. each chunk is lexed from a fresh lexer state, and keeps
+// going past its end until the lexer is back in a fresh state (not inside
+// a token, not escaped) - sync_idx records where that happened. chunks are
+// then stitched in order; if the previous chunk synced exactly at this
+// chunk's start, this chunk's tokens are correct as-is, otherwise (a
+// comment/string/etc. crossed the boundary) the stitcher re-lexes from the
+// previous sync point.
+
+#define TXT_LEX_PARALLEL_MIN_SIZE MB(4)
+#define TXT_LEX_PARALLEL_CHUNK_SIZE MB(1)
+
+typedef struct TXT_LexChunk TXT_LexChunk;
+struct TXT_LexChunk
+{
+  Arena *arena;
+  Rng1U64 range;
+  U64 sync_idx;
+  TXT_TokenChunkList tokens;
+};
+
+typedef struct TXT_LexJob TXT_LexJob;
+struct TXT_LexJob
+{
+  // links (guarded by lex job mutex)
+  TXT_LexJob *next;
+  TXT_LexJob *prev;
+  U64 active_worker_count;
+  
+  // task description
+  String8 string;
+  U64 *bytes_processed_counter;
+  U64 chunks_count;
+  TXT_LexChunk *chunks;
+  
+  // atomically-updated progress
+  U64 next_chunk_idx;
+};
+
 ////////////////////////////////
 //~ rjf: Cache Types
 
@@ -220,6 +262,14 @@ struct TXT_Shared
   U64 parse_thread_count;
   OS_Handle *parse_threads;
   
+  // lex worker threads
+  OS_Handle lex_job_mutex;
+  OS_Handle lex_job_cv;
+  TXT_LexJob *first_lex_job;
+  TXT_LexJob *last_lex_job;
+  U64 lex_worker_count;
+  OS_Handle *lex_workers;
+  
   // rjf: evictor thread
   OS_Handle evictor_thread;
 };
@@ -234,6 +284,7 @@ global TXT_Shared *txt_shared = 0;
 //~ rjf: Basic Helpers
 
 internal TXT_LangKind txt_lang_kind_from_extension(String8 extension);
+internal U64 txt_line_end_idx_from_string(String8 string, U64 start_idx);
 
 ////////////////////////////////
 //~ rjf: Token Type Functions
@@ -246,8 +297,14 @@ internal TXT_TokenArray txt_token_array_from_list(Arena *arena, TXT_TokenList *l
 ////////////////////////////////
 //~ rjf: Lexing Functions
 
+internal U64 txt_lex_string_range__c_cpp(Arena *arena, TXT_TokenChunkList *tokens_out, U64 *bytes_processed_counter, String8 string, U64 start_idx, U64 sync_min_idx);
 internal TXT_TokenArray txt_token_array_from_string__c_cpp(Arena *arena, U64 *bytes_processed_counter, String8 string);
 
+////////////////////////////////
+//~ Parallel Lexing
+
+internal void txt_lex_job_do_chunks(TXT_LexJob *job);
+
 ////////////////////////////////
 //~ rjf: Main Layer Initialization
 
@@ -282,6 +339,7 @@ internal TXT_TextInfo txt_text_info_from_key_hash_lang(TXT_Scope *scope, U128 ke
 internal B32 txt_u2p_enqueue_req(U128 key, U128 hash, TXT_LangKind lang, U64 endt_us);
 internal void txt_u2p_dequeue_req(U128 *key_out, U128 *hash_out, TXT_LangKind *lang_out);
 internal void txt_parse_thread__entry_point(void *p);
+internal void txt_lex_worker_thread__entry_point(void *p);
 
 ////////////////////////////////
 //~ rjf: Evictor Threads
@@ -31,6 +31,11 @@ txti_init(void)
     thread->thread = os_launch_thread(txti_mut_thread_entry_point, (void *)idx, 0);
   }
   txti_state->detector_thread = os_launch_thread(txti_detector_thread_entry_point, 0, 0);
+  txti_state->watcher = os_file_watcher_alloc();
+  if(!os_handle_match(txti_state->watcher, os_handle_zero()))
+  {
+    txti_state->watcher_thread = os_launch_thread(txti_watcher_thread_entry_point, 0, 0);
+  }
 }
 
 ////////////////////////////////
@@ -72,6 +77,22 @@ txti_lang_kind_from_extension(String8 extension)
   return kind;
 }
 
+internal TXTI_LangLexFunctionType *
+txti_lex_function_from_lang_kind(TXTI_LangKind kind)
+{
+  TXTI_LangLexFunctionType *lex_function = 0;
+  switch(kind)
+  {
+    default:{}break;
+    case TXTI_LangKind_C:
+    case TXTI_LangKind_CPlusPlus:
+    {
+      lex_function = txti_lex__cpp;
+    }break;
+  }
+  return lex_function;
+}
+
 ////////////////////////////////
 //~ rjf: Token Type Functions
 
@@ -134,26 +155,40 @@ txti_token_array_from_list(Arena *arena, TXTI_TokenList *list)
 ////////////////////////////////
 //~ rjf: Lexing Functions
 
-internal TXTI_TokenArray
-txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, String8 string)
+internal void
+txti_lex__cpp(Arena *arena, TXTI_TokenChunkList *tokens_out, U64 *bytes_processed_counter, String8 string, TXTI_LexCheckpoint *checkpoint)
 {
-  Temp scratch = scratch_begin(&arena, 1);
-  
-  //- rjf: generate token list
-  TXTI_TokenChunkList tokens = {0};
+  //- generate token list, resuming from checkpoint
   {
-    B32 comment_is_single_line = 0;
-    B32 string_is_char = 0;
-    TXTI_TokenKind active_token_kind = TXTI_TokenKind_Null;
-    U64 active_token_start_idx = 0;
-    B32 escaped = 0;
-    B32 next_escaped = 0;
-    U64 byte_process_start_idx = 0;
-    for(U64 idx = 0; idx <= string.size;)
+    TXTI_LexCheckpoint next_checkpoint = {0};
+    B32 next_checkpoint_taken = 0;
+    U64 tokens_out_base_count = tokens_out->token_count;
+    B32 comment_is_single_line = checkpoint->comment_is_single_line;
+    B32 string_is_char = checkpoint->string_is_char;
+    TXTI_TokenKind active_token_kind = checkpoint->active_token_kind;
+    U64 active_token_start_idx = checkpoint->active_token_start_idx;
+    B32 escaped = checkpoint->escaped;
+    B32 next_escaped = checkpoint->escaped;
+    U64 byte_process_start_idx = checkpoint->idx;
+    for(U64 idx = checkpoint->idx; idx <= string.size;)
     {
       U8 byte      = (idx+0 < string.size) ? (string.str[idx+0]) : 0;
       U8 next_byte = (idx+1 < string.size) ? (string.str[idx+1]) : 0;
       
+      // store checkpoint before the first byte whose lexing could depend
+      // on bytes past the end of the string - appended data resumes from here
+      if(!next_checkpoint_taken && idx+1 >= string.size)
+      {
+        next_checkpoint_taken = 1;
+        next_checkpoint.idx                    = idx;
+        next_checkpoint.token_count            = checkpoint->token_count + (tokens_out->token_count - tokens_out_base_count);
+        next_checkpoint.active_token_kind      = active_token_kind;
+        next_checkpoint.active_token_start_idx = active_token_start_idx;
+        next_checkpoint.escaped                = escaped;
+        next_checkpoint.comment_is_single_line = comment_is_single_line;
+        next_checkpoint.string_is_char         = string_is_char;
+      }
+      
       // rjf: update counter
       if(bytes_processed_counter != 0 && ((idx-byte_process_start_idx) >= 1000 || idx == string.size))
       {
@@ -211,7 +246,7 @@ txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, St
         else
         {
           TXTI_Token token = {TXTI_TokenKind_Error, r1u64(idx, idx+1)};
-          txti_token_chunk_list_push(scratch.arena, &tokens, 4096, &token);
+          txti_token_chunk_list_push(arena, tokens_out, 4096, &token);
         }
       }
       
@@ -400,7 +435,7 @@ txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, St
         }
         
         // rjf: push
-        txti_token_chunk_list_push(scratch.arena, &tokens, 4096, &token);
+        txti_token_chunk_list_push(arena, tokens_out, 4096, &token);
         
         // rjf: increment by ender padding
         idx += ender_pad;
@@ -413,9 +448,17 @@ txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, St
       }
       escaped = next_escaped;
     }
+    MemoryCopyStruct(checkpoint, &next_checkpoint);
   }
-  
-  //- rjf: token list -> token array
+}
+
+internal TXTI_TokenArray
+txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, String8 string)
+{
+  Temp scratch = scratch_begin(&arena, 1);
+  TXTI_TokenChunkList tokens = {0};
+  TXTI_LexCheckpoint checkpoint = {0};
+  txti_lex__cpp(scratch.arena, &tokens, bytes_processed_counter, string, &checkpoint);
   TXTI_TokenArray result = txti_token_array_from_chunk_list(arena, &tokens);
   scratch_end(scratch);
   return result;
@@ -521,9 +564,12 @@ txti_handle_from_path(String8 path)
         {
           TXTI_Buffer *buffer = &entity->buffers[idx];
           buffer->data_arena = arena_alloc__sized(GB(32), KB(64));
-          buffer->analysis_arena = arena_alloc__sized(GB(32), KB(64));
+          buffer->lines_arena = arena_alloc__sized(GB(32), KB(64));
+          buffer->tokens_arena = arena_alloc__sized(GB(32), KB(64));
           buffer->data_arena->align = 1;
         }
+        entity->is_watched = os_file_watcher_add_path(txti_state->watcher, entity->path);
+        ins_atomic_u64_inc_eval(entity->is_watched ? &txti_state->watched_entity_count : &txti_state->polled_entity_count);
         SLLQueuePush(slot->first, slot->last, entity);
         found_entity = entity;
       }
@@ -925,6 +971,28 @@ txti_append(TXTI_Handle handle, String8 string)
   os_condition_variable_broadcast(mut_thread->msg_cv);
 }
 
+internal void
+txti_set_append_cap(TXTI_Handle handle, U64 cap)
+{
+  U64 hash = handle.u64[0];
+  U64 id = handle.u64[1];
+  U64 slot_idx = hash%txti_state->entity_map.slots_count;
+  U64 stripe_idx = slot_idx%txti_state->entity_map_stripes.count;
+  TXTI_EntitySlot *slot = &txti_state->entity_map.slots[slot_idx];
+  TXTI_Stripe *stripe = &txti_state->entity_map_stripes.v[stripe_idx];
+  OS_MutexScopeR(stripe->rw_mutex)
+  {
+    for(TXTI_Entity *e = slot->first; e != 0; e = e->next)
+    {
+      if(e->id == id)
+      {
+        ins_atomic_u64_eval_assign(&e->append_cap, cap);
+        break;
+      }
+    }
+  }
+}
+
 //- rjf: buffer external change detection enabling/disabling
 
 internal void
@@ -934,6 +1002,158 @@ txti_set_external_change_detection_enabled(B32 enabled)
   ins_atomic_u64_eval_assign(&txti_state->detector_thread_enabled, enabled_u64);
 }
 
+//- external change watching stats
+
+internal TXTI_WatchStats
+txti_watch_stats(void)
+{
+  TXTI_WatchStats stats = {0};
+  stats.os = os_file_watcher_stats(txti_state->watcher);
+  stats.watched_entity_count = ins_atomic_u64_eval(&txti_state->watched_entity_count);
+  stats.polled_entity_count = ins_atomic_u64_eval(&txti_state->polled_entity_count);
+  stats.invalidation_count = ins_atomic_u64_eval(&txti_state->invalidation_count);
+  return stats;
+}
+
+////////////////////////////////
+//~ Buffer Analysis
+
+internal void
+txti_buffer_clear_analysis(TXTI_Buffer *buffer)
+{
+  arena_clear(buffer->lines_arena);
+  arena_clear(buffer->tokens_arena);
+  buffer->lines_count = 0;
+  buffer->lines_ranges = 0;
+  buffer->lines_max_size = 0;
+  MemoryZeroStruct(&buffer->tokens);
+  MemoryZeroStruct(&buffer->lex_checkpoint);
+}
+
+internal void
+txti_buffer_extend_lines(TXTI_Buffer *buffer, U64 *bytes_processed_counter)
+{
+  //- pick line to re-split from. the last line is open-ended. if the line
+  // before it was ended by a '\r' that was the last byte, the byte which that
+  // '\r' skips had not arrived yet, so that line must be re-split too.
+  U64 line_idx = 0;
+  U64 line_start_idx = 0;
+  if(buffer->lines_count != 0)
+  {
+    line_idx = buffer->lines_count-1;
+    if(line_idx != 0 &&
+       buffer->data.str[buffer->lines_ranges[line_idx-1].max] == '\r' &&
+       buffer->lines_ranges[line_idx-1].max+1 == buffer->lines_ranges[line_idx].min)
+    {
+      line_idx -= 1;
+    }
+    line_start_idx = buffer->lines_ranges[line_idx].min;
+    arena_put_back(buffer->lines_arena, (buffer->lines_count-line_idx)*sizeof(Rng1U64));
+    buffer->lines_count = line_idx;
+  }
+  
+  //- split lines, extending line ranges array in-place
+  U64 byte_process_start_idx = line_start_idx;
+  for(;;)
+  {
+    U64 line_end_idx = line_start_idx;
+    for(;line_end_idx < buffer->data.size && buffer->data.str[line_end_idx] != '\n' && buffer->data.str[line_end_idx] != '\r'; line_end_idx += 1);
+    Rng1U64 *line_range = push_array_no_zero(buffer->lines_arena, Rng1U64, 1);
+    if(buffer->lines_count == 0)
+    {
+      buffer->lines_ranges = line_range;
+    }
+    *line_range = r1u64(line_start_idx, line_end_idx);
+    buffer->lines_count += 1;
+    buffer->lines_max_size = Max(buffer->lines_max_size, dim_1u64(*line_range));
+    if(bytes_processed_counter != 0 && line_end_idx-byte_process_start_idx >= 1000)
+    {
+      ins_atomic_u64_add_eval(bytes_processed_counter, (line_end_idx-byte_process_start_idx));
+      byte_process_start_idx = line_end_idx;
+    }
+    if(line_end_idx >= buffer->data.size)
+    {
+      break;
+    }
+    line_start_idx = line_end_idx+1;
+    if(buffer->data.str[line_end_idx] == '\r')
+    {
+      line_start_idx += 1;
+    }
+    line_start_idx = Min(line_start_idx, buffer->data.size);
+  }
+}
+
+internal void
+txti_buffer_extend_tokens(TXTI_Buffer *buffer, TXTI_LangLexFunctionType *lex_function, U64 *bytes_processed_counter)
+{
+  Temp scratch = scratch_begin(0, 0);
+  
+  //- drop provisional tokens (those finalized by the old end of data)
+  U64 stable_token_count = Min(buffer->lex_checkpoint.token_count, buffer->tokens.count);
+  arena_put_back(buffer->tokens_arena, (buffer->tokens.count-stable_token_count)*sizeof(TXTI_Token));
+  buffer->tokens.count = stable_token_count;
+  
+  //- lex from checkpoint
+  TXTI_TokenChunkList tokens = {0};
+  lex_function(scratch.arena, &tokens, bytes_processed_counter, buffer->data, &buffer->lex_checkpoint);
+  
+  //- extend token array in-place
+  TXTI_Token *tokens_dst = push_array_no_zero(buffer->tokens_arena, TXTI_Token, tokens.token_count);
+  if(buffer->tokens.count == 0)
+  {
+    buffer->tokens.v = tokens_dst;
+  }
+  for(TXTI_TokenChunkNode *n = tokens.first; n != 0; n = n->next)
+  {
+    MemoryCopy(buffer->tokens.v+buffer->tokens.count, n->v, n->count*sizeof(TXTI_Token));
+    buffer->tokens.count += n->count;
+  }
+  
+  scratch_end(scratch);
+}
+
+internal B32
+txti_buffer_trim_to_cap(TXTI_Buffer *buffer, U64 cap)
+{
+  B32 trimmed = 0;
+  if(cap != 0 && buffer->data.size > cap && buffer->lines_count > 1)
+  {
+    //- keep the newest 3/4 of the cap; trimming costs the size of the kept
+    // data, so this bounds it to once per cap/4 appended bytes
+    U64 keep_size = cap - cap/4;
+    U64 cut_min_idx = buffer->data.size - keep_size;
+    
+    //- binary search for first line starting at/after the cut
+    U64 min_idx = 1;
+    U64 opl_idx = buffer->lines_count;
+    for(;min_idx < opl_idx;)
+    {
+      U64 mid_idx = (min_idx+opl_idx)/2;
+      if(buffer->lines_ranges[mid_idx].min < cut_min_idx)
+      {
+        min_idx = mid_idx+1;
+      }
+      else
+      {
+        opl_idx = mid_idx;
+      }
+    }
+    
+    //- drop all data before that line; analysis must be rebuilt
+    if(min_idx < buffer->lines_count)
+    {
+      U64 drop_size = buffer->lines_ranges[min_idx].min;
+      MemoryCopy(buffer->data.str, buffer->data.str+drop_size, buffer->data.size-drop_size);
+      arena_put_back(buffer->data_arena, drop_size);
+      buffer->data.size -= drop_size;
+      txti_buffer_clear_analysis(buffer);
+      trimmed = 1;
+    }
+  }
+  return trimmed;
+}
+
 ////////////////////////////////
 //~ rjf: Mutator Threads
 
@@ -998,16 +1218,7 @@ txti_mut_thread_entry_point(void *p)
       }
       
       //- rjf: nonzero lang kind -> unpack lang info
-      TXTI_LangLexFunctionType *lex_function = 0;
-      switch(lang_kind)
-      {
-        default:{}break;
-        case TXTI_LangKind_C:
-        case TXTI_LangKind_CPlusPlus:
-        {
-          lex_function = txti_token_array_from_string__cpp;
-        }break;
-      }
+      TXTI_LangLexFunctionType *lex_function = txti_lex_function_from_lang_kind(lang_kind);
       
       //- rjf: detect line end kind
       TXTI_LineEndKind line_end_kind = TXTI_LineEndKind_Null;
@@ -1036,8 +1247,10 @@ txti_mut_thread_entry_point(void *p)
         }
       }
       
-      //- rjf: obtain initial buffer_apply_gen, reset byte processing counters
+      //- obtain initial buffer_apply_gen, reset byte processing counters,
+      // unpack lang info & append cap for appends
       U64 initial_buffer_apply_gen = 0;
+      U64 append_cap = 0;
       ProfScope("obtain initial buffer_apply_gen") OS_MutexScopeR(stripe->rw_mutex)
       {
         TXTI_Entity *entity = 0;
@@ -1057,6 +1270,11 @@ txti_mut_thread_entry_point(void *p)
             ins_atomic_u64_eval_assign(&entity->bytes_processed, 0);
             ins_atomic_u64_eval_assign(&entity->bytes_to_process, file_contents.size + !!lex_function*file_contents.size);
           }
+          if(msg->kind == TXTI_MsgKind_Append)
+          {
+            lex_function = txti_lex_function_from_lang_kind(entity->lang_kind);
+            append_cap = ins_atomic_u64_eval(&entity->append_cap);
+          }
         }
       }
       
@@ -1126,19 +1344,13 @@ txti_mut_thread_entry_point(void *p)
             {
               TXTI_Buffer *buffer = &entity->buffers[(initial_buffer_apply_gen+1+buffer_apply_idx)%TXTI_ENTITY_BUFFER_COUNT];
               
-              // rjf: clear old analysis data
-              arena_clear(buffer->analysis_arena);
-              buffer->lines_count = 0;
-              buffer->lines_ranges = 0;
-              buffer->lines_max_size = 0;
-              MemoryZeroStruct(&buffer->tokens);
-              
               // rjf: perform edit to buffer data
               switch(msg->kind)
               {
                 default:{}break;
                 
-                // rjf: replace range
+                // append - data arena holds only the data, so this
+                // extends it in-place
                 case TXTI_MsgKind_Append: ProfScope("append")
                 {
                   U8 *append_data_buffer = push_array_no_zero(buffer->data_arena, U8, msg->string.size);
@@ -1150,75 +1362,42 @@ txti_mut_thread_entry_point(void *p)
                   }
                 }break;
                 
-                // rjf: reload from disk
+                // reload from disk - no null terminator, so that later
+                // appends stay contiguous
                 case TXTI_MsgKind_Reload: ProfScope("reload")
                 {
                   arena_clear(buffer->data_arena);
+                  MemoryZeroStruct(&buffer->data);
                   if(file_contents.size != 0)
                   {
-                    buffer->data = push_str8_copy(buffer->data_arena, file_contents);
-                  }
-                  else
-                  {
-                    MemoryZeroStruct(&buffer->data);
+                    buffer->data.str = push_array_no_zero(buffer->data_arena, U8, file_contents.size);
+                    buffer->data.size = file_contents.size;
+                    MemoryCopy(buffer->data.str, file_contents.str, file_contents.size);
                   }
+                  txti_buffer_clear_analysis(buffer);
                 }break;
               }
               
-              // rjf: parse & store line range info
+              // parse & store line range info (appends only re-split
+              // the last line onward)
               ProfScope("parse & store line range info")
               {
-                // rjf: count # of lines
-                U64 line_count = 1;
-                U64 byte_process_start_idx = 0;
-                for(U64 idx = 0; idx < buffer->data.size; idx += 1)
+                txti_buffer_extend_lines(buffer, buffer_apply_idx == 0 ? &entity->bytes_processed : 0);
+              }
+              
+              // over append cap -> drop oldest lines, re-split the rest
+              if(msg->kind == TXTI_MsgKind_Append && append_cap != 0 && buffer->data.size > append_cap) ProfScope("trim to append cap")
+              {
+                if(txti_buffer_trim_to_cap(buffer, append_cap))
                 {
-                  if(buffer_apply_idx == 0 && idx-byte_process_start_idx >= 1000)
-                  {
-                    ins_atomic_u64_add_eval(&entity->bytes_processed, (idx-byte_process_start_idx));
-                    byte_process_start_idx = idx;
-                  }
-                  if(buffer->data.str[idx] == '\n' || buffer->data.str[idx] == '\r')
-                  {
-                    line_count += 1;
-                    if(buffer->data.str[idx] == '\r')
-                    {
-                      idx += 1;
-                    }
-                  }
-                }
-                
-                // rjf: allocate & store line ranges
-                ProfScope("allocate & store line ranges")
-                {
-                  buffer->lines_count = line_count;
-                  buffer->lines_ranges = push_array_no_zero(buffer->analysis_arena, Rng1U64, buffer->lines_count);
-                  U64 line_idx = 0;
-                  U64 line_start_idx = 0;
-                  for(U64 idx = 0; idx <= buffer->data.size; idx += 1)
-                  {
-                    if(idx == buffer->data.size || buffer->data.str[idx] == '\n' || buffer->data.str[idx] == '\r')
-                    {
-                      Rng1U64 line_range = r1u64(line_start_idx, idx);
-                      U64 line_size = dim_1u64(line_range);
-                      buffer->lines_ranges[line_idx] = line_range;
-                      buffer->lines_max_size = Max(buffer->lines_max_size, line_size);
-                      line_idx += 1;
-                      line_start_idx = idx+1;
-                      if(idx < buffer->data.size && buffer->data.str[idx] == '\r')
-                      {
-                        line_start_idx += 1;
-                        idx += 1;
-                      }
-                    }
-                  }
+                  txti_buffer_extend_lines(buffer, 0);
                 }
               }
               
-              // rjf: lex file contents
+              // lex file contents (appends resume from the checkpoint)
               if(lex_function != 0) ProfScope("lex text")
               {
-                buffer->tokens = lex_function(buffer->analysis_arena, buffer_apply_idx == 0 ? &entity->bytes_processed : 0, buffer->data);
+                txti_buffer_extend_tokens(buffer, lex_function, buffer_apply_idx == 0 ? &entity->bytes_processed : 0);
               }
               
               // rjf: mark final process counter
@@ -1246,6 +1425,29 @@ txti_mut_thread_entry_point(void *p)
 ////////////////////////////////
 //~ rjf: Detector Thread
 
+internal void
+txti_entity_detect_external_change(TXTI_Entity *entity)
+{
+  // NOTE: the pending flag is cleared before the stat, so a change landing
+  // after the stat re-marks the entity rather than being lost.
+  ins_atomic_u64_eval_assign(&entity->change_pending, 0);
+  FileProperties props = os_properties_from_file_path(entity->path);
+  U64 entity_timestamp = entity->timestamp;
+  if(props.modified != entity_timestamp)
+  {
+    if(ins_atomic_u64_eval(&entity->working_count) == 0)
+    {
+      TXTI_Handle handle = {txti_hash_from_string(entity->path), entity->id};
+      txti_reload(handle, entity->path);
+      ins_atomic_u64_inc_eval(&entity->working_count);
+    }
+    else
+    {
+      ins_atomic_u64_eval_assign(&entity->change_pending, 1);
+    }
+  }
+}
+
 internal void
 txti_detector_thread_entry_point(void *p)
 {
@@ -1266,13 +1468,9 @@ txti_detector_thread_entry_point(void *p)
           TXTI_EntitySlot *slot = &txti_state->entity_map.slots[slot_idx];
           for(TXTI_Entity *entity = slot->first; entity != 0; entity = entity->next)
           {
-            FileProperties props = os_properties_from_file_path(entity->path);
-            U64 entity_timestamp = entity->timestamp;
-            if(props.modified != entity_timestamp && ins_atomic_u64_eval(&entity->working_count) == 0)
+            if(!entity->is_watched || ins_atomic_u64_eval(&entity->change_pending))
             {
-              TXTI_Handle handle = {txti_hash_from_string(entity->path), entity->id};
-              txti_reload(handle, entity->path);
-              ins_atomic_u64_inc_eval(&entity->working_count);
+              txti_entity_detect_external_change(entity);
             }
           }
         }
@@ -1281,3 +1479,45 @@ txti_detector_thread_entry_point(void *p)
     os_sleep_milliseconds(100);
   }
 }
+
+////////////////////////////////
+//~ Watcher Thread
+
+internal void
+txti_watcher_thread_entry_point(void *p)
+{
+  TCTX tctx_;
+  tctx_init_and_equip(&tctx_);
+  ProfThreadName("[txti] watcher");
+  for(;;)
+  {
+    Temp scratch = scratch_begin(0, 0);
+    String8List paths = os_file_watcher_wait(scratch.arena, txti_state->watcher, max_U64);
+    B32 detection_enabled = !!ins_atomic_u64_eval(&txti_state->detector_thread_enabled);
+    for(String8Node *n = paths.first; n != 0; n = n->next)
+    {
+      U64 hash = txti_hash_from_string(n->string);
+      U64 slot_idx = hash%txti_state->entity_map.slots_count;
+      U64 stripe_idx = slot_idx%txti_state->entity_map_stripes.count;
+      TXTI_EntitySlot *slot = &txti_state->entity_map.slots[slot_idx];
+      TXTI_Stripe *stripe = &txti_state->entity_map_stripes.v[stripe_idx];
+      OS_MutexScopeR(stripe->rw_mutex)
+      {
+        for(TXTI_Entity *entity = slot->first; entity != 0; entity = entity->next)
+        {
+          if(str8_match(entity->path, n->string, 0))
+          {
+            ins_atomic_u64_inc_eval(&txti_state->invalidation_count);
+            ins_atomic_u64_eval_assign(&entity->change_pending, 1);
+            if(detection_enabled)
+            {
+              txti_entity_detect_external_change(entity);
+            }
+            break;
+          }
+        }
+      }
+    }
+    scratch_end(scratch);
+  }
+}
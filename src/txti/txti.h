@@ -46,6 +46,12 @@
 // for multiple mutator threads to be attempting to write to the same entity at
 // the same time, as this could not produce meaningful or coherent results.
 // This way, all edits to each entity are applied serially.
+//
+// Appends (e.g. debug output streaming into a log) are analyzed incrementally:
+// only the last, still-open line is re-split, and lexing resumes from a
+// checkpoint stored with the buffer, so each append costs time proportional
+// to the appended data. An entity may also be given an append cap -- once its
+// data exceeds the cap, the oldest lines are dropped.
 
 ////////////////////////////////
 //~ rjf: Handle Type
@@ -150,7 +156,24 @@ typedef enum TXTI_LangKind
 }
 TXTI_LangKind;
 
-typedef TXTI_TokenArray TXTI_LangLexFunctionType(Arena *arena, U64 *bytes_processed_counter, String8 string);
+// NOTE: lexers are resumable, so that appends only need to lex new data.
+// the checkpoint records the lexer state just before the first byte whose
+// lexing could depend on bytes past the end of the lexed string, and the
+// number of tokens emitted before that point. tokens past `token_count` are
+// provisional - they were finalized by the end of the string.
+typedef struct TXTI_LexCheckpoint TXTI_LexCheckpoint;
+struct TXTI_LexCheckpoint
+{
+  U64 idx;
+  U64 token_count;
+  TXTI_TokenKind active_token_kind;
+  U64 active_token_start_idx;
+  B32 escaped;
+  B32 comment_is_single_line;
+  B32 string_is_char;
+};
+
+typedef void TXTI_LangLexFunctionType(Arena *arena, TXTI_TokenChunkList *tokens_out, U64 *bytes_processed_counter, String8 string, TXTI_LexCheckpoint *checkpoint);
 
 ////////////////////////////////
 //~ rjf: Buffer Entity Types
@@ -160,9 +183,11 @@ typedef TXTI_TokenArray TXTI_LangLexFunctionType(Arena *arena, U64 *bytes_proces
 typedef struct TXTI_Buffer TXTI_Buffer;
 struct TXTI_Buffer
 {
-  // rjf: arenas
+  // arenas (each holds exactly one contiguous array, so that appends
+  // can extend it in place)
   Arena *data_arena;
-  Arena *analysis_arena;
+  Arena *lines_arena;
+  Arena *tokens_arena;
   
   // rjf: raw textual data
   String8 data;
@@ -174,6 +199,7 @@ struct TXTI_Buffer
   
   // rjf: tokens
   TXTI_TokenArray tokens;
+  TXTI_LexCheckpoint lex_checkpoint;
 };
 
 typedef struct TXTI_Entity TXTI_Entity;
@@ -192,6 +218,11 @@ struct TXTI_Entity
   U64 bytes_processed;
   U64 bytes_to_process;
   U64 working_count;
+  U64 append_cap;
+  
+  // external change watching
+  B32 is_watched;
+  U64 change_pending;
   
   // rjf: double-buffered mutable text buffers
   U64 buffer_apply_gen;
@@ -249,6 +280,15 @@ struct TXTI_BufferInfo
   U64 bytes_to_process;
 };
 
+typedef struct TXTI_WatchStats TXTI_WatchStats;
+struct TXTI_WatchStats
+{
+  OS_FileWatcherStats os;
+  U64 watched_entity_count;
+  U64 polled_entity_count;
+  U64 invalidation_count;
+};
+
 typedef struct TXTI_Slice TXTI_Slice;
 struct TXTI_Slice
 {
@@ -324,6 +364,14 @@ struct TXTI_State
   // rjf: detector thread
   U64 detector_thread_enabled;
   OS_Handle detector_thread;
+  
+  // watcher thread (pushes OS change notifications into entities; the
+  // detector thread then only polls entities which could not be watched)
+  OS_Handle watcher;
+  OS_Handle watcher_thread;
+  U64 watched_entity_count;
+  U64 polled_entity_count;
+  U64 invalidation_count;
 };
 
 ////////////////////////////////
@@ -341,6 +389,7 @@ internal void txti_init(void);
 
 internal U64 txti_hash_from_string(String8 string);
 internal TXTI_LangKind txti_lang_kind_from_extension(String8 extension);
+internal TXTI_LangLexFunctionType *txti_lex_function_from_lang_kind(TXTI_LangKind kind);
 
 ////////////////////////////////
 //~ rjf: Token Type Functions
@@ -353,6 +402,7 @@ internal TXTI_TokenArray txti_token_array_from_list(Arena *arena, TXTI_TokenList
 ////////////////////////////////
 //~ rjf: Lexing Functions
 
+internal void txti_lex__cpp(Arena *arena, TXTI_TokenChunkList *tokens_out, U64 *bytes_processed_counter, String8 string, TXTI_LexCheckpoint *checkpoint);
 internal TXTI_TokenArray txti_token_array_from_string__cpp(Arena *arena, U64 *bytes_processed_counter, String8 string);
 
 ////////////////////////////////
@@ -379,10 +429,22 @@ internal TxtRng txti_expr_range_from_handle_pt(TXTI_Handle handle, TxtPt pt);
 //- rjf: buffer mutations
 internal void txti_reload(TXTI_Handle handle, String8 path);
 internal void txti_append(TXTI_Handle handle, String8 string);
+internal void txti_set_append_cap(TXTI_Handle handle, U64 cap);
 
 //- rjf: buffer external change detection enabling/disabling
 internal void txti_set_external_change_detection_enabled(B32 enabled);
 
+//- external change watching stats
+internal TXTI_WatchStats txti_watch_stats(void);
+
+////////////////////////////////
+//~ Buffer Analysis
+
+internal void txti_buffer_clear_analysis(TXTI_Buffer *buffer);
+internal void txti_buffer_extend_lines(TXTI_Buffer *buffer, U64 *bytes_processed_counter);
+internal void txti_buffer_extend_tokens(TXTI_Buffer *buffer, TXTI_LangLexFunctionType *lex_function, U64 *bytes_processed_counter);
+internal B32 txti_buffer_trim_to_cap(TXTI_Buffer *buffer, U64 cap);
+
 ////////////////////////////////
 //~ rjf: Mutator Threads
 
@@ -391,6 +453,12 @@ internal void txti_mut_thread_entry_point(void *p);
 ////////////////////////////////
 //~ rjf: Detector Thread
 
+internal void txti_entity_detect_external_change(TXTI_Entity *entity);
 internal void txti_detector_thread_entry_point(void *p);
 
+////////////////////////////////
+//~ Watcher Thread
+
+internal void txti_watcher_thread_entry_point(void *p);
+
 #endif //TXTI_H
@@ -219,6 +219,34 @@ tg_graph_begin(U64 address_size, U64 slot_count)
   return graph;
 }
 
+internal TG_Graph *
+tg_graph_alloc(U64 address_size, U64 slot_count, RADDBG_Parsed *rdbg)
+{
+  Arena *arena = arena_alloc();
+  TG_Graph *graph = push_array(arena, TG_Graph, 1);
+  graph->address_size = address_size;
+  graph->content_hash_slots_count = slot_count;
+  graph->content_hash_slots = push_array(arena, TG_Slot, graph->content_hash_slots_count);
+  graph->key_hash_slots_count = slot_count;
+  graph->key_hash_slots = push_array(arena, TG_Slot, graph->key_hash_slots_count);
+  graph->arena = arena;
+  graph->mutex = os_mutex_alloc();
+  graph->rdbg = rdbg;
+  graph->cache_slots_count = slot_count;
+  graph->cache_slots = push_array(arena, TG_CacheSlot, graph->cache_slots_count);
+  return graph;
+}
+
+internal void
+tg_graph_release(TG_Graph *graph)
+{
+  if(graph != 0 && graph->arena != 0)
+  {
+    os_mutex_release(graph->mutex);
+    arena_release(graph->arena);
+  }
+}
+
 internal TG_Key
 tg_cons_type_make(TG_Graph *graph, TG_Kind kind, TG_Key direct_type_key, U64 u64)
 {
@@ -236,7 +264,7 @@ tg_cons_type_make(TG_Graph *graph, TG_Kind kind, TG_Key direct_type_key, U64 u64
   U64 content_slot_idx = content_hash%graph->content_hash_slots_count;
   TG_Slot *content_slot = &graph->content_hash_slots[content_slot_idx];
   TG_Node *node = 0;
-  for(TG_Node *n = content_slot->first; n != 0; n = n->content_hash_next)
+  for(TG_Node *n = *(TG_Node *volatile *)&content_slot->first; n != 0; n = *(TG_Node *volatile *)&n->content_hash_next)
   {
     if(n->cons_type.kind == kind && tg_key_match(n->cons_type.direct_type_key, direct_type_key))
     {
@@ -244,37 +272,170 @@ tg_cons_type_make(TG_Graph *graph, TG_Kind kind, TG_Key direct_type_key, U64 u64
       break;
     }
   }
-  TG_Key result = zero_struct;
   if(node == 0)
   {
-    TG_Key key = {TG_KeyKind_Cons};
-    key.u32[0] = (U32)kind;
-    key.u64[0] = graph->cons_id_gen;
-    U64 key_hash = tg_hash_from_string(5381, str8_struct(&key));
-    U64 key_slot_idx = key_hash%graph->key_hash_slots_count;
-    TG_Slot *key_slot = &graph->key_hash_slots[key_slot_idx];
-    graph->cons_id_gen += 1;
-    TG_Node *node = push_array(tg_build_arena, TG_Node, 1);
-    SLLQueuePush_N(content_slot->first, content_slot->last, node, content_hash_next);
-    SLLQueuePush_N(key_slot->first, key_slot->last, node, key_hash_next);
-    node->key = key;
-    node->cons_type.kind = kind;
-    node->cons_type.direct_type_key = direct_type_key;
-    node->cons_type.u64 = u64;
-    result = key;
-  }
-  else
-  {
-    result = node->key;
+    // shared graphs are built by many threads - serialize writers, &
+    // re-check, since another thread may have made this type since we looked
+    B32 is_shared = (graph->arena != 0);
+    Arena *arena = is_shared ? graph->arena : tg_build_arena;
+    if(is_shared)
+    {
+      os_mutex_take(graph->mutex);
+      for(TG_Node *n = content_slot->first; n != 0; n = n->content_hash_next)
+      {
+        if(n->cons_type.kind == kind && tg_key_match(n->cons_type.direct_type_key, direct_type_key))
+        {
+          node = n;
+          break;
+        }
+      }
+    }
+    if(node == 0)
+    {
+      TG_Key key = {TG_KeyKind_Cons};
+      key.u32[0] = (U32)kind;
+      key.u64[0] = graph->cons_id_gen;
+      U64 key_hash = tg_hash_from_string(5381, str8_struct(&key));
+      U64 key_slot_idx = key_hash%graph->key_hash_slots_count;
+      TG_Slot *key_slot = &graph->key_hash_slots[key_slot_idx];
+      graph->cons_id_gen += 1;
+      node = push_array(arena, TG_Node, 1);
+      node->key = key;
+      node->cons_type.kind = kind;
+      node->cons_type.direct_type_key = direct_type_key;
+      node->cons_type.u64 = u64;
+      
+      // publish fully-formed node to lock-free readers; key slot first, so
+      // that any key found through the content slot is always resolvable
+      if(key_slot->last == 0) { ins_atomic_ptr_eval_assign(&key_slot->first, node); }
+      else { ins_atomic_ptr_eval_assign(&key_slot->last->key_hash_next, node); }
+      key_slot->last = node;
+      if(content_slot->last == 0) { ins_atomic_ptr_eval_assign(&content_slot->first, node); }
+      else { ins_atomic_ptr_eval_assign(&content_slot->last->content_hash_next, node); }
+      content_slot->last = node;
+    }
+    if(is_shared)
+    {
+      os_mutex_drop(graph->mutex);
+    }
   }
+  TG_Key result = node->key;
   return result;
 }
 
 ////////////////////////////////
 //~ rjf: Graph Introspection API
 
+internal TG_CacheNode *
+tg_cache_node_from_graph_raddbg_key(TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
+{
+  TG_CacheNode *node = 0;
+  if(graph->arena != 0 && graph->rdbg == rdbg && key.kind != TG_KeyKind_Null)
+  {
+    U64 hash = tg_hash_from_string(5381, str8_struct(&key));
+    U64 slot_idx = hash%graph->cache_slots_count;
+    TG_CacheSlot *slot = &graph->cache_slots[slot_idx];
+    for(TG_CacheNode *n = *(TG_CacheNode *volatile *)&slot->first; n != 0; n = *(TG_CacheNode *volatile *)&n->hash_next)
+    {
+      if(tg_key_match(n->key, key))
+      {
+        node = n;
+        break;
+      }
+    }
+    if(node == 0) OS_MutexScope(graph->mutex)
+    {
+      for(TG_CacheNode *n = slot->first; n != 0; n = n->hash_next)
+      {
+        if(tg_key_match(n->key, key))
+        {
+          node = n;
+          break;
+        }
+      }
+      if(node == 0)
+      {
+        node = push_array(graph->arena, TG_CacheNode, 1);
+        node->key = key;
+        if(slot->last == 0) { ins_atomic_ptr_eval_assign(&slot->first, node); }
+        else { ins_atomic_ptr_eval_assign(&slot->last->hash_next, node); }
+        slot->last = node;
+      }
+    }
+  }
+  return node;
+}
+
+internal TG_Type *
+tg_type_copy(Arena *arena, TG_Type *src)
+{
+  TG_Type *dst = src;
+  if(src != &tg_type_nil && src != &tg_type_variadic)
+  {
+    dst = push_array(arena, TG_Type, 1);
+    MemoryCopyStruct(dst, src);
+    dst->name = push_str8_copy(arena, src->name);
+    if(src->param_type_keys != 0)
+    {
+      dst->param_type_keys = push_array_no_zero(arena, TG_Key, src->count);
+      MemoryCopy(dst->param_type_keys, src->param_type_keys, sizeof(TG_Key)*src->count);
+    }
+    if(src->members != 0)
+    {
+      dst->members = push_array_no_zero(arena, TG_Member, src->count);
+      for(U64 idx = 0; idx < src->count; idx += 1)
+      {
+        MemoryCopyStruct(&dst->members[idx], &src->members[idx]);
+        dst->members[idx].name = push_str8_copy(arena, src->members[idx].name);
+        dst->members[idx].inheritance_key_chain = tg_key_list_copy(arena, &src->members[idx].inheritance_key_chain);
+      }
+    }
+    if(src->enum_vals != 0)
+    {
+      dst->enum_vals = push_array_no_zero(arena, TG_EnumVal, src->count);
+      for(U64 idx = 0; idx < src->count; idx += 1)
+      {
+        dst->enum_vals[idx].name = push_str8_copy(arena, src->enum_vals[idx].name);
+        dst->enum_vals[idx].val  = src->enum_vals[idx].val;
+      }
+    }
+  }
+  return dst;
+}
+
 internal TG_Type *
 tg_type_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
+{
+  TG_Type *type = &tg_type_nil;
+  TG_CacheNode *cache_node = tg_cache_node_from_graph_raddbg_key(graph, rdbg, key);
+  if(cache_node == 0)
+  {
+    type = tg_type_from_graph_raddbg_key__uncached(arena, graph, rdbg, key);
+  }
+  else
+  {
+    type = *(TG_Type *volatile *)&cache_node->type;
+    if(type == 0)
+    {
+      Temp scratch = scratch_begin(&arena, 1);
+      TG_Type *computed = tg_type_from_graph_raddbg_key__uncached(scratch.arena, graph, rdbg, key);
+      OS_MutexScope(graph->mutex)
+      {
+        type = cache_node->type;
+        if(type == 0)
+        {
+          type = tg_type_copy(graph->arena, computed);
+          ins_atomic_ptr_eval_assign(&cache_node->type, type);
+        }
+      }
+      scratch_end(scratch);
+    }
+  }
+  return type;
+}
+
+internal TG_Type *
+tg_type_from_graph_raddbg_key__uncached(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
 {
   TG_Type *type = &tg_type_nil;
   U64 reg_byte_count = 0;
@@ -302,7 +463,7 @@ tg_type_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg
         U64 key_hash = tg_hash_from_string(5381, str8_struct(&key));
         U64 key_slot_idx = key_hash%graph->key_hash_slots_count;
         TG_Slot *key_slot = &graph->key_hash_slots[key_slot_idx];
-        for(TG_Node *node = key_slot->first; node != 0; node = node->key_hash_next)
+        for(TG_Node *node = *(TG_Node *volatile *)&key_slot->first; node != 0; node = *(TG_Node *volatile *)&node->key_hash_next)
         {
           if(tg_key_match(node->key, key))
           {
@@ -944,6 +1105,16 @@ tg_members_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *r
 {
   TG_MemberArray result = {0};
   Temp scratch = scratch_begin(&arena, 1);
+  if(tg_cache_node_from_graph_raddbg_key(graph, rdbg, key) != 0)
+  {
+    TG_Type *type = tg_type_from_graph_raddbg_key(scratch.arena, graph, rdbg, key);
+    if(type->members != 0)
+    {
+      result.count = type->count;
+      result.v = type->members;
+    }
+  }
+  else
   {
     TG_Type *type = tg_type_from_graph_raddbg_key(scratch.arena, graph, rdbg, key);
     if(type->members != 0)
@@ -963,6 +1134,46 @@ tg_members_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *r
 
 internal TG_MemberArray
 tg_data_members_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
+{
+  TG_MemberArray result = {0};
+  TG_CacheNode *cache_node = tg_cache_node_from_graph_raddbg_key(graph, rdbg, key);
+  if(cache_node == 0)
+  {
+    result = tg_data_members_from_graph_raddbg_key__uncached(arena, graph, rdbg, key);
+  }
+  else
+  {
+    TG_MemberArray *members = *(TG_MemberArray *volatile *)&cache_node->data_members;
+    if(members == 0)
+    {
+      Temp scratch = scratch_begin(&arena, 1);
+      TG_MemberArray computed = tg_data_members_from_graph_raddbg_key__uncached(scratch.arena, graph, rdbg, key);
+      OS_MutexScope(graph->mutex)
+      {
+        members = cache_node->data_members;
+        if(members == 0)
+        {
+          members = push_array(graph->arena, TG_MemberArray, 1);
+          members->count = computed.count;
+          members->v = push_array(graph->arena, TG_Member, members->count);
+          for(U64 idx = 0; idx < computed.count; idx += 1)
+          {
+            MemoryCopyStruct(&members->v[idx], &computed.v[idx]);
+            members->v[idx].name = push_str8_copy(graph->arena, computed.v[idx].name);
+            members->v[idx].inheritance_key_chain = tg_key_list_copy(graph->arena, &computed.v[idx].inheritance_key_chain);
+          }
+          ins_atomic_ptr_eval_assign(&cache_node->data_members, members);
+        }
+      }
+      scratch_end(scratch);
+    }
+    result = *members;
+  }
+  return result;
+}
+
+internal TG_MemberArray
+tg_data_members_from_graph_raddbg_key__uncached(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
 {
   Temp scratch = scratch_begin(&arena, 1);
   TG_Kind root_type_kind = tg_kind_from_key(key);
@@ -1325,11 +1536,35 @@ tg_rhs_string_from_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Ke
 internal String8
 tg_string_from_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key)
 {
-  Temp scratch = scratch_begin(&arena, 1);
-  String8List list = {0};
-  tg_lhs_string_from_key(scratch.arena, graph, rdbg, key, &list, 0, 0);
-  tg_rhs_string_from_key(scratch.arena, graph, rdbg, key, &list, 0);
-  String8 result = str8_list_join(arena, &list, 0);
-  scratch_end(scratch);
+  String8 result = {0};
+  TG_CacheNode *cache_node = tg_cache_node_from_graph_raddbg_key(graph, rdbg, key);
+  String8 *cached = (cache_node != 0) ? *(String8 *volatile *)&cache_node->string : 0;
+  if(cached != 0)
+  {
+    result = *cached;
+  }
+  else
+  {
+    Temp scratch = scratch_begin(&arena, 1);
+    String8List list = {0};
+    tg_lhs_string_from_key(scratch.arena, graph, rdbg, key, &list, 0, 0);
+    tg_rhs_string_from_key(scratch.arena, graph, rdbg, key, &list, 0);
+    if(cache_node == 0)
+    {
+      result = str8_list_join(arena, &list, 0);
+    }
+    else OS_MutexScope(graph->mutex)
+    {
+      cached = cache_node->string;
+      if(cached == 0)
+      {
+        cached = push_array(graph->arena, String8, 1);
+        *cached = str8_list_join(graph->arena, &list, 0);
+        ins_atomic_ptr_eval_assign(&cache_node->string, cached);
+      }
+      result = *cached;
+    }
+    scratch_end(scratch);
+  }
   return result;
 }
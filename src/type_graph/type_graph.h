@@ -73,6 +73,8 @@ struct TG_Slot
   TG_Node *last;
 };
 
+typedef struct TG_CacheSlot TG_CacheSlot;
+
 typedef struct TG_Graph TG_Graph;
 struct TG_Graph
 {
@@ -82,6 +84,15 @@ struct TG_Graph
   TG_Slot *content_hash_slots;
   U64 key_hash_slots_count;
   TG_Slot *key_hash_slots;
+  
+  // shared graphs only (tg_graph_alloc) - these live as long as the
+  // debug info they're built for, are used by many threads at once, & cache
+  // resolved info for `rdbg`. writers take `mutex`; readers never lock.
+  Arena *arena;
+  OS_Handle mutex;
+  RADDBG_Parsed *rdbg;
+  U64 cache_slots_count;
+  TG_CacheSlot *cache_slots;
 };
 
 ////////////////////////////////
@@ -173,6 +184,25 @@ struct TG_Type
   TG_EnumVal *enum_vals;
 };
 
+////////////////////////////////
+//~ Shared Graph Cache Types
+
+typedef struct TG_CacheNode TG_CacheNode;
+struct TG_CacheNode
+{
+  TG_CacheNode *hash_next;
+  TG_Key key;
+  TG_Type *type;
+  TG_MemberArray *data_members;
+  String8 *string;
+};
+
+struct TG_CacheSlot
+{
+  TG_CacheNode *first;
+  TG_CacheNode *last;
+};
+
 ////////////////////////////////
 //~ rjf: Globals
 
@@ -220,12 +250,22 @@ internal B32 tg_key_match(TG_Key a, TG_Key b);
 //~ rjf: Graph Construction API
 
 internal TG_Graph *tg_graph_begin(U64 address_size, U64 slot_count);
+internal TG_Graph *tg_graph_alloc(U64 address_size, U64 slot_count, RADDBG_Parsed *rdbg);
+internal void tg_graph_release(TG_Graph *graph);
 internal TG_Key tg_cons_type_make(TG_Graph *graph, TG_Kind kind, TG_Key direct_type_key, U64 u64);
 
 ////////////////////////////////
 //~ rjf: Graph Introspection API
-
+//
+// NOTE: when `graph` is a shared graph built for `rdbg`, types, data
+// member arrays, & strings are computed once per key & returned from the
+// graph's cache, rather than being pushed onto `arena`. those results are
+// read-only, & are valid for as long as the graph is.
+
+internal TG_CacheNode *tg_cache_node_from_graph_raddbg_key(TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
+internal TG_Type *tg_type_copy(Arena *arena, TG_Type *src);
 internal TG_Type *tg_type_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
+internal TG_Type *tg_type_from_graph_raddbg_key__uncached(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
 internal TG_Key tg_direct_from_graph_raddbg_key(TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
 internal TG_Key tg_unwrapped_direct_from_graph_raddbg_key(TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
 internal TG_Key tg_owner_from_graph_raddbg_key(TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
@@ -236,6 +276,7 @@ internal TG_Kind tg_kind_from_key(TG_Key key);
 internal TG_Member *tg_member_copy(Arena *arena, TG_Member *src);
 internal TG_MemberArray tg_members_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
 internal TG_MemberArray tg_data_members_from_graph_raddbg_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
+internal TG_MemberArray tg_data_members_from_graph_raddbg_key__uncached(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
 internal void tg_lhs_string_from_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key, String8List *out, U32 prec, B32 skip_return);
 internal void tg_rhs_string_from_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key, String8List *out, U32 prec);
 internal String8 tg_string_from_key(Arena *arena, TG_Graph *graph, RADDBG_Parsed *rdbg, TG_Key key);
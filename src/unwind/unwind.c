@@ -15,6 +15,14 @@ unw_memview_from_data(String8 data, U64 base_vaddr){
   return(result);
 }
 
+internal UNW_MemView
+unw_memview_from_read_function(UNW_MemViewReadFunctionType *read_function, void *read_user_data){
+  UNW_MemView result = {0};
+  result.read_function = read_function;
+  result.read_user_data = read_user_data;
+  return(result);
+}
+
 //- mem view user face for unwind users
 
 internal B32
@@ -24,6 +32,9 @@ unw_memview_read(UNW_MemView *memview, U64 addr, U64 size, void *out){
     MemoryCopy(out, (U8*)memview->data + addr - memview->addr_first, size);
     result = 1;
   }
+  else if (memview->read_function != 0){
+    result = memview->read_function(memview->read_user_data, addr, size, out);
+  }
   return(result);
 }
 
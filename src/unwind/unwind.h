@@ -9,6 +9,9 @@
 
 // * applies to (any X,Y: unwind(X, Y))
 
+#define UNW_MEMVIEW_READ_FUNCTION_DEF(name) B32 name(void *user_data, U64 addr, U64 size, void *out)
+typedef UNW_MEMVIEW_READ_FUNCTION_DEF(UNW_MemViewReadFunctionType);
+
 typedef struct UNW_MemView{
   // Upgrade Path:
   //  1. A list of ranges like this one
@@ -18,6 +21,11 @@ typedef struct UNW_MemView{
   void *data;
   U64 addr_first;
   U64 addr_opl;
+  
+  // abstracted source of new data: consulted for reads that do not fit in
+  // [addr_first,addr_opl), when set
+  UNW_MemViewReadFunctionType *read_function;
+  void *read_user_data;
 } UNW_MemView;
 
 typedef struct UNW_Result{
@@ -284,6 +292,7 @@ enum{
 
 //- mem view construction
 internal UNW_MemView unw_memview_from_data(String8 data, U64 base_vaddr);
+internal UNW_MemView unw_memview_from_read_function(UNW_MemViewReadFunctionType *read_function, void *read_user_data);
 
 //- mem view user face for unwind users
 internal B32 unw_memview_read(UNW_MemView *memview, U64 addr, U64 size, void *out);